@@ -0,0 +1,147 @@
+#include "AcquisitionFrame.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+struct AcquisitionFrameStore {
+    pthread_mutex_t lock;
+    AcquisitionFrame* frames;
+    int* holds;                             // Per frame: readers + the producer's or the latest slot's hold
+    int frame_count;
+    int latest;                             // Index of the latest frame (-1 = none yet)
+    uint64_t sequence;
+};
+
+// --- Private Function Prototypes ---
+static int frame_slot(const AcquisitionFrameStore* store, const AcquisitionFrame* frame);
+
+// --- Public Functions ---
+
+AcquisitionFrameStore* acquisition_frame_store_create(int frame_count) {
+    if (frame_count < 2) return NULL; // Latest + one being written
+
+    AcquisitionFrameStore* store = calloc(1, sizeof(AcquisitionFrameStore));
+    if (!store) {
+        perror("Failed to allocate memory for AcquisitionFrameStore");
+        return NULL;
+    }
+    store->frames = calloc((size_t)frame_count, sizeof(AcquisitionFrame));
+    store->holds = calloc((size_t)frame_count, sizeof(int));
+    if (!store->frames || !store->holds) {
+        perror("Failed to allocate memory for acquisition frames");
+        free(store->frames);
+        free(store->holds);
+        free(store);
+        return NULL;
+    }
+    if (pthread_mutex_init(&store->lock, NULL) != 0) {
+        fprintf(stderr, "AcquisitionFrame: Failed to initialize mutex\n");
+        free(store->frames);
+        free(store->holds);
+        free(store);
+        return NULL;
+    }
+    store->frame_count = frame_count;
+    store->latest = -1;
+    return store;
+}
+
+void acquisition_frame_capture(AcquisitionFrame* frame, const Channel channels[], int channel_count,
+                               ChannelMask fresh_mask, const GPSData* gps, double time_s, double wall_time_s) {
+    if (!frame || !channels) return;
+    if (channel_count > MAX_TOTAL_CHANNELS) channel_count = MAX_TOTAL_CHANNELS;
+
+    frame->time_s = time_s;
+    frame->wall_time_s = wall_time_s;
+    frame->fresh_mask = fresh_mask;
+    frame->channel_count = channel_count;
+    if (gps) {
+        frame->gps = *gps;
+    } else {
+        frame->gps = (GPSData){ .latitude = NAN, .longitude = NAN, .altitude = NAN, .speed = NAN };
+    }
+
+    for (int i = 0; i < channel_count; i++) {
+        const Channel* channel = &channels[i];
+        FrameChannel* captured = &frame->channels[i];
+        memcpy(captured->id, channel->id, sizeof(captured->id));
+        memcpy(captured->unit, channel->unit, sizeof(captured->unit));
+        captured->board_address = channel->board_address;
+        captured->pin = channel->pin;
+        captured->is_active = channel->is_active;
+        captured->publish_value = channel->publish_value;
+        captured->has_raw_value = !channel_has_calibrated_override(channel);
+        captured->raw_adc_value = channel->raw_adc_value;
+        captured->value = channel_get_calibrated_value(channel);
+        captured->sample_time_s = channel->sample_time_s;
+        captured->quality_flags = channel->quality_flags;
+    }
+}
+
+AcquisitionFrame* acquisition_frame_begin(AcquisitionFrameStore* store) {
+    if (!store) return NULL;
+
+    AcquisitionFrame* frame = NULL;
+    pthread_mutex_lock(&store->lock);
+    for (int i = 0; i < store->frame_count; i++) {
+        if (store->holds[i] == 0) {
+            store->holds[i] = 1; // The producer's hold, handed to the latest slot on publish
+            frame = &store->frames[i];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&store->lock);
+    return frame;
+}
+
+void acquisition_frame_publish(AcquisitionFrameStore* store, AcquisitionFrame* frame) {
+    if (!store || !frame) return;
+    int slot = frame_slot(store, frame);
+    if (slot < 0) return;
+
+    pthread_mutex_lock(&store->lock);
+    frame->sequence = ++store->sequence;
+    if (store->latest >= 0) store->holds[store->latest]--;
+    store->latest = slot;
+    pthread_mutex_unlock(&store->lock);
+}
+
+const AcquisitionFrame* acquisition_frame_acquire(AcquisitionFrameStore* store) {
+    if (!store) return NULL;
+
+    const AcquisitionFrame* frame = NULL;
+    pthread_mutex_lock(&store->lock);
+    if (store->latest >= 0) {
+        store->holds[store->latest]++;
+        frame = &store->frames[store->latest];
+    }
+    pthread_mutex_unlock(&store->lock);
+    return frame;
+}
+
+void acquisition_frame_release(AcquisitionFrameStore* store, const AcquisitionFrame* frame) {
+    if (!store || !frame) return;
+    int slot = frame_slot(store, frame);
+    if (slot < 0) return;
+
+    pthread_mutex_lock(&store->lock);
+    if (store->holds[slot] > 0) store->holds[slot]--;
+    pthread_mutex_unlock(&store->lock);
+}
+
+void acquisition_frame_store_destroy(AcquisitionFrameStore* store) {
+    if (!store) return;
+    pthread_mutex_destroy(&store->lock);
+    free(store->frames);
+    free(store->holds);
+    free(store);
+}
+
+// --- Private Function Implementations ---
+
+static int frame_slot(const AcquisitionFrameStore* store, const AcquisitionFrame* frame) {
+    if (frame < store->frames || frame >= store->frames + store->frame_count) return -1;
+    return (int)(frame - store->frames);
+}
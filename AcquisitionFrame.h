@@ -0,0 +1,90 @@
+#ifndef ACQUISITION_FRAME_H
+#define ACQUISITION_FRAME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Channel.h"
+#include "HardwareManager.h" // For GPSData
+#include "SweepScheduler.h"  // For ChannelMask
+
+/**
+ * @file AcquisitionFrame.h
+ * @brief Immutable per-sweep snapshot shared by every sink (CSV, InfluxDB, display, socket clients).
+ *
+ * After each sweep the acquisition task captures the channels once (raw code, calibrated
+ * value, quality) together with the GPS fix into a frame and publishes it. Sinks acquire
+ * the latest frame, read it without locks and release it; a frame is recycled only when
+ * no sink holds it any more, so a reader never sees a half-updated sweep, whatever thread
+ * it runs on. Frames come from a pool sized at creation: nothing is allocated per sweep.
+ */
+
+#define ACQUISITION_FRAME_POOL_SIZE 6 // Latest + one being written + one per concurrent reader
+
+// One channel as captured in a frame
+typedef struct {
+    char id[MEASUREMENT_ID_SIZE];
+    char unit[UNIT_SIZE];
+    int board_address;
+    int pin;
+    bool is_active;
+    bool publish_value;      // false = statistics-only channel
+    bool has_raw_value;      // false when the value is synthetic (calibrated override): no ADC code
+    int raw_adc_value;
+    double value;            // Calibrated, filtered value (channel_get_calibrated_value)
+    double sample_time_s;    // Monotonic time of the latest successful read (0 = never read)
+    uint8_t quality_flags;   // CHANNEL_QUALITY_* bits
+} FrameChannel;
+
+typedef struct {
+    uint64_t sequence;       // Increases by one with every published frame (first = 1)
+    double time_s;           // Monotonic capture time
+    double wall_time_s;      // Wall-clock capture time (timestamps of the sinks)
+    ChannelMask fresh_mask;  // Channels with a new value in this sweep
+    GPSData gps;             // Fix taken with the sweep (NAN fields = no fix)
+    int channel_count;
+    FrameChannel channels[MAX_TOTAL_CHANNELS];
+} AcquisitionFrame;
+
+typedef struct AcquisitionFrameStore AcquisitionFrameStore; // Opaque frame pool
+
+/**
+ * @brief Creates an empty store (acquire returns NULL until the first publish).
+ * @param frame_count Pool size: ACQUISITION_FRAME_POOL_SIZE plus any frames held in queues
+ * @return A pointer to the store, or NULL on failure
+ */
+AcquisitionFrameStore* acquisition_frame_store_create(int frame_count);
+
+/**
+ * @brief Fills a frame from the live channels. Sequence and publication are left to the store.
+ */
+void acquisition_frame_capture(AcquisitionFrame* frame, const Channel channels[], int channel_count,
+                               ChannelMask fresh_mask, const GPSData* gps, double time_s, double wall_time_s);
+
+/**
+ * @brief Takes a frame no sink holds, to be filled and then published (single producer).
+ * @return A writable frame, or NULL if every frame is still held
+ */
+AcquisitionFrame* acquisition_frame_begin(AcquisitionFrameStore* store);
+
+/**
+ * @brief Makes a frame from acquisition_frame_begin the latest one, replacing the previous.
+ */
+void acquisition_frame_publish(AcquisitionFrameStore* store, AcquisitionFrame* frame);
+
+/**
+ * @brief Returns the latest frame and holds it until acquisition_frame_release. Thread-safe.
+ * @return The frame, or NULL before the first publish
+ */
+const AcquisitionFrame* acquisition_frame_acquire(AcquisitionFrameStore* store);
+
+/**
+ * @brief Drops a hold taken with acquisition_frame_acquire (NULL is ignored). Thread-safe.
+ */
+void acquisition_frame_release(AcquisitionFrameStore* store, const AcquisitionFrame* frame);
+
+/**
+ * @brief Frees the store. No frame may be held any more.
+ */
+void acquisition_frame_store_destroy(AcquisitionFrameStore* store);
+
+#endif // ACQUISITION_FRAME_H
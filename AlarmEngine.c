@@ -0,0 +1,211 @@
+#include "AlarmEngine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define MAX_COMPILED_CONDITIONS (MAX_ALARM_RULES * MAX_ALARM_CONDITIONS)
+
+// One row of the evaluation table
+typedef struct {
+    int channel_index;
+    AlarmConditionType type;
+    double threshold;
+    double release;             // Value on the other side of the threshold that releases the condition
+    double for_s;
+
+    bool asserted;
+    double asserted_since_s;
+    double value;               // Latest evaluated value (rate for a rate condition)
+
+    // Previous fresh sample, for the rate of change
+    bool has_last_sample;
+    double last_sample_value;
+    double last_sample_time_s;
+} CompiledCondition;
+
+typedef struct {
+    char id[ALARM_ID_SIZE];
+    AlarmSeverity severity;
+    bool any;
+    int first_condition;        // The rule's conditions are contiguous in the table
+    int condition_count;
+    bool raised;
+} CompiledRule;
+
+struct AlarmEngine {
+    CompiledCondition conditions[MAX_COMPILED_CONDITIONS];
+    int condition_count;
+    CompiledRule rules[MAX_ALARM_RULES];
+    int rule_count;
+    int active_count;
+
+    AlarmEvent events[MAX_ALARM_RULES]; // Raises and clears of the latest sweep
+    int event_count;
+};
+
+// --- Private Function Prototypes ---
+static int find_channel_index(const Channel channels[], int channel_count, const char* id);
+static void update_condition(CompiledCondition* condition, const Channel* channel, double now_s);
+static bool condition_counts(const CompiledCondition* condition, double now_s);
+
+// --- Public Functions ---
+
+AlarmEngine* alarm_engine_create(const AlarmConfig* config, const Channel channels[], int channel_count) {
+    if (!config || !channels || config->rule_count <= 0) return NULL;
+
+    AlarmEngine* engine = calloc(1, sizeof(AlarmEngine));
+    if (!engine) {
+        perror("Failed to allocate memory for AlarmEngine");
+        return NULL;
+    }
+
+    for (int r = 0; r < config->rule_count && r < MAX_ALARM_RULES; r++) {
+        const AlarmRuleConfig* rule_config = &config->rules[r];
+        CompiledRule* rule = &engine->rules[engine->rule_count];
+        rule->first_condition = engine->condition_count;
+
+        bool usable = rule_config->condition_count > 0;
+        for (int c = 0; c < rule_config->condition_count && usable; c++) {
+            const AlarmConditionConfig* condition_config = &rule_config->conditions[c];
+            CompiledCondition* condition = &engine->conditions[rule->first_condition + c];
+
+            condition->channel_index = find_channel_index(channels, channel_count, condition_config->channel_id);
+            if (condition->channel_index < 0 || condition_config->type == ALARM_CONDITION_NONE) {
+                fprintf(stderr, "AlarmEngine: Channel '%s' of rule '%s' not found or inactive, skipping the rule\n",
+                        condition_config->channel_id, rule_config->id);
+                usable = false;
+                break;
+            }
+
+            condition->type = condition_config->type;
+            condition->threshold = condition_config->threshold;
+            condition->release = condition_config->type == ALARM_CONDITION_BELOW ?
+                                 condition_config->threshold + condition_config->hysteresis :
+                                 condition_config->threshold - condition_config->hysteresis;
+            condition->for_s = condition_config->for_s;
+            condition->value = NAN;
+        }
+        if (!usable) {
+            memset(&engine->conditions[rule->first_condition], 0,
+                   (size_t)rule_config->condition_count * sizeof(CompiledCondition));
+            continue;
+        }
+
+        snprintf(rule->id, sizeof(rule->id), "%s", rule_config->id);
+        rule->severity = rule_config->severity;
+        rule->any = rule_config->any;
+        rule->condition_count = rule_config->condition_count;
+        engine->condition_count += rule->condition_count;
+        engine->rule_count++;
+    }
+
+    if (engine->rule_count == 0) {
+        alarm_engine_destroy(engine);
+        return NULL;
+    }
+    printf("AlarmEngine: %d rules compiled into %d conditions\n", engine->rule_count, engine->condition_count);
+    return engine;
+}
+
+int alarm_engine_process(AlarmEngine* engine, const Channel channels[], ChannelMask fresh_mask, double now_s) {
+    if (!engine || !channels) return 0;
+
+    for (int c = 0; c < engine->condition_count; c++) {
+        CompiledCondition* condition = &engine->conditions[c];
+        const Channel* channel = &channels[condition->channel_index];
+        if ((fresh_mask & CHANNEL_MASK_BIT(condition->channel_index)) && channel_is_quality_ok(channel)) {
+            update_condition(condition, channel, now_s);
+        }
+    }
+
+    engine->event_count = 0;
+    for (int r = 0; r < engine->rule_count; r++) {
+        CompiledRule* rule = &engine->rules[r];
+        const CompiledCondition* first = &engine->conditions[rule->first_condition];
+        const CompiledCondition* cause = NULL;
+
+        bool raised = !rule->any;
+        for (int c = 0; c < rule->condition_count; c++) {
+            bool counts = condition_counts(&first[c], now_s);
+            if (counts && !cause) cause = &first[c];
+            raised = rule->any ? (raised || counts) : (raised && counts);
+        }
+        if (raised == rule->raised) continue;
+        if (!cause) cause = first;
+
+        rule->raised = raised;
+        engine->active_count += raised ? 1 : -1;
+        engine->events[engine->event_count++] = (AlarmEvent){
+            .rule_index = r,
+            .id = rule->id,
+            .severity = rule->severity,
+            .raised = raised,
+            .channel_index = cause->channel_index,
+            .value = cause->value
+        };
+    }
+    return engine->event_count;
+}
+
+const AlarmEvent* alarm_engine_get_event(const AlarmEngine* engine, int index) {
+    if (!engine || index < 0 || index >= engine->event_count) return NULL;
+    return &engine->events[index];
+}
+
+int alarm_engine_active_count(const AlarmEngine* engine) {
+    return engine ? engine->active_count : 0;
+}
+
+const char* alarm_engine_severity_name(AlarmSeverity severity) {
+    switch (severity) {
+        case ALARM_SEVERITY_INFO: return "info";
+        case ALARM_SEVERITY_WARNING: return "warning";
+        case ALARM_SEVERITY_CRITICAL: return "critical";
+    }
+    return "unknown";
+}
+
+void alarm_engine_destroy(AlarmEngine* engine) {
+    free(engine);
+}
+
+// --- Private Function Implementations ---
+
+static int find_channel_index(const Channel channels[], int channel_count, const char* id) {
+    for (int i = 0; i < channel_count && i < MAX_TOTAL_CHANNELS; i++) {
+        if (channels[i].is_active && strcmp(channels[i].id, id) == 0) return i;
+    }
+    return -1;
+}
+
+// Applies a fresh sample: asserts past the threshold, releases past the hysteresis band
+static void update_condition(CompiledCondition* condition, const Channel* channel, double now_s) {
+    double value = channel_get_calibrated_value(channel);
+
+    if (condition->type == ALARM_CONDITION_RATE) {
+        double time_s = channel->sample_time_s > 0.0 ? channel->sample_time_s : now_s;
+        bool has_rate = condition->has_last_sample && time_s > condition->last_sample_time_s;
+        double rate = has_rate ? fabs(value - condition->last_sample_value) / (time_s - condition->last_sample_time_s) : NAN;
+        condition->has_last_sample = true;
+        condition->last_sample_value = value;
+        condition->last_sample_time_s = time_s;
+        if (!has_rate) return;
+        value = rate;
+    }
+
+    condition->value = value;
+    bool beyond = condition->type == ALARM_CONDITION_BELOW ? value < condition->threshold : value > condition->threshold;
+    bool released = condition->type == ALARM_CONDITION_BELOW ? value >= condition->release : value <= condition->release;
+
+    if (!condition->asserted && beyond) {
+        condition->asserted = true;
+        condition->asserted_since_s = now_s;
+    } else if (condition->asserted && released) {
+        condition->asserted = false;
+    }
+}
+
+static bool condition_counts(const CompiledCondition* condition, double now_s) {
+    return condition->asserted && now_s - condition->asserted_since_s >= condition->for_s;
+}
@@ -0,0 +1,77 @@
+#ifndef ALARM_ENGINE_H
+#define ALARM_ENGINE_H
+
+#include <stdbool.h>
+#include "Channel.h"
+#include "ConfigYAML.h"
+#include "SweepScheduler.h" // For ChannelMask
+
+/**
+ * @file AlarmEngine.h
+ * @brief Local alarm rules of the YAML `alarms` section, evaluated after every sweep.
+ *
+ * The rules are compiled once into a flat table of conditions, each with its
+ * channel index resolved, so a sweep costs one pass over that table. A
+ * condition compares the channel's published (calibrated, filtered) value
+ * with its threshold, or the rate of change between its fresh samples with a
+ * rate limit. It asserts when the threshold is crossed and releases only
+ * `hysteresis` back past it; with `for_s` it must stay asserted that long
+ * before it counts. A rule is raised when all (or, with `combine: any`, any)
+ * of its conditions count, and cleared when that stops being true.
+ *
+ * Conditions are only updated on fresh samples of good quality; a channel
+ * that stops delivering keeps its conditions as they were.
+ */
+
+typedef struct {
+    int rule_index;
+    const char* id;          // Rule id (valid while the engine exists)
+    AlarmSeverity severity;
+    bool raised;             // true = raised, false = cleared
+    int channel_index;       // Channel of the rule's first condition that counts (first condition on clear)
+    double value;            // That condition's latest value (units per second for a rate)
+} AlarmEvent;
+
+typedef struct AlarmEngine AlarmEngine; // Opaque compiled rule table
+
+/**
+ * @brief Compiles the rules against the channel array.
+ *
+ * Rules naming an unknown or inactive channel are skipped with a message.
+ *
+ * @return A pointer to the engine, or NULL on failure or when no rule is usable
+ */
+AlarmEngine* alarm_engine_create(const AlarmConfig* config, const Channel channels[], int channel_count);
+
+/**
+ * @brief Evaluates all rules on one sweep.
+ *
+ * The events reported by the return value stay readable until the next call.
+ *
+ * @param fresh_mask Channels that got a new sample in this sweep
+ * @param now_s Monotonic time of the sweep, for the for_s durations
+ * @return Number of rules raised or cleared by this sweep
+ */
+int alarm_engine_process(AlarmEngine* engine, const Channel channels[], ChannelMask fresh_mask, double now_s);
+
+/**
+ * @brief Returns an event of the latest alarm_engine_process call (NULL for an invalid index).
+ */
+const AlarmEvent* alarm_engine_get_event(const AlarmEngine* engine, int index);
+
+/**
+ * @brief Returns the number of rules currently raised.
+ */
+int alarm_engine_active_count(const AlarmEngine* engine);
+
+/**
+ * @brief Returns the name of a severity ("info", "warning" or "critical").
+ */
+const char* alarm_engine_severity_name(AlarmSeverity severity);
+
+/**
+ * @brief Frees the engine.
+ */
+void alarm_engine_destroy(AlarmEngine* engine);
+
+#endif // ALARM_ENGINE_H
@@ -0,0 +1,105 @@
+#include "AlarmHook.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#define ALARM_HOOK_MAX_ARGUMENTS 8
+
+extern char** environ;
+
+struct AlarmHook {
+    char command[256];          // Empty = no command
+    int socket_fd;              // -1 = no socket
+    struct sockaddr_un socket_address;
+    pid_t running[ALARM_HOOK_MAX_RUNNING]; // 0 = free slot
+};
+
+// --- Private Function Prototypes ---
+static void reap_finished(AlarmHook* hook);
+static void spawn_command(AlarmHook* hook, const char* const arguments[]);
+
+// --- Public Functions ---
+
+AlarmHook* alarm_hook_create(const AlarmConfig* config) {
+    if (!config || (config->hook_command[0] == '\0' && config->hook_socket[0] == '\0')) return NULL;
+
+    AlarmHook* hook = calloc(1, sizeof(AlarmHook));
+    if (!hook) {
+        perror("Failed to allocate memory for AlarmHook");
+        return NULL;
+    }
+
+    snprintf(hook->command, sizeof(hook->command), "%s", config->hook_command);
+    hook->socket_fd = -1;
+    if (config->hook_socket[0] != '\0') {
+        hook->socket_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (hook->socket_fd < 0) {
+            fprintf(stderr, "AlarmHook: Socket creation failed: %s\n", strerror(errno));
+        }
+        hook->socket_address.sun_family = AF_UNIX;
+        snprintf(hook->socket_address.sun_path, sizeof(hook->socket_address.sun_path), "%s", config->hook_socket);
+    }
+    return hook;
+}
+
+void alarm_hook_notify(AlarmHook* hook, const char* const arguments[], const char* json_line) {
+    if (!hook) return;
+
+    reap_finished(hook);
+    if (hook->command[0] != '\0' && arguments) spawn_command(hook, arguments);
+
+    // A missing listener (ENOENT, ECONNREFUSED) or a full buffer (EAGAIN) just loses this datagram
+    if (hook->socket_fd >= 0 && json_line &&
+        sendto(hook->socket_fd, json_line, strlen(json_line), MSG_DONTWAIT,
+               (const struct sockaddr*)&hook->socket_address, sizeof(hook->socket_address)) < 0 &&
+        errno != ENOENT && errno != ECONNREFUSED && errno != EAGAIN) {
+        fprintf(stderr, "AlarmHook: Send to %s failed: %s\n", hook->socket_address.sun_path, strerror(errno));
+    }
+}
+
+void alarm_hook_destroy(AlarmHook* hook) {
+    if (!hook) return;
+
+    reap_finished(hook);
+    if (hook->socket_fd >= 0) close(hook->socket_fd);
+    free(hook);
+}
+
+// --- Private Function Implementations ---
+
+static void reap_finished(AlarmHook* hook) {
+    for (int i = 0; i < ALARM_HOOK_MAX_RUNNING; i++) {
+        if (hook->running[i] > 0 && waitpid(hook->running[i], NULL, WNOHANG) != 0) hook->running[i] = 0;
+    }
+}
+
+static void spawn_command(AlarmHook* hook, const char* const arguments[]) {
+    int slot = 0;
+    while (slot < ALARM_HOOK_MAX_RUNNING && hook->running[slot] > 0) slot++;
+    if (slot == ALARM_HOOK_MAX_RUNNING) {
+        fprintf(stderr, "AlarmHook: %d hook commands still running, alarm not passed to %s\n",
+                ALARM_HOOK_MAX_RUNNING, hook->command);
+        return;
+    }
+
+    char* argv[ALARM_HOOK_MAX_ARGUMENTS + 2];
+    int argc = 0;
+    argv[argc++] = hook->command;
+    while (argc <= ALARM_HOOK_MAX_ARGUMENTS && arguments[argc - 1]) {
+        argv[argc] = (char*)arguments[argc - 1];
+        argc++;
+    }
+    argv[argc] = NULL;
+
+    int result = posix_spawn(&hook->running[slot], hook->command, NULL, NULL, argv, environ);
+    if (result != 0) {
+        fprintf(stderr, "AlarmHook: Failed to run %s: %s\n", hook->command, strerror(result));
+        hook->running[slot] = 0;
+    }
+}
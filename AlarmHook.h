@@ -0,0 +1,41 @@
+#ifndef ALARM_HOOK_H
+#define ALARM_HOOK_H
+
+#include <stdbool.h>
+#include "ConfigYAML.h"
+
+/**
+ * @file AlarmHook.h
+ * @brief Local delivery of alarm raises and clears, independent of the network link.
+ *
+ * With `alarms.hook_command` set, every raise and clear spawns the command
+ * (posix_spawn, no shell) with the arguments
+ * `<rule id> <raised|cleared> <severity> <channel id> <value>`; the command
+ * runs in the background and finished ones are reaped on later calls. With
+ * `alarms.hook_socket` set, the JSON line passed in is also sent as one
+ * datagram to that Unix socket, without blocking when nobody listens.
+ */
+
+#define ALARM_HOOK_MAX_RUNNING 8 // Spawned commands still running; more are dropped
+
+typedef struct AlarmHook AlarmHook; // Opaque hook state
+
+/**
+ * @brief Creates the hook.
+ * @return A pointer to the hook, or NULL on failure or when neither target is configured
+ */
+AlarmHook* alarm_hook_create(const AlarmConfig* config);
+
+/**
+ * @brief Delivers one alarm transition to the command and the socket.
+ * @param arguments The command arguments after the command itself (NULL-terminated)
+ * @param json_line The same transition as a newline-terminated JSON object, for the socket
+ */
+void alarm_hook_notify(AlarmHook* hook, const char* const arguments[], const char* json_line);
+
+/**
+ * @brief Closes the socket and frees the hook. Running commands are not waited for.
+ */
+void alarm_hook_destroy(AlarmHook* hook);
+
+#endif // ALARM_HOOK_H
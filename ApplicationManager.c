@@ -7,6 +7,7 @@
 #include <signal.h>
 #include <math.h>
 #include <time.h>
+#include <sys/stat.h>
 
 // All required headers from the original main.c
 #include "ADS1115.h"
@@ -21,17 +22,56 @@
 #include "SocketServer.h"
 #include "util.h"
 #include "DataPublisher.h"
-#include "TimingUtils.h"
+#include "TaskScheduler.h"
 #include "HardwareManager.h"
+#include "ConfigWatcher.h"
+#include "SweepScheduler.h"
+#include "EventLoop.h"
+#include "TriggerEngine.h"
+#include "MqttPublisher.h"
+#include "EnergyMeter.h"
+#include "TripOdometer.h"
+#include "AlarmEngine.h"
+#include "AlarmHook.h"
+#include "AcquisitionFrame.h"
+#include "Pipeline.h"
+
+// Periods of the housekeeping tasks driven by the task scheduler
+#define APP_DISPLAY_REFRESH_INTERVAL_S 0.25
+#define APP_HARDWARE_REPROBE_INTERVAL_S 30.0
+#define APP_DEFAULT_SOC_SAVE_INTERVAL_S 1.0
+#define APP_DEFAULT_ENERGY_SAVE_INTERVAL_S 5.0
+#define APP_DEFAULT_SKETCH_INTERVAL_S 60.0
+#define APP_DEFAULT_SKETCH_DIRECTORY "logs"
+#define APP_DEFAULT_CAPTURE_DIRECTORY "logs"
+
+// Background (non-acquisition) timers on the event loop
+#define APP_OFFLINE_REPLAY_INTERVAL_MS 60000
+
+// Completed burst captures waiting for the event loop (a capture spans at least post_samples sweeps)
+#define APP_CAPTURE_QUEUE_SIZE 4
+
+// A capture taken out of the trigger engine, with where it goes resolved on the sweep thread
+typedef struct {
+    TriggerCapture* capture;
+    char directory[256];
+    char file_name[160];
+    bool upload;
+} PendingCapture;
 
 // The internal structure of the ApplicationManager
 struct ApplicationManager {
-    volatile sig_atomic_t keep_running;
     char config_file_path[APP_CONFIG_FILE_PATH_MAX];
     YAMLAppConfig* yaml_config;
 
     BatteryState battery_state;
+    int battery_channel_index[MAX_BATTERY_PACKS][BATTERY_CHANNEL_COUNT]; // Virtual channels per pack (-1 = none)
+    EnergyMeter* energy_meter;  // Voltage/current pair counters (NULL if none configured)
+    TripOdometer* trip_odometer; // GPS distance and Wh/km (NULL if not configured)
+    int trip_meter_index;       // Energy meter feeding the odometer (-1 = none)
     SenderContext* sender_ctx;
+    SenderContext* tier_senders[MAX_ROLLUP_TIERS]; // One per rollup tier (bucket)
+    int tier_sender_count;
     CsvLogger csv_logger;
     
     pthread_mutex_t cal_mutex;
@@ -40,7 +80,40 @@ struct ApplicationManager {
     HardwareManager* hardware_manager;
     DataPublisher* data_publisher;
     DisplayManager* display_manager;
-    IntervalTimer send_timer;
+    AcquisitionFrameStore* frames; // Latest sweep as seen by CSV, publisher, display and socket clients
+    Pipeline* pipeline;         // Sinks on their own threads (CSV, display, MQTT)
+    PipelineSinkId csv_sink;
+    PipelineSinkId display_sink;
+    PipelineSinkId mqtt_sink;
+    MqttPublisher* mqtt_publisher; // NULL without an mqtt section
+    ConfigWatcher* config_watcher;
+    SweepScheduler* sweep_scheduler;
+
+    // Background reactor: socket server, config watcher, offline replay trigger
+    EventLoop* event_loop;
+    SocketServerContext* socket_server;
+    EventSource* offline_replay_timer;
+    EventSource* mqtt_keepalive_timer; // NULL without MQTT output or keepalive
+
+    // Acquisition-side periodic jobs (sweep, publish, SoC save, status, re-probe)
+    TaskScheduler* task_scheduler;
+    TaskId sweep_task;
+    TaskId publish_task;
+    TaskId soc_save_task;
+    TaskId energy_save_task;
+    TaskId sketch_task;
+    char sketch_path[512];      // This trip's quantile sketch file
+    TriggerEngine* trigger_engine; // Burst capture around transients (NULL if unavailable)
+
+    // Captures are written and uploaded on the event loop, not the sweep thread
+    pthread_mutex_t capture_lock;
+    PendingCapture pending_captures[APP_CAPTURE_QUEUE_SIZE];
+    int pending_capture_count;
+    EventSource* capture_event;
+    unsigned capture_sequence;  // Keeps the file names of captures within one second apart
+    AlarmEngine* alarm_engine;  // Local alarm rules (NULL if none configured)
+    AlarmHook* alarm_hook;      // Alarm command/socket (NULL if none configured)
+    GPSData gps_data;           // GPS fix taken with the latest sweep
     time_t start_time;
     time_t last_hw_error_log_time;
     bool hw_error_active;
@@ -48,6 +121,36 @@ struct ApplicationManager {
 
 // --- Private Function Prototypes ---
 // print_measurements function removed - now using DisplayManager
+static void apply_pending_config_reload(ApplicationManager* app);
+static SweepScheduler* create_sweep_scheduler(const ApplicationManager* app);
+static bool register_tasks(ApplicationManager* app);
+static double soc_save_interval_s(const ApplicationManager* app);
+static double energy_save_interval_s(const ApplicationManager* app);
+static double sketch_interval_s(const ApplicationManager* app);
+static void init_sketch_path(ApplicationManager* app);
+static void run_sweep_task(void* user_data);
+static void publish_frame(ApplicationManager* app, ChannelMask fresh_mask, double wall_time_s);
+static int frame_pool_size(const ApplicationManager* app);
+static bool create_pipeline(ApplicationManager* app);
+static void create_rollup_tiers(ApplicationManager* app);
+static void create_trigger_engine(ApplicationManager* app);
+static void queue_trigger_capture(ApplicationManager* app);
+static void handle_capture_event(EventLoop* loop, void* user_data);
+static void save_pending_captures(ApplicationManager* app);
+static double wall_clock_seconds(void);
+static double monotonic_seconds(void);
+static void dispatch_alarms(ApplicationManager* app, int event_count);
+static void add_battery_channels(ApplicationManager* app);
+static void update_battery_channels(ApplicationManager* app);
+static void run_publish_task(void* user_data);
+static void run_display_task(void* user_data);
+static void run_soc_save_task(void* user_data);
+static void run_energy_save_task(void* user_data);
+static void run_sketch_task(void* user_data);
+static double trip_energy_wh(const ApplicationManager* app);
+static void handle_offline_replay_timer(EventLoop* loop, void* user_data);
+static void handle_mqtt_keepalive_timer(EventLoop* loop, void* user_data);
+static void run_reprobe_task(void* user_data);
 
 // --- Public API Implementation ---
 
@@ -68,8 +171,17 @@ ApplicationManager* app_manager_create(const char* config_file) {
         return NULL;
     }
 
-    app->keep_running = true;
+    if (pthread_mutex_init(&app->capture_lock, NULL) != 0) {
+        fprintf(stderr, "Failed to initialize capture mutex\n");
+        free(app);
+        return NULL;
+    }
+
     app->yaml_config = NULL;
+    app->gps_data.latitude = NAN;  // No fix until the first sweep reports one
+    app->gps_data.longitude = NAN;
+    app->gps_data.altitude = NAN;
+    app->gps_data.speed = NAN;
     
     // Safe string copying with guaranteed null termination
     strncpy(app->config_file_path, config_file, sizeof(app->config_file_path) - 1);
@@ -177,19 +289,105 @@ AppManagerError app_manager_init(ApplicationManager* app) {
         hardware_manager_cleanup(app->hardware_manager);
         return APP_ERROR_PUBLISHER_INIT_FAILED;
     }
+    data_publisher_set_channel_stats(app->data_publisher, hardware_manager_get_channel_stats(app->hardware_manager));
+    data_publisher_set_channel_spectra(app->data_publisher, hardware_manager_get_channel_spectra(app->hardware_manager));
+
+    // Downsampled tiers, each sent to its own bucket
+    create_rollup_tiers(app);
+
+    // One reactor thread serves all background I/O and timers
+    app->event_loop = event_loop_create();
+    if (!app->event_loop) {
+        display_manager_add_message(app->display_manager, MSG_ERROR, "Event loop initialization failed");
+        return APP_ERROR_EVENT_LOOP_FAILED;
+    }
+
+    // One snapshot per sweep, shared by every sink
+    app->frames = acquisition_frame_store_create(frame_pool_size(app));
+    if (!app->frames) {
+        display_manager_add_message(app->display_manager, MSG_ERROR, "Acquisition frame store initialization failed");
+        return APP_ERROR_MEMORY_ALLOCATION;
+    }
 
     // Initialize socket server
-    SocketServerContext* socket_server = socket_server_create(app->hardware_manager, app->yaml_config);
-    socket_server_start(socket_server);
-    
-    // Transmission interval for sending networked data
-    double send_interval_s = app->yaml_config->system.data_send_interval_ms / 1000.0;
-    interval_timer_init(&app->send_timer, send_interval_s);
-    csv_logger_init_from_yaml(&app->csv_logger, hardware_manager_get_channels(app->hardware_manager), app->yaml_config);
+    app->socket_server = socket_server_create(app->hardware_manager, app->frames, app->yaml_config);
+    if (app->socket_server && !socket_server_start(app->socket_server, app->event_loop)) {
+        display_manager_add_message(app->display_manager, MSG_WARN, "Socket server failed to start");
+        socket_server_destroy(app->socket_server);
+        app->socket_server = NULL;
+    }
+
+    // Periodically ask the offline threads (senders, MQTT client) to replay queued data
+    app->offline_replay_timer = event_loop_add_timer(app->event_loop, APP_OFFLINE_REPLAY_INTERVAL_MS,
+                                                     APP_OFFLINE_REPLAY_INTERVAL_MS,
+                                                     handle_offline_replay_timer, app);
     
     // Initialize battery monitor with YAML configuration
     battery_monitor_init_from_yaml(&app->battery_state, hardware_manager_get_channels(app->hardware_manager), app->yaml_config);
 
+    // Per-pack SoC, charge and energy are published like any other channel
+    add_battery_channels(app);
+
+    // Energy and charge counters, restored from their state files
+    app->energy_meter = energy_meter_create(&app->yaml_config->energy,
+                                            hardware_manager_get_channels(app->hardware_manager),
+                                            hardware_manager_get_channel_count(app->hardware_manager));
+
+    // Odometer and Wh/km, fused from the GPS fixes and one of the meters
+    app->trip_odometer = trip_odometer_create(&app->yaml_config->trip);
+    app->trip_meter_index = energy_meter_find(app->energy_meter, app->yaml_config->trip.energy_meter_id);
+
+    // After the virtual channels so they get CSV columns
+    csv_logger_init_from_yaml(&app->csv_logger, hardware_manager_get_channels(app->hardware_manager), app->yaml_config);
+
+    // Slow outputs consume the frames on their own threads
+    if (!create_pipeline(app)) {
+        display_manager_add_message(app->display_manager, MSG_ERROR, "Output pipeline initialization failed");
+        return APP_ERROR_MEMORY_ALLOCATION;
+    }
+
+    // One quantile sketch file per run (trip), merged across trips offline
+    init_sketch_path(app);
+
+    // After the virtual channels so captures include them
+    create_trigger_engine(app);
+
+    // After the virtual channels so rules can watch them
+    app->alarm_engine = alarm_engine_create(&app->yaml_config->alarms,
+                                            hardware_manager_get_channels(app->hardware_manager),
+                                            hardware_manager_get_channel_count(app->hardware_manager));
+    app->alarm_hook = alarm_hook_create(&app->yaml_config->alarms);
+    if (app->yaml_config->alarms.rule_count > 0 && !app->alarm_engine) {
+        display_manager_add_message(app->display_manager, MSG_WARN, "Alarm rules unavailable");
+    }
+
+    // Per-channel sample/publish table; without it every channel is read every sweep
+    app->sweep_scheduler = create_sweep_scheduler(app);
+    if (!app->sweep_scheduler) {
+        display_manager_add_message(app->display_manager, MSG_WARN, "Multi-rate scheduling unavailable; sampling all channels every sweep");
+    }
+
+    // Every periodic job runs from one deadline-ordered scheduler
+    app->task_scheduler = task_scheduler_create();
+    if (!app->task_scheduler || !register_tasks(app)) {
+        display_manager_add_message(app->display_manager, MSG_ERROR, "Task scheduler initialization failed");
+        return APP_ERROR_MEMORY_ALLOCATION;
+    }
+
+    // Watch the configuration file for hot reloads (inotify or SIGHUP)
+    app->config_watcher = config_watcher_create(app->config_file_path, app->yaml_config);
+    if (!app->config_watcher || !config_watcher_start(app->config_watcher, app->event_loop)) {
+        // Without its event sources a half-started watcher would never report a reload
+        config_watcher_destroy(app->config_watcher);
+        app->config_watcher = NULL;
+        display_manager_add_message(app->display_manager, MSG_WARN, "Config hot reload unavailable; restart to apply changes");
+    }
+
+    if (!event_loop_start(app->event_loop)) {
+        display_manager_add_message(app->display_manager, MSG_ERROR, "Event loop failed to start");
+        return APP_ERROR_EVENT_LOOP_FAILED;
+    }
+
     display_manager_add_message(app->display_manager, MSG_INFO, "Application Manager initialized successfully with config: %s", config_filename);
     display_manager_add_message(app->display_manager, MSG_INFO, "Channels configured: %zu", app->yaml_config->channel_count);
     display_manager_add_message(app->display_manager, MSG_INFO, "Main loop interval: %d ms", app->yaml_config->system.main_loop_interval_ms);
@@ -197,63 +395,27 @@ AppManagerError app_manager_init(ApplicationManager* app) {
     return APP_SUCCESS;
 }
 
-void app_manager_run(ApplicationManager* app) {
-    if (!app) return;
-
-    while (app->keep_running) {
-        // Collect measurements via HardwareManager
-        bool measurements_ok = hardware_manager_collect_measurements(app->hardware_manager);
-        time_t now = time(NULL);
+void app_manager_run(ApplicationManager* app, volatile sig_atomic_t* shutdown_requested,
+                     volatile sig_atomic_t* reload_requested) {
+    if (!app || !shutdown_requested || !reload_requested) return;
 
-        if (!measurements_ok) {
-            if (now - app->last_hw_error_log_time >= 2) {
-                display_manager_add_message(app->display_manager, MSG_WARN,
-                                           "Falha de leitura em uma ou mais entradas ADS1115 (tentando novamente)");
-                app->last_hw_error_log_time = now;
-            }
-            app->hw_error_active = true;
-        } else if (app->hw_error_active) {
-            display_manager_add_message(app->display_manager, MSG_INFO,
-                                       "Leituras ADS1115 normalizadas");
-            app->hw_error_active = false;
-        }
-        
-        if (interval_timer_should_trigger(&app->send_timer)) {
-            // Get current data from hardware manager
-            const Channel* channels = hardware_manager_get_channels(app->hardware_manager);
-            GPSData gps_data;
-            hardware_manager_get_current_gps(app->hardware_manager, &gps_data);
-            
-            data_publisher_publish(app->data_publisher, channels, &gps_data);
-            interval_timer_mark_triggered(&app->send_timer);
+    while (!*shutdown_requested) {
+        if (*reload_requested) {
+            *reload_requested = 0;
+            app_manager_request_config_reload(app);
         }
-        
-        // Log and display using hardware manager data
-        const Channel* channels = hardware_manager_get_channels(app->hardware_manager);
-        GPSData gps_data;
-        hardware_manager_get_current_gps(app->hardware_manager, &gps_data);
-        
-        csv_logger_log(&app->csv_logger, channels, &gps_data);
-        
-        // Update display with measurements
-        int channel_count = hardware_manager_get_channel_count(app->hardware_manager);
-        display_manager_update_measurements(app->display_manager, channels, channel_count, &gps_data);
-        
-        // Update system status
-        SystemStatus status = {
-            .active_boards = app->yaml_config->hardware.board_count,
-            .total_boards = app->yaml_config->hardware.board_count,
-            .loop_frequency_hz = 1000.0 / app->yaml_config->system.main_loop_interval_ms,
-            .send_frequency_hz = 1000.0 / app->yaml_config->system.data_send_interval_ms,
-            .uptime_seconds = (int)(time(NULL) - app->start_time),
-            .gps_connected = hardware_manager_is_gps_available(app->hardware_manager),
-            .influxdb_connected = true  // Assume connected for now
-        };
-        display_manager_update_status(app->display_manager, &status);
-        display_manager_refresh(app->display_manager);
-        
-        // usleep(app->yaml_config->system.main_loop_interval_ms * 1000);
+
+        // Apply a validated configuration change between sweeps
+        apply_pending_config_reload(app);
+
+        task_scheduler_run_due(app->task_scheduler);
+
+        // Idle until the next deadline (signals wake us up early)
+        task_scheduler_wait(app->task_scheduler);
     }
+
+    task_scheduler_print_stats(app->task_scheduler);
+    pipeline_print_stats(app->pipeline);
 }
 
 void app_manager_destroy(ApplicationManager* app) {
@@ -264,11 +426,43 @@ void app_manager_destroy(ApplicationManager* app) {
         display_manager_refresh(app->display_manager);
     }
     
+    // Stop background callbacks before tearing down what they use
+    event_loop_stop(app->event_loop);
+    config_watcher_destroy(app->config_watcher);
+    socket_server_destroy(app->socket_server);
+    event_loop_destroy(app->event_loop);
+    sweep_scheduler_destroy(app->sweep_scheduler);
+    task_scheduler_destroy(app->task_scheduler);
+    pipeline_destroy(app->pipeline); // Writes what the sinks still have queued
+    mqtt_publisher_destroy(app->mqtt_publisher);
+    acquisition_frame_store_destroy(app->frames);
+    // Send the partial rollup periods before the tier senders stop
+    data_publisher_flush_tiers(app->data_publisher, hardware_manager_get_channels(app->hardware_manager),
+                               hardware_manager_get_channel_count(app->hardware_manager));
+    save_pending_captures(app); // Captures the stopped event loop did not get to
     data_publisher_destroy(app->data_publisher);
+    // Keep the distributions sampled since the last periodic save (no path if init stopped early)
+    if (app->sketch_path[0] != '\0') {
+        channel_stats_save_sketches(hardware_manager_get_channel_stats(app->hardware_manager),
+                                    hardware_manager_get_channels(app->hardware_manager), app->sketch_path);
+    }
+    trigger_engine_destroy(app->trigger_engine);
+    alarm_engine_destroy(app->alarm_engine);
+    alarm_hook_destroy(app->alarm_hook);
     hardware_manager_cleanup(app->hardware_manager);
     sender_destroy(app->sender_ctx);
+    for (int t = 0; t < app->tier_sender_count; t++) {
+        sender_destroy(app->tier_senders[t]);
+    }
     csv_logger_close(&app->csv_logger);
+    battery_monitor_save_state(&app->battery_state); // Keep the charge counted since the last periodic save
+    battery_monitor_close(&app->battery_state);
+    energy_meter_save(app->energy_meter); // Keep the energy counted since the last periodic save
+    energy_meter_destroy(app->energy_meter);
+    trip_odometer_save(app->trip_odometer);
+    trip_odometer_destroy(app->trip_odometer);
     pthread_mutex_destroy(&app->cal_mutex);
+    pthread_mutex_destroy(&app->capture_lock);
     
     // Cleanup display manager last
     if (app->display_manager) {
@@ -285,11 +479,9 @@ void app_manager_destroy(ApplicationManager* app) {
     free(app);
 }
 
-void app_manager_signal_shutdown(ApplicationManager* app) {
+void app_manager_request_config_reload(ApplicationManager* app) {
     if (!app) return;
-    const char msg[] = "\nTermination signal received. Shutting down...\n";
-    write(STDOUT_FILENO, msg, sizeof(msg) - 1);
-    app->keep_running = false;
+    config_watcher_request_reload(app->config_watcher);
 }
 
 const char* app_manager_error_string(AppManagerError error) {
@@ -312,6 +504,8 @@ const char* app_manager_error_string(AppManagerError error) {
             return "Data publisher initialization failed";
         case APP_ERROR_MUTEX_INIT_FAILED:
             return "Mutex initialization failed";
+        case APP_ERROR_EVENT_LOOP_FAILED:
+            return "Event loop initialization failed";
         default:
             return "Unknown error";
     }
@@ -319,4 +513,502 @@ const char* app_manager_error_string(AppManagerError error) {
 
 // --- Private Helper Functions ---
 
+static void apply_pending_config_reload(ApplicationManager* app) {
+    YAMLAppConfig* new_config = NULL;
+    char message[512];
+
+    ConfigReloadStatus status = config_watcher_poll(app->config_watcher, &new_config, message, sizeof(message));
+    if (status == CONFIG_RELOAD_NONE) return;
+
+    if (status == CONFIG_RELOAD_REJECTED) {
+        display_manager_add_message(app->display_manager, MSG_ERROR, "%s", message);
+        return;
+    }
+
+    // Channels first: if the layout somehow disagrees nothing else is touched
+    if (!hardware_manager_apply_channel_settings(app->hardware_manager, new_config)) {
+        display_manager_add_message(app->display_manager, MSG_ERROR, "Config reload rejected: channel layout mismatch");
+        config_yaml_free(new_config);
+        return;
+    }
+
+    // Update the running configuration in place; other modules hold pointers into it
+    config_yaml_apply_reloadable(app->yaml_config, new_config);
+    config_yaml_free(new_config);
+
+    sender_update_influxdb_config(app->sender_ctx, &app->yaml_config->influxdb);
+    for (int t = 0; t < app->tier_sender_count; t++) {
+        sender_update_influxdb_config(app->tier_senders[t], &app->yaml_config->influxdb);
+    }
+    battery_monitor_apply_config(&app->battery_state, app->yaml_config);
+    trip_odometer_configure(app->trip_odometer, &app->yaml_config->trip);
+
+    // Periods may have changed; each task keeps its phase
+    task_scheduler_set_period(app->task_scheduler, app->sweep_task,
+                              app->yaml_config->system.main_loop_interval_ms / 1000.0);
+    task_scheduler_set_period(app->task_scheduler, app->publish_task,
+                              app->yaml_config->system.data_send_interval_ms / 1000.0);
+    if (app->soc_save_task >= 0) {
+        task_scheduler_set_period(app->task_scheduler, app->soc_save_task, soc_save_interval_s(app));
+    }
+    if (app->energy_save_task >= 0) {
+        task_scheduler_set_period(app->task_scheduler, app->energy_save_task, energy_save_interval_s(app));
+    }
+    task_scheduler_set_period(app->task_scheduler, app->sketch_task, sketch_interval_s(app));
+    pipeline_set_interval(app->pipeline, app->csv_sink, app->yaml_config->sinks.csv.interval_ms / 1000.0);
+    pipeline_set_interval(app->pipeline, app->display_sink, app->yaml_config->sinks.display.interval_ms / 1000.0);
+    pipeline_set_interval(app->pipeline, app->mqtt_sink, app->yaml_config->sinks.mqtt.interval_ms / 1000.0);
+
+    // Sample and publish intervals may have changed; rebuild the table
+    SweepScheduler* scheduler = create_sweep_scheduler(app);
+    if (scheduler) {
+        sweep_scheduler_destroy(app->sweep_scheduler);
+        app->sweep_scheduler = scheduler;
+    }
+
+    display_manager_add_message(app->display_manager, MSG_INFO, "%s", message);
+}
+
+static bool register_tasks(ApplicationManager* app) {
+    TaskScheduler* scheduler = app->task_scheduler;
+    double sweep_interval_s = app->yaml_config->system.main_loop_interval_ms / 1000.0;
+    double send_interval_s = app->yaml_config->system.data_send_interval_ms / 1000.0;
+
+    // Registration order is execution order for coinciding deadlines: sweep before its consumers.
+    // Publishing catches up after a stall so the long-term point rate matches the configuration.
+    app->sweep_task = task_scheduler_add(scheduler, "sweep", sweep_interval_s, TASK_POLICY_SKIP, run_sweep_task, app);
+    app->publish_task = task_scheduler_add(scheduler, "publish", send_interval_s, TASK_POLICY_CATCH_UP, run_publish_task, app);
+    TaskId display_task = task_scheduler_add(scheduler, "display", APP_DISPLAY_REFRESH_INTERVAL_S, TASK_POLICY_SKIP, run_display_task, app);
+    TaskId reprobe_task = task_scheduler_add(scheduler, "reprobe", APP_HARDWARE_REPROBE_INTERVAL_S, TASK_POLICY_SKIP, run_reprobe_task, app);
+
+    app->soc_save_task = -1;
+    if (app->battery_state.enabled) {
+        app->soc_save_task = task_scheduler_add(scheduler, "soc-save", soc_save_interval_s(app), TASK_POLICY_SKIP, run_soc_save_task, app);
+        if (app->soc_save_task < 0) return false;
+    }
+
+    app->energy_save_task = -1;
+    if (app->energy_meter || app->trip_odometer) {
+        app->energy_save_task = task_scheduler_add(scheduler, "energy-save", energy_save_interval_s(app), TASK_POLICY_SKIP, run_energy_save_task, app);
+        if (app->energy_save_task < 0) return false;
+    }
+
+    // Always registered: quantiles can be enabled by a reload
+    app->sketch_task = task_scheduler_add(scheduler, "sketch", sketch_interval_s(app), TASK_POLICY_SKIP, run_sketch_task, app);
+
+    return app->sweep_task >= 0 && app->publish_task >= 0 &&
+           app->sketch_task >= 0 && display_task >= 0 && reprobe_task >= 0;
+}
+
+static double soc_save_interval_s(const ApplicationManager* app) {
+    double interval = app->yaml_config->battery.soc_save_interval_s;
+    return interval > 0.0 ? interval : APP_DEFAULT_SOC_SAVE_INTERVAL_S;
+}
+
+static double energy_save_interval_s(const ApplicationManager* app) {
+    double interval = app->yaml_config->energy.save_interval_s;
+    return interval > 0.0 ? interval : APP_DEFAULT_ENERGY_SAVE_INTERVAL_S;
+}
+
+static double sketch_interval_s(const ApplicationManager* app) {
+    double interval = app->yaml_config->logging.sketch_interval_s;
+    return interval > 0.0 ? interval : APP_DEFAULT_SKETCH_INTERVAL_S;
+}
+
+static void init_sketch_path(ApplicationManager* app) {
+    const char* directory = app->yaml_config->logging.sketch_directory[0] ?
+                            app->yaml_config->logging.sketch_directory : APP_DEFAULT_SKETCH_DIRECTORY;
+    mkdir(directory, 0755);
+
+    // Format: <sketch_directory>/sketch_YYYY-MM-DD_HH-MM-SS.bin
+    struct tm* tm_info = localtime(&app->start_time);
+    snprintf(app->sketch_path, sizeof(app->sketch_path), "%s/sketch_", directory);
+    size_t length = strlen(app->sketch_path);
+    strftime(app->sketch_path + length, sizeof(app->sketch_path) - length, "%Y-%m-%d_%H-%M-%S.bin", tm_info);
+}
+
+static void run_sweep_task(void* user_data) {
+    ApplicationManager* app = (ApplicationManager*)user_data;
+
+    // Collect the channels due in this slot via HardwareManager
+    ChannelMask sample_mask = sweep_scheduler_next_sample_mask(app->sweep_scheduler);
+    bool measurements_ok = hardware_manager_collect_channels(app->hardware_manager, sample_mask);
+    time_t now = time(NULL);
+
+    if (!measurements_ok) {
+        if (now - app->last_hw_error_log_time >= 2) {
+            display_manager_add_message(app->display_manager, MSG_WARN,
+                                       "Falha de leitura em uma ou mais entradas ADS1115 (tentando novamente)");
+            app->last_hw_error_log_time = now;
+        }
+        app->hw_error_active = true;
+    } else if (app->hw_error_active) {
+        display_manager_add_message(app->display_manager, MSG_INFO,
+                                   "Leituras ADS1115 normalizadas");
+        app->hw_error_active = false;
+    }
+
+    hardware_manager_get_current_gps(app->hardware_manager, &app->gps_data);
+
+    // Coulomb counting on the samples just acquired
+    battery_monitor_update(&app->battery_state, hardware_manager_get_channels(app->hardware_manager));
+    update_battery_channels(app);
+    energy_meter_update(app->energy_meter, hardware_manager_get_channels(app->hardware_manager));
+    trip_odometer_update(app->trip_odometer, &app->gps_data, trip_energy_wh(app));
+
+    const Channel* channels = hardware_manager_get_channels(app->hardware_manager);
+    int channel_count = hardware_manager_get_channel_count(app->hardware_manager);
+    ChannelMask fresh_mask = hardware_manager_get_fresh_mask(app->hardware_manager);
+    double wall_time_s = wall_clock_seconds();
+
+    // Alarms first: they must not wait behind the rollups and the capture
+    int alarm_events = alarm_engine_process(app->alarm_engine, channels, fresh_mask, monotonic_seconds());
+    if (alarm_events > 0) dispatch_alarms(app, alarm_events);
+
+    publish_frame(app, fresh_mask, wall_time_s);
+
+    data_publisher_update_tiers(app->data_publisher, channels, channel_count, fresh_mask, wall_time_s);
+
+    if (trigger_engine_process(app->trigger_engine, channels, fresh_mask, wall_time_s)) {
+        queue_trigger_capture(app);
+    }
+}
+
+// Captures the sweep (battery channels included) once for every sink and hands it over
+static void publish_frame(ApplicationManager* app, ChannelMask fresh_mask, double wall_time_s) {
+    AcquisitionFrame* frame = acquisition_frame_begin(app->frames);
+    if (!frame) {
+        // Only if sinks hold on to every older frame; they keep the previous sweep
+        display_manager_add_message(app->display_manager, MSG_DEBUG, "No free acquisition frame; sweep not shared");
+        return;
+    }
+
+    acquisition_frame_capture(frame, hardware_manager_get_channels(app->hardware_manager),
+                              hardware_manager_get_channel_count(app->hardware_manager),
+                              fresh_mask, &app->gps_data, monotonic_seconds(), wall_time_s);
+    acquisition_frame_publish(app->frames, frame);
+    pipeline_submit(app->pipeline);
+}
+
+// Frames the sinks may hold besides the latest one and the direct readers
+static int frame_pool_size(const ApplicationManager* app) {
+    const SinksConfig* sinks = &app->yaml_config->sinks;
+    int queue_sizes[3];
+    int sink_count = 0;
+    if (sinks->csv.enabled) queue_sizes[sink_count++] = sinks->csv.queue_size;
+    if (sinks->display.enabled) queue_sizes[sink_count++] = sinks->display.queue_size;
+    if (sinks->mqtt.enabled && app->yaml_config->mqtt.enabled) queue_sizes[sink_count++] = sinks->mqtt.queue_size;
+    return pipeline_frames_needed(queue_sizes, sink_count);
+}
+
+static bool create_pipeline(ApplicationManager* app) {
+    const SinksConfig* sinks = &app->yaml_config->sinks;
+
+    app->pipeline = pipeline_create(app->frames);
+    if (!app->pipeline) return false;
+
+    app->csv_sink = -1;
+    if (sinks->csv.enabled && app->csv_logger.is_active) {
+        PipelineSink sink = csv_logger_sink(&app->csv_logger);
+        app->csv_sink = pipeline_add_sink(app->pipeline, &sink, sinks->csv.queue_size, sinks->csv.interval_ms / 1000.0);
+        if (app->csv_sink < 0) return false;
+    }
+
+    app->display_sink = -1;
+    if (sinks->display.enabled) {
+        PipelineSink sink = display_manager_sink(app->display_manager);
+        app->display_sink = pipeline_add_sink(app->pipeline, &sink, sinks->display.queue_size,
+                                              sinks->display.interval_ms / 1000.0);
+        if (app->display_sink < 0) return false;
+    }
+
+    app->mqtt_sink = -1;
+    if (sinks->mqtt.enabled && app->yaml_config->mqtt.enabled) {
+        char offline_queue_path[512];
+        snprintf(offline_queue_path, sizeof(offline_queue_path), "%s/offline_mqtt.txt",
+                 app->yaml_config->logging.csv_directory);
+        app->mqtt_publisher = mqtt_publisher_create(&app->yaml_config->mqtt, offline_queue_path);
+        if (!app->mqtt_publisher) {
+            display_manager_add_message(app->display_manager, MSG_WARN, "MQTT output unavailable");
+        } else {
+            PipelineSink sink = mqtt_publisher_sink(app->mqtt_publisher);
+            app->mqtt_sink = pipeline_add_sink(app->pipeline, &sink, sinks->mqtt.queue_size,
+                                               sinks->mqtt.interval_ms / 1000.0);
+            if (app->mqtt_sink < 0) return false;
+
+            // The sink only talks to the broker when frames flow; the timer keeps an idle link alive
+            int keepalive_ms = app->yaml_config->mqtt.keepalive_s * 1000 / 2;
+            if (keepalive_ms > 0) {
+                app->mqtt_keepalive_timer = event_loop_add_timer(app->event_loop, keepalive_ms, keepalive_ms,
+                                                                 handle_mqtt_keepalive_timer, app);
+            }
+        }
+    }
+
+    return pipeline_start(app->pipeline);
+}
+
+static void create_rollup_tiers(ApplicationManager* app) {
+    const InfluxDBConfig* influxdb = &app->yaml_config->influxdb;
+
+    for (int t = 0; t < influxdb->tier_count; t++) {
+        const RollupTierConfig* tier = &influxdb->tiers[t];
+        SenderContext* sender = sender_create_for_tier(app->yaml_config, tier);
+        if (!sender) {
+            display_manager_add_message(app->display_manager, MSG_WARN, "Rollup tier '%s' unavailable", tier->name);
+            continue;
+        }
+
+        app->tier_senders[app->tier_sender_count++] = sender;
+        if (!data_publisher_add_tier(app->data_publisher, tier, sender)) {
+            display_manager_add_message(app->display_manager, MSG_WARN, "Rollup tier '%s' unavailable", tier->name);
+        }
+    }
+}
+
+static void create_trigger_engine(ApplicationManager* app) {
+    const CaptureConfig* capture = &app->yaml_config->capture;
+
+    // Always created: triggers can be enabled by a reload
+    app->trigger_engine = trigger_engine_create(hardware_manager_get_channel_count(app->hardware_manager),
+                                                capture->pre_samples, capture->post_samples, capture->holdoff_s);
+    app->capture_event = event_loop_add_event(app->event_loop, handle_capture_event, app);
+    if (!app->trigger_engine || !app->capture_event) {
+        display_manager_add_message(app->display_manager, MSG_WARN, "Burst capture unavailable");
+        trigger_engine_destroy(app->trigger_engine);
+        app->trigger_engine = NULL;
+    }
+}
+
+// Runs in the sweep that completed the capture (the next sweep overwrites it): copies it out
+// and leaves the file and the upload to the event loop
+static void queue_trigger_capture(ApplicationManager* app) {
+    TriggerCapture* capture = trigger_engine_copy_capture(app->trigger_engine,
+                                                          hardware_manager_get_channels(app->hardware_manager));
+    if (!capture) {
+        display_manager_add_message(app->display_manager, MSG_WARN, "Burst capture dropped (out of memory)");
+        return;
+    }
+
+    PendingCapture pending = { .capture = capture, .upload = app->yaml_config->capture.upload };
+    snprintf(pending.directory, sizeof(pending.directory), "%s", app->yaml_config->capture.directory[0] ?
+             app->yaml_config->capture.directory : APP_DEFAULT_CAPTURE_DIRECTORY);
+
+    // Format: capture_YYYY-MM-DD_HH-MM-SS_<sequence>_<channel>.bin (time of the trigger)
+    time_t trigger_time = (time_t)capture->event.time_s;
+    struct tm tm_info;
+    localtime_r(&trigger_time, &tm_info);
+    size_t length = strftime(pending.file_name, sizeof(pending.file_name), "capture_%Y-%m-%d_%H-%M-%S_", &tm_info);
+    snprintf(pending.file_name + length, sizeof(pending.file_name) - length, "%03u_%s.bin",
+             app->capture_sequence++ % 1000, capture->channel_ids[capture->event.channel_index]);
+
+    pthread_mutex_lock(&app->capture_lock);
+    bool queued = app->pending_capture_count < APP_CAPTURE_QUEUE_SIZE;
+    if (queued) app->pending_captures[app->pending_capture_count++] = pending;
+    pthread_mutex_unlock(&app->capture_lock);
+
+    if (!queued) {
+        display_manager_add_message(app->display_manager, MSG_WARN, "Burst capture %s dropped (queue full)",
+                                    pending.file_name);
+        trigger_capture_free(capture);
+        return;
+    }
+    event_loop_signal(app->capture_event);
+}
+
+static void handle_capture_event(EventLoop* loop, void* user_data) {
+    save_pending_captures((ApplicationManager*)user_data);
+}
+
+// Writes and publishes the queued captures (event loop, or shutdown once the loop has stopped)
+static void save_pending_captures(ApplicationManager* app) {
+    PendingCapture pending[APP_CAPTURE_QUEUE_SIZE];
+
+    pthread_mutex_lock(&app->capture_lock);
+    int count = app->pending_capture_count;
+    memcpy(pending, app->pending_captures, (size_t)count * sizeof(PendingCapture));
+    app->pending_capture_count = 0;
+    pthread_mutex_unlock(&app->capture_lock);
+
+    for (int c = 0; c < count; c++) {
+        const TriggerCapture* capture = pending[c].capture;
+        const TriggerEvent* event = &capture->event;
+        mkdir(pending[c].directory, 0755);
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", pending[c].directory, pending[c].file_name);
+        if (!trigger_capture_write(capture, path)) {
+            display_manager_add_message(app->display_manager, MSG_WARN, "Failed to save burst capture %s",
+                                        pending[c].file_name);
+        }
+
+        data_publisher_publish_capture(app->data_publisher, capture, pending[c].file_name, pending[c].upload);
+        display_manager_add_message(app->display_manager, MSG_INFO, "Burst capture: %s %s (%d frames)",
+                                    capture->channel_ids[event->channel_index],
+                                    trigger_engine_condition_name(event->condition), event->frame_count);
+        trigger_capture_free(pending[c].capture);
+    }
+}
+
+static double wall_clock_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Sends the raises and clears of this sweep to InfluxDB (ahead of queued data), the display,
+// the local hook and the socket clients
+static void dispatch_alarms(ApplicationManager* app, int event_count) {
+    const Channel* channels = hardware_manager_get_channels(app->hardware_manager);
+
+    for (int e = 0; e < event_count; e++) {
+        const AlarmEvent* event = alarm_engine_get_event(app->alarm_engine, e);
+        const char* channel_id = channels[event->channel_index].id;
+        const char* state = event->raised ? "raised" : "cleared";
+        const char* severity = alarm_engine_severity_name(event->severity);
+
+        data_publisher_publish_alarm(app->data_publisher, event, channels);
+
+        MessageLevel type = MSG_INFO;
+        if (event->raised && event->severity == ALARM_SEVERITY_CRITICAL) type = MSG_ERROR;
+        if (event->raised && event->severity == ALARM_SEVERITY_WARNING) type = MSG_WARN;
+        display_manager_add_message(app->display_manager, type, "Alarm %s %s: %s = %.3f",
+                                    event->id, state, channel_id, event->value);
+
+        char value[32];
+        char json_line[256];
+        if (isfinite(event->value)) {
+            snprintf(value, sizeof(value), "%.6g", event->value);
+        } else {
+            snprintf(value, sizeof(value), "null");
+        }
+        snprintf(json_line, sizeof(json_line),
+                 "{\"alarm\":{\"rule\":\"%s\",\"state\":\"%s\",\"severity\":\"%s\",\"channel\":\"%s\",\"value\":%s}}\n",
+                 event->id, state, severity, channel_id, value);
+
+        const char* arguments[] = { event->id, state, severity, channel_id, value, NULL };
+        alarm_hook_notify(app->alarm_hook, arguments, json_line);
+        socket_server_post_alarm(app->socket_server, json_line);
+    }
+}
+
+static void add_battery_channels(ApplicationManager* app) {
+    const BatteryState* battery = &app->battery_state;
+
+    for (int p = 0; p < MAX_BATTERY_PACKS; p++) {
+        for (int v = 0; v < BATTERY_CHANNEL_COUNT; v++) {
+            app->battery_channel_index[p][v] = -1;
+            if (p >= battery->pack_count) continue;
+            if (v == BATTERY_CHANNEL_ENERGY && battery->voltage_index[p] < 0) continue; // No voltage, no energy
+
+            char id[MEASUREMENT_ID_SIZE];
+            snprintf(id, sizeof(id), "%s%s", battery->pack_id[p], battery_monitor_channel_suffix(v));
+            app->battery_channel_index[p][v] = hardware_manager_add_virtual_channel(app->hardware_manager, id,
+                                                                                   battery_monitor_channel_unit(v));
+        }
+    }
+
+    update_battery_channels(app);
+}
+
+static void update_battery_channels(ApplicationManager* app) {
+    for (int p = 0; p < app->battery_state.pack_count; p++) {
+        for (int v = 0; v < BATTERY_CHANNEL_COUNT; v++) {
+            if (app->battery_channel_index[p][v] < 0) continue;
+            hardware_manager_set_channel_calibrated_override(app->hardware_manager, app->battery_channel_index[p][v],
+                                                             battery_monitor_get_value(&app->battery_state, p, v));
+        }
+    }
+}
+
+static void run_publish_task(void* user_data) {
+    ApplicationManager* app = (ApplicationManager*)user_data;
+    ChannelMask publish_mask = sweep_scheduler_next_publish_mask(app->sweep_scheduler);
+    const AcquisitionFrame* frame = acquisition_frame_acquire(app->frames);
+    data_publisher_publish_frame(app->data_publisher, frame, publish_mask);
+    acquisition_frame_release(app->frames, frame);
+    if (app->energy_meter) data_publisher_publish_energy(app->data_publisher, app->energy_meter);
+    if (app->trip_odometer) data_publisher_publish_trip(app->data_publisher, app->trip_odometer);
+}
+
+static void run_display_task(void* user_data) {
+    ApplicationManager* app = (ApplicationManager*)user_data;
+
+    // System status only; the display sink draws the measurements
+    SystemStatus status = {
+        .active_boards = app->yaml_config->hardware.board_count,
+        .total_boards = app->yaml_config->hardware.board_count,
+        .loop_frequency_hz = 1000.0 / app->yaml_config->system.main_loop_interval_ms,
+        .send_frequency_hz = 1000.0 / app->yaml_config->system.data_send_interval_ms,
+        .uptime_seconds = (int)(time(NULL) - app->start_time),
+        .gps_connected = hardware_manager_is_gps_available(app->hardware_manager),
+        .influxdb_connected = true  // Assume connected for now
+    };
+    display_manager_update_status(app->display_manager, &status);
+    display_manager_refresh(app->display_manager);
+}
+
+static void run_soc_save_task(void* user_data) {
+    ApplicationManager* app = (ApplicationManager*)user_data;
+    battery_monitor_save_state(&app->battery_state);
+}
+
+static void run_energy_save_task(void* user_data) {
+    ApplicationManager* app = (ApplicationManager*)user_data;
+    energy_meter_save(app->energy_meter);
+    trip_odometer_save(app->trip_odometer);
+}
+
+// Net energy of the trip's meter (consumed minus regenerated), NAN without one
+static double trip_energy_wh(const ApplicationManager* app) {
+    EnergyTotals totals;
+    if (!energy_meter_get_totals(app->energy_meter, app->trip_meter_index, &totals)) return NAN;
+    return totals.wh_out - totals.wh_in;
+}
+
+static void run_sketch_task(void* user_data) {
+    ApplicationManager* app = (ApplicationManager*)user_data;
+    ChannelStatsTable* stats = hardware_manager_get_channel_stats(app->hardware_manager);
+    const Channel* channels = hardware_manager_get_channels(app->hardware_manager);
+
+    data_publisher_publish_sketches(app->data_publisher, channels);
+    if (!channel_stats_save_sketches(stats, channels, app->sketch_path)) {
+        display_manager_add_message(app->display_manager, MSG_WARN, "Failed to save quantile sketches");
+    }
+}
+
+static void handle_offline_replay_timer(EventLoop* loop, void* user_data) {
+    ApplicationManager* app = (ApplicationManager*)user_data;
+    sender_request_offline_replay(app->sender_ctx);
+    for (int t = 0; t < app->tier_sender_count; t++) {
+        sender_request_offline_replay(app->tier_senders[t]);
+    }
+    mqtt_publisher_request_replay(app->mqtt_publisher);
+}
+
+static void handle_mqtt_keepalive_timer(EventLoop* loop, void* user_data) {
+    mqtt_publisher_poll(((ApplicationManager*)user_data)->mqtt_publisher);
+}
+
+static void run_reprobe_task(void* user_data) {
+    ApplicationManager* app = (ApplicationManager*)user_data;
+    int recovered = hardware_manager_reprobe_boards(app->hardware_manager);
+    if (recovered > 0) {
+        display_manager_add_message(app->display_manager, MSG_INFO, "%d ADS1115 board(s) back online", recovered);
+    }
+}
+
+static SweepScheduler* create_sweep_scheduler(const ApplicationManager* app) {
+    return sweep_scheduler_create(hardware_manager_get_channels(app->hardware_manager),
+                                  hardware_manager_get_channel_count(app->hardware_manager),
+                                  app->yaml_config->system.main_loop_interval_ms,
+                                  app->yaml_config->system.data_send_interval_ms);
+}
+
 // print_measurements function removed - now using DisplayManager
\ No newline at end of file
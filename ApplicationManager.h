@@ -2,6 +2,7 @@
 #define APPLICATION_MANAGER_H
 
 #include <stdbool.h>
+#include <signal.h>
 #include "ConfigYAML.h"
 #include "DisplayManager.h"
 
@@ -18,7 +19,8 @@ typedef enum {
     APP_ERROR_CONFIG_LOAD_FAILED,
     APP_ERROR_SENDER_INIT_FAILED,
     APP_ERROR_PUBLISHER_INIT_FAILED,
-    APP_ERROR_MUTEX_INIT_FAILED
+    APP_ERROR_MUTEX_INIT_FAILED,
+    APP_ERROR_EVENT_LOOP_FAILED
 } AppManagerError;
 
 // Opaque pointer to the application manager
@@ -49,10 +51,15 @@ AppManagerError app_manager_init(ApplicationManager* app);
 /**
  * @brief Starts and runs the main application event loop.
  *
- * This function will block until the application is signaled to shut down.
+ * This function will block until *shutdown_requested becomes non-zero. Both flags are
+ * meant to be set by signal handlers, which then touch no application state; signals
+ * also cut the idle wait short, so a request is seen within one scheduler wait.
  * @param app A pointer to the ApplicationManager instance.
+ * @param shutdown_requested Set to leave the loop (SIGINT, SIGTERM).
+ * @param reload_requested Set to reload the configuration (SIGHUP); cleared once handled.
  */
-void app_manager_run(ApplicationManager* app);
+void app_manager_run(ApplicationManager* app, volatile sig_atomic_t* shutdown_requested,
+                     volatile sig_atomic_t* reload_requested);
 
 /**
  * @brief Cleans up and destroys the ApplicationManager and all its resources.
@@ -62,13 +69,13 @@ void app_manager_run(ApplicationManager* app);
 void app_manager_destroy(ApplicationManager* app);
 
 /**
- * @brief Handles termination signals (SIGINT, SIGTERM).
+ * @brief Requests a reload of the YAML configuration file (e.g. on SIGHUP).
  *
- * This function is designed to be called from a signal handler in main.c
- * to gracefully shut down the application.
+ * Called by app_manager_run when reload_requested is set. The file is re-read and validated on a background thread;
+ * compatible changes are applied between sweeps, structural changes are rejected.
  * @param app A pointer to the ApplicationManager instance.
  */
-void app_manager_signal_shutdown(ApplicationManager* app);
+void app_manager_request_config_reload(ApplicationManager* app);
 
 /**
  * @brief Converts an error code to a human-readable string.
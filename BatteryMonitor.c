@@ -4,132 +4,214 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "ansi_colors.h"
 
-#define SOC_STATE_FILE "logs/soc_state.dat"
-
-// --- Private function to load the SoC from a file ---
-static double load_soc_from_file() {
-    FILE* file = fopen(SOC_STATE_FILE, "r");
-    if (!file) {
-        // File doesn't exist, so create it with the default value of 100%
-        printf("SoC state file not found. Creating a new one with default 100%% SoC.\n");
-        file = fopen(SOC_STATE_FILE, "w");
-        if (file) {
-            fprintf(file, "100.0\n");
-            fclose(file);
-        } else {
-            // If we can't even create the file, there's a bigger problem (e.g., permissions)
-            perror("Could not create SoC state file");
+#define SOC_LEGACY_STATE_FILE "logs/soc_state.dat" // Text format used before the double-slot store
+
+// Record kept in each pack's state file
+typedef struct {
+    double soc_percent;
+    double ah_in;
+    double ah_out;
+    double energy_Wh;
+} PersistedPackState;
+
+static const char* const channel_suffixes[BATTERY_CHANNEL_COUNT] = { "_soc", "_ah_in", "_ah_out", "_energy_wh" };
+static const char* const channel_units[BATTERY_CHANNEL_COUNT] = { "%", "Ah", "Ah", "Wh" };
+
+static double clamp_soc(double soc) {
+    if (soc < 0.0) return 0.0;
+    if (soc > 100.0) return 100.0;
+    return soc;
+}
+
+static int find_channel_index(const Channel* channels, const char* id) {
+    if (!id || id[0] == '\0') return -1;
+    for (int i = 0; i < NUM_CHANNELS; i++) {
+        if (strcmp(channels[i].id, id) == 0) {
+            return i;
         }
-        return 100.0; // Return the default value
     }
+    return -1;
+}
 
-    // If the file exists, read from it
-    double soc = 100.0;
-    if (fscanf(file, "%lf", &soc) != 1) {
-        soc = 100.0; // Default if file is corrupt or empty
-    }
+// --- Private function to read the SoC from the old text file (migration) ---
+static bool load_legacy_soc(double* soc) {
+    FILE* file = fopen(SOC_LEGACY_STATE_FILE, "r");
+    if (!file) return false;
+
+    bool ok = fscanf(file, "%lf", soc) == 1 && isfinite(*soc);
     fclose(file);
+    return ok;
+}
 
-    // Clamp the loaded value just in case
-    if (soc < 0.0) soc = 0.0;
-    if (soc > 100.0) soc = 100.0;
+// --- Private function to save one pack ---
+static void save_pack(const BatteryState* state, int p) {
+    if (!state->store[p]) return;
 
-    return soc;
+    PersistedPackState persisted = {
+        .soc_percent = state->soc_percent[p],
+        .ah_in = state->ah_in[p],
+        .ah_out = state->ah_out[p],
+        .energy_Wh = state->energy_Wh[p]
+    };
+    if (!state_store_save(state->store[p], &persisted)) {
+        fprintf(stderr, "Failed to save SoC state of battery '%s'\n", state->pack_id[p]);
+    }
+}
+
+// --- Private function to open a pack's state file and restore its counters from it ---
+static void load_pack_state(BatteryState* state, int p, const char* state_file) {
+    state->soc_percent[p] = 100.0;
+    state->ah_in[p] = 0.0;
+    state->ah_out[p] = 0.0;
+    state->energy_Wh[p] = 0.0;
+
+    state->store[p] = state_store_open(state_file, sizeof(PersistedPackState));
+    if (!state->store[p]) {
+        fprintf(stderr, ANSI_COLOR_YELLOW "Warning: SoC of battery '%s' will not be persisted; starting at 100%%\n" ANSI_COLOR_RESET,
+                state->pack_id[p]);
+        return;
+    }
+
+    PersistedPackState persisted;
+    if (state_store_load(state->store[p], &persisted) && isfinite(persisted.soc_percent)) {
+        state->soc_percent[p] = clamp_soc(persisted.soc_percent);
+        if (isfinite(persisted.ah_in) && persisted.ah_in >= 0.0) state->ah_in[p] = persisted.ah_in;
+        if (isfinite(persisted.ah_out) && persisted.ah_out >= 0.0) state->ah_out[p] = persisted.ah_out;
+        if (isfinite(persisted.energy_Wh)) state->energy_Wh[p] = persisted.energy_Wh;
+        return;
+    }
+
+    // The first pack inherits the SoC of the old single-battery text file
+    double legacy_soc;
+    if (p == 0 && load_legacy_soc(&legacy_soc)) {
+        printf("Migrating SoC from %s\n", SOC_LEGACY_STATE_FILE);
+        state->soc_percent[p] = clamp_soc(legacy_soc);
+    } else {
+        printf("SoC state file for battery '%s' not found. Starting with default 100%% SoC.\n", state->pack_id[p]);
+    }
+    save_pack(state, p);
+}
+
+// --- Private function to set up one pack; returns false if its channels are missing ---
+static bool init_pack(BatteryState* state, const Channel* channels, const BatteryPackConfig* config) {
+    int p = state->pack_count;
+
+    state->current_index[p] = find_channel_index(channels, config->current_channel_id);
+    if (state->current_index[p] < 0) {
+        fprintf(stderr, ANSI_COLOR_RED "Error: Battery current ID '%s' not found in configuration.\n" ANSI_COLOR_RESET,
+                config->current_channel_id);
+        return false;
+    }
+
+    state->voltage_index[p] = find_channel_index(channels, config->voltage_channel_id);
+    if (config->voltage_channel_id[0] != '\0' && state->voltage_index[p] < 0) {
+        fprintf(stderr, ANSI_COLOR_RED "Error: Battery voltage ID '%s' not found in configuration.\n" ANSI_COLOR_RESET,
+                config->voltage_channel_id);
+        return false;
+    }
+
+    snprintf(state->pack_id[p], sizeof(state->pack_id[p]), "%s", config->id);
+    state->capacity_Ah[p] = config->capacity_ah;
+    state->has_last_sample[p] = false;
+    state->last_power_W[p] = NAN;
+    load_pack_state(state, p, config->state_file);
+    state->pack_count++;
+
+    printf("Coulomb counting is " ANSI_COLOR_GREEN "ENABLED" ANSI_COLOR_RESET " for '%s' ('%s') with capacity %.2f Ah. Initial SoC: %.2f%%\n",
+           config->id, config->current_channel_id, config->capacity_ah, state->soc_percent[p]);
+    return true;
 }
+
 bool battery_monitor_init(BatteryState* state, const Channel* channels) {
+    memset(state, 0, sizeof(*state));
+
     const char* enable_env = getenv("COULOMB_COUNTING_ENABLE");
     if (!enable_env || (strcmp(enable_env, "1") != 0 && strcmp(enable_env, "true") != 0)) {
-        state->enabled = false;
         printf("Coulomb counting is " ANSI_COLOR_YELLOW "DISABLED" ANSI_COLOR_RESET ". Set COULOMB_COUNTING_ENABLE=1 to enable.\n");
         return false;
     }
-    
+
     const char* capacity_str = getenv("BATTERY_CAPACITY_AH");
     const char* current_id_str = getenv("BATTERY_CURRENT_ID");
 
     if (!capacity_str || !current_id_str) {
         fprintf(stderr, ANSI_COLOR_RED "Error: BATTERY_CAPACITY_AH and BATTERY_CURRENT_ID must be set for Coulomb counting.\n" ANSI_COLOR_RESET);
-        state->enabled = false;
         return false;
     }
 
-    state->enabled = true;
-    state->capacity_Ah = atof(capacity_str);
-    state->state_of_charge_percent = load_soc_from_file(); // Load persistent SoC
-    state->current_measurement_index = -1;
-
-    for (int i = 0; i < NUM_CHANNELS; i++) {
-        if (strcmp(channels[i].id, current_id_str) == 0) {
-            state->current_measurement_index = i;
-            break;
-        }
-    }
-
-    if (state->current_measurement_index == -1) {
-        fprintf(stderr, ANSI_COLOR_RED "Error: Battery current ID '%s' not found in configuration.\n" ANSI_COLOR_RESET, current_id_str);
-        state->enabled = false;
-        return false;
-    }
+    BatteryPackConfig pack = {0};
+    snprintf(pack.id, sizeof(pack.id), "%s", BATTERY_LEGACY_PACK_ID);
+    pack.capacity_ah = atof(capacity_str);
+    snprintf(pack.current_channel_id, sizeof(pack.current_channel_id), "%s", current_id_str);
+    snprintf(pack.state_file, sizeof(pack.state_file), "%s", BATTERY_LEGACY_STATE_FILE);
 
-    clock_gettime(CLOCK_MONOTONIC, &state->last_update_time);
-    clock_gettime(CLOCK_MONOTONIC, &state->last_save_time); // Initialize save timer
-    printf("Coulomb counting is " ANSI_COLOR_GREEN "ENABLED" ANSI_COLOR_RESET " for '%s' with capacity %.2f Ah. Initial SoC: %.2f%%\n", 
-           current_id_str, state->capacity_Ah, state->state_of_charge_percent);
-    return true;
+    state->enabled = init_pack(state, channels, &pack);
+    return state->enabled;
 }
 
 bool battery_monitor_init_from_yaml(BatteryState* state, const Channel* channels, const YAMLAppConfig* config) {
+    memset(state, 0, sizeof(*state));
+
     if (!config) {
         fprintf(stderr, "NULL YAML configuration provided to battery_monitor_init_from_yaml\n");
-        state->enabled = false;
         return false;
     }
-    
-    if (!config->battery.coulomb_counting_enabled) {
-        state->enabled = false;
+
+    if (config->battery.pack_count == 0) {
         printf("Coulomb counting is " ANSI_COLOR_YELLOW "DISABLED" ANSI_COLOR_RESET " in YAML configuration.\n");
         return false;
     }
-    
-    if (config->battery.capacity_ah <= 0.0) {
-        fprintf(stderr, ANSI_COLOR_RED "Error: Invalid battery capacity in YAML configuration: %.2f\n" ANSI_COLOR_RESET, 
-                config->battery.capacity_ah);
-        state->enabled = false;
-        return false;
-    }
-    
-    if (strlen(config->battery.current_channel_id) == 0) {
-        fprintf(stderr, ANSI_COLOR_RED "Error: Battery current channel ID not specified in YAML configuration.\n" ANSI_COLOR_RESET);
-        state->enabled = false;
-        return false;
+
+    for (int p = 0; p < config->battery.pack_count && p < MAX_BATTERY_PACKS; p++) {
+        const BatteryPackConfig* pack = &config->battery.packs[p];
+
+        if (pack->capacity_ah <= 0.0) {
+            fprintf(stderr, ANSI_COLOR_RED "Error: Invalid capacity for battery '%s' in YAML configuration: %.2f\n" ANSI_COLOR_RESET,
+                    pack->id, pack->capacity_ah);
+            battery_monitor_close(state);
+            return false;
+        }
+
+        if (!init_pack(state, channels, pack)) {
+            battery_monitor_close(state);
+            return false;
+        }
     }
 
     state->enabled = true;
-    state->capacity_Ah = config->battery.capacity_ah;
-    state->state_of_charge_percent = load_soc_from_file(); // Load persistent SoC
-    state->current_measurement_index = -1;
+    return true;
+}
 
-    for (int i = 0; i < NUM_CHANNELS; i++) {
-        if (strcmp(channels[i].id, config->battery.current_channel_id) == 0) {
-            state->current_measurement_index = i;
-            break;
-        }
+void battery_monitor_apply_config(BatteryState* state, const YAMLAppConfig* config) {
+    if (!state->enabled || !config) {
+        return;
     }
 
-    if (state->current_measurement_index == -1) {
-        fprintf(stderr, ANSI_COLOR_RED "Error: Battery current ID '%s' not found in configuration.\n" ANSI_COLOR_RESET, 
-                config->battery.current_channel_id);
-        state->enabled = false;
-        return false;
+    for (int p = 0; p < state->pack_count && p < config->battery.pack_count; p++) {
+        state->capacity_Ah[p] = config->battery.packs[p].capacity_ah;
     }
+}
 
-    clock_gettime(CLOCK_MONOTONIC, &state->last_update_time);
-    clock_gettime(CLOCK_MONOTONIC, &state->last_save_time); // Initialize save timer
-    printf("Coulomb counting is " ANSI_COLOR_GREEN "ENABLED" ANSI_COLOR_RESET " for '%s' with capacity %.2f Ah. Initial SoC: %.2f%%\n", 
-           config->battery.current_channel_id, state->capacity_Ah, state->state_of_charge_percent);
-    return true;
+// Splits one trapezoid of current into the charge that left the pack (positive
+// current) and the charge that entered it. When the current changes sign inside
+// the interval, the two triangles on either side of the zero crossing are separated.
+static void split_charge_Ah(double i0_A, double i1_A, double dt_s, double* out_Ah, double* in_Ah) {
+    if (i0_A >= 0.0 && i1_A >= 0.0) {
+        *out_Ah = 0.5 * (i0_A + i1_A) * dt_s / 3600.0;
+        *in_Ah = 0.0;
+    } else if (i0_A <= 0.0 && i1_A <= 0.0) {
+        *out_Ah = 0.0;
+        *in_Ah = -0.5 * (i0_A + i1_A) * dt_s / 3600.0;
+    } else {
+        double t_zero_s = dt_s * fabs(i0_A) / (fabs(i0_A) + fabs(i1_A));
+        double first_Ah = 0.5 * i0_A * t_zero_s / 3600.0;
+        double second_Ah = 0.5 * i1_A * (dt_s - t_zero_s) / 3600.0;
+        *out_Ah = first_Ah > 0.0 ? first_Ah : second_Ah;
+        *in_Ah = first_Ah > 0.0 ? -second_Ah : -first_Ah;
+    }
 }
 
 void battery_monitor_update(BatteryState* state, const Channel* channels) {
@@ -137,47 +219,108 @@ void battery_monitor_update(BatteryState* state, const Channel* channels) {
         return;
     }
 
-    struct timespec current_time;
-    clock_gettime(CLOCK_MONOTONIC, &current_time);
+    const int count = state->pack_count;
+    bool fresh[MAX_BATTERY_PACKS];
+    double time_s[MAX_BATTERY_PACKS];
+    double current_A[MAX_BATTERY_PACKS];
+    double power_W[MAX_BATTERY_PACKS];
 
-    double time_diff_s = (current_time.tv_sec - state->last_update_time.tv_sec)
-                       + (current_time.tv_nsec - state->last_update_time.tv_nsec) / 1e9;
+    // Gather the newest sample of every pack
+    for (int p = 0; p < count; p++) {
+        const Channel* current_channel = &channels[state->current_index[p]];
+        fresh[p] = !state->has_last_sample[p] || current_channel->sample_time_s != state->last_sample_time_s[p];
+        if (!fresh[p]) continue; // The current channel was not sampled in this sweep
 
-    double current_A = channel_get_calibrated_value(&channels[state->current_measurement_index]);
-    double charge_moved_Ah = (current_A * time_diff_s) / 3600.0;
-    double soc_change_percent = (charge_moved_Ah / state->capacity_Ah) * 100.0;
+        if (!channel_is_sample_quality_ok(current_channel) || current_channel->sample_time_s <= 0.0) {
+            // Do not integrate a bad current sample; hold the SoC across the gap
+            state->has_last_sample[p] = false;
+            fresh[p] = false;
+            continue;
+        }
 
-    state->state_of_charge_percent -= soc_change_percent;
+        // Integrate the unfiltered sample so short transients are not smoothed away
+        time_s[p] = current_channel->sample_time_s;
+        current_A[p] = channel_get_sample_value(current_channel);
 
-    if (state->state_of_charge_percent > 100.0) {
-        state->state_of_charge_percent = 100.0;
-    } else if (state->state_of_charge_percent < 0.0) {
-        state->state_of_charge_percent = 0.0;
+        power_W[p] = NAN;
+        if (state->voltage_index[p] >= 0) {
+            const Channel* voltage_channel = &channels[state->voltage_index[p]];
+            if (channel_is_sample_quality_ok(voltage_channel)) {
+                power_W[p] = channel_get_sample_value(voltage_channel) * current_A[p];
+            }
+        }
     }
 
-    state->last_update_time = current_time;
+    // Integrate all packs in one pass
+    for (int p = 0; p < count; p++) {
+        if (!fresh[p]) continue;
 
-    // Check if one second has passed since the last save
-    double save_time_diff_s = (current_time.tv_sec - state->last_save_time.tv_sec)
-                            + (current_time.tv_nsec - state->last_save_time.tv_nsec) / 1e9;
+        double dt_s = time_s[p] - state->last_sample_time_s[p];
+        if (state->has_last_sample[p] && dt_s > 0.0 && dt_s <= BATTERY_MAX_INTEGRATION_GAP_S) {
+            double out_Ah, in_Ah;
+            split_charge_Ah(state->last_current_A[p], current_A[p], dt_s, &out_Ah, &in_Ah);
+
+            state->ah_out[p] += out_Ah;
+            state->ah_in[p] += in_Ah;
+            state->soc_percent[p] = clamp_soc(state->soc_percent[p] - (out_Ah - in_Ah) / state->capacity_Ah[p] * 100.0);
+
+            // NaN power (no or bad voltage) at either end skips the energy of this interval
+            double energy_Wh = 0.5 * (state->last_power_W[p] + power_W[p]) * dt_s / 3600.0;
+            if (isfinite(energy_Wh)) {
+                state->energy_Wh[p] += energy_Wh;
+            }
+        }
+
+        state->has_last_sample[p] = true;
+        state->last_sample_time_s[p] = time_s[p];
+        state->last_current_A[p] = current_A[p];
+        state->last_power_W[p] = power_W[p];
+    }
+}
+
+double battery_monitor_get_value(const BatteryState* state, int pack, BatteryChannel value) {
+    if (!state || pack < 0 || pack >= state->pack_count) {
+        return NAN;
+    }
 
-    if (save_time_diff_s >= 1.0) {
-        battery_monitor_save_state(state);
-        state->last_save_time = current_time;
+    switch (value) {
+        case BATTERY_CHANNEL_SOC:
+            return state->soc_percent[pack];
+        case BATTERY_CHANNEL_AH_IN:
+            return state->ah_in[pack];
+        case BATTERY_CHANNEL_AH_OUT:
+            return state->ah_out[pack];
+        case BATTERY_CHANNEL_ENERGY:
+            return state->voltage_index[pack] >= 0 ? state->energy_Wh[pack] : NAN;
+        default:
+            return NAN;
     }
 }
 
+const char* battery_monitor_channel_suffix(BatteryChannel value) {
+    return (value >= 0 && value < BATTERY_CHANNEL_COUNT) ? channel_suffixes[value] : "";
+}
+
+const char* battery_monitor_channel_unit(BatteryChannel value) {
+    return (value >= 0 && value < BATTERY_CHANNEL_COUNT) ? channel_units[value] : "";
+}
+
 void battery_monitor_save_state(const BatteryState* state) {
     if (!state->enabled) {
         return;
     }
-    FILE* file = fopen(SOC_STATE_FILE, "w");
-    if (file) {
-        fprintf(file, "%.4f\n", state->state_of_charge_percent);
-        fclose(file);
-        printf("Saved SoC: %.2f%%\n", state->state_of_charge_percent);
-    } else {
-        perror("Failed to save SoC state file");
+
+    for (int p = 0; p < state->pack_count; p++) {
+        save_pack(state, p);
+    }
+}
+
+void battery_monitor_close(BatteryState* state) {
+    if (!state) return;
+
+    for (int p = 0; p < MAX_BATTERY_PACKS; p++) {
+        state_store_close(state->store[p]);
+        state->store[p] = NULL;
     }
 }
 
@@ -186,6 +329,8 @@ void battery_monitor_reset_soc(BatteryState* state) {
         return;
     }
     printf("Resetting SoC to 100%%.\n");
-    state->state_of_charge_percent = 100.0;
+    for (int p = 0; p < state->pack_count; p++) {
+        state->soc_percent[p] = 100.0;
+    }
     battery_monitor_save_state(state); // Persist the reset immediately
 }
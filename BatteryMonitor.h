@@ -5,32 +5,78 @@
 #include <time.h>
 #include "Channel.h"
 #include "ConfigYAML.h"
+#include "StateStore.h"
 
-// Structure to hold the state of the battery
+// Samples further apart than this are not bridged by the integrator (read failures, stalls)
+#define BATTERY_MAX_INTEGRATION_GAP_S 5.0
+
+// Values each pack publishes as a virtual channel "<pack id><suffix>"
+typedef enum {
+    BATTERY_CHANNEL_SOC = 0,   // State of charge (%)
+    BATTERY_CHANNEL_AH_IN,     // Charge put into the pack (Ah)
+    BATTERY_CHANNEL_AH_OUT,    // Charge taken out of the pack (Ah)
+    BATTERY_CHANNEL_ENERGY,    // Net energy delivered (Wh); needs a voltage channel
+    BATTERY_CHANNEL_COUNT
+} BatteryChannel;
+
+// State of all monitored packs, stored per field (struct-of-arrays) so one
+// update pass integrates every pack. Index p is the pack's position in the
+// `batteries:` list.
 typedef struct {
-    bool enabled;
-    double state_of_charge_percent; // SoC from 0.0 to 100.0
-    double capacity_Ah;             // Total capacity in Ampere-hours
-    int current_measurement_index;  // Which measurement index corresponds to battery current
-    struct timespec last_update_time; // Last time the state was updated
-    struct timespec last_save_time;   // Time of the last persistent save
+    bool enabled;                   // At least one pack is monitored
+    int pack_count;
+
+    // Configuration
+    char pack_id[MAX_BATTERY_PACKS][BATTERY_PACK_ID_SIZE];
+    int current_index[MAX_BATTERY_PACKS];   // Channel index of the pack current
+    int voltage_index[MAX_BATTERY_PACKS];   // Channel index of the pack voltage (-1 = none, no energy)
+    double capacity_Ah[MAX_BATTERY_PACKS];
+
+    // Results
+    double soc_percent[MAX_BATTERY_PACKS];  // SoC from 0.0 to 100.0
+    double ah_in[MAX_BATTERY_PACKS];
+    double ah_out[MAX_BATTERY_PACKS];
+    double energy_Wh[MAX_BATTERY_PACKS];
+
+    // Trapezoidal integration state: the previous sample of each pack
+    bool has_last_sample[MAX_BATTERY_PACKS];
+    double last_sample_time_s[MAX_BATTERY_PACKS];  // Acquisition timestamp (Channel.sample_time_s)
+    double last_current_A[MAX_BATTERY_PACKS];
+    double last_power_W[MAX_BATTERY_PACKS];        // NaN when the voltage was unusable
+
+    StateStore* store[MAX_BATTERY_PACKS];          // Crash-safe SoC files (NULL if unavailable)
 } BatteryState;
 
-// Initializes the battery monitor using environment variables. Returns true if enabled.
+// Initializes a single pack using environment variables. Returns true if enabled.
 bool battery_monitor_init(BatteryState* state, const Channel* channels);
 
-// Initializes the battery monitor using YAML configuration. Returns true if enabled.
+// Initializes every pack of the YAML `batteries:` list (or the single `battery:` section).
+// Returns true if at least one pack is monitored.
 bool battery_monitor_init_from_yaml(BatteryState* state, const Channel* channels, const YAMLAppConfig* config);
 
-// Updates the State of Charge based on the current measurement and time delta.
+// Applies runtime-reloadable settings (pack capacities) from a reloaded configuration.
+void battery_monitor_apply_config(BatteryState* state, const YAMLAppConfig* config);
+
+// Integrates each pack's newest current sample, if it has one since the last call.
+// Call after every acquisition sweep. Uses trapezoids between consecutive sample
+// timestamps, so the result does not depend on how regularly it is called.
 void battery_monitor_update(BatteryState* state, const Channel* channels);
 
-// Saves the current SoC to a file for persistence.
+// Returns a pack's published value, or NAN for an invalid pack or a missing voltage channel.
+double battery_monitor_get_value(const BatteryState* state, int pack, BatteryChannel value);
+
+// Channel id suffix and unit for a published value (e.g. "_soc", "%").
+const char* battery_monitor_channel_suffix(BatteryChannel value);
+const char* battery_monitor_channel_unit(BatteryChannel value);
+
+// Persists every pack to its double-slot state file and syncs it to disk.
+// Called periodically by the application scheduler (battery.soc_save_interval_s).
 void battery_monitor_save_state(const BatteryState* state);
 
-// Resets the SoC to 100% and saves it.
+// Closes the state files. Save first if the latest values should survive.
+void battery_monitor_close(BatteryState* state);
+
+// Resets every pack's SoC to 100% and saves it.
 void battery_monitor_reset_soc(BatteryState* state);
 
 #endif // BATTERY_MONITOR_H
-
-
@@ -6,7 +6,6 @@ It will take 3 measurements to perform a linear regression and calculate the slo
 #include "CalibrationHelper.h"
 #include <stdio.h>
 #include <string.h>
-#include <sys/select.h> // For select()
 #include <unistd.h>     // For STDIN_FILENO
 #include "ansi_colors.h"
 
@@ -115,52 +114,66 @@ int calibrateSensor(int index, int adc_reading, double *slope, double *offset) {
     return 1; // Indicate success
 }
 
-// This function runs in a separate thread, listening for user commands to start calibration.
-void *calibrationListener(void *arg_ptr) {
-    CalibrationThreadArgs* args = (CalibrationThreadArgs*) arg_ptr;
-    char command[16];
+void calibration_handle_command(const char* command, CalibrationThreadArgs* args) {
     int local_sensor_index;
 
-    printf(ANSI_COLOR_YELLOW "Input listener started. Type CAL<0-3> to calibrate or SOC_RESET to reset SoC.\n" ANSI_COLOR_RESET);
+    // Check for SoC reset command
+    if (strncmp(command, "SOC_RESET", 9) == 0) {
+        *(args->reset_soc_flag_ptr) = true;
+        printf("SoC reset requested. The main loop will handle it.\n");
+    } 
+    // Check for calibration command
+    else if (sscanf(command, "CAL%d", &local_sensor_index) == 1) {
+        if (local_sensor_index >= 0 && local_sensor_index < NUM_CHANNELS) {
+            pthread_mutex_lock(args->mutex);
+            *(args->sensor_index_ptr) = local_sensor_index;
+            pthread_mutex_unlock(args->mutex);
+            printf("Calibration requested for sensor A%d. The main loop will handle it.\n", local_sensor_index);
+        } else {
+            fprintf(stderr, "Invalid sensor index. Please use 0-%d.\n", NUM_CHANNELS - 1);
+        }
+    }
+}
+
+// Called by the event loop whenever stdin has data; assembles lines and dispatches commands.
+static void handle_stdin_ready(EventLoop* loop, int fd, uint32_t events, void* user_data) {
+    static char line[64];
+    static size_t line_length = 0;
+    CalibrationThreadArgs* args = (CalibrationThreadArgs*)user_data;
+
+    char buffer[64];
+    ssize_t count = read(fd, buffer, sizeof(buffer));
+    if (count <= 0) {
+        if (count == 0 || (events & EPOLLHUP)) {
+            // stdin closed: stop listening instead of spinning on EOF
+            printf("Input listener shutting down.\n");
+            event_loop_remove(loop, args->stdin_source);
+            args->stdin_source = NULL;
+        }
+        return;
+    }
 
-    // Loop until the main thread signals for shutdown.
-    while (*(args->keep_running_ptr)) {
-        fd_set fds;
-        struct timeval tv;
-        int retval;
-
-        // Set up the file descriptor set.
-        FD_ZERO(&fds);
-        FD_SET(STDIN_FILENO, &fds);
-
-        // Set up the timeout. This makes select() non-blocking.
-        tv.tv_sec = 0;
-        tv.tv_usec = 500000;
-
-        // Wait for input on stdin or until the timeout expires.
-        retval = select(STDIN_FILENO + 1, &fds, NULL, NULL, &tv);
-
-        if (retval > 0 && FD_ISSET(STDIN_FILENO, &fds)) {
-            if (fgets(command, sizeof(command), stdin) != NULL) {
-                // Check for SoC reset command
-                if (strncmp(command, "SOC_RESET", 9) == 0) {
-                    *(args->reset_soc_flag_ptr) = true;
-                    printf("SoC reset requested. The main loop will handle it.\n");
-                } 
-                // Check for calibration command
-                else if (sscanf(command, "CAL%d", &local_sensor_index) == 1) {
-                    if (local_sensor_index >= 0 && local_sensor_index < NUM_CHANNELS) {
-                        pthread_mutex_lock(args->mutex);
-                        *(args->sensor_index_ptr) = local_sensor_index;
-                        pthread_mutex_unlock(args->mutex);
-                        printf("Calibration requested for sensor A%d. The main loop will handle it.\n", local_sensor_index);
-                    } else {
-                        fprintf(stderr, "Invalid sensor index. Please use 0-%d.\n", NUM_CHANNELS - 1);
-                    }
-                }
-            }
+    for (ssize_t i = 0; i < count; i++) {
+        if (buffer[i] == '\n') {
+            line[line_length] = '\0';
+            calibration_handle_command(line, args);
+            line_length = 0;
+        } else if (line_length < sizeof(line) - 1) {
+            line[line_length++] = buffer[i];
         }
     }
-    printf("Input listener shutting down.\n");
-    return NULL;
+}
+
+bool calibration_listener_attach(EventLoop* loop, CalibrationThreadArgs* args) {
+    if (!loop || !args) return false;
+
+    args->stdin_source = event_loop_add_fd(loop, STDIN_FILENO, EPOLLIN, handle_stdin_ready, args);
+    if (!args->stdin_source) {
+        // e.g. stdin redirected from a regular file, which epoll cannot watch
+        fprintf(stderr, "Input listener unavailable: stdin cannot be watched.\n");
+        return false;
+    }
+
+    printf(ANSI_COLOR_YELLOW "Input listener started. Type CAL<0-3> to calibrate or SOC_RESET to reset SoC.\n" ANSI_COLOR_RESET);
+    return true;
 }
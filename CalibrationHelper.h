@@ -7,22 +7,27 @@
 #include "pthread.h"
 #include "signal.h"
 #include "stdbool.h" // For bool type
+#include "EventLoop.h"
 
 // The number of ADC channels available for measurement and calibration.
 #define NUM_CHANNELS 4
 
-// Arguments for the calibration listener thread
+// Arguments for the calibration listener
 typedef struct {
     int* sensor_index_ptr;
     pthread_mutex_t* mutex;
     volatile sig_atomic_t* keep_running_ptr;
     volatile bool* reset_soc_flag_ptr; // Flag to signal an SoC reset
+    EventSource* stdin_source;         // Set by calibration_listener_attach
 } CalibrationThreadArgs;
 
 
 int calibrateSensor(int index, int adc_reading, double *slope, double *offset);
 
-// Listens for calibration commands from the user (e.g., "CAL0")
-void *calibrationListener(void *args);
+// Handles one command line from the user ("CAL<n>" or "SOC_RESET")
+void calibration_handle_command(const char* command, CalibrationThreadArgs* args);
+
+// Listens for calibration commands on stdin from the event loop (no polling thread)
+bool calibration_listener_attach(EventLoop* loop, CalibrationThreadArgs* args);
 
 #endif
\ No newline at end of file
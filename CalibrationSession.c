@@ -0,0 +1,223 @@
+#include "CalibrationSession.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+
+#define MAD_TO_SIGMA 1.4826       // Scales a median absolute deviation to a Gaussian sigma
+#define OUTLIER_THRESHOLD 3.0     // Robust sigmas from the median before a sample is dropped
+#define MIN_SIGMA_COUNTS 1.0      // ADC readings are quantized; never reject within one count
+
+struct CalibrationSession {
+    pthread_mutex_t lock;
+    CalibrationSessionStatus status;
+
+    // Samples of the point being captured, and scratch space for their deviations
+    double samples[CALIBRATION_SESSION_MAX_SAMPLES];
+    double deviations[CALIBRATION_SESSION_MAX_SAMPLES];
+    double reference;
+
+    // Running fit of reference value against raw reading
+    double mean_x, mean_y;
+    double m2_x, m2_y, c_xy;
+};
+
+// --- Private Function Prototypes ---
+static void finish_point(CalibrationSession* session);
+static void update_fit(CalibrationSession* session, double x, double y);
+static int compare_doubles(const void* a, const void* b);
+static double median_of_sorted(const double* values, int count);
+
+// --- Public Functions ---
+
+CalibrationSession* calibration_session_create(void) {
+    CalibrationSession* session = calloc(1, sizeof(CalibrationSession));
+    if (!session) {
+        perror("Failed to allocate memory for CalibrationSession");
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&session->lock, NULL) != 0) {
+        fprintf(stderr, "CalibrationSession: Failed to initialize mutex\n");
+        free(session);
+        return NULL;
+    }
+
+    session->status.state = CALIBRATION_SESSION_IDLE;
+    session->status.channel_index = -1;
+    session->status.slope = NAN;
+    session->status.offset = NAN;
+    session->status.r_squared = NAN;
+    session->status.last_reference = NAN;
+    session->status.last_raw_mean = NAN;
+    return session;
+}
+
+bool calibration_session_start(CalibrationSession* session, int channel_index, int samples_per_point) {
+    if (!session || channel_index < 0 || channel_index >= MAX_TOTAL_CHANNELS) return false;
+    if (samples_per_point == 0) samples_per_point = CALIBRATION_SESSION_DEFAULT_SAMPLES;
+    if (samples_per_point < CALIBRATION_SESSION_MIN_SAMPLES || samples_per_point > CALIBRATION_SESSION_MAX_SAMPLES) {
+        return false;
+    }
+
+    pthread_mutex_lock(&session->lock);
+    bool started = session->status.state != CALIBRATION_SESSION_APPLYING;
+    if (started) {
+        session->status = (CalibrationSessionStatus){
+            .state = CALIBRATION_SESSION_WAITING,
+            .channel_index = channel_index,
+            .samples_per_point = samples_per_point,
+            .last_reference = NAN,
+            .last_raw_mean = NAN,
+            .slope = NAN,
+            .offset = NAN,
+            .r_squared = NAN
+        };
+        session->mean_x = session->mean_y = 0.0;
+        session->m2_x = session->m2_y = session->c_xy = 0.0;
+    }
+    pthread_mutex_unlock(&session->lock);
+    return started;
+}
+
+bool calibration_session_capture(CalibrationSession* session, double reference_value) {
+    if (!session || !isfinite(reference_value)) return false;
+
+    pthread_mutex_lock(&session->lock);
+    bool started = session->status.state == CALIBRATION_SESSION_WAITING;
+    if (started) {
+        session->reference = reference_value;
+        session->status.samples_captured = 0;
+        session->status.state = CALIBRATION_SESSION_CAPTURING;
+    }
+    pthread_mutex_unlock(&session->lock);
+    return started;
+}
+
+void calibration_session_add_samples(CalibrationSession* session, const Channel channels[], ChannelMask read_mask) {
+    if (!session || !channels) return;
+
+    pthread_mutex_lock(&session->lock);
+    CalibrationSessionStatus* status = &session->status;
+    if (status->state == CALIBRATION_SESSION_CAPTURING && (read_mask & CHANNEL_MASK_BIT(status->channel_index))) {
+        session->samples[status->samples_captured++] = channels[status->channel_index].raw_adc_value;
+        if (status->samples_captured == status->samples_per_point) finish_point(session);
+    }
+    pthread_mutex_unlock(&session->lock);
+}
+
+bool calibration_session_apply(CalibrationSession* session) {
+    if (!session) return false;
+
+    pthread_mutex_lock(&session->lock);
+    bool accepted = session->status.state == CALIBRATION_SESSION_WAITING &&
+                    isfinite(session->status.slope) && isfinite(session->status.offset);
+    if (accepted) session->status.state = CALIBRATION_SESSION_APPLYING;
+    pthread_mutex_unlock(&session->lock);
+    return accepted;
+}
+
+bool calibration_session_take_result(CalibrationSession* session, int* channel_index, double* slope, double* offset) {
+    if (!session || !channel_index || !slope || !offset) return false;
+
+    pthread_mutex_lock(&session->lock);
+    bool pending = session->status.state == CALIBRATION_SESSION_APPLYING;
+    if (pending) {
+        *channel_index = session->status.channel_index;
+        *slope = session->status.slope;
+        *offset = session->status.offset;
+        session->status.state = CALIBRATION_SESSION_IDLE;
+    }
+    pthread_mutex_unlock(&session->lock);
+    return pending;
+}
+
+void calibration_session_cancel(CalibrationSession* session) {
+    if (!session) return;
+
+    pthread_mutex_lock(&session->lock);
+    session->status.state = CALIBRATION_SESSION_IDLE;
+    pthread_mutex_unlock(&session->lock);
+}
+
+void calibration_session_get_status(CalibrationSession* session, CalibrationSessionStatus* status) {
+    if (!session || !status) return;
+
+    pthread_mutex_lock(&session->lock);
+    *status = session->status;
+    pthread_mutex_unlock(&session->lock);
+}
+
+void calibration_session_destroy(CalibrationSession* session) {
+    if (!session) return;
+
+    pthread_mutex_destroy(&session->lock);
+    free(session);
+}
+
+// --- Private Function Implementations ---
+
+// Reduces the captured samples to one outlier-free reading and adds the point to the fit
+static void finish_point(CalibrationSession* session) {
+    CalibrationSessionStatus* status = &session->status;
+    int count = status->samples_captured;
+
+    qsort(session->samples, count, sizeof(double), compare_doubles);
+    double median = median_of_sorted(session->samples, count);
+    for (int k = 0; k < count; k++) {
+        session->deviations[k] = fabs(session->samples[k] - median);
+    }
+    qsort(session->deviations, count, sizeof(double), compare_doubles);
+    double sigma = MAD_TO_SIGMA * median_of_sorted(session->deviations, count);
+    if (sigma < MIN_SIGMA_COUNTS) sigma = MIN_SIGMA_COUNTS;
+
+    double sum = 0.0;
+    int kept = 0;
+    for (int k = 0; k < count; k++) {
+        if (fabs(session->samples[k] - median) > OUTLIER_THRESHOLD * sigma) continue;
+        sum += session->samples[k];
+        kept++;
+    }
+    double raw_mean = sum / kept; // The median itself is always kept
+
+    status->last_raw_mean = raw_mean;
+    status->last_reference = session->reference;
+    status->last_rejected = count - kept;
+    status->point_count++;
+    update_fit(session, raw_mean, session->reference);
+    status->state = CALIBRATION_SESSION_WAITING;
+}
+
+// Welford update of the means and co-moments, then slope, offset and R² from them
+static void update_fit(CalibrationSession* session, double x, double y) {
+    CalibrationSessionStatus* status = &session->status;
+    double n = status->point_count;
+
+    double dx = x - session->mean_x;
+    double dy = y - session->mean_y;
+    session->mean_x += dx / n;
+    session->mean_y += dy / n;
+    session->m2_x += dx * (x - session->mean_x);
+    session->m2_y += dy * (y - session->mean_y);
+    session->c_xy += dx * (y - session->mean_y);
+
+    if (session->m2_x <= 0.0) {
+        status->slope = status->offset = status->r_squared = NAN; // All readings equal so far
+        return;
+    }
+    status->slope = session->c_xy / session->m2_x;
+    status->offset = session->mean_y - status->slope * session->mean_x;
+    status->r_squared = session->m2_y > 0.0 ?
+        (session->c_xy * session->c_xy) / (session->m2_x * session->m2_y) : 1.0;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double median_of_sorted(const double* values, int count) {
+    if (count % 2 == 1) return values[count / 2];
+    return 0.5 * (values[count / 2 - 1] + values[count / 2]);
+}
@@ -0,0 +1,104 @@
+#ifndef CALIBRATION_SESSION_H
+#define CALIBRATION_SESSION_H
+
+#include <stdbool.h>
+#include "Channel.h"
+#include "SweepScheduler.h" // For ChannelMask
+
+/**
+ * @file CalibrationSession.h
+ * @brief Remote linear calibration of one channel against reference values.
+ *
+ * A client starts a session on a channel, sets a known reference (voltage,
+ * current, ...) and asks for a point. The next samples_per_point raw samples
+ * of that channel are captured at the full sweep rate, samples further than
+ * three robust sigmas (median absolute deviation, at least one ADC count) from
+ * the median are dropped, and the mean of the rest becomes the point. Points
+ * feed a running least-squares fit (Welford co-moments, O(1) memory in the
+ * number of points) that reports slope, offset and R² after every point.
+ *
+ * Commands come from the socket server's thread and samples from the
+ * acquisition thread, so every call takes the session's lock. An accepted fit
+ * is handed back to the acquisition thread (calibration_session_take_result),
+ * which applies it between sweeps.
+ */
+
+#define CALIBRATION_SESSION_MIN_SAMPLES 8
+#define CALIBRATION_SESSION_MAX_SAMPLES 4096
+#define CALIBRATION_SESSION_DEFAULT_SAMPLES 200
+
+typedef enum {
+    CALIBRATION_SESSION_IDLE = 0,   // No session (or the last one was applied or cancelled)
+    CALIBRATION_SESSION_WAITING,    // Waiting for the next reference point
+    CALIBRATION_SESSION_CAPTURING,  // Capturing samples for the current point
+    CALIBRATION_SESSION_APPLYING    // Fit accepted, waiting for the acquisition thread
+} CalibrationSessionState;
+
+typedef struct {
+    CalibrationSessionState state;
+    int channel_index;          // -1 before the first session
+    int samples_per_point;
+    int samples_captured;       // Of the point being captured
+    int point_count;
+    double last_reference;      // Reference value of the last completed point
+    double last_raw_mean;       // Its outlier-free mean ADC reading
+    int last_rejected;          // Samples dropped as outliers at that point
+    double slope;               // Fit so far (NAN until two distinct readings)
+    double offset;
+    double r_squared;
+} CalibrationSessionStatus;
+
+typedef struct CalibrationSession CalibrationSession; // Opaque session state
+
+/**
+ * @brief Creates an idle session with room for the largest point.
+ * @return A pointer to the session, or NULL on failure
+ */
+CalibrationSession* calibration_session_create(void);
+
+/**
+ * @brief Starts a new session on a channel, discarding any unfinished one.
+ * @param samples_per_point Samples averaged per point (MIN..MAX_SAMPLES; 0 = default)
+ * @return true on success, false for an invalid sample count or a fit still being applied
+ */
+bool calibration_session_start(CalibrationSession* session, int channel_index, int samples_per_point);
+
+/**
+ * @brief Captures the next point; the reference value is what the channel should read.
+ * @return true if capture started (the session must be waiting for a point)
+ */
+bool calibration_session_capture(CalibrationSession* session, double reference_value);
+
+/**
+ * @brief Feeds the latest sweep: the session channel's raw value is captured if it is in read_mask.
+ */
+void calibration_session_add_samples(CalibrationSession* session, const Channel channels[], ChannelMask read_mask);
+
+/**
+ * @brief Accepts the current fit for the acquisition thread to apply.
+ * @return true if the session was waiting for a point and has a finite fit
+ */
+bool calibration_session_apply(CalibrationSession* session);
+
+/**
+ * @brief Takes an accepted fit (once); the session becomes idle.
+ * @return true if a fit was waiting to be applied
+ */
+bool calibration_session_take_result(CalibrationSession* session, int* channel_index, double* slope, double* offset);
+
+/**
+ * @brief Abandons the current session without touching the channel's calibration.
+ */
+void calibration_session_cancel(CalibrationSession* session);
+
+/**
+ * @brief Copies the current state and fit.
+ */
+void calibration_session_get_status(CalibrationSession* session, CalibrationSessionStatus* status);
+
+/**
+ * @brief Frees the session.
+ */
+void calibration_session_destroy(CalibrationSession* session);
+
+#endif // CALIBRATION_SESSION_H
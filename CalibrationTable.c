@@ -0,0 +1,122 @@
+#include "CalibrationTable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct CalibrationTable {
+    CalibrationCurve curves[MAX_TOTAL_CHANNELS];
+    bool in_use[MAX_TOTAL_CHANNELS];
+};
+
+// --- Private Function Prototypes ---
+static bool curve_matches(const CalibrationCurve* curve, const Channel* channel);
+static bool curve_compile(CalibrationCurve* curve, const Channel* channel);
+static void curve_free(CalibrationCurve* curve);
+
+// --- Public Functions ---
+
+CalibrationTable* calibration_table_create(void) {
+    CalibrationTable* table = calloc(1, sizeof(CalibrationTable));
+    if (!table) {
+        perror("Failed to allocate memory for CalibrationTable");
+        return NULL;
+    }
+    return table;
+}
+
+bool calibration_table_attach(CalibrationTable* table, Channel channels[], int count) {
+    if (!table || !channels || count < 0 || count > MAX_TOTAL_CHANNELS) return false;
+
+    bool ok = true;
+    for (int i = 0; i < MAX_TOTAL_CHANNELS; i++) {
+        CalibrationCurve* curve = &table->curves[i];
+        bool wants_curve = i < count && channels[i].calibration_type != CHANNEL_CALIBRATION_LINEAR;
+
+        if (!wants_curve) {
+            if (table->in_use[i]) curve_free(curve);
+            table->in_use[i] = false;
+            if (i < count) channels[i].calibration_curve = NULL;
+            continue;
+        }
+
+        if (!table->in_use[i] || !curve_matches(curve, &channels[i])) {
+            curve_free(curve);
+            table->in_use[i] = curve_compile(curve, &channels[i]);
+            if (!table->in_use[i]) {
+                fprintf(stderr, "Calibration: Invalid curve for channel '%s', using slope/offset\n",
+                        channels[i].id);
+                ok = false;
+            }
+        }
+        channels[i].calibration_curve = table->in_use[i] ? curve : NULL;
+    }
+    return ok;
+}
+
+void calibration_table_destroy(CalibrationTable* table) {
+    if (!table) return;
+
+    for (int i = 0; i < MAX_TOTAL_CHANNELS; i++) {
+        if (table->in_use[i]) curve_free(&table->curves[i]);
+    }
+    free(table);
+}
+
+// --- Private Function Implementations ---
+
+static bool curve_matches(const CalibrationCurve* curve, const Channel* channel) {
+    if (curve->type != channel->calibration_type || (curve->lut != NULL) != channel->calibration_lut) return false;
+
+    if (curve->type == CHANNEL_CALIBRATION_POLYNOMIAL) {
+        return curve->term_count == channel->calibration_term_count &&
+               memcmp(curve->terms, channel->calibration_terms, curve->term_count * sizeof(double)) == 0;
+    }
+    return curve->point_count == channel->calibration_point_count &&
+           memcmp(curve->point_raw, channel->calibration_point_raw, curve->point_count * sizeof(double)) == 0 &&
+           memcmp(curve->point_value, channel->calibration_point_value, curve->point_count * sizeof(double)) == 0;
+}
+
+static bool curve_compile(CalibrationCurve* curve, const Channel* channel) {
+    memset(curve, 0, sizeof(*curve));
+    curve->type = channel->calibration_type;
+
+    if (curve->type == CHANNEL_CALIBRATION_POLYNOMIAL) {
+        if (channel->calibration_term_count < 1 || channel->calibration_term_count > CHANNEL_MAX_CALIBRATION_TERMS) {
+            return false;
+        }
+        curve->term_count = channel->calibration_term_count;
+        memcpy(curve->terms, channel->calibration_terms, curve->term_count * sizeof(double));
+    } else if (curve->type == CHANNEL_CALIBRATION_PIECEWISE) {
+        int points = channel->calibration_point_count;
+        if (points < 2 || points > CHANNEL_MAX_CALIBRATION_POINTS) return false;
+
+        curve->point_count = points;
+        memcpy(curve->point_raw, channel->calibration_point_raw, points * sizeof(double));
+        memcpy(curve->point_value, channel->calibration_point_value, points * sizeof(double));
+        for (int k = 0; k + 1 < points; k++) {
+            double width = curve->point_raw[k + 1] - curve->point_raw[k];
+            if (!(width > 0.0)) return false;
+            curve->segment_slope[k] = (curve->point_value[k + 1] - curve->point_value[k]) / width;
+        }
+    } else {
+        return false;
+    }
+
+    if (channel->calibration_lut) {
+        curve->lut = malloc(CHANNEL_CALIBRATION_LUT_SIZE * sizeof(float));
+        if (!curve->lut) {
+            // Still correct without the table, just evaluated per sample
+            fprintf(stderr, "Calibration: No memory for the lookup table of channel '%s'\n", channel->id);
+            return true;
+        }
+        for (int code = 0; code < CHANNEL_CALIBRATION_LUT_SIZE; code++) {
+            curve->lut[code] = (float)calibration_curve_evaluate(curve, (double)(code + INT16_MIN));
+        }
+    }
+    return true;
+}
+
+static void curve_free(CalibrationCurve* curve) {
+    free(curve->lut);
+    curve->lut = NULL;
+}
@@ -0,0 +1,42 @@
+#ifndef CALIBRATION_TABLE_H
+#define CALIBRATION_TABLE_H
+
+#include <stdbool.h>
+#include "Channel.h"
+
+/**
+ * @file CalibrationTable.h
+ * @brief Compiled non-linear calibration curves for the hardware manager's channels.
+ *
+ * Channels with a polynomial or piecewise calibration get a CalibrationCurve
+ * that their calibration_curve member points at. Filtered values are
+ * converted by Horner's rule or a binary search over the segments. Raw
+ * samples normally go through a 65536-entry table indexed by the signed
+ * 16-bit ADC code, built once per configuration, so the raw-code path costs
+ * one load regardless of the curve. Linear channels keep slope/offset and no curve.
+ */
+
+typedef struct CalibrationTable CalibrationTable; // Opaque set of compiled curves
+
+/**
+ * @brief Creates an empty table; call calibration_table_attach to compile the channels' curves.
+ * @return A pointer to the table, or NULL on failure
+ */
+CalibrationTable* calibration_table_create(void);
+
+/**
+ * @brief Compiles the curves of the given channels and points each channel at its curve.
+ *
+ * Curves whose configuration is unchanged are kept (their lookup tables are not rebuilt).
+ * Linear channels get a NULL curve.
+ *
+ * @return true on success; on failure the affected channels fall back to linear calibration
+ */
+bool calibration_table_attach(CalibrationTable* table, Channel channels[], int count);
+
+/**
+ * @brief Frees the table. Detach the channels first (or stop using them).
+ */
+void calibration_table_destroy(CalibrationTable* table);
+
+#endif // CALIBRATION_TABLE_H
@@ -1,6 +1,7 @@
 #include "Channel.h"
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
 
 void channel_init(Channel* channel) {
     if (!channel) return;
@@ -8,7 +9,27 @@ void channel_init(Channel* channel) {
     memset(channel, 0, sizeof(Channel));
     channel->slope = 1.0;
     channel->offset = 0.0;
+    channel->calibration_type = CHANNEL_CALIBRATION_LINEAR;
+    channel->calibration_lut = true;
+    channel->calibration_curve = NULL;
     channel->filter_alpha = 0.1; // Default alpha value
+    channel->filter_count = 0;   // Plain filter_alpha EMA unless a filter chain is configured
+    channel->min_value = -INFINITY; // No range limits unless configured
+    channel->max_value = INFINITY;
+    channel->timeout_threshold_s = 0.0;
+    channel->sample_interval_ms = 0;  // Sample every sweep unless configured
+    channel->publish_interval_ms = 0;
+    channel->stats_window = CHANNEL_STATS_WINDOW_NONE;
+    channel->stats_window_samples = 0;
+    channel->publish_value = true;
+    channel->stats_quantiles = false;
+    channel->trigger_above = NAN; // No burst capture unless configured
+    channel->trigger_below = NAN;
+    channel->trigger_rate = NAN;
+    channel->spectrum_size = 0; // No spectral analysis unless configured
+    channel->spectrum_band_count = 0;
+    channel->quality_flags = CHANNEL_QUALITY_OK;
+    channel->sample_quality_flags = CHANNEL_QUALITY_OK;
     channel->has_calibrated_override = false;
     channel->calibrated_override_value = 0.0;
     channel->is_active = false;
@@ -26,7 +47,70 @@ double channel_get_calibrated_value(const Channel* channel) {
 
     // Use the filtered value if it has been calculated, otherwise use the raw value.
     double value_to_use = (channel->filtered_adc_value > 0) ? channel->filtered_adc_value : (double)channel->raw_adc_value;
-    return value_to_use * channel->slope + channel->offset;
+    return channel_calibrate(channel, value_to_use);
+}
+
+double channel_get_sample_value(const Channel* channel) {
+    if (!channel) return 0.0;
+
+    if (channel->has_calibrated_override) {
+        return channel->calibrated_override_value;
+    }
+
+    // Raw codes index the precomputed table directly
+    const CalibrationCurve* curve = channel->calibration_curve;
+    if (curve && curve->lut && channel->raw_adc_value >= INT16_MIN && channel->raw_adc_value <= INT16_MAX) {
+        return curve->lut[channel->raw_adc_value - INT16_MIN];
+    }
+    return channel_calibrate(channel, (double)channel->raw_adc_value);
+}
+
+double channel_calibrate(const Channel* channel, double adc_value) {
+    if (!channel) return 0.0;
+
+    if (channel->calibration_curve) {
+        return calibration_curve_evaluate(channel->calibration_curve, adc_value);
+    }
+    return adc_value * channel->slope + channel->offset;
+}
+
+void channel_copy_calibration(Channel* target, const Channel* source) {
+    if (!target || !source) return;
+
+    target->slope = source->slope;
+    target->offset = source->offset;
+    target->calibration_type = source->calibration_type;
+    target->calibration_term_count = source->calibration_term_count;
+    memcpy(target->calibration_terms, source->calibration_terms, sizeof(target->calibration_terms));
+    target->calibration_point_count = source->calibration_point_count;
+    memcpy(target->calibration_point_raw, source->calibration_point_raw, sizeof(target->calibration_point_raw));
+    memcpy(target->calibration_point_value, source->calibration_point_value, sizeof(target->calibration_point_value));
+    target->calibration_lut = source->calibration_lut;
+}
+
+double calibration_curve_evaluate(const CalibrationCurve* curve, double adc_value) {
+    if (!curve) return adc_value;
+
+    if (curve->type == CHANNEL_CALIBRATION_POLYNOMIAL) {
+        double value = 0.0;
+        for (int k = curve->term_count - 1; k >= 0; k--) {
+            value = value * adc_value + curve->terms[k];
+        }
+        return value;
+    }
+
+    // Piecewise: binary search for the segment; the end segments extrapolate
+    int low = 0;
+    int high = curve->point_count - 2;
+    while (low < high) {
+        int mid = (low + high + 1) / 2;
+        if (adc_value >= curve->point_raw[mid]) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return curve->point_value[low] + curve->segment_slope[low] * (adc_value - curve->point_raw[low]);
 }
 
 void channel_set_calibrated_override(Channel* channel, double calibrated_value) {
@@ -47,6 +131,14 @@ bool channel_has_calibrated_override(const Channel* channel) {
     return channel && channel->has_calibrated_override;
 }
 
+bool channel_is_quality_ok(const Channel* channel) {
+    return channel && channel->quality_flags == CHANNEL_QUALITY_OK;
+}
+
+bool channel_is_sample_quality_ok(const Channel* channel) {
+    return channel && channel->sample_quality_flags == CHANNEL_QUALITY_OK;
+}
+
 void channel_update_raw_value(Channel* channel, int new_raw_value) {
     if (!channel) return;
     channel->raw_adc_value = new_raw_value;
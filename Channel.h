@@ -1,6 +1,7 @@
 #ifndef MEASUREMENT_H
 #define MEASUREMENT_H
 #include <stdbool.h>
+#include <stdint.h>
 
 #define MEASUREMENT_ID_SIZE 32
 #define GAIN_SETTING_SIZE 16
@@ -9,6 +10,64 @@
 #define MAX_BOARDS 4
 #define MAX_TOTAL_CHANNELS (MAX_BOARDS * NUM_CHANNELS)
 
+// Per-sample quality flags (bitmask, 0 = good). Set by the validation stage each sweep.
+#define CHANNEL_QUALITY_OK        0x00
+#define CHANNEL_QUALITY_BELOW_MIN 0x01  // Calibrated value below validation.min_value
+#define CHANNEL_QUALITY_ABOVE_MAX 0x02  // Calibrated value above validation.max_value
+#define CHANNEL_QUALITY_STALE     0x04  // No successful read within validation.timeout_threshold_s
+#define CHANNEL_QUALITY_INVALID   0x08  // Value is NaN or infinite
+
+// Streaming statistics window types (YAML statistics.window)
+#define CHANNEL_STATS_WINDOW_NONE     0
+#define CHANNEL_STATS_WINDOW_TUMBLING 1  // Restarts after every publish of the channel
+#define CHANNEL_STATS_WINDOW_SLIDING  2  // Last statistics.window_samples samples
+
+#define CHANNEL_SPECTRUM_MAX_BANDS 8  // Energy bands per channel (YAML spectrum.bands_hz has one more edge)
+
+// Calibration models (YAML calibration.type)
+#define CHANNEL_CALIBRATION_LINEAR     0  // slope * raw + offset
+#define CHANNEL_CALIBRATION_POLYNOMIAL 1  // sum of coefficients[k] * raw^k
+#define CHANNEL_CALIBRATION_PIECEWISE  2  // Linear interpolation between (raw, value) points
+
+#define CHANNEL_MAX_CALIBRATION_TERMS  6  // Polynomial up to raw^5
+#define CHANNEL_MAX_CALIBRATION_POINTS 16
+#define CHANNEL_CALIBRATION_LUT_SIZE   65536 // One entry per signed 16-bit ADC code
+
+// Compiled non-linear calibration. Built and owned by the hardware manager's CalibrationTable;
+// channels point at it (NULL = linear slope/offset).
+typedef struct {
+    int type;                   // CHANNEL_CALIBRATION_POLYNOMIAL or _PIECEWISE
+    int term_count;
+    double terms[CHANNEL_MAX_CALIBRATION_TERMS];          // Ascending powers, evaluated by Horner's rule
+    int point_count;
+    double point_raw[CHANNEL_MAX_CALIBRATION_POINTS];     // Strictly increasing
+    double point_value[CHANNEL_MAX_CALIBRATION_POINTS];
+    double segment_slope[CHANNEL_MAX_CALIBRATION_POINTS]; // Slope from point k to k + 1
+    float* lut;                 // Calibrated value per raw code (index raw + 32768); NULL = evaluate
+} CalibrationCurve;
+
+// Filter chain stage types (YAML filters[].type)
+#define CHANNEL_FILTER_MEDIAN  1  // Median of the last `window` samples
+#define CHANNEL_FILTER_HAMPEL  2  // Replaces outliers (> threshold scaled MADs) by the window median
+#define CHANNEL_FILTER_EMA     3  // Exponential average with a time constant, using the real dt
+#define CHANNEL_FILTER_LOWPASS 4  // Second-order Butterworth-style low-pass (biquad)
+#define CHANNEL_FILTER_KALMAN  5  // Scalar random-walk Kalman filter
+
+#define CHANNEL_MAX_FILTER_STAGES 4
+#define CHANNEL_FILTER_MAX_WINDOW 15
+
+// One configured filter stage; only the fields of its type are used
+typedef struct {
+    int type;                  // CHANNEL_FILTER_*
+    int window;                // Median/Hampel: odd sample count (3-CHANNEL_FILTER_MAX_WINDOW)
+    double threshold;          // Hampel: outlier threshold in scaled MADs
+    double time_constant_s;    // EMA
+    double cutoff_hz;          // Low-pass corner frequency
+    double q;                  // Low-pass quality factor
+    double process_noise;      // Kalman: variance growth per second
+    double measurement_noise;  // Kalman: sample variance (same units as process_noise)
+} ChannelFilterStage;
+
 // This struct will hold ALL information about a single sensor channel.
 typedef struct {
     // Configuration
@@ -17,13 +76,49 @@ typedef struct {
     char gain_setting[GAIN_SETTING_SIZE];
     int board_address;  // I2C address of the board (0x48-0x4B)
     int pin;           // ADC pin on that board (0-3)
+    bool is_virtual;   // Computed in software (no ADC input); value set via the calibrated override
 
     // Calibration
     double slope;
     double offset;
+    int calibration_type;           // CHANNEL_CALIBRATION_*
+    int calibration_term_count;     // Polynomial coefficients of raw^0, raw^1, ...
+    double calibration_terms[CHANNEL_MAX_CALIBRATION_TERMS];
+    int calibration_point_count;    // Piecewise (raw, value) points
+    double calibration_point_raw[CHANNEL_MAX_CALIBRATION_POINTS];
+    double calibration_point_value[CHANNEL_MAX_CALIBRATION_POINTS];
+    bool calibration_lut;           // Precompute raw samples into a lookup table (non-linear models)
+    const CalibrationCurve* calibration_curve; // Compiled model (NULL = linear)
 
     // Filtering
-    double filter_alpha;  // EMA filter alpha value from YAML
+    double filter_alpha;  // EMA filter alpha value from YAML (used when no filters are configured)
+    ChannelFilterStage filters[CHANNEL_MAX_FILTER_STAGES]; // YAML filters list, applied in order
+    int filter_count;
+
+    // Validation (from the YAML validation section)
+    double min_value;            // Lowest plausible calibrated value (-INFINITY when unset)
+    double max_value;            // Highest plausible calibrated value (+INFINITY when unset)
+    double timeout_threshold_s;  // Stale-data threshold in seconds (0 = disabled)
+
+    // Multi-rate scheduling (0 = every main loop sweep / every transmission)
+    int sample_interval_ms;
+    int publish_interval_ms;
+
+    // Streaming statistics (YAML statistics section)
+    int stats_window;          // CHANNEL_STATS_WINDOW_*
+    int stats_window_samples;  // Sliding window length
+    bool publish_value;        // false = publish only the statistics of this channel
+    bool stats_quantiles;      // Keep a quantile sketch of every sample for the trip
+
+    // Burst capture triggers (YAML trigger section; NAN = off)
+    double trigger_above;  // Fires when the sample rises above this value
+    double trigger_below;  // Fires when the sample falls below this value
+    double trigger_rate;   // Fires when |d(sample)/dt| exceeds this, in units per second
+
+    // Spectral analysis (YAML spectrum section)
+    int spectrum_size;        // FFT block length in samples (0 = off)
+    int spectrum_band_count;  // Bands between consecutive spectrum_band_edges_hz
+    double spectrum_band_edges_hz[CHANNEL_SPECTRUM_MAX_BANDS + 1];
 
     // Live Data
     int raw_adc_value;
@@ -31,6 +126,9 @@ typedef struct {
     bool has_calibrated_override;
     double calibrated_override_value;
     bool is_active;
+    double sample_time_s;   // Monotonic time of the latest successful read (0 = never read)
+    uint8_t quality_flags;  // CHANNEL_QUALITY_* bits from the latest sweep
+    uint8_t sample_quality_flags; // The same checks on the unfiltered sample (channel_get_sample_value)
 } Channel;
 
 // --- Public API ---
@@ -41,6 +139,18 @@ void channel_init(Channel* channel);
 // Calculates the final calibrated value
 double channel_get_calibrated_value(const Channel* channel);
 
+// Calculates the calibrated value of the latest raw sample, bypassing the EMA filter
+double channel_get_sample_value(const Channel* channel);
+
+// Applies the channel's calibration (linear or compiled curve) to a raw or filtered ADC value
+double channel_calibrate(const Channel* channel, double adc_value);
+
+// Copies slope, offset and the configured calibration model (not the compiled curve)
+void channel_copy_calibration(Channel* target, const Channel* source);
+
+// Evaluates a compiled curve at an ADC value (Horner's rule or piecewise interpolation)
+double calibration_curve_evaluate(const CalibrationCurve* curve, double adc_value);
+
 // Overrides the calibrated value without changing the raw ADC reading
 void channel_set_calibrated_override(Channel* channel, double calibrated_value);
 
@@ -53,6 +163,12 @@ bool channel_has_calibrated_override(const Channel* channel);
 // Updates the raw ADC value
 void channel_update_raw_value(Channel* channel, int new_raw_value);
 
+// Returns true when the latest value passed validation (no quality flags set)
+bool channel_is_quality_ok(const Channel* channel);
+
+// Returns true when the latest unfiltered sample passed validation; gate integrators on this
+bool channel_is_sample_quality_ok(const Channel* channel);
+
 // Applies the EMA filter to the raw value
 void channel_apply_filter(Channel* channel, double alpha);
 
@@ -0,0 +1,236 @@
+#include "ChannelSpectrum.h"
+#include "FFT.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// One channel's analyser: the block being filled and the latest result
+typedef struct {
+    int size;              // Block length (0 = disabled)
+    FFT* fft;
+    float* block;          // Samples of the current block
+    float* window;         // Hann coefficients
+    double window_power;   // Sum of squared window coefficients
+    double window_sum;
+    int filled;
+    double first_time_s;
+    double last_time_s;
+
+    int band_count;
+    double band_edges_hz[CHANNEL_SPECTRUM_MAX_BANDS + 1];
+
+    ChannelSpectrumResult result;
+    bool has_result;       // A block was analysed since the last take
+} SpectrumAnalyser;
+
+struct ChannelSpectrumTable {
+    int count;
+    SpectrumAnalyser analysers[MAX_TOTAL_CHANNELS];
+
+    // Scratch space shared by all channels (analysis runs on one thread)
+    float input[CHANNEL_SPECTRUM_MAX_SIZE];
+    float re[CHANNEL_SPECTRUM_MAX_SIZE / 2 + 1];
+    float im[CHANNEL_SPECTRUM_MAX_SIZE / 2 + 1];
+};
+
+// --- Private Function Prototypes ---
+static bool analyser_init(SpectrumAnalyser* analyser, int size);
+static void analyser_free(SpectrumAnalyser* analyser);
+static void analyse_block(ChannelSpectrumTable* table, SpectrumAnalyser* analyser);
+
+// --- Public Functions ---
+
+ChannelSpectrumTable* channel_spectrum_create(const Channel* channels, int count) {
+    if (!channels || count < 0 || count > MAX_TOTAL_CHANNELS) {
+        fprintf(stderr, "ChannelSpectrum: Invalid parameters\n");
+        return NULL;
+    }
+
+    ChannelSpectrumTable* table = calloc(1, sizeof(ChannelSpectrumTable));
+    if (!table) {
+        perror("Failed to allocate memory for ChannelSpectrumTable");
+        return NULL;
+    }
+
+    if (!channel_spectrum_configure(table, channels, count)) {
+        channel_spectrum_destroy(table);
+        return NULL;
+    }
+    return table;
+}
+
+bool channel_spectrum_configure(ChannelSpectrumTable* table, const Channel* channels, int count) {
+    if (!table || !channels || count < 0 || count > MAX_TOTAL_CHANNELS) return false;
+
+    for (int i = count; i < table->count; i++) {
+        analyser_free(&table->analysers[i]);
+    }
+    table->count = count;
+
+    for (int i = 0; i < count; i++) {
+        SpectrumAnalyser* analyser = &table->analysers[i];
+        int size = channels[i].spectrum_size;
+
+        // Bands only change how a block is summarised, so they apply from the next block on
+        analyser->band_count = channels[i].spectrum_band_count;
+        memcpy(analyser->band_edges_hz, channels[i].spectrum_band_edges_hz, sizeof(analyser->band_edges_hz));
+
+        if (analyser->size == size) continue; // Unchanged: keep the block being filled
+
+        analyser_free(analyser);
+        if (size != 0 && !analyser_init(analyser, size)) {
+            fprintf(stderr, "ChannelSpectrum: Cannot create analyser for channel '%s'\n", channels[i].id);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool channel_spectrum_is_enabled(const ChannelSpectrumTable* table, int index) {
+    return table && index >= 0 && index < table->count && table->analysers[index].size > 0;
+}
+
+void channel_spectrum_add(ChannelSpectrumTable* table, int index, double value, double time_s) {
+    if (!channel_spectrum_is_enabled(table, index) || !isfinite(value)) return;
+
+    SpectrumAnalyser* analyser = &table->analysers[index];
+    if (analyser->filled == 0) analyser->first_time_s = time_s;
+    analyser->block[analyser->filled++] = (float)value;
+    analyser->last_time_s = time_s;
+
+    if (analyser->filled == analyser->size) {
+        analyse_block(table, analyser);
+        analyser->filled = 0;
+    }
+}
+
+bool channel_spectrum_take(ChannelSpectrumTable* table, int index, ChannelSpectrumResult* result) {
+    if (!channel_spectrum_is_enabled(table, index)) return false;
+
+    SpectrumAnalyser* analyser = &table->analysers[index];
+    if (!analyser->has_result) return false;
+
+    if (result) *result = analyser->result;
+    analyser->has_result = false;
+    return true;
+}
+
+void channel_spectrum_destroy(ChannelSpectrumTable* table) {
+    if (!table) return;
+
+    for (int i = 0; i < MAX_TOTAL_CHANNELS; i++) {
+        analyser_free(&table->analysers[i]);
+    }
+    free(table);
+}
+
+// --- Private Function Implementations ---
+
+static bool analyser_init(SpectrumAnalyser* analyser, int size) {
+    if (size < CHANNEL_SPECTRUM_MIN_SIZE || size > CHANNEL_SPECTRUM_MAX_SIZE) return false;
+
+    analyser->fft = fft_create(size);
+    analyser->block = malloc(size * sizeof(float));
+    analyser->window = malloc(size * sizeof(float));
+    if (!analyser->fft || !analyser->block || !analyser->window) {
+        analyser_free(analyser);
+        return false;
+    }
+
+    // Periodic Hann window: sidelobes fall fast enough to keep PWM harmonics apart
+    analyser->window_power = 0.0;
+    analyser->window_sum = 0.0;
+    for (int n = 0; n < size; n++) {
+        double w = 0.5 - 0.5 * cos(2.0 * M_PI * n / size);
+        analyser->window[n] = (float)w;
+        analyser->window_power += w * w;
+        analyser->window_sum += w;
+    }
+
+    analyser->size = size;
+    analyser->filled = 0;
+    analyser->has_result = false;
+    return true;
+}
+
+static void analyser_free(SpectrumAnalyser* analyser) {
+    fft_destroy(analyser->fft);
+    free(analyser->block);
+    free(analyser->window);
+    analyser->fft = NULL;
+    analyser->block = NULL;
+    analyser->window = NULL;
+    analyser->size = 0;
+    analyser->filled = 0;
+    analyser->has_result = false;
+}
+
+static void analyse_block(ChannelSpectrumTable* table, SpectrumAnalyser* analyser) {
+    int n = analyser->size;
+    int half = n / 2;
+    double duration_s = analyser->last_time_s - analyser->first_time_s;
+    if (!(duration_s > 0.0)) return; // No usable time base (e.g. samples without timestamps)
+
+    double mean = 0.0;
+    for (int i = 0; i < n; i++) mean += analyser->block[i];
+    mean /= n;
+    for (int i = 0; i < n; i++) {
+        table->input[i] = (float)((analyser->block[i] - mean) * analyser->window[i]);
+    }
+
+    fft_forward_real(analyser->fft, table->input, table->re, table->im);
+
+    ChannelSpectrumResult* result = &analyser->result;
+    memset(result, 0, sizeof(*result));
+    result->sample_rate_hz = (n - 1) / duration_s;
+    result->band_count = analyser->band_count;
+    double bin_hz = result->sample_rate_hz / n;
+
+    // Mean-square contribution of bin k: one-sided, so interior bins count twice
+    double scale = 1.0 / (n * analyser->window_power);
+    double total = 0.0;
+    double bands[CHANNEL_SPECTRUM_MAX_BANDS] = {0};
+    int peak = 1;
+    double peak_power = -1.0;
+    for (int k = 1; k <= half; k++) {
+        double power = (double)table->re[k] * table->re[k] + (double)table->im[k] * table->im[k];
+        double mean_square = power * scale * (k < half ? 2.0 : 1.0);
+        total += mean_square;
+
+        double hz = k * bin_hz;
+        for (int b = 0; b < analyser->band_count; b++) {
+            if (hz >= analyser->band_edges_hz[b] && hz < analyser->band_edges_hz[b + 1]) {
+                bands[b] += mean_square;
+            }
+        }
+
+        if (power > peak_power) {
+            peak_power = power;
+            peak = k;
+        }
+    }
+
+    result->ac_rms = sqrt(total);
+    for (int b = 0; b < analyser->band_count; b++) {
+        result->band_rms[b] = sqrt(bands[b]);
+    }
+
+    // Parabolic fit through the peak bin and its neighbours (magnitudes)
+    double magnitude = sqrt(peak_power);
+    double offset = 0.0;
+    double peak_magnitude = magnitude;
+    if (peak > 1 && peak < half) {
+        double left = hypot(table->re[peak - 1], table->im[peak - 1]);
+        double right = hypot(table->re[peak + 1], table->im[peak + 1]);
+        double denominator = left - 2.0 * magnitude + right;
+        if (denominator < 0.0) {
+            offset = 0.5 * (left - right) / denominator;
+            peak_magnitude = magnitude - 0.25 * (left - right) * offset;
+        }
+    }
+    result->dominant_hz = (peak + offset) * bin_hz;
+    result->dominant_amplitude = 2.0 * peak_magnitude / analyser->window_sum;
+
+    analyser->has_result = true;
+}
@@ -0,0 +1,74 @@
+#ifndef CHANNEL_SPECTRUM_H
+#define CHANNEL_SPECTRUM_H
+
+#include <stdbool.h>
+#include "Channel.h"
+
+/**
+ * @file ChannelSpectrum.h
+ * @brief Per-channel spectral features (dominant frequency, AC RMS, band energy).
+ *
+ * Channels with a YAML `spectrum` section collect consecutive unfiltered
+ * samples into blocks of spectrum.size. A full block has its mean removed, is
+ * Hann-windowed and goes through a real FFT; the block is then discarded and
+ * the next one starts empty, so the analysis costs one FFT per `size` samples
+ * and only a handful of numbers leave the device. The sample rate is measured
+ * from the first and last sample times of each block, so a channel sampled
+ * with sample_interval_ms or at the sweep rate needs no extra configuration.
+ *
+ * Powers are scaled so that each bin holds the mean-square value it
+ * contributes: a band's RMS is the square root of the sum of its bins, and the
+ * AC RMS (all bins but DC) matches the time-domain standard deviation.
+ */
+
+#define CHANNEL_SPECTRUM_MIN_SIZE 16
+#define CHANNEL_SPECTRUM_MAX_SIZE 4096
+
+typedef struct {
+    double sample_rate_hz;          // Measured over the block
+    double dominant_hz;             // Strongest non-DC component (parabolic interpolation between bins)
+    double dominant_amplitude;      // Its peak amplitude, in channel units
+    double ac_rms;                  // RMS of everything but DC
+    double band_rms[CHANNEL_SPECTRUM_MAX_BANDS]; // RMS within [bands_hz[b], bands_hz[b + 1])
+    int band_count;
+} ChannelSpectrumResult;
+
+typedef struct ChannelSpectrumTable ChannelSpectrumTable; // Opaque spectrum table
+
+/**
+ * @brief Creates a table with one analyser per channel, as configured by spectrum_size.
+ * @param channels Channel array
+ * @param count Number of channels
+ * @return A pointer to the table, or NULL on failure
+ */
+ChannelSpectrumTable* channel_spectrum_create(const Channel* channels, int count);
+
+/**
+ * @brief Applies a reloaded configuration. Channels whose block size changed start a new block.
+ * @return true on success
+ */
+bool channel_spectrum_configure(ChannelSpectrumTable* table, const Channel* channels, int count);
+
+/**
+ * @brief Returns true if the channel has spectral analysis enabled.
+ */
+bool channel_spectrum_is_enabled(const ChannelSpectrumTable* table, int index);
+
+/**
+ * @brief Adds one sample; analyses the block when it is full (no-op when disabled).
+ * @param time_s Monotonic time of the sample in seconds
+ */
+void channel_spectrum_add(ChannelSpectrumTable* table, int index, double value, double time_s);
+
+/**
+ * @brief Takes the channel's latest result.
+ * @return true if a block was analysed since the previous call
+ */
+bool channel_spectrum_take(ChannelSpectrumTable* table, int index, ChannelSpectrumResult* result);
+
+/**
+ * @brief Frees the table.
+ */
+void channel_spectrum_destroy(ChannelSpectrumTable* table);
+
+#endif // CHANNEL_SPECTRUM_H
@@ -0,0 +1,332 @@
+#include "ChannelStats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+
+#define CHANNEL_STATS_SKETCH_FILE_MAGIC 0x544b5351u // "QSKT"
+
+// One channel's window. Sliding windows also keep the last `capacity` samples
+// and two monotonic deques of sample sequence numbers for min and max.
+typedef struct {
+    int type;              // CHANNEL_STATS_WINDOW_*
+    int capacity;          // Sliding window length in samples
+
+    // Running statistics of the samples currently in the window
+    uint32_t count;
+    double mean;
+    double m2;             // Sum of squared deviations from the mean (Welford)
+    double sum_sq;
+    double min;            // Tumbling only; sliding windows read the deques
+    double max;
+
+    // Sliding window state
+    double* ring;
+    uint64_t next_seq;     // Sequence number of the next sample
+    uint64_t* max_queue;   // Decreasing values, front = window max
+    int max_head, max_len;
+    uint64_t* min_queue;   // Increasing values, front = window min
+    int min_head, min_len;
+} StatsWindow;
+
+struct ChannelStatsTable {
+    int count;
+    StatsWindow windows[MAX_TOTAL_CHANNELS];
+    QuantileSketch* sketches[MAX_TOTAL_CHANNELS]; // Trip-long distributions (NULL = disabled)
+};
+
+// --- Private Function Prototypes ---
+static bool window_init(StatsWindow* window, int type, int capacity);
+static void window_free(StatsWindow* window);
+static void window_reset(StatsWindow* window);
+static void welford_add(StatsWindow* window, double value);
+static void welford_remove(StatsWindow* window, double value);
+static void sliding_add(StatsWindow* window, double value);
+static void sliding_recompute(StatsWindow* window);
+
+// --- Public Functions ---
+
+ChannelStatsTable* channel_stats_create(const Channel* channels, int count) {
+    if (!channels || count < 0 || count > MAX_TOTAL_CHANNELS) {
+        fprintf(stderr, "ChannelStats: Invalid parameters\n");
+        return NULL;
+    }
+
+    ChannelStatsTable* table = calloc(1, sizeof(ChannelStatsTable));
+    if (!table) {
+        perror("Failed to allocate memory for ChannelStatsTable");
+        return NULL;
+    }
+
+    if (!channel_stats_configure(table, channels, count)) {
+        channel_stats_destroy(table);
+        return NULL;
+    }
+    return table;
+}
+
+bool channel_stats_configure(ChannelStatsTable* table, const Channel* channels, int count) {
+    if (!table || !channels || count < 0 || count > MAX_TOTAL_CHANNELS) return false;
+
+    table->count = count;
+    for (int i = 0; i < MAX_TOTAL_CHANNELS; i++) {
+        bool wants_sketch = i < count && channels[i].stats_quantiles;
+        if (wants_sketch && !table->sketches[i]) {
+            table->sketches[i] = quantile_sketch_create(QUANTILE_SKETCH_DEFAULT_ACCURACY);
+            if (!table->sketches[i]) return false;
+        } else if (!wants_sketch && table->sketches[i]) {
+            quantile_sketch_destroy(table->sketches[i]);
+            table->sketches[i] = NULL;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        StatsWindow* window = &table->windows[i];
+        int type = channels[i].stats_window;
+        int capacity = type == CHANNEL_STATS_WINDOW_SLIDING ? channels[i].stats_window_samples : 0;
+
+        if (window->type == type && window->capacity == capacity) continue; // Unchanged: keep its data
+
+        window_free(window);
+        if (!window_init(window, type, capacity)) {
+            fprintf(stderr, "ChannelStats: Cannot create window for channel '%s'\n", channels[i].id);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool channel_stats_is_enabled(const ChannelStatsTable* table, int index) {
+    return table && index >= 0 && index < table->count &&
+           table->windows[index].type != CHANNEL_STATS_WINDOW_NONE;
+}
+
+void channel_stats_add(ChannelStatsTable* table, int index, double value) {
+    if (!table || index < 0 || index >= table->count || !isfinite(value)) return;
+
+    quantile_sketch_add(table->sketches[index], value);
+
+    StatsWindow* window = &table->windows[index];
+    if (window->type == CHANNEL_STATS_WINDOW_NONE) return;
+    if (window->type == CHANNEL_STATS_WINDOW_SLIDING) {
+        sliding_add(window, value);
+        return;
+    }
+
+    welford_add(window, value);
+    if (value < window->min) window->min = value;
+    if (value > window->max) window->max = value;
+}
+
+bool channel_stats_get(const ChannelStatsTable* table, int index, ChannelStatsSummary* summary) {
+    if (!channel_stats_is_enabled(table, index) || !summary) return false;
+
+    const StatsWindow* window = &table->windows[index];
+    if (window->count == 0) return false;
+
+    summary->count = window->count;
+    summary->mean = window->mean;
+    summary->stddev = window->count > 1 ? sqrt(fmax(window->m2, 0.0) / (window->count - 1)) : 0.0;
+    summary->rms = sqrt(fmax(window->sum_sq, 0.0) / window->count);
+
+    if (window->type == CHANNEL_STATS_WINDOW_SLIDING) {
+        summary->max = window->ring[window->max_queue[window->max_head] % window->capacity];
+        summary->min = window->ring[window->min_queue[window->min_head] % window->capacity];
+    } else {
+        summary->min = window->min;
+        summary->max = window->max;
+    }
+    summary->peak_to_peak = summary->max - summary->min;
+    return true;
+}
+
+const QuantileSketch* channel_stats_get_sketch(const ChannelStatsTable* table, int index) {
+    if (!table || index < 0 || index >= table->count) return NULL;
+    return table->sketches[index];
+}
+
+bool channel_stats_save_sketches(const ChannelStatsTable* table, const Channel* channels, const char* path) {
+    if (!table || !channels || !path) return false;
+
+    uint32_t entries = 0;
+    for (int i = 0; i < table->count; i++) {
+        if (table->sketches[i]) entries++;
+    }
+    if (entries == 0) return true;
+
+    // Write next to the target and rename, so a crash leaves the previous file intact
+    char temp_path[512];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        perror("ChannelStats: Failed to open sketch file");
+        return false;
+    }
+
+    uint32_t magic = CHANNEL_STATS_SKETCH_FILE_MAGIC;
+    bool ok = fwrite(&magic, sizeof(magic), 1, file) == 1 &&
+              fwrite(&entries, sizeof(entries), 1, file) == 1;
+    for (int i = 0; i < table->count && ok; i++) {
+        if (!table->sketches[i]) continue;
+        char id[MEASUREMENT_ID_SIZE] = {0};
+        snprintf(id, sizeof(id), "%s", channels[i].id);
+        ok = fwrite(id, sizeof(id), 1, file) == 1 && quantile_sketch_write(table->sketches[i], file);
+    }
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+
+    if (fclose(file) != 0 || !ok || rename(temp_path, path) != 0) {
+        fprintf(stderr, "ChannelStats: Failed to write sketch file '%s'\n", path);
+        unlink(temp_path);
+        return false;
+    }
+    return true;
+}
+
+void channel_stats_end_period(ChannelStatsTable* table, int index) {
+    if (!channel_stats_is_enabled(table, index)) return;
+
+    StatsWindow* window = &table->windows[index];
+    if (window->type == CHANNEL_STATS_WINDOW_TUMBLING) {
+        window_reset(window);
+    }
+}
+
+void channel_stats_destroy(ChannelStatsTable* table) {
+    if (!table) return;
+
+    for (int i = 0; i < MAX_TOTAL_CHANNELS; i++) {
+        window_free(&table->windows[i]);
+        quantile_sketch_destroy(table->sketches[i]);
+    }
+    free(table);
+}
+
+// --- Private Function Implementations ---
+
+static bool window_init(StatsWindow* window, int type, int capacity) {
+    memset(window, 0, sizeof(*window));
+    window->type = type;
+    window->capacity = capacity;
+
+    if (type == CHANNEL_STATS_WINDOW_SLIDING) {
+        if (capacity < 2 || capacity > CHANNEL_STATS_MAX_WINDOW) return false;
+
+        window->ring = malloc((size_t)capacity * sizeof(double));
+        window->max_queue = malloc((size_t)capacity * sizeof(uint64_t));
+        window->min_queue = malloc((size_t)capacity * sizeof(uint64_t));
+        if (!window->ring || !window->max_queue || !window->min_queue) {
+            window_free(window);
+            return false;
+        }
+    }
+
+    window_reset(window);
+    return true;
+}
+
+static void window_free(StatsWindow* window) {
+    free(window->ring);
+    free(window->max_queue);
+    free(window->min_queue);
+    memset(window, 0, sizeof(*window));
+}
+
+static void window_reset(StatsWindow* window) {
+    window->count = 0;
+    window->mean = 0.0;
+    window->m2 = 0.0;
+    window->sum_sq = 0.0;
+    window->min = INFINITY;
+    window->max = -INFINITY;
+    window->next_seq = 0;
+    window->max_head = window->max_len = 0;
+    window->min_head = window->min_len = 0;
+}
+
+static void welford_add(StatsWindow* window, double value) {
+    window->count++;
+    double delta = value - window->mean;
+    window->mean += delta / window->count;
+    window->m2 += delta * (value - window->mean);
+    window->sum_sq += value * value;
+}
+
+static void welford_remove(StatsWindow* window, double value) {
+    if (window->count <= 1) {
+        window->count = 0;
+        window->mean = 0.0;
+        window->m2 = 0.0;
+        window->sum_sq = 0.0;
+        return;
+    }
+
+    window->count--;
+    double delta = value - window->mean;
+    window->mean -= delta / window->count;
+    window->m2 -= delta * (value - window->mean);
+    window->sum_sq -= value * value;
+}
+
+static void sliding_add(StatsWindow* window, double value) {
+    const int capacity = window->capacity;
+    const uint64_t seq = window->next_seq++;
+    const int slot = (int)(seq % (uint64_t)capacity);
+
+    // The slot's previous sample leaves the window
+    if (seq >= (uint64_t)capacity) {
+        welford_remove(window, window->ring[slot]);
+        uint64_t expired = seq - (uint64_t)capacity;
+        if (window->max_len > 0 && window->max_queue[window->max_head] == expired) {
+            window->max_head = (window->max_head + 1) % capacity;
+            window->max_len--;
+        }
+        if (window->min_len > 0 && window->min_queue[window->min_head] == expired) {
+            window->min_head = (window->min_head + 1) % capacity;
+            window->min_len--;
+        }
+    }
+
+    window->ring[slot] = value;
+    welford_add(window, value);
+
+    // Samples dominated by the new one can never become the window max/min again
+    while (window->max_len > 0 &&
+           window->ring[window->max_queue[(window->max_head + window->max_len - 1) % capacity] % capacity] <= value) {
+        window->max_len--;
+    }
+    window->max_queue[(window->max_head + window->max_len) % capacity] = seq;
+    window->max_len++;
+
+    while (window->min_len > 0 &&
+           window->ring[window->min_queue[(window->min_head + window->min_len - 1) % capacity] % capacity] >= value) {
+        window->min_len--;
+    }
+    window->min_queue[(window->min_head + window->min_len) % capacity] = seq;
+    window->min_len++;
+
+    // Once per lap, rebuild the running sums from the ring (amortized O(1))
+    if (window->next_seq % (uint64_t)capacity == 0) {
+        sliding_recompute(window);
+    }
+}
+
+static void sliding_recompute(StatsWindow* window) {
+    int n = (int)window->count;
+    double sum = 0.0, sum_sq = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum += window->ring[i];
+        sum_sq += window->ring[i] * window->ring[i];
+    }
+
+    double mean = sum / n;
+    double m2 = 0.0;
+    for (int i = 0; i < n; i++) {
+        double d = window->ring[i] - mean;
+        m2 += d * d;
+    }
+
+    window->mean = mean;
+    window->m2 = m2;
+    window->sum_sq = sum_sq;
+}
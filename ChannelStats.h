@@ -0,0 +1,92 @@
+#ifndef CHANNEL_STATS_H
+#define CHANNEL_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Channel.h"
+#include "QuantileSketch.h"
+
+/**
+ * @file ChannelStats.h
+ * @brief Streaming per-channel statistics (mean, standard deviation, min, max, RMS, peak-to-peak).
+ *
+ * Every accepted sample updates its channel's window in O(1): Welford's
+ * algorithm keeps the mean and variance, a running sum of squares gives the
+ * RMS. A tumbling window accumulates until the publisher resets it after
+ * reporting. A sliding window covers the last N samples, using a ring buffer,
+ * Welford removal and monotonic deques for min/max. Its running sums are
+ * recomputed from the ring once per lap so rounding error cannot build up.
+ * Channels with `quantiles: true` also feed a quantile sketch that covers the
+ * whole trip. Windows are configured per channel in the YAML `statistics` section.
+ *
+ * Trip sketch file layout (host byte order): uint32 magic "QSKT", uint32 entry
+ * count, then per entry a MEASUREMENT_ID_SIZE channel id followed by the sketch
+ * as written by quantile_sketch_write.
+ */
+
+#define CHANNEL_STATS_MAX_WINDOW 4096 // Largest sliding window (samples)
+
+typedef struct {
+    uint32_t count;        // Samples in the window
+    double mean;
+    double stddev;         // Sample standard deviation (0 with fewer than two samples)
+    double min;
+    double max;
+    double rms;
+    double peak_to_peak;
+} ChannelStatsSummary;
+
+typedef struct ChannelStatsTable ChannelStatsTable; // Opaque statistics table
+
+/**
+ * @brief Creates a table with one window per channel, as configured by stats_window/stats_window_samples.
+ * @param channels Channel array
+ * @param count Number of channels
+ * @return A pointer to the table, or NULL on failure
+ */
+ChannelStatsTable* channel_stats_create(const Channel* channels, int count);
+
+/**
+ * @brief Applies a reloaded window configuration. Windows whose type or length changed start over.
+ * @return true on success
+ */
+bool channel_stats_configure(ChannelStatsTable* table, const Channel* channels, int count);
+
+/**
+ * @brief Returns true if the channel has a statistics window.
+ */
+bool channel_stats_is_enabled(const ChannelStatsTable* table, int index);
+
+/**
+ * @brief Adds one sample to a channel's window and quantile sketch (no-op when it has neither).
+ */
+void channel_stats_add(ChannelStatsTable* table, int index, double value);
+
+/**
+ * @brief Returns the channel's trip quantile sketch, or NULL when it has none.
+ */
+const QuantileSketch* channel_stats_get_sketch(const ChannelStatsTable* table, int index);
+
+/**
+ * @brief Writes every channel's quantile sketch to a trip file, replacing it atomically.
+ * @return true on success (also when no channel has a sketch)
+ */
+bool channel_stats_save_sketches(const ChannelStatsTable* table, const Channel* channels, const char* path);
+
+/**
+ * @brief Reads the statistics of a channel's window.
+ * @return false if the channel has no window or the window is empty
+ */
+bool channel_stats_get(const ChannelStatsTable* table, int index, ChannelStatsSummary* summary);
+
+/**
+ * @brief Starts a new tumbling window after its statistics were reported. Sliding windows are kept.
+ */
+void channel_stats_end_period(ChannelStatsTable* table, int index);
+
+/**
+ * @brief Frees the table.
+ */
+void channel_stats_destroy(ChannelStatsTable* table);
+
+#endif // CHANNEL_STATS_H
@@ -0,0 +1,68 @@
+#include "ChannelValidation.h"
+#include <string.h>
+#include <math.h>
+
+static void load_limits(ValidationTable* table, const Channel* channels, int count) {
+    for (int i = 0; i < count; i++) {
+        table->min_value[i] = channels[i].min_value;
+        table->max_value[i] = channels[i].max_value;
+        // A disabled watchdog is an infinite timeout, so the check stays branch-free
+        table->timeout_s[i] = channels[i].timeout_threshold_s > 0.0 ?
+                              channels[i].timeout_threshold_s : INFINITY;
+    }
+}
+
+void validation_table_build(ValidationTable* table, const Channel* channels, int count, double now_s) {
+    if (!table) return;
+
+    memset(table, 0, sizeof(*table));
+    if (!channels || count <= 0) return;
+    if (count > MAX_TOTAL_CHANNELS) count = MAX_TOTAL_CHANNELS;
+
+    table->count = count;
+    load_limits(table, channels, count);
+    for (int i = 0; i < count; i++) {
+        table->last_update_s[i] = now_s;
+    }
+}
+
+void validation_table_update_limits(ValidationTable* table, const Channel* channels, int count) {
+    if (!table || !channels) return;
+    if (count > table->count) count = table->count;
+    load_limits(table, channels, count);
+}
+
+int validation_table_evaluate(ValidationTable* table, double now_s) {
+    if (!table) return 0;
+
+    const int count = table->count;
+    int flagged = 0;
+
+    // Comparisons are turned into bits rather than branched on; the loop has no
+    // data-dependent control flow and auto-vectorizes at -O2/-O3.
+    for (int i = 0; i < count; i++) {
+        const double v = table->value[i];
+        const uint8_t below = (uint8_t)(v < table->min_value[i]);
+        const uint8_t above = (uint8_t)(v > table->max_value[i]);
+        const uint8_t stale = (uint8_t)((now_s - table->last_update_s[i]) > table->timeout_s[i]);
+        const uint8_t invalid = (uint8_t)((v - v) != 0.0); // NaN or +/-inf
+
+        const uint8_t flags = (uint8_t)(below * CHANNEL_QUALITY_BELOW_MIN |
+                                        above * CHANNEL_QUALITY_ABOVE_MAX |
+                                        stale * CHANNEL_QUALITY_STALE |
+                                        invalid * CHANNEL_QUALITY_INVALID);
+        const uint8_t bad = (uint8_t)(flags != 0);
+
+        const double s = table->sample[i];
+        table->sample_flags[i] = (uint8_t)((s < table->min_value[i]) * CHANNEL_QUALITY_BELOW_MIN |
+                                           (s > table->max_value[i]) * CHANNEL_QUALITY_ABOVE_MAX |
+                                           stale * CHANNEL_QUALITY_STALE |
+                                           ((s - s) != 0.0) * CHANNEL_QUALITY_INVALID);
+
+        table->flags[i] = flags;
+        table->violation_count[i] += bad;
+        flagged += bad;
+    }
+
+    return flagged;
+}
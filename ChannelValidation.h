@@ -0,0 +1,68 @@
+#ifndef CHANNEL_VALIDATION_H
+#define CHANNEL_VALIDATION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Channel.h"
+
+/**
+ * @file ChannelValidation.h
+ * @brief Per-sweep range and staleness checks for calibrated channel values.
+ *
+ * Limits from the YAML `validation` section are packed into flat arrays once
+ * (at start-up and on config reload) so the per-sweep check is a single
+ * branch-free pass over contiguous memory. Each channel gets a CHANNEL_QUALITY_*
+ * bitmask that sinks use to tag or suppress bad samples.
+ *
+ * The unfiltered sample is checked against the same limits in the same pass, since a
+ * filtered value can be in range while the sample it smooths is not (or is NaN).
+ * Integrators and analysis windows, which consume the samples, gate on sample_flags.
+ */
+
+typedef struct {
+    int count;
+
+    // Limits, laid out as one array per field
+    double min_value[MAX_TOTAL_CHANNELS];
+    double max_value[MAX_TOTAL_CHANNELS];
+    double timeout_s[MAX_TOTAL_CHANNELS];     // +INFINITY when the watchdog is disabled
+
+    // Per-sweep state
+    double value[MAX_TOTAL_CHANNELS];         // Calibrated values to check
+    double sample[MAX_TOTAL_CHANNELS];        // Unfiltered calibrated samples to check
+    double last_update_s[MAX_TOTAL_CHANNELS]; // Time of the last successful read
+    uint8_t flags[MAX_TOTAL_CHANNELS];        // Result bitmask per channel
+    uint8_t sample_flags[MAX_TOTAL_CHANNELS]; // Result bitmask of the unfiltered sample
+    uint32_t violation_count[MAX_TOTAL_CHANNELS]; // Sweeps with any flag set
+} ValidationTable;
+
+/**
+ * @brief Loads limits from the channel array. Staleness timers are restarted at now_s.
+ * @param table The table to fill
+ * @param channels Channel array (limits are read from min_value/max_value/timeout_threshold_s)
+ * @param count Number of channels
+ * @param now_s Current monotonic time in seconds
+ */
+void validation_table_build(ValidationTable* table, const Channel* channels, int count, double now_s);
+
+/**
+ * @brief Reloads the limits only, keeping staleness timers and counters.
+ */
+void validation_table_update_limits(ValidationTable* table, const Channel* channels, int count);
+
+/**
+ * @brief Records a successful read of a channel (feeds the stale-data watchdog).
+ */
+static inline void validation_table_mark_updated(ValidationTable* table, int index, double now_s) {
+    table->last_update_s[index] = now_s;
+}
+
+/**
+ * @brief Evaluates every channel against its limits using table->value and table->sample.
+ * @param table The table; the caller fills table->value and table->sample beforehand
+ * @param now_s Current monotonic time in seconds
+ * @return Number of channels with at least one quality flag set on their value
+ */
+int validation_table_evaluate(ValidationTable* table, double now_s);
+
+#endif // CHANNEL_VALIDATION_H
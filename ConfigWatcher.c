@@ -0,0 +1,252 @@
+#include "ConfigWatcher.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+
+// Editors usually write a file in several steps (truncate, write, rename);
+// wait for the directory to be quiet for this long before reloading.
+#define CONFIG_WATCHER_DEBOUNCE_MS 250
+
+struct ConfigWatcher {
+    char config_path[PATH_MAX];
+    char config_dir[PATH_MAX];
+    char config_name[NAME_MAX + 1];
+
+    YAMLAppConfig* reference_config; // Structural reference (the config at startup)
+
+    int inotify_fd;
+    int watch_descriptor;
+
+    // Reactor sources (owned by the event loop the watcher is attached to)
+    EventLoop* loop;
+    EventSource* inotify_source;
+    EventSource* debounce_timer;     // One-shot: fires once the directory has been quiet
+    EventSource* reload_event;       // Explicit reload requests (SIGHUP)
+
+    // Result handed to the main loop
+    pthread_mutex_t mutex;
+    volatile ConfigReloadStatus pending_status;
+    YAMLAppConfig* pending_config;
+    char pending_message[512];
+};
+
+// --- Private Function Prototypes ---
+static void handle_inotify_ready(EventLoop* loop, int fd, uint32_t events, void* user_data);
+static void handle_reload_timer(EventLoop* loop, void* user_data);
+static bool drain_inotify_events(ConfigWatcher* watcher);
+static void attempt_reload(ConfigWatcher* watcher);
+static void publish_result(ConfigWatcher* watcher, ConfigReloadStatus status,
+                           YAMLAppConfig* config, const char* message);
+
+// --- Public Functions ---
+
+ConfigWatcher* config_watcher_create(const char* config_path, const YAMLAppConfig* active_config) {
+    if (!config_path || !active_config) {
+        fprintf(stderr, "ConfigWatcher: Invalid parameters\n");
+        return NULL;
+    }
+
+    if (strlen(config_path) >= PATH_MAX) {
+        fprintf(stderr, "ConfigWatcher: Config path too long: %s\n", config_path);
+        return NULL;
+    }
+
+    ConfigWatcher* watcher = calloc(1, sizeof(ConfigWatcher));
+    if (!watcher) {
+        perror("Failed to allocate memory for ConfigWatcher");
+        return NULL;
+    }
+
+    watcher->inotify_fd = -1;
+    watcher->watch_descriptor = -1;
+    strncpy(watcher->config_path, config_path, sizeof(watcher->config_path) - 1);
+
+    // Split into directory and file name: the directory is watched so that
+    // atomic replace-by-rename saves are seen as well as in-place writes.
+    const char* slash = strrchr(config_path, '/');
+    if (slash) {
+        size_t dir_len = (size_t)(slash - config_path);
+        if (dir_len == 0) dir_len = 1; // File in "/"
+        memcpy(watcher->config_dir, config_path, dir_len);
+        watcher->config_dir[dir_len] = '\0';
+        strncpy(watcher->config_name, slash + 1, sizeof(watcher->config_name) - 1);
+    } else {
+        strcpy(watcher->config_dir, ".");
+        strncpy(watcher->config_name, config_path, sizeof(watcher->config_name) - 1);
+    }
+
+    watcher->reference_config = config_yaml_duplicate(active_config);
+    if (!watcher->reference_config) {
+        free(watcher);
+        return NULL;
+    }
+
+    watcher->inotify_fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (watcher->inotify_fd >= 0) {
+        watcher->watch_descriptor = inotify_add_watch(watcher->inotify_fd, watcher->config_dir,
+                                                      IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    }
+    if (watcher->watch_descriptor < 0) {
+        // Still usable through explicit reload requests (SIGHUP)
+        fprintf(stderr, "ConfigWatcher: inotify unavailable for '%s' (%s); reload on SIGHUP only\n",
+                watcher->config_dir, strerror(errno));
+    }
+
+    pthread_mutex_init(&watcher->mutex, NULL);
+    watcher->pending_status = CONFIG_RELOAD_NONE;
+    return watcher;
+}
+
+bool config_watcher_start(ConfigWatcher* watcher, EventLoop* loop) {
+    if (!watcher || !loop || watcher->loop) return false;
+
+    watcher->loop = loop;
+    watcher->debounce_timer = event_loop_add_timer(loop, 0, 0, handle_reload_timer, watcher);
+    watcher->reload_event = event_loop_add_event(loop, handle_reload_timer, watcher);
+    if (!watcher->debounce_timer || !watcher->reload_event) {
+        fprintf(stderr, "ConfigWatcher: Failed to register with the event loop\n");
+        return false;
+    }
+
+    if (watcher->watch_descriptor >= 0) {
+        watcher->inotify_source = event_loop_add_fd(loop, watcher->inotify_fd, EPOLLIN,
+                                                    handle_inotify_ready, watcher);
+    }
+    return true;
+}
+
+void config_watcher_request_reload(ConfigWatcher* watcher) {
+    if (!watcher) return;
+    event_loop_signal(watcher->reload_event);
+}
+
+ConfigReloadStatus config_watcher_poll(ConfigWatcher* watcher, YAMLAppConfig** new_config,
+                                       char* message, size_t message_size) {
+    if (!watcher) return CONFIG_RELOAD_NONE;
+
+    // Cheap unlocked peek: this is called once per sweep
+    if (watcher->pending_status == CONFIG_RELOAD_NONE) return CONFIG_RELOAD_NONE;
+
+    pthread_mutex_lock(&watcher->mutex);
+    ConfigReloadStatus status = watcher->pending_status;
+
+    if (status == CONFIG_RELOAD_READY && new_config) {
+        *new_config = watcher->pending_config;
+        watcher->pending_config = NULL;
+    }
+    if (message && message_size > 0) {
+        snprintf(message, message_size, "%s", watcher->pending_message);
+    }
+
+    watcher->pending_status = CONFIG_RELOAD_NONE;
+    pthread_mutex_unlock(&watcher->mutex);
+
+    return status;
+}
+
+void config_watcher_destroy(ConfigWatcher* watcher) {
+    if (!watcher) return;
+
+    if (watcher->loop) {
+        event_loop_remove(watcher->loop, watcher->inotify_source);
+        event_loop_remove(watcher->loop, watcher->debounce_timer);
+        event_loop_remove(watcher->loop, watcher->reload_event);
+    }
+
+    if (watcher->inotify_fd >= 0) close(watcher->inotify_fd);
+
+    config_yaml_free(watcher->pending_config);
+    config_yaml_free(watcher->reference_config);
+    pthread_mutex_destroy(&watcher->mutex);
+    free(watcher);
+}
+
+// --- Private Function Implementations ---
+
+static void handle_inotify_ready(EventLoop* loop, int fd, uint32_t events, void* user_data) {
+    ConfigWatcher* watcher = (ConfigWatcher*)user_data;
+
+    // Every relevant event restarts the quiet period
+    if (drain_inotify_events(watcher)) {
+        event_loop_set_timer(watcher->debounce_timer, CONFIG_WATCHER_DEBOUNCE_MS, 0);
+    }
+}
+
+static void handle_reload_timer(EventLoop* loop, void* user_data) {
+    ConfigWatcher* watcher = (ConfigWatcher*)user_data;
+
+    // An explicit request supersedes a pending debounced one
+    event_loop_set_timer(watcher->debounce_timer, 0, 0);
+    attempt_reload(watcher);
+}
+
+// Reads all queued inotify events; returns true if any concerns our config file.
+static bool drain_inotify_events(ConfigWatcher* watcher) {
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool relevant = false;
+
+    while (true) {
+        ssize_t length = read(watcher->inotify_fd, buffer, sizeof(buffer));
+        if (length <= 0) break;
+
+        for (char* ptr = buffer; ptr < buffer + length; ) {
+            const struct inotify_event* event = (const struct inotify_event*)ptr;
+            if (event->len > 0 && strcmp(event->name, watcher->config_name) == 0) {
+                relevant = true;
+            }
+            ptr += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    return relevant;
+}
+
+static void attempt_reload(ConfigWatcher* watcher) {
+    char message[512];
+
+    YAMLAppConfig* candidate = config_yaml_load(watcher->config_path);
+    if (!candidate) {
+        snprintf(message, sizeof(message), "Config reload rejected: failed to parse '%.200s'",
+                 watcher->config_path);
+        publish_result(watcher, CONFIG_RELOAD_REJECTED, NULL, message);
+        return;
+    }
+
+    char reason[400];
+    if (config_yaml_validate_comprehensive(candidate, reason, sizeof(reason)) != CONFIG_YAML_SUCCESS) {
+        snprintf(message, sizeof(message), "Config reload rejected (validation): %s", reason);
+        config_yaml_free(candidate);
+        publish_result(watcher, CONFIG_RELOAD_REJECTED, NULL, message);
+        return;
+    }
+
+    if (config_yaml_check_reload_compatible(watcher->reference_config, candidate,
+                                            reason, sizeof(reason)) != CONFIG_YAML_SUCCESS) {
+        snprintf(message, sizeof(message), "Config reload rejected: %s", reason);
+        config_yaml_free(candidate);
+        publish_result(watcher, CONFIG_RELOAD_REJECTED, NULL, message);
+        return;
+    }
+
+    snprintf(message, sizeof(message), "Config reloaded from '%.200s'", watcher->config_path);
+    publish_result(watcher, CONFIG_RELOAD_READY, candidate, message);
+}
+
+static void publish_result(ConfigWatcher* watcher, ConfigReloadStatus status,
+                           YAMLAppConfig* config, const char* message) {
+    pthread_mutex_lock(&watcher->mutex);
+
+    // A newer result supersedes one the main loop has not picked up yet
+    config_yaml_free(watcher->pending_config);
+    watcher->pending_config = config;
+    watcher->pending_status = status;
+    snprintf(watcher->pending_message, sizeof(watcher->pending_message), "%s", message);
+
+    pthread_mutex_unlock(&watcher->mutex);
+}
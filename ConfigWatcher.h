@@ -0,0 +1,74 @@
+#ifndef CONFIG_WATCHER_H
+#define CONFIG_WATCHER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "ConfigYAML.h"
+#include "EventLoop.h"
+
+/**
+ * @file ConfigWatcher.h
+ * @brief Watches the YAML configuration file and prepares hot reloads.
+ *
+ * Runs on the background event loop: inotify reports rewrites of the
+ * configuration file (debounced with a one-shot timer) and an event source
+ * carries explicit reload requests (e.g. SIGHUP). The new file is parsed,
+ * validated with config_yaml_validate_comprehensive() and checked for
+ * structural compatibility off the acquisition path. The main loop then picks
+ * up the result between sweeps with config_watcher_poll().
+ */
+
+typedef struct ConfigWatcher ConfigWatcher; // Opaque watcher type
+
+// Outcome of a reload attempt as seen by the main loop
+typedef enum {
+    CONFIG_RELOAD_NONE = 0,   // Nothing new since the last poll
+    CONFIG_RELOAD_READY,      // A validated, compatible configuration is available
+    CONFIG_RELOAD_REJECTED    // The file changed but was rejected; see the message
+} ConfigReloadStatus;
+
+/**
+ * @brief Creates a watcher for the given configuration file.
+ * @param config_path Path to the YAML file the application was started with
+ * @param active_config The running configuration, used as the structural reference (copied)
+ * @return A pointer to the watcher, or NULL on failure
+ */
+ConfigWatcher* config_watcher_create(const char* config_path, const YAMLAppConfig* active_config);
+
+/**
+ * @brief Registers the watcher's sources with an event loop.
+ * @param watcher The watcher
+ * @param loop The background event loop (must outlive the watcher)
+ * @return true on success
+ */
+bool config_watcher_start(ConfigWatcher* watcher, EventLoop* loop);
+
+/**
+ * @brief Requests a reload regardless of file changes.
+ *
+ * Async-signal-safe (see event_loop_signal()), so it may be called from a
+ * SIGHUP handler.
+ * @param watcher The watcher
+ */
+void config_watcher_request_reload(ConfigWatcher* watcher);
+
+/**
+ * @brief Collects the result of the latest reload attempt, if any.
+ * @param watcher The watcher
+ * @param new_config Receives the new configuration on CONFIG_RELOAD_READY (caller frees it)
+ * @param message Buffer for a human-readable reason on CONFIG_RELOAD_REJECTED (can be NULL)
+ * @param message_size Size of the message buffer
+ * @return The reload status
+ */
+ConfigReloadStatus config_watcher_poll(ConfigWatcher* watcher, YAMLAppConfig** new_config,
+                                       char* message, size_t message_size);
+
+/**
+ * @brief Unregisters from the event loop and frees all resources, including any unclaimed configuration.
+ *
+ * The event loop must be stopped first.
+ * @param watcher The watcher
+ */
+void config_watcher_destroy(ConfigWatcher* watcher);
+
+#endif // CONFIG_WATCHER_H
@@ -1,4 +1,6 @@
 #include "ConfigYAML.h"
+#include "ChannelStats.h"
+#include "ChannelSpectrum.h"
 #include <yaml.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -30,11 +32,43 @@ static bool parse_single_channel(YAMLParseContext* ctx, Channel* channel);
 static bool parse_calibration_section(YAMLParseContext* ctx, Channel* channel);
 static bool parse_adc_section(YAMLParseContext* ctx, Channel* channel);
 static bool parse_validation_section(YAMLParseContext* ctx, Channel* channel);
+static bool parse_statistics_section(YAMLParseContext* ctx, Channel* channel);
+static bool parse_trigger_section(YAMLParseContext* ctx, Channel* channel);
+static bool parse_calibration_points(YAMLParseContext* ctx, Channel* channel);
+static bool parse_spectrum_section(YAMLParseContext* ctx, Channel* channel);
+static bool parse_band_edges(YAMLParseContext* ctx, Channel* channel);
+static bool parse_filters_section(YAMLParseContext* ctx, Channel* channel);
+static bool parse_filter_stage(YAMLParseContext* ctx, ChannelFilterStage* stage);
 static bool parse_boards_section(YAMLParseContext* ctx);
 static bool parse_single_board(YAMLParseContext* ctx, BoardConfig* board);
 static bool parse_influxdb_section(YAMLParseContext* ctx);
+static bool parse_rollup_tiers(YAMLParseContext* ctx, InfluxDBConfig* influxdb);
+static bool parse_single_rollup_tier(YAMLParseContext* ctx, RollupTierConfig* tier);
+static bool validate_batching(int batch_size, int flush_interval_ms, const char* owner,
+                              char* error_message, size_t error_size);
 static bool parse_logging_section(YAMLParseContext* ctx);
+static bool parse_sinks_section(YAMLParseContext* ctx);
+static bool parse_sink(YAMLParseContext* ctx, SinkConfig* sink);
+static bool parse_mqtt_section(YAMLParseContext* ctx);
+static bool parse_gateway_section(YAMLParseContext* ctx);
+static void normalize_mqtt(MqttConfig* mqtt);
+static bool parse_capture_section(YAMLParseContext* ctx);
 static bool parse_battery_section(YAMLParseContext* ctx);
+static bool parse_batteries_section(YAMLParseContext* ctx);
+static bool parse_single_battery_pack(YAMLParseContext* ctx, BatteryPackConfig* pack);
+static void normalize_battery_packs(BatteryConfig* battery);
+static bool parse_energy_section(YAMLParseContext* ctx);
+static bool parse_energy_meters(YAMLParseContext* ctx, EnergyConfig* energy);
+static bool parse_single_energy_meter(YAMLParseContext* ctx, EnergyMeterConfig* meter);
+static void normalize_energy_meters(EnergyConfig* energy);
+static bool parse_trip_section(YAMLParseContext* ctx);
+static bool parse_alarms_section(YAMLParseContext* ctx);
+static bool parse_alarm_rules(YAMLParseContext* ctx, AlarmConfig* alarms);
+static bool parse_single_alarm_rule(YAMLParseContext* ctx, AlarmRuleConfig* rule);
+static bool parse_alarm_conditions(YAMLParseContext* ctx, AlarmRuleConfig* rule);
+static bool parse_single_alarm_condition(YAMLParseContext* ctx, AlarmConditionConfig* condition);
+static bool find_active_channel(const YAMLAppConfig* config, const char* id);
+static bool alarm_rules_equal(const AlarmRuleConfig* a, const AlarmRuleConfig* b);
 static bool parse_gps_section(YAMLParseContext* ctx);
 static bool parse_network_section(YAMLParseContext* ctx);
 static bool expect_event_type(YAMLParseContext* ctx, yaml_event_type_t expected);
@@ -43,6 +77,8 @@ static bool get_scalar_double(YAMLParseContext* ctx, double* value);
 static bool get_scalar_int(YAMLParseContext* ctx, int* value);
 static bool get_scalar_long(YAMLParseContext* ctx, long* value);
 static bool get_scalar_bool(YAMLParseContext* ctx, bool* value);
+static bool get_scalar_double_list(YAMLParseContext* ctx, double* values, int max_count, int* count);
+static bool get_double_list_items(YAMLParseContext* ctx, double* values, int max_count, int* count);
 static bool get_current_scalar_key(YAMLParseContext* ctx, char* buffer, size_t buffer_size);
 static bool skip_mapping(YAMLParseContext* ctx);
 static bool skip_sequence(YAMLParseContext* ctx);
@@ -81,6 +117,24 @@ YAMLAppConfig* config_yaml_load(const char* filename) {
         fclose(file);
         return NULL;
     }
+
+    // Defaults of sections whose zero value is meaningful
+    ctx.config->capture.pre_samples = CAPTURE_DEFAULT_PRE_SAMPLES;
+    ctx.config->capture.post_samples = CAPTURE_DEFAULT_POST_SAMPLES;
+    ctx.config->capture.upload = true;
+    ctx.config->sinks.csv = (SinkConfig){ true, SINK_DEFAULT_CSV_QUEUE_SIZE, 0 };
+    ctx.config->sinks.display = (SinkConfig){ true, SINK_DEFAULT_DISPLAY_QUEUE_SIZE, SINK_DEFAULT_DISPLAY_INTERVAL_MS };
+    ctx.config->sinks.mqtt = (SinkConfig){ true, SINK_DEFAULT_MQTT_QUEUE_SIZE, 0 };
+    snprintf(ctx.config->influxdb.udp_host, sizeof(ctx.config->influxdb.udp_host), "localhost");
+    ctx.config->influxdb.udp_port = INFLUX_DEFAULT_UDP_PORT;
+    ctx.config->influxdb.udp_mtu = INFLUX_DEFAULT_UDP_MTU;
+    ctx.config->gateway = (GatewayConfig){ GATEWAY_DEFAULT_PORT, GATEWAY_DEFAULT_MAX_NODES,
+                                           GATEWAY_DEFAULT_NODE_LINES_PER_S };
+    ctx.config->mqtt.port = MQTT_DEFAULT_PORT;
+    ctx.config->mqtt.keepalive_s = MQTT_DEFAULT_KEEPALIVE_S;
+    ctx.config->mqtt.max_inflight = MQTT_DEFAULT_MAX_INFLIGHT;
+    ctx.config->mqtt.ack_timeout_ms = MQTT_DEFAULT_ACK_TIMEOUT_MS;
+    ctx.config->mqtt.reconnect_max_s = MQTT_DEFAULT_RECONNECT_MAX_S;
     
     // Initialize YAML parser
     if (!yaml_parser_initialize(&ctx.parser)) {
@@ -105,11 +159,25 @@ YAMLAppConfig* config_yaml_load(const char* filename) {
         return NULL;
     }
 
+    normalize_battery_packs(&ctx.config->battery);
+    normalize_energy_meters(&ctx.config->energy);
+    if (strlen(ctx.config->trip.state_file) == 0) {
+        snprintf(ctx.config->trip.state_file, sizeof(ctx.config->trip.state_file), "logs/odometer.bin");
+    }
+    normalize_mqtt(&ctx.config->mqtt);
+
     // Expand environment variables in InfluxDB configuration
     expand_environment_variables(ctx.config->influxdb.url, sizeof(ctx.config->influxdb.url));
     expand_environment_variables(ctx.config->influxdb.bucket, sizeof(ctx.config->influxdb.bucket));
     expand_environment_variables(ctx.config->influxdb.org, sizeof(ctx.config->influxdb.org));
     expand_environment_variables(ctx.config->influxdb.token, sizeof(ctx.config->influxdb.token));
+    expand_environment_variables(ctx.config->influxdb.udp_host, sizeof(ctx.config->influxdb.udp_host));
+    for (int t = 0; t < ctx.config->influxdb.tier_count; t++) {
+        expand_environment_variables(ctx.config->influxdb.tiers[t].bucket, sizeof(ctx.config->influxdb.tiers[t].bucket));
+    }
+    expand_environment_variables(ctx.config->mqtt.host, sizeof(ctx.config->mqtt.host));
+    expand_environment_variables(ctx.config->mqtt.username, sizeof(ctx.config->mqtt.username));
+    expand_environment_variables(ctx.config->mqtt.password, sizeof(ctx.config->mqtt.password));
 
     return ctx.config;
 }
@@ -178,6 +246,61 @@ ConfigYAMLResult config_yaml_validate_comprehensive(const YAMLAppConfig* config,
         return CONFIG_YAML_ERROR_VALIDATION_FAILED;
     }
 
+    // Validate batching and rollup tiers
+    if (!validate_batching(config->influxdb.batch_size, config->influxdb.flush_interval_ms, "influxdb",
+                           error_message, error_size)) {
+        return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+    }
+
+    if (config->influxdb.transport == INFLUX_TRANSPORT_UDP &&
+        (strlen(config->influxdb.udp_host) == 0 || config->influxdb.udp_port < 1 || config->influxdb.udp_port > 65535 ||
+         config->influxdb.udp_mtu < 576 || config->influxdb.udp_mtu > 65535)) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "influxdb: UDP transport needs udp_host, udp_port 1-65535 and udp_mtu 576-65535 (got '%s', %d, %d)",
+                    config->influxdb.udp_host, config->influxdb.udp_port, config->influxdb.udp_mtu);
+        }
+        return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+    }
+
+    for (int t = 0; t < config->influxdb.tier_count; t++) {
+        const RollupTierConfig* tier = &config->influxdb.tiers[t];
+
+        if (strlen(tier->name) == 0 || strlen(tier->bucket) == 0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size, "Rollup tier %d: name and bucket are required", t);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (tier->interval_s < 1.0 || tier->interval_s > 86400.0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Rollup tier '%s': interval_s must be 1-86400 (got %.1f)", tier->name, tier->interval_s);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (!validate_batching(tier->batch_size, tier->flush_interval_ms, tier->name, error_message, error_size)) {
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        // Every tier has its own bucket (and offline file named after it)
+        bool duplicate = strcmp(tier->bucket, config->influxdb.bucket) == 0;
+        for (int other = 0; other < t && !duplicate; other++) {
+            duplicate = strcmp(tier->bucket, config->influxdb.tiers[other].bucket) == 0 ||
+                        strcmp(tier->name, config->influxdb.tiers[other].name) == 0;
+        }
+        if (duplicate) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Rollup tier '%s': name and bucket must differ from the other tiers and the raw bucket",
+                        tier->name);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+    }
+
     // Validate channel configurations
     for (size_t i = 0; i < config->channel_count; i++) {
         const Channel* ch = &config->channels[i];
@@ -199,6 +322,30 @@ ConfigYAMLResult config_yaml_validate_comprehensive(const YAMLAppConfig* config,
         }
 
         // Validate calibration values
+        if (ch->calibration_type == CHANNEL_CALIBRATION_POLYNOMIAL && ch->calibration_term_count < 1) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Channel '%s': polynomial calibration needs 1-%d coefficients",
+                        ch->id, CHANNEL_MAX_CALIBRATION_TERMS);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (ch->calibration_type == CHANNEL_CALIBRATION_PIECEWISE) {
+            bool points_valid = ch->calibration_point_count >= 2;
+            for (int k = 0; points_valid && k + 1 < ch->calibration_point_count; k++) {
+                points_valid = ch->calibration_point_raw[k + 1] > ch->calibration_point_raw[k];
+            }
+            if (!points_valid) {
+                if (error_message && error_size > 0) {
+                    snprintf(error_message, error_size,
+                            "Channel '%s': piecewise calibration needs 2-%d points with increasing raw values",
+                            ch->id, CHANNEL_MAX_CALIBRATION_POINTS);
+                }
+                return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+            }
+        }
+
         if (ch->slope == 0.0) {
             if (error_message && error_size > 0) {
                 snprintf(error_message, error_size,
@@ -225,37 +372,400 @@ ConfigYAMLResult config_yaml_validate_comprehensive(const YAMLAppConfig* config,
             }
             return CONFIG_YAML_ERROR_VALIDATION_FAILED;
         }
+
+        // Validation limits must describe a non-empty range
+        if (!(ch->min_value < ch->max_value)) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Channel '%s': validation min_value (%.3f) must be below max_value (%.3f)",
+                        ch->id, ch->min_value, ch->max_value);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (ch->timeout_threshold_s < 0.0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Channel '%s': timeout_threshold_s cannot be negative (%.2f)",
+                        ch->id, ch->timeout_threshold_s);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (ch->sample_interval_ms < 0 || ch->publish_interval_ms < 0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Channel '%s': sample_interval_ms and publish_interval_ms cannot be negative",
+                        ch->id);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (ch->stats_window == CHANNEL_STATS_WINDOW_SLIDING &&
+            (ch->stats_window_samples < 2 || ch->stats_window_samples > CHANNEL_STATS_MAX_WINDOW)) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Channel '%s': statistics.window_samples must be 2-%d for a sliding window (got %d)",
+                        ch->id, CHANNEL_STATS_MAX_WINDOW, ch->stats_window_samples);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (!ch->publish_value && ch->stats_window == CHANNEL_STATS_WINDOW_NONE && !ch->stats_quantiles &&
+            ch->spectrum_size == 0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Channel '%s': statistics.publish_value is false but no window, quantiles or spectrum is set",
+                        ch->id);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (!isnan(ch->trigger_rate) && !(ch->trigger_rate > 0.0)) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Channel '%s': trigger.rate must be positive (got %.3f)", ch->id, ch->trigger_rate);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (ch->spectrum_size != 0 &&
+            (ch->spectrum_size < CHANNEL_SPECTRUM_MIN_SIZE || ch->spectrum_size > CHANNEL_SPECTRUM_MAX_SIZE ||
+             (ch->spectrum_size & (ch->spectrum_size - 1)) != 0)) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Channel '%s': spectrum.size must be a power of two from %d to %d (got %d)",
+                        ch->id, CHANNEL_SPECTRUM_MIN_SIZE, CHANNEL_SPECTRUM_MAX_SIZE, ch->spectrum_size);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        bool bands_valid = ch->spectrum_band_count > 0 || ch->spectrum_band_edges_hz[0] == 0.0;
+        for (int b = 0; b < ch->spectrum_band_count; b++) {
+            if (ch->spectrum_band_edges_hz[0] < 0.0 ||
+                !(ch->spectrum_band_edges_hz[b + 1] > ch->spectrum_band_edges_hz[b])) {
+                bands_valid = false;
+            }
+        }
+        if (!bands_valid) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Channel '%s': spectrum.bands_hz needs 2-%d non-negative, strictly increasing edges",
+                        ch->id, CHANNEL_SPECTRUM_MAX_BANDS + 1);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        for (int f = 0; f < ch->filter_count; f++) {
+            const ChannelFilterStage* stage = &ch->filters[f];
+            const char* problem = NULL;
+            switch (stage->type) {
+                case CHANNEL_FILTER_MEDIAN:
+                case CHANNEL_FILTER_HAMPEL:
+                    if (stage->window < 3 || stage->window > CHANNEL_FILTER_MAX_WINDOW || stage->window % 2 == 0) {
+                        problem = "window must be an odd sample count from 3 to 15";
+                    } else if (stage->type == CHANNEL_FILTER_HAMPEL && !(stage->threshold > 0.0)) {
+                        problem = "threshold must be positive";
+                    }
+                    break;
+                case CHANNEL_FILTER_EMA:
+                    if (!(stage->time_constant_s > 0.0)) problem = "time_constant_s must be positive";
+                    break;
+                case CHANNEL_FILTER_LOWPASS:
+                    if (!(stage->cutoff_hz > 0.0) || !(stage->q > 0.0)) problem = "cutoff_hz and q must be positive";
+                    break;
+                case CHANNEL_FILTER_KALMAN:
+                    if (!(stage->process_noise > 0.0) || !(stage->measurement_noise > 0.0)) {
+                        problem = "process_noise and measurement_noise must be positive";
+                    }
+                    break;
+            }
+            if (problem) {
+                if (error_message && error_size > 0) {
+                    snprintf(error_message, error_size, "Channel '%s': filters[%d]: %s", ch->id, f, problem);
+                }
+                return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+            }
+        }
+
+        // A channel read less often than its stale threshold would always be flagged
+        if (ch->timeout_threshold_s > 0.0 &&
+            ch->sample_interval_ms > ch->timeout_threshold_s * 1000.0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Channel '%s': sample_interval_ms (%d) exceeds timeout_threshold_s (%.2f s)",
+                        ch->id, ch->sample_interval_ms, ch->timeout_threshold_s);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+    }
+
+    if (config->capture.pre_samples < 0 || config->capture.post_samples < 1 ||
+        config->capture.pre_samples + config->capture.post_samples > CAPTURE_MAX_SAMPLES) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Invalid capture window: pre_samples %d, post_samples %d (post must be at least 1, total at most %d)",
+                    config->capture.pre_samples, config->capture.post_samples, CAPTURE_MAX_SAMPLES);
+        }
+        return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+    }
+
+    if (config->capture.holdoff_s < 0.0) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Invalid capture holdoff_s: %.1f (cannot be negative)", config->capture.holdoff_s);
+        }
+        return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+    }
+
+    if (config->logging.sketch_interval_s < 0.0) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Invalid sketch_interval_s: %.1f (must be positive, or 0 for default)",
+                    config->logging.sketch_interval_s);
+        }
+        return CONFIG_YAML_ERROR_VALIDATION_FAILED;
     }
 
     // Validate battery configuration
-    if (config->battery.coulomb_counting_enabled) {
-        if (config->battery.capacity_ah <= 0.0 || config->battery.capacity_ah > 10000.0) {
+    if (config->battery.soc_save_interval_s < 0.0) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Invalid soc_save_interval_s: %.1f (must be positive, or 0 for default)",
+                    config->battery.soc_save_interval_s);
+        }
+        return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+    }
+
+    // Each pack publishes its results as extra channels, which share the channel limit
+    if (config->channel_count + (size_t)config->battery.pack_count * BATTERY_PACK_CHANNELS > NUM_CHANNELS) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Too many channels with battery packs: %zu channels + %d packs x %d exceeds %d",
+                    config->channel_count, config->battery.pack_count, BATTERY_PACK_CHANNELS, NUM_CHANNELS);
+        }
+        return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+    }
+
+    for (int p = 0; p < config->battery.pack_count; p++) {
+        const BatteryPackConfig* pack = &config->battery.packs[p];
+
+        if (strlen(pack->id) == 0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size, "Battery pack %d has no id", p);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (pack->capacity_ah <= 0.0 || pack->capacity_ah > 10000.0) {
             if (error_message && error_size > 0) {
                 snprintf(error_message, error_size,
-                        "Invalid battery capacity: %.1f Ah (must be 0.1-10000)",
-                        config->battery.capacity_ah);
+                        "Battery '%s': invalid capacity %.1f Ah (must be 0.1-10000)",
+                        pack->id, pack->capacity_ah);
             }
             return CONFIG_YAML_ERROR_VALIDATION_FAILED;
         }
 
-        // Check that battery current channel exists
-        bool current_channel_found = false;
-        for (size_t i = 0; i < config->channel_count; i++) {
-            if (config->channels[i].is_active &&
-                strcmp(config->channels[i].id, config->battery.current_channel_id) == 0) {
-                current_channel_found = true;
-                break;
+        if (!find_active_channel(config, pack->current_channel_id)) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Battery '%s': current channel '%s' not found in active channels",
+                        pack->id, pack->current_channel_id);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (strlen(pack->voltage_channel_id) > 0 && !find_active_channel(config, pack->voltage_channel_id)) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Battery '%s': voltage channel '%s' not found in active channels",
+                        pack->id, pack->voltage_channel_id);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        for (int q = p + 1; q < config->battery.pack_count; q++) {
+            const BatteryPackConfig* other = &config->battery.packs[q];
+            if (strcmp(pack->id, other->id) == 0 || strcmp(pack->state_file, other->state_file) == 0) {
+                if (error_message && error_size > 0) {
+                    snprintf(error_message, error_size,
+                            "Battery packs '%s' and '%s' share an id or state_file", pack->id, other->id);
+                }
+                return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+            }
+        }
+    }
+
+    // Validate energy meters
+    if (config->energy.save_interval_s < 0.0) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Invalid energy save_interval_s: %.1f (must be positive, or 0 for default)",
+                    config->energy.save_interval_s);
+        }
+        return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+    }
+
+    for (int m = 0; m < config->energy.meter_count; m++) {
+        const EnergyMeterConfig* meter = &config->energy.meters[m];
+
+        if (strlen(meter->id) == 0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size, "Energy meter %d has no id", m);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (!find_active_channel(config, meter->voltage_channel_id) ||
+            !find_active_channel(config, meter->current_channel_id)) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Energy meter '%s': voltage channel '%s' and current channel '%s' must be active channels",
+                        meter->id, meter->voltage_channel_id, meter->current_channel_id);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        for (int q = m + 1; q < config->energy.meter_count; q++) {
+            const EnergyMeterConfig* other = &config->energy.meters[q];
+            if (strcmp(meter->id, other->id) == 0 || strcmp(meter->state_file, other->state_file) == 0) {
+                if (error_message && error_size > 0) {
+                    snprintf(error_message, error_size,
+                            "Energy meters '%s' and '%s' share an id or state_file", meter->id, other->id);
+                }
+                return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+            }
+        }
+    }
+
+    // Validate output sinks
+    const struct { const char* name; const SinkConfig* sink; } sinks[] = {
+        { "csv", &config->sinks.csv },
+        { "display", &config->sinks.display },
+        { "mqtt", &config->sinks.mqtt },
+    };
+    for (size_t s = 0; s < sizeof(sinks) / sizeof(sinks[0]); s++) {
+        if (sinks[s].sink->queue_size < 1 || sinks[s].sink->queue_size > SINK_MAX_QUEUE_SIZE ||
+            sinks[s].sink->interval_ms < 0 || sinks[s].sink->interval_ms > SINK_MAX_INTERVAL_MS) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Invalid %s sink: queue_size %d (must be 1-%d), interval_ms %d (must be 0-%d)",
+                        sinks[s].name, sinks[s].sink->queue_size, SINK_MAX_QUEUE_SIZE,
+                        sinks[s].sink->interval_ms, SINK_MAX_INTERVAL_MS);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+    }
+
+    // Validate MQTT output
+    if (config->mqtt.enabled) {
+        const MqttConfig* mqtt = &config->mqtt;
+        const char* problem = NULL;
+        if (strlen(mqtt->host) == 0) {
+            problem = "host is empty";
+        } else if (mqtt->port < 1 || mqtt->port > 65535) {
+            problem = "port must be 1-65535";
+        } else if (strpbrk(mqtt->topic, "+#") || strpbrk(mqtt->backlog_topic, "+#")) {
+            problem = "topics must not contain wildcards";
+        } else if (mqtt->keepalive_s < 0 || mqtt->keepalive_s > 65535) {
+            problem = "keepalive_s must be 0-65535";
+        } else if (mqtt->max_inflight < 1 || mqtt->max_inflight > MQTT_MAX_INFLIGHT) {
+            problem = "max_inflight must be 1-64";
+        } else if (mqtt->ack_timeout_ms < 100 || mqtt->ack_timeout_ms > 60000) {
+            problem = "ack_timeout_ms must be 100-60000";
+        } else if (mqtt->reconnect_max_s < 1 || mqtt->reconnect_max_s > 3600) {
+            problem = "reconnect_max_s must be 1-3600";
+        } else if (strlen(mqtt->password) > 0 && strlen(mqtt->username) == 0) {
+            problem = "password given without username";
+        }
+        if (problem) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size, "Invalid mqtt section: %s", problem);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+    }
+
+    // Validate gateway mode (only used with --gateway)
+    if (config->gateway.port < 1 || config->gateway.port > 65535 ||
+        config->gateway.max_nodes < 1 || config->gateway.max_nodes > GATEWAY_MAX_NODES ||
+        config->gateway.node_lines_per_s < 1 || config->gateway.node_lines_per_s > 1000000) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Invalid gateway section: port %d (must be 1-65535), max_nodes %d (must be 1-%d), "
+                    "node_lines_per_s %d (must be 1-1000000)",
+                    config->gateway.port, config->gateway.max_nodes, GATEWAY_MAX_NODES,
+                    config->gateway.node_lines_per_s);
+        }
+        return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+    }
+
+    // Validate trip odometer
+    if (config->trip.enabled) {
+        const TripConfig* trip = &config->trip;
+        if (trip->min_speed_mps < 0.0 || trip->min_speed_mps > 10.0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Invalid trip min_speed_mps: %.2f (must be 0-10, or 0 for default)", trip->min_speed_mps);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+
+        if (trip->window_s != 0.0 && (trip->window_s < 10.0 || trip->window_s > 900.0)) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Invalid trip window_s: %.1f (must be 10-900, or 0 for default)", trip->window_s);
             }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
         }
 
-        if (!current_channel_found) {
+        bool meter_found = strlen(trip->energy_meter_id) == 0;
+        for (int m = 0; m < config->energy.meter_count && !meter_found; m++) {
+            meter_found = strcmp(config->energy.meters[m].id, trip->energy_meter_id) == 0;
+        }
+        if (!meter_found) {
             if (error_message && error_size > 0) {
                 snprintf(error_message, error_size,
-                        "Battery current channel '%s' not found in active channels",
-                        config->battery.current_channel_id);
+                        "Trip energy_meter '%s' is not a configured energy meter", trip->energy_meter_id);
+            }
+            return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+        }
+    }
+
+    // Validate alarm rules (channels are resolved when the engine is built, so virtual channels qualify)
+    for (int r = 0; r < config->alarms.rule_count; r++) {
+        const AlarmRuleConfig* rule = &config->alarms.rules[r];
+
+        if (strlen(rule->id) == 0 || rule->condition_count == 0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size, "Alarm rule %d ('%s') needs an id and at least one condition",
+                        r, rule->id);
             }
             return CONFIG_YAML_ERROR_VALIDATION_FAILED;
         }
+
+        for (int q = r + 1; q < config->alarms.rule_count; q++) {
+            if (strcmp(rule->id, config->alarms.rules[q].id) == 0) {
+                if (error_message && error_size > 0) {
+                    snprintf(error_message, error_size, "Alarm rule id '%s' is used twice", rule->id);
+                }
+                return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+            }
+        }
+
+        for (int c = 0; c < rule->condition_count; c++) {
+            const AlarmConditionConfig* condition = &rule->conditions[c];
+            if (strlen(condition->channel_id) == 0 || condition->type == ALARM_CONDITION_NONE ||
+                !isfinite(condition->threshold) || (condition->type == ALARM_CONDITION_RATE && condition->threshold <= 0.0) ||
+                !(condition->hysteresis >= 0.0) || !(condition->for_s >= 0.0)) {
+                if (error_message && error_size > 0) {
+                    snprintf(error_message, error_size,
+                            "Alarm rule '%s' condition %d: needs a channel, one of above/below/rate (rate > 0) "
+                            "and non-negative hysteresis and for_s", rule->id, c);
+                }
+                return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+            }
+        }
     }
 
     // Validate hardware configuration
@@ -422,12 +932,349 @@ ConfigYAMLResult config_yaml_validate_hardware(const YAMLAppConfig* config,
     return CONFIG_YAML_SUCCESS;
 }
 
-void config_yaml_free(YAMLAppConfig* config) {
-    if (!config) return;
+ConfigYAMLResult config_yaml_check_reload_compatible(const YAMLAppConfig* current,
+                                                     const YAMLAppConfig* candidate,
+                                                     char* error_message,
+                                                     size_t error_size) {
+    if (!current || !candidate) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size, "Configuration is NULL");
+        }
+        return CONFIG_YAML_ERROR_VALIDATION_FAILED;
+    }
 
-    if (config->channels) {
+    if (strcmp(current->hardware.i2c_bus, candidate->hardware.i2c_bus) != 0) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: i2c_bus changed from '%s' to '%s' (restart required)",
+                    current->hardware.i2c_bus, candidate->hardware.i2c_bus);
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    if (current->hardware.board_count != candidate->hardware.board_count) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: board count changed from %d to %d (restart required)",
+                    current->hardware.board_count, candidate->hardware.board_count);
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    for (int i = 0; i < current->hardware.board_count; i++) {
+        if (current->hardware.boards[i].address != candidate->hardware.boards[i].address) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Structural change: board %d address changed from 0x%02x to 0x%02x (restart required)",
+                        i, current->hardware.boards[i].address, candidate->hardware.boards[i].address);
+            }
+            return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+        }
+    }
+
+    if (current->channel_count != candidate->channel_count) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: channel count changed from %zu to %zu (restart required)",
+                    current->channel_count, candidate->channel_count);
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    for (size_t i = 0; i < current->channel_count; i++) {
+        const Channel* old_ch = &current->channels[i];
+        const Channel* new_ch = &candidate->channels[i];
+
+        if (strcmp(old_ch->id, new_ch->id) != 0 ||
+            old_ch->is_active != new_ch->is_active ||
+            old_ch->board_address != new_ch->board_address ||
+            old_ch->pin != new_ch->pin ||
+            strcmp(old_ch->gain_setting, new_ch->gain_setting) != 0 ||
+            strcmp(old_ch->unit, new_ch->unit) != 0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Structural change: channel %zu ('%s' -> '%s') changed id, unit, board, pin or gain (restart required)",
+                        i, old_ch->id, new_ch->id);
+            }
+            return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+        }
+    }
+
+    if (current->battery.pack_count != candidate->battery.pack_count) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: battery pack count changed from %d to %d (restart required)",
+                    current->battery.pack_count, candidate->battery.pack_count);
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    for (int p = 0; p < current->battery.pack_count; p++) {
+        const BatteryPackConfig* old_pack = &current->battery.packs[p];
+        const BatteryPackConfig* new_pack = &candidate->battery.packs[p];
+
+        if (strcmp(old_pack->id, new_pack->id) != 0 ||
+            strcmp(old_pack->current_channel_id, new_pack->current_channel_id) != 0 ||
+            strcmp(old_pack->voltage_channel_id, new_pack->voltage_channel_id) != 0 ||
+            strcmp(old_pack->state_file, new_pack->state_file) != 0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Structural change: battery pack %d ('%s' -> '%s') changed id, channels or state_file (restart required)",
+                        p, old_pack->id, new_pack->id);
+            }
+            return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+        }
+    }
+
+    if (current->energy.meter_count != candidate->energy.meter_count) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: energy meter count changed from %d to %d (restart required)",
+                    current->energy.meter_count, candidate->energy.meter_count);
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    for (int m = 0; m < current->energy.meter_count; m++) {
+        const EnergyMeterConfig* old_meter = &current->energy.meters[m];
+        const EnergyMeterConfig* new_meter = &candidate->energy.meters[m];
+
+        if (strcmp(old_meter->id, new_meter->id) != 0 ||
+            strcmp(old_meter->voltage_channel_id, new_meter->voltage_channel_id) != 0 ||
+            strcmp(old_meter->current_channel_id, new_meter->current_channel_id) != 0 ||
+            strcmp(old_meter->state_file, new_meter->state_file) != 0) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Structural change: energy meter %d ('%s' -> '%s') changed id, channels or state_file (restart required)",
+                        m, old_meter->id, new_meter->id);
+            }
+            return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+        }
+    }
+
+    // The MQTT connection and session are set up at start-up
+    const MqttConfig* old_mqtt = &current->mqtt;
+    const MqttConfig* new_mqtt = &candidate->mqtt;
+    if (old_mqtt->enabled != new_mqtt->enabled ||
+        strcmp(old_mqtt->host, new_mqtt->host) != 0 ||
+        old_mqtt->port != new_mqtt->port ||
+        strcmp(old_mqtt->client_id, new_mqtt->client_id) != 0 ||
+        strcmp(old_mqtt->username, new_mqtt->username) != 0 ||
+        strcmp(old_mqtt->password, new_mqtt->password) != 0 ||
+        strcmp(old_mqtt->topic, new_mqtt->topic) != 0 ||
+        strcmp(old_mqtt->backlog_topic, new_mqtt->backlog_topic) != 0 ||
+        old_mqtt->format != new_mqtt->format ||
+        old_mqtt->keepalive_s != new_mqtt->keepalive_s ||
+        old_mqtt->max_inflight != new_mqtt->max_inflight ||
+        old_mqtt->ack_timeout_ms != new_mqtt->ack_timeout_ms ||
+        old_mqtt->reconnect_max_s != new_mqtt->reconnect_max_s) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: mqtt section changed (restart required)");
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    if (current->trip.enabled != candidate->trip.enabled ||
+        strcmp(current->trip.energy_meter_id, candidate->trip.energy_meter_id) != 0 ||
+        strcmp(current->trip.state_file, candidate->trip.state_file) != 0) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: trip odometer enabled, energy_meter or state_file changed (restart required)");
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    if (strcmp(current->alarms.hook_command, candidate->alarms.hook_command) != 0 ||
+        strcmp(current->alarms.hook_socket, candidate->alarms.hook_socket) != 0 ||
+        current->alarms.rule_count != candidate->alarms.rule_count) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: alarm hooks or rule count changed (restart required)");
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    for (int r = 0; r < current->alarms.rule_count; r++) {
+        if (!alarm_rules_equal(&current->alarms.rules[r], &candidate->alarms.rules[r])) {
+            if (error_message && error_size > 0) {
+                snprintf(error_message, error_size,
+                        "Structural change: alarm rule %d ('%s' -> '%s') changed (restart required)",
+                        r, current->alarms.rules[r].id, candidate->alarms.rules[r].id);
+            }
+            return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+        }
+    }
+
+    if (current->logging.csv_enabled != candidate->logging.csv_enabled ||
+        strcmp(current->logging.csv_directory, candidate->logging.csv_directory) != 0 ||
+        strcmp(current->logging.sketch_directory, candidate->logging.sketch_directory) != 0) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: logging directories changed (restart required)");
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    // Sink threads, queues and the frame pool are created at start-up
+    if (current->sinks.csv.enabled != candidate->sinks.csv.enabled ||
+        current->sinks.csv.queue_size != candidate->sinks.csv.queue_size ||
+        current->sinks.display.enabled != candidate->sinks.display.enabled ||
+        current->sinks.display.queue_size != candidate->sinks.display.queue_size ||
+        current->sinks.mqtt.enabled != candidate->sinks.mqtt.enabled ||
+        current->sinks.mqtt.queue_size != candidate->sinks.mqtt.queue_size) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: sinks enabled or queue_size changed (restart required)");
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    // The capture ring is sized at start-up
+    if (current->capture.pre_samples != candidate->capture.pre_samples ||
+        current->capture.post_samples != candidate->capture.post_samples ||
+        current->capture.holdoff_s != candidate->capture.holdoff_s ||
+        strcmp(current->capture.directory, candidate->capture.directory) != 0) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: capture window, holdoff or directory changed (restart required)");
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    // Each tier owns a sender thread and offline file created at start-up
+    bool tiers_changed = current->influxdb.tier_count != candidate->influxdb.tier_count ||
+                         current->influxdb.batch_size != candidate->influxdb.batch_size ||
+                         current->influxdb.flush_interval_ms != candidate->influxdb.flush_interval_ms;
+    for (int t = 0; t < current->influxdb.tier_count && !tiers_changed; t++) {
+        const RollupTierConfig* old_tier = &current->influxdb.tiers[t];
+        const RollupTierConfig* new_tier = &candidate->influxdb.tiers[t];
+        tiers_changed = strcmp(old_tier->name, new_tier->name) != 0 ||
+                        strcmp(old_tier->bucket, new_tier->bucket) != 0 ||
+                        old_tier->interval_s != new_tier->interval_s ||
+                        old_tier->batch_size != new_tier->batch_size ||
+                        old_tier->flush_interval_ms != new_tier->flush_interval_ms;
+    }
+    if (tiers_changed) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: InfluxDB batching or rollup tiers changed (restart required)");
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    // The UDP socket of the raw sender is opened at start-up
+    if (current->influxdb.transport != candidate->influxdb.transport ||
+        strcmp(current->influxdb.udp_host, candidate->influxdb.udp_host) != 0 ||
+        current->influxdb.udp_port != candidate->influxdb.udp_port ||
+        current->influxdb.udp_mtu != candidate->influxdb.udp_mtu) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: InfluxDB transport changed (restart required)");
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    if (current->network.socket_server_enabled != candidate->network.socket_server_enabled ||
+        current->network.socket_port != candidate->network.socket_port) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size,
+                    "Structural change: socket server settings changed (restart required)");
+        }
+        return CONFIG_YAML_ERROR_INVALID_STRUCTURE;
+    }
+
+    return CONFIG_YAML_SUCCESS;
+}
+
+void config_yaml_apply_reloadable(YAMLAppConfig* target, const YAMLAppConfig* source) {
+    if (!target || !source) return;
+
+    target->metadata = source->metadata;
+    target->system = source->system;
+    target->influxdb = source->influxdb;
+    target->battery.capacity_ah = source->battery.capacity_ah;
+    for (int p = 0; p < target->battery.pack_count && p < source->battery.pack_count; p++) {
+        target->battery.packs[p].capacity_ah = source->battery.packs[p].capacity_ah;
+    }
+    target->battery.soc_save_interval_s = source->battery.soc_save_interval_s;
+    target->energy.save_interval_s = source->energy.save_interval_s;
+    target->trip.min_speed_mps = source->trip.min_speed_mps;
+    target->trip.window_s = source->trip.window_s;
+    target->network.update_interval_ms = source->network.update_interval_ms;
+    target->logging.sketch_interval_s = source->logging.sketch_interval_s;
+    target->sinks.csv.interval_ms = source->sinks.csv.interval_ms;
+    target->sinks.display.interval_ms = source->sinks.display.interval_ms;
+    target->sinks.mqtt.interval_ms = source->sinks.mqtt.interval_ms;
+    target->capture.upload = source->capture.upload;
+
+    size_t count = (target->channel_count < source->channel_count) ?
+                   target->channel_count : source->channel_count;
+    for (size_t i = 0; i < count; i++) {
+        channel_copy_calibration(&target->channels[i], &source->channels[i]);
+        target->channels[i].filter_alpha = source->channels[i].filter_alpha;
+        target->channels[i].filter_count = source->channels[i].filter_count;
+        memcpy(target->channels[i].filters, source->channels[i].filters, sizeof(target->channels[i].filters));
+        target->channels[i].min_value = source->channels[i].min_value;
+        target->channels[i].max_value = source->channels[i].max_value;
+        target->channels[i].timeout_threshold_s = source->channels[i].timeout_threshold_s;
+        target->channels[i].sample_interval_ms = source->channels[i].sample_interval_ms;
+        target->channels[i].publish_interval_ms = source->channels[i].publish_interval_ms;
+        target->channels[i].stats_window = source->channels[i].stats_window;
+        target->channels[i].stats_window_samples = source->channels[i].stats_window_samples;
+        target->channels[i].publish_value = source->channels[i].publish_value;
+        target->channels[i].stats_quantiles = source->channels[i].stats_quantiles;
+        target->channels[i].trigger_above = source->channels[i].trigger_above;
+        target->channels[i].trigger_below = source->channels[i].trigger_below;
+        target->channels[i].trigger_rate = source->channels[i].trigger_rate;
+        target->channels[i].spectrum_size = source->channels[i].spectrum_size;
+        target->channels[i].spectrum_band_count = source->channels[i].spectrum_band_count;
+        memcpy(target->channels[i].spectrum_band_edges_hz, source->channels[i].spectrum_band_edges_hz,
+               sizeof(target->channels[i].spectrum_band_edges_hz));
+    }
+}
+
+YAMLAppConfig* config_yaml_duplicate(const YAMLAppConfig* config) {
+    if (!config) return NULL;
+
+    YAMLAppConfig* copy = malloc(sizeof(YAMLAppConfig));
+    if (!copy) {
+        fprintf(stderr, "ConfigYAML: Memory allocation failed\n");
+        return NULL;
+    }
+    *copy = *config;
+    copy->channels = NULL;
+    copy->hardware.boards = NULL;
+
+    if (config->channels && config->channel_count > 0) {
+        copy->channels = malloc(config->channel_count * sizeof(Channel));
+        if (!copy->channels) {
+            config_yaml_free(copy);
+            return NULL;
+        }
+        memcpy(copy->channels, config->channels, config->channel_count * sizeof(Channel));
+    }
+
+    if (config->hardware.boards) {
+        copy->hardware.boards = calloc(MAX_BOARDS, sizeof(BoardConfig));
+        if (!copy->hardware.boards) {
+            config_yaml_free(copy);
+            return NULL;
+        }
+        memcpy(copy->hardware.boards, config->hardware.boards,
+               config->hardware.board_count * sizeof(BoardConfig));
+    }
+
+    return copy;
+}
+
+void config_yaml_free(YAMLAppConfig* config) {
+    if (!config) return;
+
+    if (config->channels) {
         free(config->channels);
     }
+    free(config->hardware.boards);
     free(config);
 }
 
@@ -542,8 +1389,24 @@ static bool parse_mapping(YAMLParseContext* ctx) {
             if (!parse_influxdb_section(ctx)) return false;
         } else if (strcmp(key, "logging") == 0) {
             if (!parse_logging_section(ctx)) return false;
+        } else if (strcmp(key, "sinks") == 0) {
+            if (!parse_sinks_section(ctx)) return false;
+        } else if (strcmp(key, "mqtt") == 0) {
+            if (!parse_mqtt_section(ctx)) return false;
+        } else if (strcmp(key, "gateway") == 0) {
+            if (!parse_gateway_section(ctx)) return false;
+        } else if (strcmp(key, "capture") == 0) {
+            if (!parse_capture_section(ctx)) return false;
         } else if (strcmp(key, "battery") == 0) {
             if (!parse_battery_section(ctx)) return false;
+        } else if (strcmp(key, "batteries") == 0) {
+            if (!parse_batteries_section(ctx)) return false;
+        } else if (strcmp(key, "energy") == 0) {
+            if (!parse_energy_section(ctx)) return false;
+        } else if (strcmp(key, "trip") == 0) {
+            if (!parse_trip_section(ctx)) return false;
+        } else if (strcmp(key, "alarms") == 0) {
+            if (!parse_alarms_section(ctx)) return false;
         } else if (strcmp(key, "gps") == 0) {
             if (!parse_gps_section(ctx)) return false;
         } else if (strcmp(key, "network") == 0) {
@@ -678,6 +1541,19 @@ static bool parse_system_section(YAMLParseContext* ctx) {
             if (!get_scalar_int(ctx, &system->main_loop_interval_ms)) return false;
         } else if (strcmp(key, "data_send_interval_ms") == 0) {
             if (!get_scalar_int(ctx, &system->data_send_interval_ms)) return false;
+        } else if (strcmp(key, "resample") == 0) {
+            char mode[32];
+            if (!get_scalar_value(ctx, mode, sizeof(mode))) return false;
+            if (strcmp(mode, "none") == 0) {
+                system->resample = RESAMPLE_NONE;
+            } else if (strcmp(mode, "linear") == 0) {
+                system->resample = RESAMPLE_LINEAR;
+            } else if (strcmp(mode, "quadratic") == 0) {
+                system->resample = RESAMPLE_QUADRATIC;
+            } else {
+                set_parse_error(ctx, "Unknown system.resample mode (use none, linear or quadratic)");
+                return false;
+            }
         } else {
             // Skip unknown system fields
             if (!yaml_parser_parse(parser, event)) return false;
@@ -793,6 +1669,18 @@ static bool parse_single_channel(YAMLParseContext* ctx, Channel* channel) {
             if (!parse_adc_section(ctx, channel)) return false;
         } else if (strcmp(key, "validation") == 0) {
             if (!parse_validation_section(ctx, channel)) return false;
+        } else if (strcmp(key, "statistics") == 0) {
+            if (!parse_statistics_section(ctx, channel)) return false;
+        } else if (strcmp(key, "trigger") == 0) {
+            if (!parse_trigger_section(ctx, channel)) return false;
+        } else if (strcmp(key, "spectrum") == 0) {
+            if (!parse_spectrum_section(ctx, channel)) return false;
+        } else if (strcmp(key, "filters") == 0) {
+            if (!parse_filters_section(ctx, channel)) return false;
+        } else if (strcmp(key, "sample_interval_ms") == 0) {
+            if (!get_scalar_int(ctx, &channel->sample_interval_ms)) return false;
+        } else if (strcmp(key, "publish_interval_ms") == 0) {
+            if (!get_scalar_int(ctx, &channel->publish_interval_ms)) return false;
         } else {
             // Skip unknown channel fields
             if (!yaml_parser_parse(&ctx->parser, &ctx->event)) return false;
@@ -827,208 +1715,1355 @@ static bool parse_calibration_section(YAMLParseContext* ctx, Channel* channel) {
             yaml_event_delete(event);
             break;
         }
-        
+        
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+        
+        if (strcmp(key, "slope") == 0) {
+            if (!get_scalar_double(ctx, &channel->slope)) return false;
+        } else if (strcmp(key, "offset") == 0) {
+            if (!get_scalar_double(ctx, &channel->offset)) return false;
+        } else if (strcmp(key, "type") == 0) {
+            char type[32];
+            if (!get_scalar_value(ctx, type, sizeof(type))) return false;
+
+            if (strcmp(type, "linear") == 0) {
+                channel->calibration_type = CHANNEL_CALIBRATION_LINEAR;
+            } else if (strcmp(type, "polynomial") == 0) {
+                channel->calibration_type = CHANNEL_CALIBRATION_POLYNOMIAL;
+            } else if (strcmp(type, "piecewise") == 0) {
+                channel->calibration_type = CHANNEL_CALIBRATION_PIECEWISE;
+            } else {
+                set_parse_error(ctx, "calibration.type must be 'linear', 'polynomial' or 'piecewise'");
+                return false;
+            }
+        } else if (strcmp(key, "coefficients") == 0) {
+            if (!get_scalar_double_list(ctx, channel->calibration_terms, CHANNEL_MAX_CALIBRATION_TERMS,
+                                        &channel->calibration_term_count)) {
+                return false;
+            }
+        } else if (strcmp(key, "points") == 0) {
+            if (!parse_calibration_points(ctx, channel)) return false;
+        } else if (strcmp(key, "lookup_table") == 0) {
+            if (!get_scalar_bool(ctx, &channel->calibration_lut)) return false;
+        } else {
+            // Skip other calibration fields (r_squared, calibration_points, etc.)
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+    
+    return true;
+}
+
+// Reads piecewise calibration points as [raw, value] pairs, e.g. points: [[1000, -20.0], [5000, 25.0]]
+static bool parse_calibration_points(YAMLParseContext* ctx, Channel* channel) {
+    if (!expect_event_type(ctx, YAML_SEQUENCE_START_EVENT)) return false;
+
+    channel->calibration_point_count = 0;
+    while (true) {
+        if (!yaml_parser_parse(&ctx->parser, &ctx->event)) return false;
+
+        if (ctx->event.type == YAML_SEQUENCE_END_EVENT) {
+            yaml_event_delete(&ctx->event);
+            break;
+        }
+
+        bool is_pair_start = ctx->event.type == YAML_SEQUENCE_START_EVENT;
+        yaml_event_delete(&ctx->event);
+        if (!is_pair_start || channel->calibration_point_count >= CHANNEL_MAX_CALIBRATION_POINTS) {
+            set_parse_error(ctx, "calibration.points must be a list of at most 16 [raw, value] pairs");
+            return false;
+        }
+
+        double pair[2];
+        int values = 0;
+        if (!get_double_list_items(ctx, pair, 2, &values)) return false;
+        if (values != 2) {
+            set_parse_error(ctx, "calibration.points entries must be [raw, value] pairs");
+            return false;
+        }
+        channel->calibration_point_raw[channel->calibration_point_count] = pair[0];
+        channel->calibration_point_value[channel->calibration_point_count] = pair[1];
+        channel->calibration_point_count++;
+    }
+
+    return true;
+}
+
+static bool parse_adc_section(YAMLParseContext* ctx, Channel* channel) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+    
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+        
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+        
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+        
+        if (strcmp(key, "gain") == 0) {
+            if (!get_scalar_value(ctx, channel->gain_setting, sizeof(channel->gain_setting))) return false;
+        } else if (strcmp(key, "filter_alpha") == 0) {
+            if (!get_scalar_double(ctx, &channel->filter_alpha)) return false;
+        } else {
+            // Skip other ADC fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+    
+    return true;
+}
+
+static bool parse_validation_section(YAMLParseContext* ctx, Channel* channel) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+    
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+        
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+        
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+        
+        if (strcmp(key, "min_value") == 0) {
+            if (!get_scalar_double(ctx, &channel->min_value)) return false;
+        } else if (strcmp(key, "max_value") == 0) {
+            if (!get_scalar_double(ctx, &channel->max_value)) return false;
+        } else if (strcmp(key, "timeout_threshold_s") == 0) {
+            if (!get_scalar_double(ctx, &channel->timeout_threshold_s)) return false;
+        } else {
+            // Skip unknown validation fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+    
+    return true;
+}
+
+static bool parse_statistics_section(YAMLParseContext* ctx, Channel* channel) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+    
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+        
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+        
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+        
+        if (strcmp(key, "window") == 0) {
+            char window[32];
+            if (!get_scalar_value(ctx, window, sizeof(window))) return false;
+
+            if (strcmp(window, "tumbling") == 0) {
+                channel->stats_window = CHANNEL_STATS_WINDOW_TUMBLING;
+            } else if (strcmp(window, "sliding") == 0) {
+                channel->stats_window = CHANNEL_STATS_WINDOW_SLIDING;
+            } else if (strcmp(window, "none") == 0) {
+                channel->stats_window = CHANNEL_STATS_WINDOW_NONE;
+            } else {
+                set_parse_error(ctx, "statistics.window must be 'tumbling', 'sliding' or 'none'");
+                return false;
+            }
+        } else if (strcmp(key, "window_samples") == 0) {
+            if (!get_scalar_int(ctx, &channel->stats_window_samples)) return false;
+        } else if (strcmp(key, "publish_value") == 0) {
+            if (!get_scalar_bool(ctx, &channel->publish_value)) return false;
+        } else if (strcmp(key, "quantiles") == 0) {
+            if (!get_scalar_bool(ctx, &channel->stats_quantiles)) return false;
+        } else {
+            // Skip unknown statistics fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+    
+    return true;
+}
+
+static bool parse_trigger_section(YAMLParseContext* ctx, Channel* channel) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+    
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+        
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+        
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+        
+        if (strcmp(key, "above") == 0) {
+            if (!get_scalar_double(ctx, &channel->trigger_above)) return false;
+        } else if (strcmp(key, "below") == 0) {
+            if (!get_scalar_double(ctx, &channel->trigger_below)) return false;
+        } else if (strcmp(key, "rate") == 0) {
+            if (!get_scalar_double(ctx, &channel->trigger_rate)) return false;
+        } else {
+            // Skip unknown trigger fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+    
+    return true;
+}
+
+static bool parse_spectrum_section(YAMLParseContext* ctx, Channel* channel) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+    
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+        
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+        
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+        
+        if (strcmp(key, "size") == 0) {
+            if (!get_scalar_int(ctx, &channel->spectrum_size)) return false;
+        } else if (strcmp(key, "bands_hz") == 0) {
+            if (!parse_band_edges(ctx, channel)) return false;
+        } else {
+            // Skip unknown spectrum fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+    
+    return true;
+}
+
+// Reads a flow or block sequence of band edges, e.g. bands_hz: [0, 5, 20, 50]
+static bool parse_band_edges(YAMLParseContext* ctx, Channel* channel) {
+    int edge_count = 0;
+    if (!get_scalar_double_list(ctx, channel->spectrum_band_edges_hz, CHANNEL_SPECTRUM_MAX_BANDS + 1,
+                                &edge_count)) {
+        return false;
+    }
+
+    channel->spectrum_band_count = edge_count > 0 ? edge_count - 1 : 0;
+    return true;
+}
+
+static bool parse_filters_section(YAMLParseContext* ctx, Channel* channel) {
+    if (!expect_event_type(ctx, YAML_SEQUENCE_START_EVENT)) return false;
+
+    channel->filter_count = 0;
+    while (true) {
+        if (!yaml_parser_parse(&ctx->parser, &ctx->event)) return false;
+
+        if (ctx->event.type == YAML_SEQUENCE_END_EVENT) {
+            yaml_event_delete(&ctx->event);
+            break;
+        }
+
+        if (ctx->event.type != YAML_MAPPING_START_EVENT || channel->filter_count >= CHANNEL_MAX_FILTER_STAGES) {
+            set_parse_error(ctx, "filters must be a list of at most 4 stages");
+            yaml_event_delete(&ctx->event);
+            return false;
+        }
+        yaml_event_delete(&ctx->event);
+
+        if (!parse_filter_stage(ctx, &channel->filters[channel->filter_count])) return false;
+        channel->filter_count++;
+    }
+
+    return true;
+}
+
+// Parses one filters[] entry (its mapping start has been consumed)
+static bool parse_filter_stage(YAMLParseContext* ctx, ChannelFilterStage* stage) {
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+
+    memset(stage, 0, sizeof(*stage));
+    stage->window = 5;
+    stage->threshold = 3.0;
+    stage->q = M_SQRT1_2; // Butterworth
+
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+
+        if (strcmp(key, "type") == 0) {
+            char type[32];
+            if (!get_scalar_value(ctx, type, sizeof(type))) return false;
+
+            if (strcmp(type, "median") == 0) {
+                stage->type = CHANNEL_FILTER_MEDIAN;
+            } else if (strcmp(type, "hampel") == 0) {
+                stage->type = CHANNEL_FILTER_HAMPEL;
+            } else if (strcmp(type, "ema") == 0) {
+                stage->type = CHANNEL_FILTER_EMA;
+            } else if (strcmp(type, "lowpass") == 0) {
+                stage->type = CHANNEL_FILTER_LOWPASS;
+            } else if (strcmp(type, "kalman") == 0) {
+                stage->type = CHANNEL_FILTER_KALMAN;
+            } else {
+                set_parse_error(ctx, "filters[].type must be 'median', 'hampel', 'ema', 'lowpass' or 'kalman'");
+                return false;
+            }
+        } else if (strcmp(key, "window") == 0) {
+            if (!get_scalar_int(ctx, &stage->window)) return false;
+        } else if (strcmp(key, "threshold") == 0) {
+            if (!get_scalar_double(ctx, &stage->threshold)) return false;
+        } else if (strcmp(key, "time_constant_s") == 0) {
+            if (!get_scalar_double(ctx, &stage->time_constant_s)) return false;
+        } else if (strcmp(key, "cutoff_hz") == 0) {
+            if (!get_scalar_double(ctx, &stage->cutoff_hz)) return false;
+        } else if (strcmp(key, "q") == 0) {
+            if (!get_scalar_double(ctx, &stage->q)) return false;
+        } else if (strcmp(key, "process_noise") == 0) {
+            if (!get_scalar_double(ctx, &stage->process_noise)) return false;
+        } else if (strcmp(key, "measurement_noise") == 0) {
+            if (!get_scalar_double(ctx, &stage->measurement_noise)) return false;
+        } else {
+            // Skip unknown filter fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+
+    if (stage->type == 0) {
+        set_parse_error(ctx, "filters[] entry without a type");
+        return false;
+    }
+    return true;
+}
+
+static bool parse_influxdb_section(YAMLParseContext* ctx) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+    
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    InfluxDBConfig* influxdb = &ctx->config->influxdb;
+    
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+        
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+        
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+        
+        if (strcmp(key, "url") == 0) {
+            if (!get_scalar_value(ctx, influxdb->url, sizeof(influxdb->url))) return false;
+        } else if (strcmp(key, "bucket") == 0) {
+            if (!get_scalar_value(ctx, influxdb->bucket, sizeof(influxdb->bucket))) return false;
+        } else if (strcmp(key, "org") == 0) {
+            if (!get_scalar_value(ctx, influxdb->org, sizeof(influxdb->org))) return false;
+        } else if (strcmp(key, "token") == 0) {
+            if (!get_scalar_value(ctx, influxdb->token, sizeof(influxdb->token))) return false;
+        } else if (strcmp(key, "batch_size") == 0) {
+            if (!get_scalar_int(ctx, &influxdb->batch_size)) return false;
+        } else if (strcmp(key, "flush_interval_ms") == 0) {
+            if (!get_scalar_int(ctx, &influxdb->flush_interval_ms)) return false;
+        } else if (strcmp(key, "transport") == 0) {
+            char transport[32];
+            if (!get_scalar_value(ctx, transport, sizeof(transport))) return false;
+            if (strcmp(transport, "http") == 0) {
+                influxdb->transport = INFLUX_TRANSPORT_HTTP;
+            } else if (strcmp(transport, "udp") == 0) {
+                influxdb->transport = INFLUX_TRANSPORT_UDP;
+            } else {
+                set_parse_error(ctx, "Unknown influxdb.transport (use http or udp)");
+                return false;
+            }
+        } else if (strcmp(key, "udp_host") == 0) {
+            if (!get_scalar_value(ctx, influxdb->udp_host, sizeof(influxdb->udp_host))) return false;
+        } else if (strcmp(key, "udp_port") == 0) {
+            if (!get_scalar_int(ctx, &influxdb->udp_port)) return false;
+        } else if (strcmp(key, "udp_mtu") == 0) {
+            if (!get_scalar_int(ctx, &influxdb->udp_mtu)) return false;
+        } else if (strcmp(key, "gzip") == 0) {
+            if (!get_scalar_bool(ctx, &influxdb->gzip)) return false;
+        } else if (strcmp(key, "tiers") == 0) {
+            if (!parse_rollup_tiers(ctx, influxdb)) return false;
+        } else {
+            // Skip other InfluxDB fields (measurement, tags, etc.)
+            if (!yaml_parser_parse(parser, event)) return false;
+            if (event->type == YAML_MAPPING_START_EVENT) {
+                yaml_event_delete(event);
+                if (!skip_mapping(ctx)) return false;
+            } else {
+                yaml_event_delete(event);
+            }
+        }
+    }
+    
+    return true;
+}
+
+static bool parse_rollup_tiers(YAMLParseContext* ctx, InfluxDBConfig* influxdb) {
+    if (!expect_event_type(ctx, YAML_SEQUENCE_START_EVENT)) return false;
+
+    while (true) {
+        if (!yaml_parser_parse(&ctx->parser, &ctx->event)) return false;
+
+        if (ctx->event.type == YAML_SEQUENCE_END_EVENT) {
+            yaml_event_delete(&ctx->event);
+            break;
+        }
+
+        if (ctx->event.type != YAML_MAPPING_START_EVENT) {
+            set_parse_error(ctx, "Expected mapping in influxdb.tiers sequence");
+            yaml_event_delete(&ctx->event);
+            return false;
+        }
+        yaml_event_delete(&ctx->event);
+
+        if (influxdb->tier_count >= MAX_ROLLUP_TIERS) {
+            set_parse_error(ctx, "Too many rollup tiers (maximum is 4)");
+            return false;
+        }
+
+        if (!parse_single_rollup_tier(ctx, &influxdb->tiers[influxdb->tier_count])) return false;
+        influxdb->tier_count++;
+    }
+
+    return true;
+}
+
+static bool parse_single_rollup_tier(YAMLParseContext* ctx, RollupTierConfig* tier) {
+    memset(tier, 0, sizeof(*tier));
+
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+
+        if (strcmp(key, "name") == 0) {
+            if (!get_scalar_value(ctx, tier->name, sizeof(tier->name))) return false;
+        } else if (strcmp(key, "interval_s") == 0) {
+            if (!get_scalar_double(ctx, &tier->interval_s)) return false;
+        } else if (strcmp(key, "bucket") == 0) {
+            if (!get_scalar_value(ctx, tier->bucket, sizeof(tier->bucket))) return false;
+        } else if (strcmp(key, "batch_size") == 0) {
+            if (!get_scalar_int(ctx, &tier->batch_size)) return false;
+        } else if (strcmp(key, "flush_interval_ms") == 0) {
+            if (!get_scalar_int(ctx, &tier->flush_interval_ms)) return false;
+        } else {
+            // Skip other tier fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+
+    return true;
+}
+
+static bool parse_logging_section(YAMLParseContext* ctx) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+    
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    LoggingConfig* logging = &ctx->config->logging;
+    
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+        
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+        
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+        
+        if (strcmp(key, "csv_enabled") == 0) {
+            if (!get_scalar_bool(ctx, &logging->csv_enabled)) return false;
+        } else if (strcmp(key, "csv_directory") == 0) {
+            if (!get_scalar_value(ctx, logging->csv_directory, sizeof(logging->csv_directory))) return false;
+        } else if (strcmp(key, "sketch_directory") == 0) {
+            if (!get_scalar_value(ctx, logging->sketch_directory, sizeof(logging->sketch_directory))) return false;
+        } else if (strcmp(key, "sketch_interval_s") == 0) {
+            if (!get_scalar_double(ctx, &logging->sketch_interval_s)) return false;
+        } else {
+            // Skip other logging fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+    
+    return true;
+}
+
+static bool parse_sinks_section(YAMLParseContext* ctx) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    SinksConfig* sinks = &ctx->config->sinks;
+
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+
+        if (strcmp(key, "csv") == 0) {
+            if (!parse_sink(ctx, &sinks->csv)) return false;
+        } else if (strcmp(key, "display") == 0) {
+            if (!parse_sink(ctx, &sinks->display)) return false;
+        } else if (strcmp(key, "mqtt") == 0) {
+            if (!parse_sink(ctx, &sinks->mqtt)) return false;
+        } else {
+            set_parse_error(ctx, "Unknown sink (expected csv, display or mqtt)");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool parse_sink(YAMLParseContext* ctx, SinkConfig* sink) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+
+        if (strcmp(key, "enabled") == 0) {
+            if (!get_scalar_bool(ctx, &sink->enabled)) return false;
+        } else if (strcmp(key, "queue_size") == 0) {
+            if (!get_scalar_int(ctx, &sink->queue_size)) return false;
+        } else if (strcmp(key, "interval_ms") == 0) {
+            if (!get_scalar_int(ctx, &sink->interval_ms)) return false;
+        } else {
+            // Skip other sink fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+
+    return true;
+}
+
+static bool parse_mqtt_section(YAMLParseContext* ctx) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    MqttConfig* mqtt = &ctx->config->mqtt;
+    mqtt->enabled = true;
+
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+
+        if (strcmp(key, "enabled") == 0) {
+            if (!get_scalar_bool(ctx, &mqtt->enabled)) return false;
+        } else if (strcmp(key, "host") == 0) {
+            if (!get_scalar_value(ctx, mqtt->host, sizeof(mqtt->host))) return false;
+        } else if (strcmp(key, "port") == 0) {
+            if (!get_scalar_int(ctx, &mqtt->port)) return false;
+        } else if (strcmp(key, "client_id") == 0) {
+            if (!get_scalar_value(ctx, mqtt->client_id, sizeof(mqtt->client_id))) return false;
+        } else if (strcmp(key, "username") == 0) {
+            if (!get_scalar_value(ctx, mqtt->username, sizeof(mqtt->username))) return false;
+        } else if (strcmp(key, "password") == 0) {
+            if (!get_scalar_value(ctx, mqtt->password, sizeof(mqtt->password))) return false;
+        } else if (strcmp(key, "topic") == 0) {
+            if (!get_scalar_value(ctx, mqtt->topic, sizeof(mqtt->topic))) return false;
+        } else if (strcmp(key, "backlog_topic") == 0) {
+            if (!get_scalar_value(ctx, mqtt->backlog_topic, sizeof(mqtt->backlog_topic))) return false;
+        } else if (strcmp(key, "format") == 0) {
+            char format[32];
+            if (!get_scalar_value(ctx, format, sizeof(format))) return false;
+            if (strcmp(format, "line") == 0) {
+                mqtt->format = MQTT_FORMAT_LINE;
+            } else if (strcmp(format, "binary") == 0) {
+                mqtt->format = MQTT_FORMAT_BINARY;
+            } else {
+                set_parse_error(ctx, "Unknown mqtt.format (use line or binary)");
+                return false;
+            }
+        } else if (strcmp(key, "keepalive_s") == 0) {
+            if (!get_scalar_int(ctx, &mqtt->keepalive_s)) return false;
+        } else if (strcmp(key, "max_inflight") == 0) {
+            if (!get_scalar_int(ctx, &mqtt->max_inflight)) return false;
+        } else if (strcmp(key, "ack_timeout_ms") == 0) {
+            if (!get_scalar_int(ctx, &mqtt->ack_timeout_ms)) return false;
+        } else if (strcmp(key, "reconnect_max_s") == 0) {
+            if (!get_scalar_int(ctx, &mqtt->reconnect_max_s)) return false;
+        } else {
+            // Skip other mqtt fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+
+    return true;
+}
+
+static bool parse_gateway_section(YAMLParseContext* ctx) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    GatewayConfig* gateway = &ctx->config->gateway;
+
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+
+        if (strcmp(key, "port") == 0) {
+            if (!get_scalar_int(ctx, &gateway->port)) return false;
+        } else if (strcmp(key, "max_nodes") == 0) {
+            if (!get_scalar_int(ctx, &gateway->max_nodes)) return false;
+        } else if (strcmp(key, "node_lines_per_s") == 0) {
+            if (!get_scalar_int(ctx, &gateway->node_lines_per_s)) return false;
+        } else {
+            // Skip other gateway fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+
+    return true;
+}
+
+static bool parse_capture_section(YAMLParseContext* ctx) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+    
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    CaptureConfig* capture = &ctx->config->capture;
+    
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+        
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+        
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+        
+        if (strcmp(key, "pre_samples") == 0) {
+            if (!get_scalar_int(ctx, &capture->pre_samples)) return false;
+        } else if (strcmp(key, "post_samples") == 0) {
+            if (!get_scalar_int(ctx, &capture->post_samples)) return false;
+        } else if (strcmp(key, "holdoff_s") == 0) {
+            if (!get_scalar_double(ctx, &capture->holdoff_s)) return false;
+        } else if (strcmp(key, "directory") == 0) {
+            if (!get_scalar_value(ctx, capture->directory, sizeof(capture->directory))) return false;
+        } else if (strcmp(key, "upload") == 0) {
+            if (!get_scalar_bool(ctx, &capture->upload)) return false;
+        } else {
+            // Skip other capture fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+    
+    return true;
+}
+
+static bool parse_battery_section(YAMLParseContext* ctx) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+    
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    BatteryConfig* battery = &ctx->config->battery;
+    
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+        
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+        
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+        
+        if (strcmp(key, "coulomb_counting_enabled") == 0) {
+            if (!get_scalar_bool(ctx, &battery->coulomb_counting_enabled)) return false;
+        } else if (strcmp(key, "capacity_ah") == 0) {
+            if (!get_scalar_double(ctx, &battery->capacity_ah)) return false;
+        } else if (strcmp(key, "current_channel_id") == 0) {
+            if (!get_scalar_value(ctx, battery->current_channel_id, sizeof(battery->current_channel_id))) return false;
+        } else if (strcmp(key, "soc_save_interval_s") == 0) {
+            if (!get_scalar_double(ctx, &battery->soc_save_interval_s)) return false;
+        } else {
+            // Skip other battery fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+    
+    return true;
+}
+
+static bool parse_batteries_section(YAMLParseContext* ctx) {
+    if (!expect_event_type(ctx, YAML_SEQUENCE_START_EVENT)) return false;
+
+    BatteryConfig* battery = &ctx->config->battery;
+
+    while (true) {
+        if (!yaml_parser_parse(&ctx->parser, &ctx->event)) return false;
+
+        if (ctx->event.type == YAML_SEQUENCE_END_EVENT) {
+            yaml_event_delete(&ctx->event);
+            break;
+        }
+
+        if (ctx->event.type != YAML_MAPPING_START_EVENT) {
+            set_parse_error(ctx, "Expected mapping in batteries sequence");
+            yaml_event_delete(&ctx->event);
+            return false;
+        }
+        yaml_event_delete(&ctx->event);
+
+        if (battery->pack_count >= MAX_BATTERY_PACKS) {
+            set_parse_error(ctx, "Too many battery packs (maximum is 4)");
+            return false;
+        }
+
+        if (!parse_single_battery_pack(ctx, &battery->packs[battery->pack_count])) return false;
+        battery->pack_count++;
+    }
+
+    return true;
+}
+
+static bool parse_single_battery_pack(YAMLParseContext* ctx, BatteryPackConfig* pack) {
+    memset(pack, 0, sizeof(*pack));
+
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+
+        if (!get_current_scalar_key(ctx, key, sizeof(key))) {
+            yaml_event_delete(event);
+            return false;
+        }
+        yaml_event_delete(event);
+
+        if (strcmp(key, "id") == 0) {
+            if (!get_scalar_value(ctx, pack->id, sizeof(pack->id))) return false;
+        } else if (strcmp(key, "capacity_ah") == 0) {
+            if (!get_scalar_double(ctx, &pack->capacity_ah)) return false;
+        } else if (strcmp(key, "current_channel_id") == 0) {
+            if (!get_scalar_value(ctx, pack->current_channel_id, sizeof(pack->current_channel_id))) return false;
+        } else if (strcmp(key, "voltage_channel_id") == 0) {
+            if (!get_scalar_value(ctx, pack->voltage_channel_id, sizeof(pack->voltage_channel_id))) return false;
+        } else if (strcmp(key, "state_file") == 0) {
+            if (!get_scalar_value(ctx, pack->state_file, sizeof(pack->state_file))) return false;
+        } else {
+            // Skip other pack fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
+    }
+
+    return true;
+}
+
+// Turns the single-battery fields into a pack when no `batteries:` list is given,
+// and fills in default state files.
+static void normalize_battery_packs(BatteryConfig* battery) {
+    if (battery->pack_count == 0 && battery->coulomb_counting_enabled) {
+        BatteryPackConfig* pack = &battery->packs[0];
+        memset(pack, 0, sizeof(*pack));
+        snprintf(pack->id, sizeof(pack->id), "%s", BATTERY_LEGACY_PACK_ID);
+        pack->capacity_ah = battery->capacity_ah;
+        memcpy(pack->current_channel_id, battery->current_channel_id, sizeof(pack->current_channel_id));
+        snprintf(pack->state_file, sizeof(pack->state_file), "%s", BATTERY_LEGACY_STATE_FILE);
+        battery->pack_count = 1;
+    }
+
+    for (int p = 0; p < battery->pack_count; p++) {
+        BatteryPackConfig* pack = &battery->packs[p];
+        if (strlen(pack->state_file) == 0) {
+            char id[BATTERY_PACK_ID_SIZE];
+            memcpy(id, pack->id, sizeof(id));
+            snprintf(pack->state_file, sizeof(pack->state_file), "logs/soc_%s.bin", id);
+        }
+    }
+
+    battery->coulomb_counting_enabled = battery->pack_count > 0;
+}
+
+static bool parse_energy_section(YAMLParseContext* ctx) {
+    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
+
+    char key[256];
+    yaml_parser_t* parser = &ctx->parser;
+    yaml_event_t* event = &ctx->event;
+    EnergyConfig* energy = &ctx->config->energy;
+
+    while (true) {
+        if (!yaml_parser_parse(parser, event)) return false;
+
+        if (event->type == YAML_MAPPING_END_EVENT) {
+            yaml_event_delete(event);
+            break;
+        }
+
         if (!get_current_scalar_key(ctx, key, sizeof(key))) {
             yaml_event_delete(event);
             return false;
         }
         yaml_event_delete(event);
-        
-        if (strcmp(key, "slope") == 0) {
-            if (!get_scalar_double(ctx, &channel->slope)) return false;
-        } else if (strcmp(key, "offset") == 0) {
-            if (!get_scalar_double(ctx, &channel->offset)) return false;
+
+        if (strcmp(key, "save_interval_s") == 0) {
+            if (!get_scalar_double(ctx, &energy->save_interval_s)) return false;
+        } else if (strcmp(key, "meters") == 0) {
+            if (!parse_energy_meters(ctx, energy)) return false;
         } else {
-            // Skip other calibration fields (r_squared, calibration_points, etc.)
+            // Skip other energy fields
             if (!yaml_parser_parse(parser, event)) return false;
             yaml_event_delete(event);
         }
     }
-    
+
     return true;
 }
 
-static bool parse_adc_section(YAMLParseContext* ctx, Channel* channel) {
-    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
-    
+static bool parse_energy_meters(YAMLParseContext* ctx, EnergyConfig* energy) {
+    if (!expect_event_type(ctx, YAML_SEQUENCE_START_EVENT)) return false;
+
+    while (true) {
+        if (!yaml_parser_parse(&ctx->parser, &ctx->event)) return false;
+
+        if (ctx->event.type == YAML_SEQUENCE_END_EVENT) {
+            yaml_event_delete(&ctx->event);
+            break;
+        }
+
+        if (ctx->event.type != YAML_MAPPING_START_EVENT) {
+            set_parse_error(ctx, "Expected mapping in energy.meters sequence");
+            yaml_event_delete(&ctx->event);
+            return false;
+        }
+        yaml_event_delete(&ctx->event);
+
+        if (energy->meter_count >= MAX_ENERGY_METERS) {
+            set_parse_error(ctx, "Too many energy meters (maximum is 8)");
+            return false;
+        }
+
+        if (!parse_single_energy_meter(ctx, &energy->meters[energy->meter_count])) return false;
+        energy->meter_count++;
+    }
+
+    return true;
+}
+
+static bool parse_single_energy_meter(YAMLParseContext* ctx, EnergyMeterConfig* meter) {
+    memset(meter, 0, sizeof(*meter));
+
     char key[256];
     yaml_parser_t* parser = &ctx->parser;
     yaml_event_t* event = &ctx->event;
-    
+
     while (true) {
         if (!yaml_parser_parse(parser, event)) return false;
-        
+
         if (event->type == YAML_MAPPING_END_EVENT) {
             yaml_event_delete(event);
             break;
         }
-        
+
         if (!get_current_scalar_key(ctx, key, sizeof(key))) {
             yaml_event_delete(event);
             return false;
         }
         yaml_event_delete(event);
-        
-        if (strcmp(key, "gain") == 0) {
-            if (!get_scalar_value(ctx, channel->gain_setting, sizeof(channel->gain_setting))) return false;
-        } else if (strcmp(key, "filter_alpha") == 0) {
-            if (!get_scalar_double(ctx, &channel->filter_alpha)) return false;
+
+        if (strcmp(key, "id") == 0) {
+            if (!get_scalar_value(ctx, meter->id, sizeof(meter->id))) return false;
+        } else if (strcmp(key, "voltage_channel_id") == 0) {
+            if (!get_scalar_value(ctx, meter->voltage_channel_id, sizeof(meter->voltage_channel_id))) return false;
+        } else if (strcmp(key, "current_channel_id") == 0) {
+            if (!get_scalar_value(ctx, meter->current_channel_id, sizeof(meter->current_channel_id))) return false;
+        } else if (strcmp(key, "state_file") == 0) {
+            if (!get_scalar_value(ctx, meter->state_file, sizeof(meter->state_file))) return false;
         } else {
-            // Skip other ADC fields
+            // Skip other meter fields
             if (!yaml_parser_parse(parser, event)) return false;
             yaml_event_delete(event);
         }
     }
-    
+
     return true;
 }
 
-static bool parse_validation_section(YAMLParseContext* ctx, Channel* channel) {
+static bool parse_trip_section(YAMLParseContext* ctx) {
     if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
-    
+
     char key[256];
     yaml_parser_t* parser = &ctx->parser;
     yaml_event_t* event = &ctx->event;
-    
+    TripConfig* trip = &ctx->config->trip;
+    trip->enabled = true;
+
     while (true) {
         if (!yaml_parser_parse(parser, event)) return false;
-        
+
         if (event->type == YAML_MAPPING_END_EVENT) {
             yaml_event_delete(event);
             break;
         }
-        
+
         if (!get_current_scalar_key(ctx, key, sizeof(key))) {
             yaml_event_delete(event);
             return false;
         }
         yaml_event_delete(event);
-        
-        // Validation fields not currently stored in Channel struct
-        // Skip all validation fields for now
-        if (!yaml_parser_parse(parser, event)) return false;
-        yaml_event_delete(event);
+
+        if (strcmp(key, "enabled") == 0) {
+            if (!get_scalar_bool(ctx, &trip->enabled)) return false;
+        } else if (strcmp(key, "energy_meter") == 0) {
+            if (!get_scalar_value(ctx, trip->energy_meter_id, sizeof(trip->energy_meter_id))) return false;
+        } else if (strcmp(key, "min_speed_mps") == 0) {
+            if (!get_scalar_double(ctx, &trip->min_speed_mps)) return false;
+        } else if (strcmp(key, "window_s") == 0) {
+            if (!get_scalar_double(ctx, &trip->window_s)) return false;
+        } else if (strcmp(key, "state_file") == 0) {
+            if (!get_scalar_value(ctx, trip->state_file, sizeof(trip->state_file))) return false;
+        } else {
+            // Skip other trip fields
+            if (!yaml_parser_parse(parser, event)) return false;
+            yaml_event_delete(event);
+        }
     }
-    
+
     return true;
 }
 
-static bool parse_influxdb_section(YAMLParseContext* ctx) {
+static bool parse_alarms_section(YAMLParseContext* ctx) {
     if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
-    
+
     char key[256];
     yaml_parser_t* parser = &ctx->parser;
     yaml_event_t* event = &ctx->event;
-    InfluxDBConfig* influxdb = &ctx->config->influxdb;
-    
+    AlarmConfig* alarms = &ctx->config->alarms;
+
     while (true) {
         if (!yaml_parser_parse(parser, event)) return false;
-        
+
         if (event->type == YAML_MAPPING_END_EVENT) {
             yaml_event_delete(event);
             break;
         }
-        
+
         if (!get_current_scalar_key(ctx, key, sizeof(key))) {
             yaml_event_delete(event);
             return false;
         }
         yaml_event_delete(event);
-        
-        if (strcmp(key, "url") == 0) {
-            if (!get_scalar_value(ctx, influxdb->url, sizeof(influxdb->url))) return false;
-        } else if (strcmp(key, "bucket") == 0) {
-            if (!get_scalar_value(ctx, influxdb->bucket, sizeof(influxdb->bucket))) return false;
-        } else if (strcmp(key, "org") == 0) {
-            if (!get_scalar_value(ctx, influxdb->org, sizeof(influxdb->org))) return false;
-        } else if (strcmp(key, "token") == 0) {
-            if (!get_scalar_value(ctx, influxdb->token, sizeof(influxdb->token))) return false;
+
+        if (strcmp(key, "hook_command") == 0) {
+            if (!get_scalar_value(ctx, alarms->hook_command, sizeof(alarms->hook_command))) return false;
+        } else if (strcmp(key, "hook_socket") == 0) {
+            if (!get_scalar_value(ctx, alarms->hook_socket, sizeof(alarms->hook_socket))) return false;
+        } else if (strcmp(key, "rules") == 0) {
+            if (!parse_alarm_rules(ctx, alarms)) return false;
         } else {
-            // Skip other InfluxDB fields (measurement, tags, etc.)
+            // Skip other alarm fields
             if (!yaml_parser_parse(parser, event)) return false;
-            if (event->type == YAML_MAPPING_START_EVENT) {
-                yaml_event_delete(event);
-                if (!skip_mapping(ctx)) return false;
-            } else {
-                yaml_event_delete(event);
-            }
+            yaml_event_delete(event);
         }
     }
-    
+
     return true;
 }
 
-static bool parse_logging_section(YAMLParseContext* ctx) {
-    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
-    
+static bool parse_alarm_rules(YAMLParseContext* ctx, AlarmConfig* alarms) {
+    if (!expect_event_type(ctx, YAML_SEQUENCE_START_EVENT)) return false;
+
+    while (true) {
+        if (!yaml_parser_parse(&ctx->parser, &ctx->event)) return false;
+
+        if (ctx->event.type == YAML_SEQUENCE_END_EVENT) {
+            yaml_event_delete(&ctx->event);
+            break;
+        }
+
+        if (ctx->event.type != YAML_MAPPING_START_EVENT) {
+            set_parse_error(ctx, "Expected mapping in alarms.rules sequence");
+            yaml_event_delete(&ctx->event);
+            return false;
+        }
+        yaml_event_delete(&ctx->event);
+
+        if (alarms->rule_count >= MAX_ALARM_RULES) {
+            set_parse_error(ctx, "Too many alarm rules (maximum is 32)");
+            return false;
+        }
+
+        if (!parse_single_alarm_rule(ctx, &alarms->rules[alarms->rule_count])) return false;
+        alarms->rule_count++;
+    }
+
+    return true;
+}
+
+static bool parse_single_alarm_rule(YAMLParseContext* ctx, AlarmRuleConfig* rule) {
+    memset(rule, 0, sizeof(*rule));
+    rule->severity = ALARM_SEVERITY_WARNING;
+
     char key[256];
+    char value[32];
     yaml_parser_t* parser = &ctx->parser;
     yaml_event_t* event = &ctx->event;
-    LoggingConfig* logging = &ctx->config->logging;
-    
+
     while (true) {
         if (!yaml_parser_parse(parser, event)) return false;
-        
+
         if (event->type == YAML_MAPPING_END_EVENT) {
             yaml_event_delete(event);
             break;
         }
-        
+
         if (!get_current_scalar_key(ctx, key, sizeof(key))) {
             yaml_event_delete(event);
             return false;
         }
         yaml_event_delete(event);
-        
-        if (strcmp(key, "csv_enabled") == 0) {
-            if (!get_scalar_bool(ctx, &logging->csv_enabled)) return false;
-        } else if (strcmp(key, "csv_directory") == 0) {
-            if (!get_scalar_value(ctx, logging->csv_directory, sizeof(logging->csv_directory))) return false;
+
+        if (strcmp(key, "id") == 0) {
+            if (!get_scalar_value(ctx, rule->id, sizeof(rule->id))) return false;
+        } else if (strcmp(key, "severity") == 0) {
+            if (!get_scalar_value(ctx, value, sizeof(value))) return false;
+            if (strcmp(value, "info") == 0) {
+                rule->severity = ALARM_SEVERITY_INFO;
+            } else if (strcmp(value, "warning") == 0) {
+                rule->severity = ALARM_SEVERITY_WARNING;
+            } else if (strcmp(value, "critical") == 0) {
+                rule->severity = ALARM_SEVERITY_CRITICAL;
+            } else {
+                set_parse_error(ctx, "Unknown alarm severity (use info, warning or critical)");
+                return false;
+            }
+        } else if (strcmp(key, "combine") == 0) {
+            if (!get_scalar_value(ctx, value, sizeof(value))) return false;
+            if (strcmp(value, "all") != 0 && strcmp(value, "any") != 0) {
+                set_parse_error(ctx, "Unknown alarm combine mode (use all or any)");
+                return false;
+            }
+            rule->any = strcmp(value, "any") == 0;
+        } else if (strcmp(key, "conditions") == 0) {
+            if (!parse_alarm_conditions(ctx, rule)) return false;
         } else {
-            // Skip other logging fields
+            // Skip other rule fields
             if (!yaml_parser_parse(parser, event)) return false;
             yaml_event_delete(event);
         }
     }
-    
+
     return true;
 }
 
-static bool parse_battery_section(YAMLParseContext* ctx) {
-    if (!expect_event_type(ctx, YAML_MAPPING_START_EVENT)) return false;
-    
+static bool parse_alarm_conditions(YAMLParseContext* ctx, AlarmRuleConfig* rule) {
+    if (!expect_event_type(ctx, YAML_SEQUENCE_START_EVENT)) return false;
+
+    while (true) {
+        if (!yaml_parser_parse(&ctx->parser, &ctx->event)) return false;
+
+        if (ctx->event.type == YAML_SEQUENCE_END_EVENT) {
+            yaml_event_delete(&ctx->event);
+            break;
+        }
+
+        if (ctx->event.type != YAML_MAPPING_START_EVENT) {
+            set_parse_error(ctx, "Expected mapping in alarm conditions sequence");
+            yaml_event_delete(&ctx->event);
+            return false;
+        }
+        yaml_event_delete(&ctx->event);
+
+        if (rule->condition_count >= MAX_ALARM_CONDITIONS) {
+            set_parse_error(ctx, "Too many conditions in an alarm rule (maximum is 4)");
+            return false;
+        }
+
+        if (!parse_single_alarm_condition(ctx, &rule->conditions[rule->condition_count])) return false;
+        rule->condition_count++;
+    }
+
+    return true;
+}
+
+static bool parse_single_alarm_condition(YAMLParseContext* ctx, AlarmConditionConfig* condition) {
+    memset(condition, 0, sizeof(*condition));
+    condition->type = ALARM_CONDITION_NONE;
+
     char key[256];
     yaml_parser_t* parser = &ctx->parser;
     yaml_event_t* event = &ctx->event;
-    BatteryConfig* battery = &ctx->config->battery;
-    
+
     while (true) {
         if (!yaml_parser_parse(parser, event)) return false;
-        
+
         if (event->type == YAML_MAPPING_END_EVENT) {
             yaml_event_delete(event);
             break;
         }
-        
+
         if (!get_current_scalar_key(ctx, key, sizeof(key))) {
             yaml_event_delete(event);
             return false;
         }
         yaml_event_delete(event);
-        
-        if (strcmp(key, "coulomb_counting_enabled") == 0) {
-            if (!get_scalar_bool(ctx, &battery->coulomb_counting_enabled)) return false;
-        } else if (strcmp(key, "capacity_ah") == 0) {
-            if (!get_scalar_double(ctx, &battery->capacity_ah)) return false;
-        } else if (strcmp(key, "current_channel_id") == 0) {
-            if (!get_scalar_value(ctx, battery->current_channel_id, sizeof(battery->current_channel_id))) return false;
+
+        AlarmConditionType type = ALARM_CONDITION_NONE;
+        if (strcmp(key, "above") == 0) type = ALARM_CONDITION_ABOVE;
+        if (strcmp(key, "below") == 0) type = ALARM_CONDITION_BELOW;
+        if (strcmp(key, "rate") == 0) type = ALARM_CONDITION_RATE;
+
+        if (type != ALARM_CONDITION_NONE) {
+            if (condition->type != ALARM_CONDITION_NONE) {
+                set_parse_error(ctx, "An alarm condition takes exactly one of above, below or rate");
+                return false;
+            }
+            condition->type = type;
+            if (!get_scalar_double(ctx, &condition->threshold)) return false;
+        } else if (strcmp(key, "channel") == 0) {
+            if (!get_scalar_value(ctx, condition->channel_id, sizeof(condition->channel_id))) return false;
+        } else if (strcmp(key, "hysteresis") == 0) {
+            if (!get_scalar_double(ctx, &condition->hysteresis)) return false;
+        } else if (strcmp(key, "for_s") == 0) {
+            if (!get_scalar_double(ctx, &condition->for_s)) return false;
         } else {
-            // Skip other battery fields
+            // Skip other condition fields
             if (!yaml_parser_parse(parser, event)) return false;
             yaml_event_delete(event);
         }
     }
-    
+
+    return true;
+}
+
+// Fills in default state files
+static void normalize_energy_meters(EnergyConfig* energy) {
+    for (int m = 0; m < energy->meter_count; m++) {
+        EnergyMeterConfig* meter = &energy->meters[m];
+        if (strlen(meter->state_file) == 0) {
+            char id[ENERGY_METER_ID_SIZE];
+            memcpy(id, meter->id, sizeof(id));
+            snprintf(meter->state_file, sizeof(meter->state_file), "logs/energy_%s.bin", id);
+        }
+    }
+}
+
+// Default topics and a client id unique to this device, so the broker resumes the same session
+static void normalize_mqtt(MqttConfig* mqtt) {
+    if (strlen(mqtt->topic) == 0) {
+        snprintf(mqtt->topic, sizeof(mqtt->topic), "%s", MQTT_DEFAULT_TOPIC);
+    }
+    if (strlen(mqtt->backlog_topic) == 0) {
+        char topic[sizeof(mqtt->topic)];
+        memcpy(topic, mqtt->topic, sizeof(topic));
+        snprintf(mqtt->backlog_topic, sizeof(mqtt->backlog_topic), "%.119s/backlog", topic);
+    }
+    if (strlen(mqtt->client_id) == 0) {
+        char hostname[64] = "";
+        gethostname(hostname, sizeof(hostname) - 1);
+        snprintf(mqtt->client_id, sizeof(mqtt->client_id), "daq-%.19s", hostname[0] ? hostname : "unknown");
+    }
+}
+
+static bool validate_batching(int batch_size, int flush_interval_ms, const char* owner,
+                              char* error_message, size_t error_size) {
+    if (batch_size < 0 || batch_size > SENDER_MAX_BATCH_LINES) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size, "%s: batch_size must be 0-%d (got %d)",
+                    owner, SENDER_MAX_BATCH_LINES, batch_size);
+        }
+        return false;
+    }
+
+    if (flush_interval_ms < 0 || flush_interval_ms > 3600000) {
+        if (error_message && error_size > 0) {
+            snprintf(error_message, error_size, "%s: flush_interval_ms must be 0-3600000 (got %d)",
+                    owner, flush_interval_ms);
+        }
+        return false;
+    }
+    return true;
+}
+
+static bool find_active_channel(const YAMLAppConfig* config, const char* id) {
+    for (size_t i = 0; i < config->channel_count; i++) {
+        if (config->channels[i].is_active && strcmp(config->channels[i].id, id) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool alarm_rules_equal(const AlarmRuleConfig* a, const AlarmRuleConfig* b) {
+    if (strcmp(a->id, b->id) != 0 || a->severity != b->severity || a->any != b->any ||
+        a->condition_count != b->condition_count) {
+        return false;
+    }
+
+    for (int c = 0; c < a->condition_count; c++) {
+        const AlarmConditionConfig* ca = &a->conditions[c];
+        const AlarmConditionConfig* cb = &b->conditions[c];
+        if (strcmp(ca->channel_id, cb->channel_id) != 0 || ca->type != cb->type ||
+            ca->threshold != cb->threshold || ca->hysteresis != cb->hysteresis ||
+            ca->for_s != cb->for_s) {
+            return false;
+        }
+    }
     return true;
 }
 
@@ -1251,6 +3286,42 @@ static bool get_scalar_bool(YAMLParseContext* ctx, bool* value) {
     return true;
 }
 
+// Reads a sequence of numbers, e.g. [0, 5, 20]
+static bool get_scalar_double_list(YAMLParseContext* ctx, double* values, int max_count, int* count) {
+    if (!expect_event_type(ctx, YAML_SEQUENCE_START_EVENT)) return false;
+    return get_double_list_items(ctx, values, max_count, count);
+}
+
+// Reads the numbers of a sequence whose start event has already been consumed
+static bool get_double_list_items(YAMLParseContext* ctx, double* values, int max_count, int* count) {
+    *count = 0;
+    while (true) {
+        if (!yaml_parser_parse(&ctx->parser, &ctx->event)) return false;
+
+        if (ctx->event.type == YAML_SEQUENCE_END_EVENT) {
+            yaml_event_delete(&ctx->event);
+            return true;
+        }
+
+        if (ctx->event.type != YAML_SCALAR_EVENT || *count >= max_count) {
+            set_parse_error(ctx, "Expected a list of at most the allowed number of values");
+            yaml_event_delete(&ctx->event);
+            return false;
+        }
+
+        char* endptr;
+        const char* text = (const char*)ctx->event.data.scalar.value;
+        double value = strtod(text, &endptr);
+        bool valid = endptr != text && *endptr == '\0';
+        yaml_event_delete(&ctx->event);
+        if (!valid) {
+            set_parse_error(ctx, "Invalid number in list");
+            return false;
+        }
+        values[(*count)++] = value;
+    }
+}
+
 static bool skip_mapping(YAMLParseContext* ctx) {
     int depth = 1;
     
@@ -1425,13 +3496,40 @@ bool config_yaml_map_to_channels(const YAMLAppConfig* config, Channel* channels)
         target_channel->gain_setting[GAIN_SETTING_SIZE - 1] = '\0';
         
         // Copy calibration data
-        target_channel->slope = yaml_channel->slope;
-        target_channel->offset = yaml_channel->offset;
+        channel_copy_calibration(target_channel, yaml_channel);
         
         // Copy pin number, board address, and filter alpha
         target_channel->pin = yaml_channel->pin;
         target_channel->board_address = yaml_channel->board_address;
         target_channel->filter_alpha = yaml_channel->filter_alpha;
+        target_channel->filter_count = yaml_channel->filter_count;
+        memcpy(target_channel->filters, yaml_channel->filters, sizeof(target_channel->filters));
+
+        // Copy validation limits
+        target_channel->min_value = yaml_channel->min_value;
+        target_channel->max_value = yaml_channel->max_value;
+        target_channel->timeout_threshold_s = yaml_channel->timeout_threshold_s;
+
+        // Copy multi-rate intervals
+        target_channel->sample_interval_ms = yaml_channel->sample_interval_ms;
+        target_channel->publish_interval_ms = yaml_channel->publish_interval_ms;
+
+        // Copy statistics settings
+        target_channel->stats_window = yaml_channel->stats_window;
+        target_channel->stats_window_samples = yaml_channel->stats_window_samples;
+        target_channel->publish_value = yaml_channel->publish_value;
+        target_channel->stats_quantiles = yaml_channel->stats_quantiles;
+
+        // Copy burst capture triggers
+        target_channel->trigger_above = yaml_channel->trigger_above;
+        target_channel->trigger_below = yaml_channel->trigger_below;
+        target_channel->trigger_rate = yaml_channel->trigger_rate;
+
+        // Copy spectral analysis settings
+        target_channel->spectrum_size = yaml_channel->spectrum_size;
+        target_channel->spectrum_band_count = yaml_channel->spectrum_band_count;
+        memcpy(target_channel->spectrum_band_edges_hz, yaml_channel->spectrum_band_edges_hz,
+               sizeof(target_channel->spectrum_band_edges_hz));
         
         // Set as active if it has a valid ID (not "NC" and not empty)
         if (strlen(target_channel->id) > 0 && 
@@ -30,33 +30,246 @@ typedef struct {
     int board_count;         // Number of configured boards
 } HardwareConfig;
 
+// Alignment of each sweep's samples onto a common instant (system.resample)
+typedef enum {
+    RESAMPLE_NONE = 0,      // Samples keep their own read times
+    RESAMPLE_LINEAR,        // Two-tap interpolation between consecutive samples
+    RESAMPLE_QUADRATIC      // Three-tap (Lagrange) interpolation over the last three samples
+} ResampleMode;
+
 // System timing configuration  
 typedef struct {
     int main_loop_interval_ms;
     int data_send_interval_ms;
+    ResampleMode resample;
 } SystemConfig;
 
+// Rollup tiers (the `influxdb.tiers:` list)
+#define MAX_ROLLUP_TIERS 4
+#define ROLLUP_TIER_NAME_SIZE 16
+#define SENDER_MAX_BATCH_LINES 1000       // Largest batch_size of a write request
+
+typedef struct {
+    char name[ROLLUP_TIER_NAME_SIZE];     // Value of the `tier` tag (e.g. "10s")
+    double interval_s;                    // Aggregation period, aligned to wall-clock multiples
+    char bucket[128];                     // Destination bucket (its retention is set on the server)
+    int batch_size;                       // Points per write request (0 = 1)
+    int flush_interval_ms;                // Longest a point waits for its batch (0 = no wait)
+} RollupTierConfig;
+
+// Transport of the raw stream (influxdb.transport); the offline backlog and the tiers always use HTTP
+#define INFLUX_DEFAULT_UDP_PORT 8089
+#define INFLUX_DEFAULT_UDP_MTU 1500
+
+typedef enum {
+    INFLUX_TRANSPORT_HTTP = 0,   // One write request per batch
+    INFLUX_TRANSPORT_UDP         // Line protocol in datagrams packed up to the MTU (no acknowledgement)
+} InfluxTransport;
+
 // InfluxDB configuration with environment variable support
 typedef struct {
     char url[256];
     char bucket[128];
     char org[128];
     char token[256];
+
+    // Batching of the raw stream
+    int batch_size;
+    int flush_interval_ms;
+
+    InfluxTransport transport;
+    char udp_host[128];           // UDP line-protocol listener (Telegraf socket_listener, InfluxDB UDP service)
+    int udp_port;
+    int udp_mtu;                  // Path MTU; datagrams carry up to this minus the IP and UDP headers
+    bool gzip;                    // Compress the HTTP writes of the raw stream (always on in gateway mode)
+
+    RollupTierConfig tiers[MAX_ROLLUP_TIERS];
+    int tier_count;
 } InfluxDBConfig;
 
 // Logging configuration
 typedef struct {
     bool csv_enabled;
     char csv_directory[256];
+    char sketch_directory[256];   // Trip quantile sketch files (empty = "logs")
+    double sketch_interval_s;     // How often sketches are published and saved (0 = default)
 } LoggingConfig;
 
+// Output sinks fed with the acquisition frames, each on its own thread (the `sinks:` section)
+#define SINK_MAX_QUEUE_SIZE 256
+#define SINK_MAX_INTERVAL_MS 60000
+#define SINK_DEFAULT_CSV_QUEUE_SIZE 64
+#define SINK_DEFAULT_DISPLAY_QUEUE_SIZE 2
+#define SINK_DEFAULT_DISPLAY_INTERVAL_MS 250
+#define SINK_DEFAULT_MQTT_QUEUE_SIZE 64
+
+typedef struct {
+    bool enabled;       // Default true (the CSV sink also needs logging.csv_enabled)
+    int queue_size;     // Frames the sink may fall behind; then its oldest frame is dropped
+    int interval_ms;    // Minimum spacing of the frames it receives (0 = every sweep)
+} SinkConfig;
+
+typedef struct {
+    SinkConfig csv;
+    SinkConfig display;
+    SinkConfig mqtt;    // Runs only with an `mqtt:` section
+} SinksConfig;
+
+// MQTT 3.1.1 output (the `mqtt:` section); its queue and interval are set in sinks.mqtt
+#define MQTT_DEFAULT_PORT 1883
+#define MQTT_DEFAULT_TOPIC "daq/measurements"
+#define MQTT_DEFAULT_KEEPALIVE_S 60
+#define MQTT_DEFAULT_MAX_INFLIGHT 16
+#define MQTT_MAX_INFLIGHT 64
+#define MQTT_DEFAULT_ACK_TIMEOUT_MS 5000
+#define MQTT_DEFAULT_RECONNECT_MAX_S 60
+#define MQTT_CLIENT_ID_SIZE 24            // 3.1.1 brokers must accept 23 characters
+
+typedef enum {
+    MQTT_FORMAT_LINE = 0,   // One line-protocol "measurements" line per frame
+    MQTT_FORMAT_BINARY      // Packed little-endian frame (layout in MqttPublisher.h)
+} MqttPayloadFormat;
+
+typedef struct {
+    bool enabled;                         // Set by the presence of the section
+    char host[128];
+    int port;
+    char client_id[MQTT_CLIENT_ID_SIZE];  // Identifies the session kept by the broker (default daq-<hostname>)
+    char username[64];                    // Empty = no authentication
+    char password[128];
+    char topic[128];                      // Live frames
+    char backlog_topic[128];              // Replayed offline batches (default <topic>/backlog)
+    MqttPayloadFormat format;
+    int keepalive_s;                      // 0 = no keepalive pings
+    int max_inflight;                     // Unacknowledged QoS 1 messages before publishing waits
+    int ack_timeout_ms;                   // Unanswered that long, the connection is dropped and reopened
+    int reconnect_max_s;                  // Longest wait between reconnection attempts
+} MqttConfig;
+
+// Triggered burst capture (the `capture:` section; thresholds are per channel)
+#define CAPTURE_MAX_SAMPLES 4096          // Largest pre_samples + post_samples
+#define CAPTURE_DEFAULT_PRE_SAMPLES 100
+#define CAPTURE_DEFAULT_POST_SAMPLES 200
+
+typedef struct {
+    int pre_samples;          // Sweeps kept from before the trigger
+    int post_samples;         // Sweeps recorded after the trigger
+    double holdoff_s;         // Minimum time between the end of a capture and the next trigger
+    char directory[256];      // Capture files (empty = "logs")
+    bool upload;              // Also upload the frames through the offline queue (low priority)
+} CaptureConfig;
+
+// Battery packs (the `batteries:` list)
+#define MAX_BATTERY_PACKS 4
+#define BATTERY_PACK_CHANNELS 4          // Virtual channels published per pack (SoC, Ah in, Ah out, energy)
+#define BATTERY_PACK_ID_SIZE 20          // Leaves room for the "_energy_wh" channel suffix
+#define BATTERY_LEGACY_PACK_ID "battery" // Pack created from the single-battery fields
+#define BATTERY_LEGACY_STATE_FILE "logs/soc_state.bin"
+
+typedef struct {
+    char id[BATTERY_PACK_ID_SIZE];                 // Prefix of the published channels
+    double capacity_ah;
+    char current_channel_id[MEASUREMENT_ID_SIZE];  // Positive current = discharge
+    char voltage_channel_id[MEASUREMENT_ID_SIZE];  // Optional; enables the energy channel
+    char state_file[256];                          // SoC persistence (default logs/soc_<id>.bin)
+} BatteryPackConfig;
+
 // Battery monitoring configuration
 typedef struct {
+    // Single-battery form (`battery:` section); becomes one pack when no list is given
     bool coulomb_counting_enabled;
     double capacity_ah;
     char current_channel_id[MEASUREMENT_ID_SIZE];
+
+    double soc_save_interval_s;  // How often the SoC is persisted (default 1 s)
+
+    // Monitored packs; coulomb counting is enabled when pack_count > 0
+    BatteryPackConfig packs[MAX_BATTERY_PACKS];
+    int pack_count;
 } BatteryConfig;
 
+// Energy meters (the `energy:` section): voltage/current channel pairs integrated into counters
+#define MAX_ENERGY_METERS 8
+#define ENERGY_METER_ID_SIZE 32
+
+typedef struct {
+    char id[ENERGY_METER_ID_SIZE];                 // Tag of the published "energy" point
+    char voltage_channel_id[MEASUREMENT_ID_SIZE];
+    char current_channel_id[MEASUREMENT_ID_SIZE];  // Positive current = consumption
+    char state_file[256];                          // Counter persistence (default logs/energy_<id>.bin)
+} EnergyMeterConfig;
+
+typedef struct {
+    double save_interval_s;      // How often the counters are persisted (0 = default 5 s)
+    EnergyMeterConfig meters[MAX_ENERGY_METERS];
+    int meter_count;
+} EnergyConfig;
+
+// Trip odometer (the `trip:` section): GPS distance fused with an energy meter into Wh/km
+#define TRIP_DEFAULT_MIN_SPEED_MPS 0.5
+#define TRIP_DEFAULT_WINDOW_S 60.0
+
+typedef struct {
+    bool enabled;                                  // Set by the presence of the section
+    char energy_meter_id[ENERGY_METER_ID_SIZE];    // Optional; meter whose net Wh gives Wh/km
+    double min_speed_mps;        // Fixes reporting a lower speed add no distance (0 = default 0.5)
+    double window_s;             // Rolling Wh/km window (0 = default 60 s)
+    char state_file[256];        // Odometer persistence (default logs/odometer.bin)
+} TripConfig;
+
+// Alarm rules (the `alarms:` section), evaluated after every sweep
+#define MAX_ALARM_RULES 32
+#define MAX_ALARM_CONDITIONS 4
+#define ALARM_ID_SIZE 32
+
+typedef enum {
+    ALARM_SEVERITY_INFO = 0,
+    ALARM_SEVERITY_WARNING,
+    ALARM_SEVERITY_CRITICAL
+} AlarmSeverity;
+
+typedef enum {
+    ALARM_CONDITION_NONE = -1,   // No threshold key given (rejected by validation)
+    ALARM_CONDITION_ABOVE = 0,
+    ALARM_CONDITION_BELOW,
+    ALARM_CONDITION_RATE         // |d(value)/dt| in units per second
+} AlarmConditionType;
+
+typedef struct {
+    char channel_id[MEASUREMENT_ID_SIZE];
+    AlarmConditionType type;
+    double threshold;
+    double hysteresis;           // Distance back past the threshold before the condition releases
+    double for_s;                // How long the condition must hold before it counts
+} AlarmConditionConfig;
+
+typedef struct {
+    char id[ALARM_ID_SIZE];                      // Tag of the published "alarms" points
+    AlarmSeverity severity;
+    bool any;                                    // true = any condition raises it, false = all must hold
+    AlarmConditionConfig conditions[MAX_ALARM_CONDITIONS];
+    int condition_count;
+} AlarmRuleConfig;
+
+typedef struct {
+    char hook_command[256];      // Executed on every raise and clear (empty = none)
+    char hook_socket[108];       // Unix datagram socket sent a JSON line per raise and clear (empty = none)
+    AlarmRuleConfig rules[MAX_ALARM_RULES];
+    int rule_count;
+} AlarmConfig;
+
+// Gateway mode (--gateway): lines and binary frames from other nodes, forwarded upstream
+#define GATEWAY_DEFAULT_PORT 8095
+#define GATEWAY_DEFAULT_MAX_NODES 64
+#define GATEWAY_MAX_NODES 1024
+#define GATEWAY_DEFAULT_NODE_LINES_PER_S 5000
+
+typedef struct {
+    int port;                     // TCP and UDP
+    int max_nodes;                // Nodes tracked at once (deduplication state, rate budgets)
+    int node_lines_per_s;         // Per node: a TCP node over it is paused, excess UDP datagrams are dropped
+} GatewayConfig;
+
 // Network configuration
 typedef struct {
     bool socket_server_enabled;
@@ -73,7 +286,14 @@ typedef struct {
     size_t channel_count;
     InfluxDBConfig influxdb;
     LoggingConfig logging;
+    SinksConfig sinks;
+    MqttConfig mqtt;
+    CaptureConfig capture;
     BatteryConfig battery;
+    EnergyConfig energy;
+    TripConfig trip;
+    AlarmConfig alarms;
+    GatewayConfig gateway;
     NetworkConfig network;
 } YAMLAppConfig;
 
@@ -130,6 +350,39 @@ ConfigYAMLResult config_yaml_validate_hardware(const YAMLAppConfig* config,
                                               char* error_message,
                                               size_t error_size);
 
+/**
+ * @brief Checks whether a newly loaded configuration can replace the running one.
+ *
+ * Only calibration, filter, validation, timing, publish and network interval settings may
+ * change at runtime. Anything that alters the channel layout, the boards or the
+ * I2C bus is a structural change and requires a restart.
+ * @param current The configuration the application is running with
+ * @param candidate The freshly loaded configuration
+ * @param error_message Buffer to store the reason for rejection (can be NULL)
+ * @param error_size Size of the error message buffer
+ * @return CONFIG_YAML_SUCCESS if compatible, CONFIG_YAML_ERROR_INVALID_STRUCTURE otherwise
+ */
+ConfigYAMLResult config_yaml_check_reload_compatible(const YAMLAppConfig* current,
+                                                     const YAMLAppConfig* candidate,
+                                                     char* error_message,
+                                                     size_t error_size);
+
+/**
+ * @brief Copies the runtime-reloadable settings from one configuration into another.
+ *
+ * The caller must have checked compatibility with config_yaml_check_reload_compatible().
+ * @param target The running configuration to update in place
+ * @param source The freshly loaded configuration
+ */
+void config_yaml_apply_reloadable(YAMLAppConfig* target, const YAMLAppConfig* source);
+
+/**
+ * @brief Creates a deep copy of a configuration.
+ * @param config The configuration to copy
+ * @return A newly allocated copy (free with config_yaml_free), or NULL on failure
+ */
+YAMLAppConfig* config_yaml_duplicate(const YAMLAppConfig* config);
+
 /**
  * @brief Frees memory allocated for a YAML configuration.
  * @param config The configuration to free
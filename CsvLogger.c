@@ -42,8 +42,8 @@ void csv_logger_init(CsvLogger* logger, const Channel* channels) {
     }
 }
 
-static void write_raw_csv_field(FILE* file_handle, const Channel* channel) {
-    if (channel_has_calibrated_override(channel)) {
+static void write_raw_csv_field(FILE* file_handle, const FrameChannel* channel) {
+    if (!channel->has_raw_value) {
         return;
     }
 
@@ -103,7 +103,19 @@ void csv_logger_log(const CsvLogger* logger, const Channel* channels, const GPSD
         return;
     }
 
-    time_t now = time(NULL);
+    AcquisitionFrame frame;
+    acquisition_frame_capture(&frame, channels, NUM_CHANNELS, 0, gps_data, 0.0, (double)time(NULL));
+    csv_logger_log_frame(logger, &frame);
+    csv_logger_flush(logger);
+}
+
+void csv_logger_log_frame(const CsvLogger* logger, const AcquisitionFrame* frame) {
+    if (!logger->is_active || logger->file_handle == NULL || !frame) {
+        return;
+    }
+
+    const GPSData* gps_data = &frame->gps;
+    time_t now = (time_t)frame->wall_time_s;
     char time_buf[64];
     // ISO 8601 format
     strftime(time_buf, sizeof(time_buf), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
@@ -112,8 +124,12 @@ void csv_logger_log(const CsvLogger* logger, const Channel* channels, const GPSD
 
     for (int i = 0; i < NUM_CHANNELS; i++) {
         fprintf(logger->file_handle, ",");
-        write_raw_csv_field(logger->file_handle, &channels[i]);
-        fprintf(logger->file_handle, ",%.4f", channel_get_calibrated_value(&channels[i]));
+        if (i >= frame->channel_count) {
+            fprintf(logger->file_handle, ",");
+            continue;
+        }
+        write_raw_csv_field(logger->file_handle, &frame->channels[i]);
+        fprintf(logger->file_handle, ",%.4f", frame->channels[i].value);
     }
 
     // Handle potentially unavailable GPS data
@@ -139,7 +155,24 @@ void csv_logger_log(const CsvLogger* logger, const Channel* channels, const GPSD
     }
 
     fprintf(logger->file_handle, "\n");
-    fflush(logger->file_handle); // Flush buffer to disk to prevent data loss on crash
+}
+
+void csv_logger_flush(const CsvLogger* logger) {
+    if (logger->is_active && logger->file_handle != NULL) {
+        fflush(logger->file_handle); // Flush buffer to disk to prevent data loss on crash
+    }
+}
+
+static void consume_frame(void* state, const AcquisitionFrame* frame) {
+    csv_logger_log_frame((const CsvLogger*)state, frame);
+}
+
+static void flush_rows(void* state) {
+    csv_logger_flush((const CsvLogger*)state);
+}
+
+PipelineSink csv_logger_sink(CsvLogger* logger) {
+    return (PipelineSink){ .name = "csv", .state = logger, .consume = consume_frame, .flush = flush_rows };
 }
 
 void csv_logger_close(CsvLogger* logger) {
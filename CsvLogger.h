@@ -5,6 +5,8 @@
 #include <stdbool.h>
 #include "Channel.h"
 #include "DataPublisher.h"
+#include "AcquisitionFrame.h"
+#include "Pipeline.h"
 #include "ConfigYAML.h"
 
 // A structure to hold the state of the CSV logger
@@ -43,6 +45,26 @@ void csv_logger_init_from_yaml(CsvLogger* logger, const Channel* channels, const
  */
 void csv_logger_log(const CsvLogger* logger, const Channel* channels, const GPSData* gps_data);
 
+/**
+ * @brief Writes a row from a published acquisition frame, without flushing.
+ * * Same columns as csv_logger_log; the timestamp is the frame's capture time.
+ * * @param logger A pointer to the CsvLogger instance.
+ * @param frame The frame to log (held by the caller).
+ */
+void csv_logger_log_frame(const CsvLogger* logger, const AcquisitionFrame* frame);
+
+/**
+ * @brief Flushes the rows written so far to disk.
+ * * @param logger A pointer to the CsvLogger instance.
+ */
+void csv_logger_flush(const CsvLogger* logger);
+
+/**
+ * @brief Pipeline sink writing one row per frame; rows are flushed whenever it has caught up.
+ * * @param logger A pointer to the CsvLogger instance (must outlive the pipeline).
+ */
+PipelineSink csv_logger_sink(CsvLogger* logger);
+
 /**
  * @brief Closes the CSV logger file.
  * * If the logger is active, this function will close the file handle.
@@ -1,14 +1,35 @@
 #include "DataPublisher.h"
 #include "LineProtocol.h"
+#include "Rollup.h"
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
+
+// An on-device downsampling tier and the sender of its bucket
+typedef struct {
+    char name[ROLLUP_TIER_NAME_SIZE];
+    RollupTier* rollup;
+    SenderContext* sender;      // Not owned
+} PublisherTier;
 
 struct DataPublisher {
     LineProtocolBuilder* lp_builder;
     SenderContext* sender_ctx;
+    ChannelStatsTable* stats;   // Optional; NULL publishes plain values only
+    ChannelSpectrumTable* spectra; // Optional; NULL publishes no spectral features
+    PublisherTier tiers[MAX_ROLLUP_TIERS];
+    int tier_count;
 };
 
+static bool publish_tier_period(DataPublisher* publisher, PublisherTier* tier,
+                                const Channel channels[], int channel_count);
+static bool build_frame_line(LineProtocolBuilder* builder, ChannelStatsTable* stats,
+                             ChannelSpectrumTable* spectra, const AcquisitionFrame* frame,
+                             ChannelMask channel_mask);
+static char* build_capture_frames(LineProtocolBuilder* builder, const TriggerCapture* capture,
+                                  const char* event_id);
+
 DataPublisher* data_publisher_create(SenderContext* sender_ctx) {
     if (!sender_ctx) return NULL;
     
@@ -22,24 +43,119 @@ DataPublisher* data_publisher_create(SenderContext* sender_ctx) {
     }
     
     publisher->sender_ctx = sender_ctx;
+    publisher->stats = NULL;
+    publisher->spectra = NULL;
+    publisher->tier_count = 0;
     return publisher;
 }
 
+void data_publisher_set_channel_stats(DataPublisher* publisher, ChannelStatsTable* stats) {
+    if (!publisher) return;
+    publisher->stats = stats;
+}
+
+void data_publisher_set_channel_spectra(DataPublisher* publisher, ChannelSpectrumTable* spectra) {
+    if (!publisher) return;
+    publisher->spectra = spectra;
+}
+
 void data_publisher_destroy(DataPublisher* publisher) {
     if (!publisher) return;
     
     if (publisher->lp_builder) {
         lp_builder_destroy(publisher->lp_builder);
     }
+    for (int t = 0; t < publisher->tier_count; t++) {
+        rollup_tier_destroy(publisher->tiers[t].rollup);
+    }
     free(publisher);
 }
 
-static bool add_channel_fields(LineProtocolBuilder* builder, const Channel channels[]) {
-    for (int i = 0; i < NUM_CHANNELS; ++i) {
+// Adds "<id>_mean", "_std", "_min", "_max", "_rms", "_p2p" and "_n" for the channel's
+// statistics window, then starts the next tumbling window.
+static LineProtocolError add_stats_fields(LineProtocolBuilder* builder, ChannelStatsTable* stats,
+                                          int index, const char* id) {
+    ChannelStatsSummary summary;
+    if (!channel_stats_get(stats, index, &summary)) return LP_SUCCESS; // Nothing collected yet
+
+    const struct { const char* suffix; double value; } fields[] = {
+        { "mean", summary.mean },
+        { "std",  summary.stddev },
+        { "min",  summary.min },
+        { "max",  summary.max },
+        { "rms",  summary.rms },
+        { "p2p",  summary.peak_to_peak },
+    };
+
+    char key[MEASUREMENT_ID_SIZE + 16];
+    for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+        snprintf(key, sizeof(key), "%s_%s", id, fields[f].suffix);
+        LineProtocolError error = lp_add_field_double(builder, key, fields[f].value);
+        if (error != LP_SUCCESS) return error;
+    }
+
+    snprintf(key, sizeof(key), "%s_n", id);
+    LineProtocolError error = lp_add_field_integer(builder, key, (int64_t)summary.count);
+    if (error != LP_SUCCESS) return error;
+
+    channel_stats_end_period(stats, index);
+    return LP_SUCCESS;
+}
+
+// Adds "<id>_fdom", "_fdom_amp", "_ac_rms" and "_band<b>" when a spectrum block was analysed
+// since the channel's previous publish; otherwise adds nothing.
+static LineProtocolError add_spectrum_fields(LineProtocolBuilder* builder, ChannelSpectrumTable* spectra,
+                                             int index, const char* id) {
+    ChannelSpectrumResult result;
+    if (!channel_spectrum_take(spectra, index, &result)) return LP_SUCCESS;
+
+    const struct { const char* suffix; double value; } fields[] = {
+        { "fdom",     result.dominant_hz },
+        { "fdom_amp", result.dominant_amplitude },
+        { "ac_rms",   result.ac_rms },
+    };
+
+    char key[MEASUREMENT_ID_SIZE + 16];
+    for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+        snprintf(key, sizeof(key), "%s_%s", id, fields[f].suffix);
+        LineProtocolError error = lp_add_field_double(builder, key, fields[f].value);
+        if (error != LP_SUCCESS) return error;
+    }
+    for (int b = 0; b < result.band_count; b++) {
+        snprintf(key, sizeof(key), "%s_band%d", id, b);
+        LineProtocolError error = lp_add_field_double(builder, key, result.band_rms[b]);
+        if (error != LP_SUCCESS) return error;
+    }
+    return LP_SUCCESS;
+}
+
+static bool add_channel_fields(LineProtocolBuilder* builder, ChannelStatsTable* stats,
+                               ChannelSpectrumTable* spectra, const AcquisitionFrame* frame,
+                               ChannelMask channel_mask) {
+    const FrameChannel* channels = frame->channels;
+    for (int i = 0; i < NUM_CHANNELS && i < frame->channel_count; ++i) {
         if (!channels[i].is_active) continue; 
-        LineProtocolError error = lp_add_field_double(builder, 
-            channels[i].id, 
-            channel_get_calibrated_value(&channels[i]));
+        if (!(channel_mask & CHANNEL_MASK_BIT(i))) continue;
+
+        LineProtocolError error = LP_SUCCESS;
+        if (!channels[i].publish_value) {
+            // Statistics-only channel
+        } else if (channels[i].quality_flags == CHANNEL_QUALITY_OK) {
+            error = lp_add_field_double(builder, 
+                channels[i].id, 
+                channels[i].value);
+        } else {
+            // Out-of-range or stale samples are withheld; publish the reason instead
+            char quality_key[MEASUREMENT_ID_SIZE + 16];
+            snprintf(quality_key, sizeof(quality_key), "%s_quality", channels[i].id);
+            error = lp_add_field_integer(builder, quality_key, channels[i].quality_flags);
+        }
+        if (error == LP_SUCCESS && channel_stats_is_enabled(stats, i)) {
+            error = add_stats_fields(builder, stats, i, channels[i].id);
+        }
+        if (error == LP_SUCCESS && channel_spectrum_is_enabled(spectra, i)) {
+            error = add_spectrum_fields(builder, spectra, i, channels[i].id);
+        }
         if (error != LP_SUCCESS) {
             fprintf(stderr, "Error adding field for channel [%s]: %s\n", 
                     channels[i].id, lp_error_string(error));
@@ -67,29 +183,360 @@ static void add_gps_fields(LineProtocolBuilder* builder, const GPSData* gps_data
 bool data_publisher_publish(DataPublisher* publisher, 
                            const Channel channels[], 
                            const GPSData* gps_data) {
+    return data_publisher_publish_channels(publisher, channels, gps_data, CHANNEL_MASK_ALL);
+}
+
+bool data_publisher_publish_channels(DataPublisher* publisher,
+                                     const Channel channels[],
+                                     const GPSData* gps_data,
+                                     ChannelMask channel_mask) {
     if (!publisher || !channels || !gps_data) return false;
+
+    AcquisitionFrame frame;
+    acquisition_frame_capture(&frame, channels, NUM_CHANNELS, 0, gps_data,
+                              0.0, lp_get_current_timestamp() / 1e9);
+    return data_publisher_publish_frame(publisher, &frame, channel_mask);
+}
+
+bool data_publisher_publish_frame(DataPublisher* publisher, const AcquisitionFrame* frame,
+                                  ChannelMask channel_mask) {
+    if (!publisher || !frame) return false;
     
-    lp_builder_reset(publisher->lp_builder);
+    if (!build_frame_line(publisher->lp_builder, publisher->stats, publisher->spectra,
+                          frame, channel_mask)) {
+        return false;
+    }
+    
+    const char* lp_string = lp_view(publisher->lp_builder);
+    if (!lp_string) return false;
+    
+    sender_submit(publisher->sender_ctx, lp_string);
+    return true;
+}
+
+bool data_publisher_format_frame(LineProtocolBuilder* builder, const AcquisitionFrame* frame) {
+    if (!builder || !frame) return false;
+    return build_frame_line(builder, NULL, NULL, frame, CHANNEL_MASK_ALL);
+}
+
+// One "measurements" line with the selected channels and the GPS fix of a frame
+static bool build_frame_line(LineProtocolBuilder* builder, ChannelStatsTable* stats,
+                             ChannelSpectrumTable* spectra, const AcquisitionFrame* frame,
+                             ChannelMask channel_mask) {
+    lp_builder_reset(builder);
     
     // Set measurement and tags
-    if (lp_set_measurement(publisher->lp_builder, "measurements") != LP_SUCCESS ||
-        lp_add_tag(publisher->lp_builder, "source", "instrumentacao") != LP_SUCCESS) {
+    if (lp_set_measurement(builder, "measurements") != LP_SUCCESS ||
+        lp_add_tag(builder, "source", "instrumentacao") != LP_SUCCESS) {
         return false;
     }
     
     // Add fields
-    if (!add_channel_fields(publisher->lp_builder, channels)) {
+    if (!add_channel_fields(builder, stats, spectra, frame, channel_mask)) {
         return false;
     }
     
-    add_gps_fields(publisher->lp_builder, gps_data);
+    add_gps_fields(builder, &frame->gps);
     
-    // Set timestamp and send
-    lp_set_timestamp_now(publisher->lp_builder);
-    
-    const char* lp_string = lp_view(publisher->lp_builder);
+    // Stamp with the sweep the values come from
+    lp_set_timestamp(builder, (int64_t)(frame->wall_time_s * 1e9));
+    return true;
+}
+
+bool data_publisher_publish_sketches(DataPublisher* publisher, const Channel channels[]) {
+    if (!publisher || !channels) return false;
+
+    for (int i = 0; i < NUM_CHANNELS; ++i) {
+        const QuantileSketch* sketch = channel_stats_get_sketch(publisher->stats, i);
+        if (!sketch || quantile_sketch_count(sketch) == 0) continue;
+
+        LineProtocolBuilder* builder = publisher->lp_builder;
+        lp_builder_reset(builder);
+        if (lp_set_measurement(builder, "distributions") != LP_SUCCESS ||
+            lp_add_tag(builder, "source", "instrumentacao") != LP_SUCCESS ||
+            lp_add_tag(builder, "channel", channels[i].id) != LP_SUCCESS ||
+            lp_add_field_double(builder, "p50", quantile_sketch_quantile(sketch, 0.50)) != LP_SUCCESS ||
+            lp_add_field_double(builder, "p95", quantile_sketch_quantile(sketch, 0.95)) != LP_SUCCESS ||
+            lp_add_field_double(builder, "p99", quantile_sketch_quantile(sketch, 0.99)) != LP_SUCCESS ||
+            lp_add_field_double(builder, "min", quantile_sketch_min(sketch)) != LP_SUCCESS ||
+            lp_add_field_double(builder, "max", quantile_sketch_max(sketch)) != LP_SUCCESS ||
+            lp_add_field_integer(builder, "n", (int64_t)quantile_sketch_count(sketch)) != LP_SUCCESS) {
+            fprintf(stderr, "Error building distribution point for channel [%s]\n", channels[i].id);
+            return false;
+        }
+
+        lp_set_timestamp_now(builder);
+        const char* lp_string = lp_view(builder);
+        if (!lp_string) return false;
+        sender_submit(publisher->sender_ctx, lp_string);
+    }
+    return true;
+}
+
+bool data_publisher_publish_energy(DataPublisher* publisher, const EnergyMeter* meter) {
+    if (!publisher || !meter) return false;
+
+    for (int m = 0; m < energy_meter_count(meter); m++) {
+        EnergyTotals totals;
+        energy_meter_get_totals(meter, m, &totals);
+
+        LineProtocolBuilder* builder = publisher->lp_builder;
+        lp_builder_reset(builder);
+        if (lp_set_measurement(builder, "energy") != LP_SUCCESS ||
+            lp_add_tag(builder, "source", "instrumentacao") != LP_SUCCESS ||
+            lp_add_tag(builder, "meter", energy_meter_id(meter, m)) != LP_SUCCESS ||
+            lp_add_field_double(builder, "wh_out", totals.wh_out) != LP_SUCCESS ||
+            lp_add_field_double(builder, "wh_in", totals.wh_in) != LP_SUCCESS ||
+            lp_add_field_double(builder, "ah_out", totals.ah_out) != LP_SUCCESS ||
+            lp_add_field_double(builder, "ah_in", totals.ah_in) != LP_SUCCESS ||
+            lp_add_field_double(builder, "ah_throughput", totals.ah_out + totals.ah_in) != LP_SUCCESS ||
+            lp_add_field_double(builder, "peak_out_w", totals.peak_out_w) != LP_SUCCESS ||
+            lp_add_field_double(builder, "peak_in_w", totals.peak_in_w) != LP_SUCCESS) {
+            fprintf(stderr, "Error building energy point for meter [%s]\n", energy_meter_id(meter, m));
+            return false;
+        }
+
+        lp_set_timestamp_now(builder);
+        const char* lp_string = lp_view(builder);
+        if (!lp_string) return false;
+        sender_submit(publisher->sender_ctx, lp_string);
+    }
+    return true;
+}
+
+bool data_publisher_publish_trip(DataPublisher* publisher, const TripOdometer* odometer) {
+    if (!publisher || !odometer) return false;
+
+    TripReading reading;
+    trip_odometer_get_reading(odometer, &reading);
+
+    LineProtocolBuilder* builder = publisher->lp_builder;
+    lp_builder_reset(builder);
+    if (lp_set_measurement(builder, "trip") != LP_SUCCESS ||
+        lp_add_tag(builder, "source", "instrumentacao") != LP_SUCCESS ||
+        lp_add_field_double(builder, "odometer_km", reading.odometer_km) != LP_SUCCESS ||
+        lp_add_field_double(builder, "trip_km", reading.trip_km) != LP_SUCCESS ||
+        (isfinite(reading.wh_per_km) &&
+         lp_add_field_double(builder, "wh_per_km", reading.wh_per_km) != LP_SUCCESS) ||
+        (isfinite(reading.trip_wh_per_km) &&
+         lp_add_field_double(builder, "trip_wh_per_km", reading.trip_wh_per_km) != LP_SUCCESS)) {
+        fprintf(stderr, "Error building trip point\n");
+        return false;
+    }
+
+    lp_set_timestamp_now(builder);
+    const char* lp_string = lp_view(builder);
     if (!lp_string) return false;
-    
     sender_submit(publisher->sender_ctx, lp_string);
     return true;
-}
\ No newline at end of file
+}
+
+bool data_publisher_publish_alarm(DataPublisher* publisher, const AlarmEvent* event, const Channel channels[]) {
+    if (!publisher || !event || !channels) return false;
+
+    LineProtocolBuilder* builder = publisher->lp_builder;
+    lp_builder_reset(builder);
+    if (lp_set_measurement(builder, "alarms") != LP_SUCCESS ||
+        lp_add_tag(builder, "source", "instrumentacao") != LP_SUCCESS ||
+        lp_add_tag(builder, "rule", event->id) != LP_SUCCESS ||
+        lp_add_tag(builder, "severity", alarm_engine_severity_name(event->severity)) != LP_SUCCESS ||
+        lp_add_tag(builder, "channel", channels[event->channel_index].id) != LP_SUCCESS ||
+        lp_add_field_boolean(builder, "active", event->raised) != LP_SUCCESS ||
+        (isfinite(event->value) && lp_add_field_double(builder, "value", event->value) != LP_SUCCESS)) {
+        fprintf(stderr, "Error building alarm point for rule [%s]\n", event->id);
+        return false;
+    }
+
+    lp_set_timestamp_now(builder);
+    const char* lp_string = lp_view(builder);
+    if (!lp_string) return false;
+    sender_submit_urgent(publisher->sender_ctx, lp_string);
+    return true;
+}
+
+bool data_publisher_add_tier(DataPublisher* publisher, const RollupTierConfig* tier, SenderContext* sender) {
+    if (!publisher || !tier || !sender) return false;
+    if (publisher->tier_count >= MAX_ROLLUP_TIERS) return false;
+
+    PublisherTier* entry = &publisher->tiers[publisher->tier_count];
+    entry->rollup = rollup_tier_create(tier->interval_s);
+    if (!entry->rollup) return false;
+
+    snprintf(entry->name, sizeof(entry->name), "%s", tier->name);
+    entry->sender = sender;
+    publisher->tier_count++;
+    return true;
+}
+
+void data_publisher_update_tiers(DataPublisher* publisher, const Channel channels[], int channel_count,
+                                 ChannelMask fresh_mask, double now_s) {
+    if (!publisher || !channels) return;
+
+    for (int t = 0; t < publisher->tier_count; t++) {
+        PublisherTier* tier = &publisher->tiers[t];
+
+        // Close the period first so these samples count towards the new one
+        if (rollup_tier_advance(tier->rollup, now_s)) {
+            publish_tier_period(publisher, tier, channels, channel_count);
+        }
+
+        for (int i = 0; i < channel_count; i++) {
+            if (!channels[i].is_active) continue;
+            if (!(fresh_mask & CHANNEL_MASK_BIT(i))) continue;
+            if (!channel_is_quality_ok(&channels[i])) continue;
+            rollup_tier_add(tier->rollup, i, channel_get_calibrated_value(&channels[i]));
+        }
+    }
+}
+
+void data_publisher_flush_tiers(DataPublisher* publisher, const Channel channels[], int channel_count) {
+    if (!publisher || !channels) return;
+
+    for (int t = 0; t < publisher->tier_count; t++) {
+        if (rollup_tier_close(publisher->tiers[t].rollup)) {
+            publish_tier_period(publisher, &publisher->tiers[t], channels, channel_count);
+        }
+    }
+}
+
+bool data_publisher_publish_capture(DataPublisher* publisher, const TriggerCapture* capture,
+                                    const char* file_name, bool upload) {
+    if (!publisher || !capture) return false;
+    const TriggerEvent* event = &capture->event;
+    const char* channel_id = capture->channel_ids[event->channel_index];
+
+    // Frames of one event share a tag so they can be queried together
+    char event_id[32];
+    snprintf(event_id, sizeof(event_id), "%lld", (long long)(event->time_s * 1000.0));
+
+    // Not publisher->lp_builder: captures are published from the event loop
+    LineProtocolBuilder* builder = lp_builder_create_default();
+    if (!builder) return false;
+
+    bool ok = lp_set_measurement(builder, "events") == LP_SUCCESS &&
+              lp_add_tag(builder, "source", "instrumentacao") == LP_SUCCESS &&
+              lp_add_tag(builder, "channel", channel_id) == LP_SUCCESS &&
+              lp_add_tag(builder, "condition", trigger_engine_condition_name(event->condition)) == LP_SUCCESS &&
+              lp_add_field_double(builder, "value", event->value) == LP_SUCCESS &&
+              lp_add_field_integer(builder, "frames", event->frame_count) == LP_SUCCESS &&
+              lp_add_field_integer(builder, "trigger_frame", event->trigger_frame) == LP_SUCCESS &&
+              lp_add_field_string(builder, "event", event_id) == LP_SUCCESS &&
+              lp_add_field_string(builder, "file", file_name ? file_name : "") == LP_SUCCESS;
+    if (!ok) {
+        fprintf(stderr, "Error building event point for channel [%s]\n", channel_id);
+        lp_builder_destroy(builder);
+        return false;
+    }
+    lp_set_timestamp(builder, (int64_t)(event->time_s * 1e9));
+
+    const char* lp_string = lp_view(builder);
+    if (!lp_string) {
+        lp_builder_destroy(builder);
+        return false;
+    }
+    sender_submit(publisher->sender_ctx, lp_string);
+
+    char* frames = upload ? build_capture_frames(builder, capture, event_id) : NULL;
+    lp_builder_destroy(builder);
+    if (!upload) return true;
+    if (!frames) return false;
+
+    sender_submit_deferred(publisher->sender_ctx, frames);
+    free(frames);
+    return true;
+}
+
+// Joins one "captures" line per frame (fields: the channels fresh in that frame)
+static char* build_capture_frames(LineProtocolBuilder* builder, const TriggerCapture* capture,
+                                  const char* event_id) {
+    const TriggerEvent* event = &capture->event;
+    size_t capacity = 0;
+    size_t length = 0;
+    char* buffer = NULL;
+
+    for (int f = 0; f < event->frame_count; f++) {
+        ChannelMask fresh_mask = capture->masks[f];
+        const float* values = &capture->values[(size_t)f * capture->channel_count];
+
+        lp_builder_reset(builder);
+        if (lp_set_measurement(builder, "captures") != LP_SUCCESS ||
+            lp_add_tag(builder, "source", "instrumentacao") != LP_SUCCESS ||
+            lp_add_tag(builder, "event", event_id) != LP_SUCCESS) {
+            free(buffer);
+            return NULL;
+        }
+        for (int i = 0; i < capture->channel_count; i++) {
+            if (!(fresh_mask & CHANNEL_MASK_BIT(i)) || !isfinite(values[i])) continue;
+            lp_add_field_double(builder, capture->channel_ids[i], values[i]);
+        }
+        if (lp_validate(builder) != LP_SUCCESS) continue; // Frame without any sample
+        lp_set_timestamp(builder, (int64_t)(capture->times[f] * 1e9));
+
+        const char* line = lp_view(builder);
+        if (!line) continue;
+        size_t line_length = strlen(line);
+        if (length + line_length + 2 > capacity) {
+            size_t new_capacity = (capacity + line_length + 2) * 2;
+            char* grown = realloc(buffer, new_capacity);
+            if (!grown) {
+                perror("Failed to allocate memory for capture upload");
+                free(buffer);
+                return NULL;
+            }
+            buffer = grown;
+            capacity = new_capacity;
+        }
+        if (length > 0) buffer[length++] = '\n';
+        memcpy(buffer + length, line, line_length + 1);
+        length += line_length;
+    }
+
+    return buffer;
+}
+
+// One point per completed period: "<id>" is the mean, plus "<id>_min", "<id>_max" and "<id>_n",
+// timestamped at the start of the period and tagged with the tier name.
+static bool publish_tier_period(DataPublisher* publisher, PublisherTier* tier,
+                                const Channel channels[], int channel_count) {
+    LineProtocolBuilder* builder = publisher->lp_builder;
+    lp_builder_reset(builder);
+
+    if (lp_set_measurement(builder, "measurements") != LP_SUCCESS ||
+        lp_add_tag(builder, "source", "instrumentacao") != LP_SUCCESS ||
+        lp_add_tag(builder, "tier", tier->name) != LP_SUCCESS) {
+        return false;
+    }
+
+    char key[MEASUREMENT_ID_SIZE + 16];
+    for (int i = 0; i < channel_count; i++) {
+        RollupCell cell;
+        if (!rollup_tier_get_completed(tier->rollup, i, &cell)) continue;
+
+        LineProtocolError error = lp_add_field_double(builder, channels[i].id, cell.sum / cell.count);
+        if (error == LP_SUCCESS) {
+            snprintf(key, sizeof(key), "%s_min", channels[i].id);
+            error = lp_add_field_double(builder, key, cell.min);
+        }
+        if (error == LP_SUCCESS) {
+            snprintf(key, sizeof(key), "%s_max", channels[i].id);
+            error = lp_add_field_double(builder, key, cell.max);
+        }
+        if (error == LP_SUCCESS) {
+            snprintf(key, sizeof(key), "%s_n", channels[i].id);
+            error = lp_add_field_integer(builder, key, (int64_t)cell.count);
+        }
+        if (error != LP_SUCCESS) {
+            fprintf(stderr, "Error adding rollup fields for channel [%s]: %s\n",
+                    channels[i].id, lp_error_string(error));
+            return false;
+        }
+    }
+
+    lp_set_timestamp(builder, (int64_t)(rollup_tier_completed_start(tier->rollup) * 1e9));
+
+    const char* lp_string = lp_view(builder);
+    if (!lp_string) return false;
+
+    sender_submit(tier->sender, lp_string);
+    return true;
+}
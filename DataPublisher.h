@@ -4,6 +4,12 @@
 #include "Channel.h"
 #include "Sender.h"
 #include "HardwareManager.h"  // For GPSData
+#include "TriggerEngine.h"
+#include "EnergyMeter.h"
+#include "TripOdometer.h"
+#include "AlarmEngine.h"
+#include "AcquisitionFrame.h"
+#include "LineProtocol.h"
 
 typedef struct DataPublisher DataPublisher;
 
@@ -11,9 +17,63 @@ typedef struct DataPublisher DataPublisher;
 DataPublisher* data_publisher_create(SenderContext* sender_ctx);
 void data_publisher_destroy(DataPublisher* publisher);
 
+// Publish the statistics windows of this table alongside the channel values (NULL disables).
+// Each publish reports a channel's window and then starts its next tumbling window.
+void data_publisher_set_channel_stats(DataPublisher* publisher, ChannelStatsTable* stats);
+
+// Publish the spectral features of this table (NULL disables). Each analysed block is
+// reported once, with the channel's next publish after it completes.
+void data_publisher_set_channel_spectra(DataPublisher* publisher, ChannelSpectrumTable* spectra);
+
 // Publish measurements to InfluxDB
 bool data_publisher_publish(DataPublisher* publisher, 
                            const Channel channels[], 
                            const GPSData* gps_data);
 
+// Publish only the channels selected in channel_mask (per-channel publish intervals)
+bool data_publisher_publish_channels(DataPublisher* publisher,
+                                     const Channel channels[],
+                                     const GPSData* gps_data,
+                                     ChannelMask channel_mask);
+
+// Publish the selected channels of a frame, stamped with the frame's capture time
+bool data_publisher_publish_frame(DataPublisher* publisher, const AcquisitionFrame* frame,
+                                  ChannelMask channel_mask);
+
+// Formats every published channel and the GPS fix of a frame as one "measurements" line,
+// without statistics or spectra (their windows are left alone). For sinks with their own transport.
+bool data_publisher_format_frame(LineProtocolBuilder* builder, const AcquisitionFrame* frame);
+
+// Publish each channel's trip quantile sketch as one "distributions" point
+// (tag channel=<id>; fields p50, p95, p99, min, max, n). Channels without a sketch are skipped.
+bool data_publisher_publish_sketches(DataPublisher* publisher, const Channel channels[]);
+
+// Publish one "energy" point per meter (tag meter=<id>; fields wh_out, wh_in, ah_out, ah_in,
+// ah_throughput, peak_out_w, peak_in_w). Every field is a lifetime counter that only grows.
+bool data_publisher_publish_energy(DataPublisher* publisher, const EnergyMeter* meter);
+
+// Publish one "trip" point (fields odometer_km, trip_km and, once defined, wh_per_km and trip_wh_per_km)
+bool data_publisher_publish_trip(DataPublisher* publisher, const TripOdometer* odometer);
+
+// Publish an "alarms" point (tags rule, severity, channel; fields active and value) ahead of queued data
+bool data_publisher_publish_alarm(DataPublisher* publisher, const AlarmEvent* event, const Channel channels[]);
+
+// Adds an on-device rollup tier whose points go to the given sender (not owned)
+bool data_publisher_add_tier(DataPublisher* publisher, const RollupTierConfig* tier, SenderContext* sender);
+
+// Feeds the fresh, good samples of this sweep to every tier; publishes each tier's
+// period (mean, min, max, count per channel) once the wall clock now_s has passed it.
+void data_publisher_update_tiers(DataPublisher* publisher, const Channel channels[], int channel_count,
+                                 ChannelMask fresh_mask, double now_s);
+
+// Publishes every tier's partial current period (called at shutdown)
+void data_publisher_flush_tiers(DataPublisher* publisher, const Channel channels[], int channel_count);
+
+// Publishes a completed capture: one live "events" point (tags channel, condition;
+// fields value, frames, trigger_frame, file) and, if upload is set, one "captures" point per frame
+// (tag event=<trigger time in ms>) handed to the sender's offline queue as low-priority data.
+// Uses its own builder, so it may run on another thread than the periodic publishing.
+bool data_publisher_publish_capture(DataPublisher* publisher, const TriggerCapture* capture,
+                                    const char* file_name, bool upload);
+
 #endif // DATA_PUBLISHER_H
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <time.h>
 
 // Node for the linked list queue
 typedef struct DataNode {
@@ -16,6 +17,7 @@ struct DataQueue {
     DataNode* tail;
     pthread_mutex_t mutex;
     pthread_cond_t cond;
+    size_t length;         // Items in the list
     volatile int shutdown; // Flag to signal threads to exit
 };
 
@@ -31,6 +33,7 @@ DataQueue* data_queue_create() {
     }
     q->head = NULL;
     q->tail = NULL;
+    q->length = 0;
     q->shutdown = 0;
     pthread_mutex_init(&q->mutex, NULL);
     pthread_cond_init(&q->cond, NULL);
@@ -86,11 +89,41 @@ void data_queue_enqueue(DataQueue* q, const char* data) {
     if (q->head == NULL) {
         q->head = new_node;
     }
+    q->length++;
     // Signal the condition variable in case the dequeue thread is waiting
     pthread_cond_signal(&q->cond);
     pthread_mutex_unlock(&q->mutex);
 }
 
+/**
+ * @brief Enqueues a data item at the head of the queue.
+ * @param q The queue.
+ * @param data The null-terminated string data to enqueue.
+ */
+void data_queue_enqueue_front(DataQueue* q, const char* data) {
+    DataNode* new_node = (DataNode*)malloc(sizeof(DataNode));
+    if (!new_node) {
+        perror("Failed to allocate DataNode");
+        return;
+    }
+    new_node->data = strdup(data);
+    if (!new_node->data) {
+        perror("Failed to duplicate string for queue");
+        free(new_node);
+        return;
+    }
+
+    pthread_mutex_lock(&q->mutex);
+    new_node->next = q->head;
+    q->head = new_node;
+    if (q->tail == NULL) {
+        q->tail = new_node;
+    }
+    q->length++;
+    pthread_cond_signal(&q->cond);
+    pthread_mutex_unlock(&q->mutex);
+}
+
 /**
  * @brief Dequeues a data item.
  *
@@ -119,12 +152,65 @@ char* data_queue_dequeue(DataQueue* q) {
     if (q->head == NULL) {
         q->tail = NULL; // The queue is now empty
     }
+    q->length--;
     free(temp); // Free the node, but not the data it points to
 
     pthread_mutex_unlock(&q->mutex);
     return data;
 }
 
+/**
+ * @brief Dequeues a data item, waiting at most timeout_ms.
+ * @param q The queue.
+ * @param timeout_ms Maximum wait in milliseconds.
+ * @return A pointer to the data string, or NULL on timeout or when shut down and empty.
+ */
+char* data_queue_dequeue_timeout(DataQueue* q, int timeout_ms) {
+    // pthread_cond_timedwait takes an absolute CLOCK_REALTIME deadline
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&q->mutex);
+    while (q->head == NULL && !q->shutdown) {
+        if (pthread_cond_timedwait(&q->cond, &q->mutex, &deadline) != 0) break; // Timed out
+    }
+
+    if (q->head == NULL) {
+        pthread_mutex_unlock(&q->mutex);
+        return NULL;
+    }
+
+    DataNode* temp = q->head;
+    char* data = temp->data;
+    q->head = q->head->next;
+    if (q->head == NULL) {
+        q->tail = NULL;
+    }
+    q->length--;
+    free(temp);
+
+    pthread_mutex_unlock(&q->mutex);
+    return data;
+}
+
+/**
+ * @brief Returns the number of items waiting in the queue.
+ * @param q The queue.
+ * @return The item count.
+ */
+size_t data_queue_length(DataQueue* q) {
+    pthread_mutex_lock(&q->mutex);
+    size_t length = q->length;
+    pthread_mutex_unlock(&q->mutex);
+    return length;
+}
+
 /**
  * @brief Signals the queue to shut down.
  *
@@ -1,6 +1,8 @@
 #ifndef DATA_QUEUE_H
 #define DATA_QUEUE_H
 
+#include <stddef.h>
+
 /**
  * @file DataQueue.h
  * @brief A simple thread-safe queue for passing string data between threads.
@@ -33,6 +35,15 @@ void data_queue_destroy(DataQueue* q);
  */
 void data_queue_enqueue(DataQueue* q, const char* data);
 
+/**
+ * @brief Adds a string to the front of the queue, ahead of everything waiting.
+ *
+ * Same as data_queue_enqueue otherwise; used for high-priority lines.
+ * @param q The queue.
+ * @param data The null-terminated string to add to the queue.
+ */
+void data_queue_enqueue_front(DataQueue* q, const char* data);
+
 /**
  * @brief Removes and returns a string from the front of the queue.
  *
@@ -45,6 +56,27 @@ void data_queue_enqueue(DataQueue* q, const char* data);
  */
 char* data_queue_dequeue(DataQueue* q);
 
+/**
+ * @brief Like data_queue_dequeue, but gives up after timeout_ms milliseconds.
+ *
+ * Used to collect a batch until its flush deadline.
+ *
+ * @param q The queue.
+ * @param timeout_ms Maximum wait in milliseconds (0 = do not wait).
+ * @return A dynamically allocated string, or NULL on timeout or shutdown with an empty queue.
+ */
+char* data_queue_dequeue_timeout(DataQueue* q, int timeout_ms);
+
+/**
+ * @brief Returns the number of strings waiting in the queue.
+ *
+ * Used by producers to detect a consumer that falls behind.
+ *
+ * @param q The queue.
+ * @return The item count (a snapshot; other threads may change it right away).
+ */
+size_t data_queue_length(DataQueue* q);
+
 /**
  * @brief Signals the queue to shut down, unblocking any waiting consumer threads.
  * @param q The queue.
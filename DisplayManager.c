@@ -124,14 +124,16 @@ static void cleanup_ncurses(DisplayManager* dm);
 static void create_windows(DisplayManager* dm);
 static void destroy_windows(DisplayManager* dm);
 static void draw_header(DisplayManager* dm);
-static void draw_measurements(DisplayManager* dm, const Channel* channels, int channel_count, const GPSData* gps);
+static void draw_measurements(DisplayManager* dm, const FrameChannel* channels, int channel_count, const GPSData* gps);
 static void draw_status(DisplayManager* dm, const SystemStatus* status);
 static void draw_messages(DisplayManager* dm);
 static void add_message_internal(DisplayManager* dm, MessageLevel level, const char* text);
 static const char* level_to_string(MessageLevel level);
 static int level_to_color_pair(MessageLevel level);
-static void fallback_print_measurements(const Channel* channels, int channel_count, const GPSData* gps);
+static void fallback_print_measurements(const FrameChannel* channels, int channel_count, const GPSData* gps);
 static void fallback_print_message(MessageLevel level, const char* text);
+static void consume_frame(void* state, const AcquisitionFrame* frame);
+static void refresh_screen(void* state);
 
 // === Public API Implementation ===
 
@@ -197,20 +199,24 @@ void display_manager_cleanup(DisplayManager* dm) {
     free(dm);
 }
 
-void display_manager_update_measurements(DisplayManager* dm, const Channel* channels, int channel_count, const GPSData* gps) {
-    if (!dm || !dm->initialized) return;
+void display_manager_update_measurements(DisplayManager* dm, const AcquisitionFrame* frame) {
+    if (!dm || !dm->initialized || !frame) return;
     
     pthread_mutex_lock(&dm->mutex);
     
     if (dm->use_fallback) {
-        fallback_print_measurements(channels, channel_count, gps);
+        fallback_print_measurements(frame->channels, frame->channel_count, &frame->gps);
     } else {
-        draw_measurements(dm, channels, channel_count, gps);
+        draw_measurements(dm, frame->channels, frame->channel_count, &frame->gps);
     }
     
     pthread_mutex_unlock(&dm->mutex);
 }
 
+PipelineSink display_manager_sink(DisplayManager* dm) {
+    return (PipelineSink){ .name = "display", .state = dm, .consume = consume_frame, .flush = refresh_screen };
+}
+
 void display_manager_update_status(DisplayManager* dm, const SystemStatus* status) {
     if (!dm || !dm->initialized || !status) return;
     
@@ -461,7 +467,7 @@ static void draw_header(DisplayManager* dm) {
 #endif
 }
 
-static void draw_measurements(DisplayManager* dm, const Channel* channels, int channel_count, const GPSData* gps) {
+static void draw_measurements(DisplayManager* dm, const FrameChannel* channels, int channel_count, const GPSData* gps) {
 #if NCURSES_AVAILABLE
     if (!dm->measurement_win) return;
     
@@ -478,7 +484,7 @@ static void draw_measurements(DisplayManager* dm, const Channel* channels, int c
     // Display channel measurements
     for (int i = 0; i < channel_count && i < MAX_TOTAL_CHANNELS && line < max_line; i++) {
         if (channels[i].is_active) {
-            double calibrated_value = channel_get_calibrated_value(&channels[i]);
+            double calibrated_value = channels[i].value;
             
             // Truncate long channel names to fit window width
             char display_id[50];
@@ -646,7 +652,7 @@ static int level_to_color_pair(MessageLevel level) {
     }
 }
 
-static void fallback_print_measurements(const Channel* channels, int channel_count, const GPSData* gps) {
+static void fallback_print_measurements(const FrameChannel* channels, int channel_count, const GPSData* gps) {
     printf("--- Measurements ---\n");
     for (int i = 0; i < channel_count && i < MAX_TOTAL_CHANNELS; i++) {
         if (channels[i].is_active) {
@@ -654,7 +660,7 @@ static void fallback_print_measurements(const Channel* channels, int channel_cou
                    channels[i].board_address,
                    channels[i].pin,
                    channels[i].id,
-                   channel_get_calibrated_value(&channels[i]),
+                   channels[i].value,
                    channels[i].unit);
         }
     }
@@ -675,4 +681,12 @@ static void fallback_print_message(MessageLevel level, const char* text) {
     strftime(time_str, sizeof(time_str), "%H:%M:%S", tm_info);
     
     printf("[%s] %s: %s\n", time_str, level_to_string(level), text);
-}
\ No newline at end of file
+}
+
+static void consume_frame(void* state, const AcquisitionFrame* frame) {
+    display_manager_update_measurements((DisplayManager*)state, frame);
+}
+
+static void refresh_screen(void* state) {
+    display_manager_refresh((DisplayManager*)state);
+}
@@ -5,6 +5,8 @@
 #include <stdarg.h>
 #include "Channel.h"
 #include "HardwareManager.h"
+#include "AcquisitionFrame.h"
+#include "Pipeline.h"
 
 // Message levels for logging
 typedef enum {
@@ -39,8 +41,11 @@ void display_manager_cleanup(DisplayManager* dm);
 bool display_manager_is_available(void);
 
 // === Data Display Functions ===
-// Update the measurements display area
-void display_manager_update_measurements(DisplayManager* dm, const Channel* channels, int channel_count, const GPSData* gps);
+// Update the measurements display area from the latest acquisition frame
+void display_manager_update_measurements(DisplayManager* dm, const AcquisitionFrame* frame);
+
+// Pipeline sink drawing the measurements of each frame it receives
+PipelineSink display_manager_sink(DisplayManager* dm);
 
 // Update the system status bar
 void display_manager_update_status(DisplayManager* dm, const SystemStatus* status);
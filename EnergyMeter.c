@@ -0,0 +1,253 @@
+#include "EnergyMeter.h"
+#include "StateStore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define SECONDS_PER_HOUR 3600.0
+
+// Running sum with its Kahan-Babuska compensation term (the low-order bits lost by sum)
+typedef struct {
+    double sum;
+    double compensation;
+} CompensatedSum;
+
+// Record kept in each meter's state file; the compensation terms are kept too
+typedef struct {
+    CompensatedSum wh_out;
+    CompensatedSum wh_in;
+    CompensatedSum ah_out;
+    CompensatedSum ah_in;
+    double peak_out_w;
+    double peak_in_w;
+} PersistedCounters;
+
+typedef struct {
+    char id[ENERGY_METER_ID_SIZE];
+    int voltage_index;
+    int current_index;
+    PersistedCounters counters;
+    StateStore* store;          // NULL if the state file is unavailable
+
+    // Previous sample, for the trapezoid to the next one
+    bool has_last_sample;
+    double last_time_s;
+    double last_current_A;
+    double last_power_W;
+} MeterState;
+
+struct EnergyMeter {
+    MeterState meters[MAX_ENERGY_METERS];
+    int count;
+};
+
+// --- Private Function Prototypes ---
+static int find_channel_index(const Channel channels[], int channel_count, const char* id);
+static void open_store(MeterState* state, const char* state_file);
+static void compensated_add(CompensatedSum* total, double value);
+static double compensated_value(const CompensatedSum* total);
+static void split_trapezoid(double y0, double y1, double dt_s, double* positive, double* negative);
+static bool counters_valid(const PersistedCounters* counters);
+
+// --- Public Functions ---
+
+EnergyMeter* energy_meter_create(const EnergyConfig* config, const Channel channels[], int channel_count) {
+    if (!config || !channels || config->meter_count <= 0) return NULL;
+
+    EnergyMeter* meter = calloc(1, sizeof(EnergyMeter));
+    if (!meter) {
+        perror("Failed to allocate memory for EnergyMeter");
+        return NULL;
+    }
+
+    for (int m = 0; m < config->meter_count && m < MAX_ENERGY_METERS; m++) {
+        const EnergyMeterConfig* meter_config = &config->meters[m];
+        MeterState* state = &meter->meters[meter->count];
+
+        state->voltage_index = find_channel_index(channels, channel_count, meter_config->voltage_channel_id);
+        state->current_index = find_channel_index(channels, channel_count, meter_config->current_channel_id);
+        if (state->voltage_index < 0 || state->current_index < 0) {
+            fprintf(stderr, "EnergyMeter: Channels of meter '%s' not found, skipping it\n", meter_config->id);
+            continue;
+        }
+
+        snprintf(state->id, sizeof(state->id), "%s", meter_config->id);
+        open_store(state, meter_config->state_file);
+        meter->count++;
+
+        printf("EnergyMeter: '%s' (%s x %s) restored at %.3f Wh out, %.3f Wh in\n", state->id,
+               meter_config->voltage_channel_id, meter_config->current_channel_id,
+               compensated_value(&state->counters.wh_out), compensated_value(&state->counters.wh_in));
+    }
+
+    if (meter->count == 0) {
+        energy_meter_destroy(meter);
+        return NULL;
+    }
+    return meter;
+}
+
+void energy_meter_update(EnergyMeter* meter, const Channel channels[]) {
+    if (!meter || !channels) return;
+
+    for (int m = 0; m < meter->count; m++) {
+        MeterState* state = &meter->meters[m];
+        const Channel* current_channel = &channels[state->current_index];
+        const Channel* voltage_channel = &channels[state->voltage_index];
+
+        double time_s = current_channel->sample_time_s;
+        if (state->has_last_sample && time_s == state->last_time_s) continue; // Not sampled in this sweep
+
+        if (!channel_is_sample_quality_ok(current_channel) || !channel_is_sample_quality_ok(voltage_channel) ||
+            time_s <= 0.0) {
+            state->has_last_sample = false; // Do not bridge bad samples
+            continue;
+        }
+
+        // Unfiltered samples, so short transients and regeneration spikes are counted in full
+        double current_A = channel_get_sample_value(current_channel);
+        double power_W = channel_get_sample_value(voltage_channel) * current_A;
+
+        double dt_s = time_s - state->last_time_s;
+        if (state->has_last_sample && dt_s > 0.0 && dt_s <= ENERGY_MAX_INTEGRATION_GAP_S) {
+            PersistedCounters* counters = &state->counters;
+            double out, in;
+
+            split_trapezoid(state->last_current_A, current_A, dt_s, &out, &in);
+            compensated_add(&counters->ah_out, out / SECONDS_PER_HOUR);
+            compensated_add(&counters->ah_in, in / SECONDS_PER_HOUR);
+
+            split_trapezoid(state->last_power_W, power_W, dt_s, &out, &in);
+            compensated_add(&counters->wh_out, out / SECONDS_PER_HOUR);
+            compensated_add(&counters->wh_in, in / SECONDS_PER_HOUR);
+        }
+
+        if (power_W > state->counters.peak_out_w) state->counters.peak_out_w = power_W;
+        if (-power_W > state->counters.peak_in_w) state->counters.peak_in_w = -power_W;
+
+        state->has_last_sample = true;
+        state->last_time_s = time_s;
+        state->last_current_A = current_A;
+        state->last_power_W = power_W;
+    }
+}
+
+int energy_meter_count(const EnergyMeter* meter) {
+    return meter ? meter->count : 0;
+}
+
+const char* energy_meter_id(const EnergyMeter* meter, int index) {
+    if (!meter || index < 0 || index >= meter->count) return NULL;
+    return meter->meters[index].id;
+}
+
+int energy_meter_find(const EnergyMeter* meter, const char* id) {
+    if (!meter || !id) return -1;
+    for (int m = 0; m < meter->count; m++) {
+        if (strcmp(meter->meters[m].id, id) == 0) return m;
+    }
+    return -1;
+}
+
+bool energy_meter_get_totals(const EnergyMeter* meter, int index, EnergyTotals* totals) {
+    if (!meter || !totals || index < 0 || index >= meter->count) return false;
+
+    const PersistedCounters* counters = &meter->meters[index].counters;
+    totals->wh_out = compensated_value(&counters->wh_out);
+    totals->wh_in = compensated_value(&counters->wh_in);
+    totals->ah_out = compensated_value(&counters->ah_out);
+    totals->ah_in = compensated_value(&counters->ah_in);
+    totals->peak_out_w = counters->peak_out_w;
+    totals->peak_in_w = counters->peak_in_w;
+    return true;
+}
+
+void energy_meter_save(const EnergyMeter* meter) {
+    if (!meter) return;
+
+    for (int m = 0; m < meter->count; m++) {
+        const MeterState* state = &meter->meters[m];
+        if (state->store && !state_store_save(state->store, &state->counters)) {
+            fprintf(stderr, "EnergyMeter: Failed to save counters of meter '%s'\n", state->id);
+        }
+    }
+}
+
+void energy_meter_destroy(EnergyMeter* meter) {
+    if (!meter) return;
+
+    for (int m = 0; m < meter->count; m++) {
+        state_store_close(meter->meters[m].store);
+    }
+    free(meter);
+}
+
+// --- Private Function Implementations ---
+
+static int find_channel_index(const Channel channels[], int channel_count, const char* id) {
+    if (!id || id[0] == '\0') return -1;
+    for (int i = 0; i < channel_count; i++) {
+        if (strcmp(channels[i].id, id) == 0) return i;
+    }
+    return -1;
+}
+
+// Opens the meter's state file and restores its counters (zero for a new or damaged file)
+static void open_store(MeterState* state, const char* state_file) {
+    state->store = state_store_open(state_file, sizeof(PersistedCounters));
+    if (!state->store) {
+        fprintf(stderr, "EnergyMeter: Counters of meter '%s' will not be persisted\n", state->id);
+        return;
+    }
+
+    PersistedCounters persisted;
+    if (state_store_load(state->store, &persisted) && counters_valid(&persisted)) {
+        state->counters = persisted;
+    }
+}
+
+// Kahan-Babuska (Neumaier) step: also exact when the addend is the larger term
+static void compensated_add(CompensatedSum* total, double value) {
+    double sum = total->sum + value;
+    if (fabs(total->sum) >= fabs(value)) {
+        total->compensation += (total->sum - sum) + value;
+    } else {
+        total->compensation += (value - sum) + total->sum;
+    }
+    total->sum = sum;
+}
+
+static double compensated_value(const CompensatedSum* total) {
+    return total->sum + total->compensation;
+}
+
+// Integrates the straight line from y0 to y1 over dt_s, returning the area above zero and the
+// (positive) area below zero. A sign change splits the interval at the zero crossing.
+static void split_trapezoid(double y0, double y1, double dt_s, double* positive, double* negative) {
+    if (y0 >= 0.0 && y1 >= 0.0) {
+        *positive = 0.5 * (y0 + y1) * dt_s;
+        *negative = 0.0;
+    } else if (y0 <= 0.0 && y1 <= 0.0) {
+        *positive = 0.0;
+        *negative = -0.5 * (y0 + y1) * dt_s;
+    } else {
+        double t_zero_s = dt_s * fabs(y0) / (fabs(y0) + fabs(y1));
+        double first = 0.5 * y0 * t_zero_s;
+        double second = 0.5 * y1 * (dt_s - t_zero_s);
+        *positive = first > 0.0 ? first : second;
+        *negative = first > 0.0 ? -second : -first;
+    }
+}
+
+static bool counters_valid(const PersistedCounters* counters) {
+    const double values[] = {
+        compensated_value(&counters->wh_out), compensated_value(&counters->wh_in),
+        compensated_value(&counters->ah_out), compensated_value(&counters->ah_in),
+        counters->peak_out_w, counters->peak_in_w
+    };
+    for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+        if (!isfinite(values[v]) || values[v] < 0.0) return false;
+    }
+    return true;
+}
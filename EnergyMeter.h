@@ -0,0 +1,83 @@
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <stdbool.h>
+#include "Channel.h"
+#include "ConfigYAML.h"
+
+/**
+ * @file EnergyMeter.h
+ * @brief Energy and charge counters for the voltage/current pairs of the YAML `energy` section.
+ *
+ * Each meter integrates its current channel's unfiltered samples, and the
+ * power V·I computed from them, with trapezoids between consecutive sample
+ * timestamps. Intervals whose current or power changes sign are split at the
+ * zero crossing, so consumed and regenerated energy (and charge out and in)
+ * are counted separately and every counter only grows. Increments are many
+ * orders of magnitude smaller than a lifetime total, so the counters use
+ * compensated (Kahan-Babuska) summation and do not drift over months of
+ * samples. Peak consumed and regenerated power are tracked alongside.
+ *
+ * Every meter keeps its counters in a double-slot StateStore file, restored
+ * at start-up, so the published totals stay monotonic across restarts.
+ */
+
+// Samples further apart than this are not bridged (read failures, stalls)
+#define ENERGY_MAX_INTEGRATION_GAP_S 5.0
+
+typedef struct {
+    double wh_out;          // Energy consumed (positive power)
+    double wh_in;           // Energy regenerated (negative power)
+    double ah_out;          // Charge drawn (positive current)
+    double ah_in;           // Charge returned (negative current)
+    double peak_out_w;      // Highest consumed power seen
+    double peak_in_w;       // Highest regenerated power seen (positive number)
+} EnergyTotals;
+
+typedef struct EnergyMeter EnergyMeter; // Opaque set of all configured meters
+
+/**
+ * @brief Creates the meters of the configuration and restores their counters.
+ * @param channels Channel array the meters read (indices are resolved once)
+ * @param channel_count Number of channels
+ * @return A pointer to the meters, or NULL on failure or when none are configured
+ */
+EnergyMeter* energy_meter_create(const EnergyConfig* config, const Channel channels[], int channel_count);
+
+/**
+ * @brief Integrates each meter's newest sample, if its current channel was sampled since the last call.
+ */
+void energy_meter_update(EnergyMeter* meter, const Channel channels[]);
+
+/**
+ * @brief Returns the number of meters.
+ */
+int energy_meter_count(const EnergyMeter* meter);
+
+/**
+ * @brief Returns a meter's id, or NULL for an invalid index.
+ */
+const char* energy_meter_id(const EnergyMeter* meter, int index);
+
+/**
+ * @brief Returns the index of the meter with the given id, or -1 if there is none.
+ */
+int energy_meter_find(const EnergyMeter* meter, const char* id);
+
+/**
+ * @brief Copies a meter's counters.
+ * @return false for an invalid index
+ */
+bool energy_meter_get_totals(const EnergyMeter* meter, int index, EnergyTotals* totals);
+
+/**
+ * @brief Persists every meter's counters to its state file.
+ */
+void energy_meter_save(const EnergyMeter* meter);
+
+/**
+ * @brief Closes the state files and frees the meters. Save first to keep the latest counts.
+ */
+void energy_meter_destroy(EnergyMeter* meter);
+
+#endif // ENERGY_METER_H
@@ -0,0 +1,300 @@
+#include "EventLoop.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+#define EVENT_LOOP_MAX_EVENTS 16
+
+typedef enum {
+    SOURCE_FD,
+    SOURCE_TIMER,
+    SOURCE_EVENT
+} EventSourceType;
+
+struct EventSource {
+    EventSourceType type;
+    int fd;
+    EventLoopFdCallback fd_callback;
+    EventLoopCallback callback;
+    void* user_data;
+    bool removed;
+    EventSource* next;          // All sources, or the pending-free list once removed
+};
+
+struct EventLoop {
+    int epoll_fd;
+    EventSource* sources;
+    EventSource* removed_sources; // Freed after the current dispatch batch
+    EventSource* stop_event;
+
+    pthread_t thread;
+    bool thread_started;
+    volatile bool stop_requested;
+};
+
+// --- Private Function Prototypes ---
+static EventSource* register_source(EventLoop* loop, EventSourceType type, int fd, uint32_t events);
+static void free_removed_sources(EventLoop* loop);
+static void dispatch(EventLoop* loop, EventSource* source, uint32_t events);
+static void* event_loop_thread_function(void* arg);
+static void handle_stop_event(EventLoop* loop, void* user_data);
+
+// --- Public Functions ---
+
+EventLoop* event_loop_create(void) {
+    EventLoop* loop = calloc(1, sizeof(EventLoop));
+    if (!loop) {
+        perror("Failed to allocate memory for EventLoop");
+        return NULL;
+    }
+
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epoll_fd < 0) {
+        perror("EventLoop: epoll_create1 failed");
+        free(loop);
+        return NULL;
+    }
+
+    loop->stop_event = event_loop_add_event(loop, handle_stop_event, NULL);
+    if (!loop->stop_event) {
+        close(loop->epoll_fd);
+        free(loop);
+        return NULL;
+    }
+
+    return loop;
+}
+
+EventSource* event_loop_add_fd(EventLoop* loop, int fd, uint32_t events,
+                               EventLoopFdCallback callback, void* user_data) {
+    if (!loop || fd < 0 || !callback) return NULL;
+
+    EventSource* source = register_source(loop, SOURCE_FD, fd, events);
+    if (!source) return NULL;
+
+    source->fd_callback = callback;
+    source->user_data = user_data;
+    return source;
+}
+
+bool event_loop_modify_fd(EventLoop* loop, EventSource* source, uint32_t events) {
+    if (!loop || !source || source->type != SOURCE_FD || source->removed) return false;
+
+    struct epoll_event event = { .events = events, .data.ptr = source };
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_MOD, source->fd, &event) < 0) {
+        fprintf(stderr, "EventLoop: Cannot modify fd %d: %s\n", source->fd, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+EventSource* event_loop_add_timer(EventLoop* loop, unsigned initial_ms, unsigned period_ms,
+                                  EventLoopCallback callback, void* user_data) {
+    if (!loop || !callback) return NULL;
+
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0) {
+        perror("EventLoop: timerfd_create failed");
+        return NULL;
+    }
+
+    EventSource* source = register_source(loop, SOURCE_TIMER, fd, EPOLLIN);
+    if (!source) {
+        close(fd);
+        return NULL;
+    }
+
+    source->callback = callback;
+    source->user_data = user_data;
+    event_loop_set_timer(source, initial_ms, period_ms);
+    return source;
+}
+
+bool event_loop_set_timer(EventSource* timer, unsigned initial_ms, unsigned period_ms) {
+    if (!timer || timer->type != SOURCE_TIMER) return false;
+
+    struct itimerspec spec = {
+        .it_value = { .tv_sec = initial_ms / 1000, .tv_nsec = (long)(initial_ms % 1000) * 1000000L },
+        .it_interval = { .tv_sec = period_ms / 1000, .tv_nsec = (long)(period_ms % 1000) * 1000000L }
+    };
+
+    if (timerfd_settime(timer->fd, 0, &spec, NULL) < 0) {
+        perror("EventLoop: timerfd_settime failed");
+        return false;
+    }
+    return true;
+}
+
+EventSource* event_loop_add_event(EventLoop* loop, EventLoopCallback callback, void* user_data) {
+    if (!loop || !callback) return NULL;
+
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        perror("EventLoop: eventfd failed");
+        return NULL;
+    }
+
+    EventSource* source = register_source(loop, SOURCE_EVENT, fd, EPOLLIN);
+    if (!source) {
+        close(fd);
+        return NULL;
+    }
+
+    source->callback = callback;
+    source->user_data = user_data;
+    return source;
+}
+
+void event_loop_signal(EventSource* event) {
+    if (!event || event->type != SOURCE_EVENT) return;
+
+    uint64_t one = 1;
+    ssize_t ignored = write(event->fd, &one, sizeof(one));
+    (void)ignored;
+}
+
+void event_loop_remove(EventLoop* loop, EventSource* source) {
+    if (!loop || !source || source->removed) return;
+
+    epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+    if (source->type != SOURCE_FD) {
+        close(source->fd);
+    }
+    source->fd = -1;
+    source->removed = true;
+
+    // Unlink now; free later, as a pending epoll event in this batch may still point at it
+    for (EventSource** link = &loop->sources; *link; link = &(*link)->next) {
+        if (*link == source) {
+            *link = source->next;
+            break;
+        }
+    }
+    source->next = loop->removed_sources;
+    loop->removed_sources = source;
+
+    if (!loop->thread_started) {
+        free_removed_sources(loop);
+    }
+}
+
+bool event_loop_start(EventLoop* loop) {
+    if (!loop || loop->thread_started) return false;
+
+    loop->stop_requested = false;
+    if (pthread_create(&loop->thread, NULL, event_loop_thread_function, loop) != 0) {
+        perror("Failed to create event loop thread");
+        return false;
+    }
+
+    loop->thread_started = true;
+    return true;
+}
+
+void event_loop_stop(EventLoop* loop) {
+    if (!loop || !loop->thread_started) return;
+
+    loop->stop_requested = true;
+    event_loop_signal(loop->stop_event);
+    pthread_join(loop->thread, NULL);
+    loop->thread_started = false;
+    free_removed_sources(loop);
+
+    // The thread exits without dispatching the stop event; a restarted loop must not see it
+    uint64_t count;
+    ssize_t ignored = read(loop->stop_event->fd, &count, sizeof(count));
+    (void)ignored;
+}
+
+void event_loop_destroy(EventLoop* loop) {
+    if (!loop) return;
+
+    event_loop_stop(loop);
+
+    while (loop->sources) {
+        event_loop_remove(loop, loop->sources);
+    }
+    free_removed_sources(loop);
+
+    close(loop->epoll_fd);
+    free(loop);
+}
+
+// --- Private Function Implementations ---
+
+static EventSource* register_source(EventLoop* loop, EventSourceType type, int fd, uint32_t events) {
+    EventSource* source = calloc(1, sizeof(EventSource));
+    if (!source) {
+        perror("Failed to allocate memory for EventSource");
+        return NULL;
+    }
+
+    source->type = type;
+    source->fd = fd;
+
+    struct epoll_event event = { .events = events, .data.ptr = source };
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        fprintf(stderr, "EventLoop: Cannot watch fd %d: %s\n", fd, strerror(errno));
+        free(source);
+        return NULL;
+    }
+
+    source->next = loop->sources;
+    loop->sources = source;
+    return source;
+}
+
+static void free_removed_sources(EventLoop* loop) {
+    while (loop->removed_sources) {
+        EventSource* next = loop->removed_sources->next;
+        free(loop->removed_sources);
+        loop->removed_sources = next;
+    }
+}
+
+static void dispatch(EventLoop* loop, EventSource* source, uint32_t events) {
+    if (source->removed) return;
+
+    if (source->type == SOURCE_FD) {
+        source->fd_callback(loop, source->fd, events, source->user_data);
+        return;
+    }
+
+    // Timers and events: drain the counter first so the fd stops being readable
+    uint64_t count;
+    ssize_t ignored = read(source->fd, &count, sizeof(count));
+    (void)ignored;
+    source->callback(loop, source->user_data);
+}
+
+static void* event_loop_thread_function(void* arg) {
+    EventLoop* loop = (EventLoop*)arg;
+    struct epoll_event events[EVENT_LOOP_MAX_EVENTS];
+
+    while (!loop->stop_requested) {
+        int ready = epoll_wait(loop->epoll_fd, events, EVENT_LOOP_MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            perror("EventLoop: epoll_wait failed");
+            break;
+        }
+
+        for (int i = 0; i < ready && !loop->stop_requested; i++) {
+            dispatch(loop, (EventSource*)events[i].data.ptr, events[i].events);
+        }
+
+        free_removed_sources(loop);
+    }
+
+    return NULL;
+}
+
+static void handle_stop_event(EventLoop* loop, void* user_data) {
+    (void)user_data;
+    loop->stop_requested = true;
+}
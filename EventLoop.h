@@ -0,0 +1,96 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+
+/**
+ * @file EventLoop.h
+ * @brief Single-threaded epoll reactor for background (non-acquisition) work.
+ *
+ * File descriptors, timers (timerfd) and wake-up events (eventfd) are all
+ * dispatched as callbacks from one thread that sleeps in epoll_wait() while
+ * nothing is due, replacing threads that poll with sleep()/select() timeouts.
+ *
+ * Sources may be added before event_loop_start() or from inside callbacks.
+ * Once the loop is running, other threads may only call event_loop_signal()
+ * and event_loop_stop(). Callbacks must not block.
+ */
+
+typedef struct EventLoop EventLoop;     // Opaque reactor type
+typedef struct EventSource EventSource; // Handle returned for every registered source
+
+// Called when a watched fd is ready; events is the epoll event mask (EPOLLIN, EPOLLHUP, ...)
+typedef void (*EventLoopFdCallback)(EventLoop* loop, int fd, uint32_t events, void* user_data);
+
+// Called when a timer expires or an event is signalled
+typedef void (*EventLoopCallback)(EventLoop* loop, void* user_data);
+
+/**
+ * @brief Creates an event loop (not yet running).
+ * @return A new event loop, or NULL on failure
+ */
+EventLoop* event_loop_create(void);
+
+/**
+ * @brief Watches a file descriptor. The caller keeps ownership of fd.
+ * @param events epoll event mask (e.g. EPOLLIN)
+ * @return Source handle, or NULL on failure
+ */
+EventSource* event_loop_add_fd(EventLoop* loop, int fd, uint32_t events,
+                               EventLoopFdCallback callback, void* user_data);
+
+/**
+ * @brief Changes the epoll event mask of a watched fd (e.g. adds EPOLLOUT while output is pending).
+ */
+bool event_loop_modify_fd(EventLoop* loop, EventSource* source, uint32_t events);
+
+/**
+ * @brief Creates a timer. A period of 0 makes it one-shot; an initial delay of 0 leaves it disarmed.
+ * @return Source handle, or NULL on failure
+ */
+EventSource* event_loop_add_timer(EventLoop* loop, unsigned initial_ms, unsigned period_ms,
+                                  EventLoopCallback callback, void* user_data);
+
+/**
+ * @brief Re-arms (or disarms with initial_ms = 0) an existing timer.
+ */
+bool event_loop_set_timer(EventSource* timer, unsigned initial_ms, unsigned period_ms);
+
+/**
+ * @brief Creates an event that other threads (or signal handlers) can trigger.
+ * @return Source handle, or NULL on failure
+ */
+EventSource* event_loop_add_event(EventLoop* loop, EventLoopCallback callback, void* user_data);
+
+/**
+ * @brief Triggers an event source. Async-signal-safe and callable from any thread.
+ *
+ * Several signals before the callback runs are coalesced into one call.
+ */
+void event_loop_signal(EventSource* event);
+
+/**
+ * @brief Unregisters and frees a source (timer and event fds are closed; watched fds are not).
+ *
+ * Safe to call from inside any callback, including the source's own.
+ */
+void event_loop_remove(EventLoop* loop, EventSource* source);
+
+/**
+ * @brief Starts the dispatch thread.
+ */
+bool event_loop_start(EventLoop* loop);
+
+/**
+ * @brief Stops the dispatch thread and waits for it to exit. Sources stay registered.
+ */
+void event_loop_stop(EventLoop* loop);
+
+/**
+ * @brief Stops the loop if running and frees it together with all remaining sources.
+ */
+void event_loop_destroy(EventLoop* loop);
+
+#endif // EVENT_LOOP_H
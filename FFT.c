@@ -0,0 +1,211 @@
+#include "FFT.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+struct FFT {
+    int size;           // Real input length N
+    int half;           // Complex transform length M = N / 2
+    int log2_half;
+
+    int* bit_reverse;   // M entries
+    float* cos_table;   // cos(2*pi*k / M), k < M / 2
+    float* sin_table;   // sin(2*pi*k / M)
+    float* split_cos;   // cos(2*pi*k / N), k < M (real-input unpacking)
+    float* split_sin;
+
+    float* work_re;     // M entries
+    float* work_im;
+};
+
+// --- Private Function Prototypes ---
+static void radix2_pass(FFT* fft, int span);
+static void radix4_pass(FFT* fft, int span);
+static void complex_transform(FFT* fft);
+
+// --- Public Functions ---
+
+FFT* fft_create(int size) {
+    if (size < 4 || (size & (size - 1)) != 0) {
+        fprintf(stderr, "FFT: Size %d is not a power of two >= 4\n", size);
+        return NULL;
+    }
+
+    FFT* fft = calloc(1, sizeof(FFT));
+    if (!fft) {
+        perror("Failed to allocate memory for FFT");
+        return NULL;
+    }
+
+    fft->size = size;
+    fft->half = size / 2;
+    while ((1 << fft->log2_half) < fft->half) fft->log2_half++;
+
+    int m = fft->half;
+    fft->bit_reverse = malloc(m * sizeof(int));
+    fft->cos_table = malloc((m / 2 + 1) * sizeof(float));
+    fft->sin_table = malloc((m / 2 + 1) * sizeof(float));
+    fft->split_cos = malloc(m * sizeof(float));
+    fft->split_sin = malloc(m * sizeof(float));
+    fft->work_re = malloc(m * sizeof(float));
+    fft->work_im = malloc(m * sizeof(float));
+    if (!fft->bit_reverse || !fft->cos_table || !fft->sin_table || !fft->split_cos ||
+        !fft->split_sin || !fft->work_re || !fft->work_im) {
+        perror("Failed to allocate memory for FFT tables");
+        fft_destroy(fft);
+        return NULL;
+    }
+
+    for (int i = 0; i < m; i++) {
+        int reversed = 0;
+        for (int bit = 0; bit < fft->log2_half; bit++) {
+            if (i & (1 << bit)) reversed |= 1 << (fft->log2_half - 1 - bit);
+        }
+        fft->bit_reverse[i] = reversed;
+    }
+
+    // Tables are computed in double precision so their error does not grow with N
+    for (int k = 0; k <= m / 2; k++) {
+        fft->cos_table[k] = (float)cos(2.0 * M_PI * k / m);
+        fft->sin_table[k] = (float)sin(2.0 * M_PI * k / m);
+    }
+    for (int k = 0; k < m; k++) {
+        fft->split_cos[k] = (float)cos(2.0 * M_PI * k / size);
+        fft->split_sin[k] = (float)sin(2.0 * M_PI * k / size);
+    }
+    return fft;
+}
+
+int fft_size(const FFT* fft) {
+    return fft ? fft->size : 0;
+}
+
+void fft_forward_real(FFT* fft, const float* input, float* re, float* im) {
+    if (!fft || !input || !re || !im) return;
+
+    int m = fft->half;
+
+    // Even samples become the real part, odd samples the imaginary part (bit-reversed order)
+    for (int i = 0; i < m; i++) {
+        int j = fft->bit_reverse[i];
+        fft->work_re[j] = input[2 * i];
+        fft->work_im[j] = input[2 * i + 1];
+    }
+
+    complex_transform(fft);
+
+    // Unpack: X[k] = E[k] + W_N^k * O[k], with E and O the spectra of the even and odd samples
+    const float* zr = fft->work_re;
+    const float* zi = fft->work_im;
+    re[0] = zr[0] + zi[0];
+    im[0] = 0.0f;
+    re[m] = zr[0] - zi[0];
+    im[m] = 0.0f;
+    for (int k = 1; k < m; k++) {
+        float even_re = 0.5f * (zr[k] + zr[m - k]);
+        float even_im = 0.5f * (zi[k] - zi[m - k]);
+        float odd_re = 0.5f * (zi[k] + zi[m - k]);
+        float odd_im = -0.5f * (zr[k] - zr[m - k]);
+        float w_re = fft->split_cos[k];
+        float w_im = -fft->split_sin[k];
+        re[k] = even_re + w_re * odd_re - w_im * odd_im;
+        im[k] = even_im + w_re * odd_im + w_im * odd_re;
+    }
+}
+
+void fft_destroy(FFT* fft) {
+    if (!fft) return;
+
+    free(fft->bit_reverse);
+    free(fft->cos_table);
+    free(fft->sin_table);
+    free(fft->split_cos);
+    free(fft->split_sin);
+    free(fft->work_re);
+    free(fft->work_im);
+    free(fft);
+}
+
+// --- Private Function Implementations ---
+
+// In-place forward transform of the bit-reversed work buffers
+static void complex_transform(FFT* fft) {
+    int span = 1;
+    if (fft->log2_half % 2 != 0) {
+        radix2_pass(fft, span);
+        span = 2;
+    }
+    for (; span < fft->half; span *= 4) {
+        radix4_pass(fft, span);
+    }
+}
+
+// One radix-2 stage: butterflies between j and j + span in blocks of 2 * span
+static void radix2_pass(FFT* fft, int span) {
+    float* re = fft->work_re;
+    float* im = fft->work_im;
+    int stride = fft->half / (2 * span); // Twiddle W_{2*span}^j = W_M^(j * stride)
+
+    for (int block = 0; block < fft->half; block += 2 * span) {
+        for (int j = 0; j < span; j++) {
+            float w_re = fft->cos_table[j * stride];
+            float w_im = -fft->sin_table[j * stride];
+            int a = block + j;
+            int b = a + span;
+            float t_re = w_re * re[b] - w_im * im[b];
+            float t_im = w_re * im[b] + w_im * re[b];
+            re[b] = re[a] - t_re;
+            im[b] = im[a] - t_im;
+            re[a] += t_re;
+            im[a] += t_im;
+        }
+    }
+}
+
+// Two radix-2 stages (spans `span` and 2 * span) fused into one pass over blocks of 4 * span
+static void radix4_pass(FFT* fft, int span) {
+    float* re = fft->work_re;
+    float* im = fft->work_im;
+    int stride1 = fft->half / (2 * span); // W_{2*span}^j
+    int stride2 = fft->half / (4 * span); // W_{4*span}^j
+
+    for (int block = 0; block < fft->half; block += 4 * span) {
+        for (int j = 0; j < span; j++) {
+            int a = block + j;
+            int b = a + span;
+            int c = b + span;
+            int d = c + span;
+
+            // First stage: (a, b) and (c, d) with W1 = W_{2*span}^j
+            float w1_re = fft->cos_table[j * stride1];
+            float w1_im = -fft->sin_table[j * stride1];
+            float tb_re = w1_re * re[b] - w1_im * im[b];
+            float tb_im = w1_re * im[b] + w1_im * re[b];
+            float td_re = w1_re * re[d] - w1_im * im[d];
+            float td_im = w1_re * im[d] + w1_im * re[d];
+            float a1_re = re[a] + tb_re, a1_im = im[a] + tb_im;
+            float b1_re = re[a] - tb_re, b1_im = im[a] - tb_im;
+            float c1_re = re[c] + td_re, c1_im = im[c] + td_im;
+            float d1_re = re[c] - td_re, d1_im = im[c] - td_im;
+
+            // Second stage: (a, c) with W2 = W_{4*span}^j, (b, d) with W_{4*span}^(j+span) = -i * W2
+            float w2_re = fft->cos_table[j * stride2];
+            float w2_im = -fft->sin_table[j * stride2];
+            float tc_re = w2_re * c1_re - w2_im * c1_im;
+            float tc_im = w2_re * c1_im + w2_im * c1_re;
+            float tw_re = w2_re * d1_re - w2_im * d1_im;
+            float tw_im = w2_re * d1_im + w2_im * d1_re;
+            float td2_re = tw_im;   // -i * (x + iy) = y - ix
+            float td2_im = -tw_re;
+
+            re[a] = a1_re + tc_re;
+            im[a] = a1_im + tc_im;
+            re[c] = a1_re - tc_re;
+            im[c] = a1_im - tc_im;
+            re[b] = b1_re + td2_re;
+            im[b] = b1_im + td2_im;
+            re[d] = b1_re - td2_re;
+            im[d] = b1_im - td2_im;
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef FFT_H
+#define FFT_H
+
+/**
+ * @file FFT.h
+ * @brief Dependency-free real-input FFT for power-of-two lengths.
+ *
+ * A real sequence of N samples is packed into an N/2-point complex sequence,
+ * transformed in place and unpacked into bins 0..N/2. The complex transform is
+ * an iterative decimation-in-time FFT that runs two radix-2 stages per pass
+ * (radix-2^2, i.e. radix-4 butterflies with a standard bit-reversed input),
+ * plus one radix-2 stage when log2(N/2) is odd. Real and imaginary parts live
+ * in separate arrays and every butterfly loop walks them contiguously, so the
+ * compiler can vectorize it without intrinsics. A plan holds the twiddle and
+ * bit-reversal tables and its work buffers; it is not thread-safe.
+ */
+
+typedef struct FFT FFT; // Opaque FFT plan
+
+/**
+ * @brief Creates a plan for real input of the given length.
+ * @param size Number of real samples (a power of two, at least 4)
+ * @return A pointer to the plan, or NULL on failure
+ */
+FFT* fft_create(int size);
+
+/**
+ * @brief Returns the real input length of the plan.
+ */
+int fft_size(const FFT* fft);
+
+/**
+ * @brief Computes the forward DFT of size real samples (no scaling).
+ *
+ * X[k] = sum_n input[n] * exp(-2*pi*i*k*n / size)
+ *
+ * @param input size samples
+ * @param re Receives size/2 + 1 real parts (bins 0..size/2)
+ * @param im Receives size/2 + 1 imaginary parts
+ */
+void fft_forward_real(FFT* fft, const float* input, float* re, float* im);
+
+/**
+ * @brief Frees the plan.
+ */
+void fft_destroy(FFT* fft);
+
+#endif // FFT_H
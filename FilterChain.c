@@ -0,0 +1,279 @@
+#include "FilterChain.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define MAD_TO_SIGMA 1.4826          // Scales a median absolute deviation to a Gaussian sigma
+#define LOWPASS_REDESIGN_RATIO 0.05  // Recompute biquad coefficients when dt drifts by more than 5%
+#define LOWPASS_MAX_CUTOFF_RATIO 0.45 // Corner is kept below this fraction of the sample rate
+
+// A compiled stage: its configuration and running state
+typedef struct {
+    ChannelFilterStage config;
+    bool primed;               // Has seen its first sample
+
+    // Median / Hampel window
+    double ring[CHANNEL_FILTER_MAX_WINDOW];
+    int ring_head;
+    int ring_len;
+
+    // EMA / Kalman estimate
+    double state;
+    double variance;
+
+    // Low-pass biquad (transposed direct form II)
+    double b0, b1, b2, a1, a2;
+    double z1, z2;
+    double design_dt_s;
+} FilterStage;
+
+struct FilterChain {
+    int count;
+    FilterStage* stages;                       // All channels' stages back to back
+    int total_stages;
+    int first_stage[MAX_TOTAL_CHANNELS];
+    int stage_count[MAX_TOTAL_CHANNELS];
+    double last_time_s[MAX_TOTAL_CHANNELS];    // Time of the channel's previous sample (0 = none)
+    double last_dt_s[MAX_TOTAL_CHANNELS];      // Used when a sample has no usable timestamp
+};
+
+// --- Private Function Prototypes ---
+static double stage_apply(FilterStage* stage, double value, double dt_s);
+static double window_push_median(FilterStage* stage, double value);
+static double median_of(double* values, int count);
+static void lowpass_design(FilterStage* stage, double dt_s);
+static bool same_stages(const FilterStage* compiled, int compiled_count, const Channel* channel);
+
+// --- Public Functions ---
+
+FilterChain* filter_chain_create(const Channel* channels, int count) {
+    if (!channels || count < 0 || count > MAX_TOTAL_CHANNELS) {
+        fprintf(stderr, "FilterChain: Invalid parameters\n");
+        return NULL;
+    }
+
+    FilterChain* chain = calloc(1, sizeof(FilterChain));
+    if (!chain) {
+        perror("Failed to allocate memory for FilterChain");
+        return NULL;
+    }
+
+    if (!filter_chain_configure(chain, channels, count)) {
+        filter_chain_destroy(chain);
+        return NULL;
+    }
+    return chain;
+}
+
+bool filter_chain_configure(FilterChain* chain, const Channel* channels, int count) {
+    if (!chain || !channels || count < 0 || count > MAX_TOTAL_CHANNELS) return false;
+
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        int stages = channels[i].filter_count;
+        total += stages < CHANNEL_MAX_FILTER_STAGES ? stages : CHANNEL_MAX_FILTER_STAGES;
+    }
+
+    FilterStage* stages = calloc(total > 0 ? total : 1, sizeof(FilterStage));
+    if (!stages) {
+        perror("Failed to allocate memory for filter stages");
+        return false;
+    }
+
+    int next = 0;
+    for (int i = 0; i < count; i++) {
+        int stage_count = channels[i].filter_count;
+        if (stage_count > CHANNEL_MAX_FILTER_STAGES) stage_count = CHANNEL_MAX_FILTER_STAGES;
+
+        bool keep = i < chain->count && chain->stage_count[i] == stage_count &&
+                    same_stages(&chain->stages[chain->first_stage[i]], chain->stage_count[i], &channels[i]);
+        for (int s = 0; s < stage_count; s++) {
+            if (keep) {
+                stages[next + s] = chain->stages[chain->first_stage[i] + s];
+            } else {
+                stages[next + s].config = channels[i].filters[s];
+            }
+        }
+        if (!keep) {
+            chain->last_time_s[i] = 0.0;
+            chain->last_dt_s[i] = 0.0;
+        }
+
+        chain->first_stage[i] = next;
+        chain->stage_count[i] = stage_count;
+        next += stage_count;
+    }
+
+    free(chain->stages);
+    chain->stages = stages;
+    chain->total_stages = total;
+    chain->count = count;
+    return true;
+}
+
+int filter_chain_stage_count(const FilterChain* chain, int index) {
+    if (!chain || index < 0 || index >= chain->count) return 0;
+    return chain->stage_count[index];
+}
+
+double filter_chain_process(FilterChain* chain, int index, double value, double time_s) {
+    if (!chain || index < 0 || index >= chain->count || !isfinite(value)) return value;
+
+    // Samples without a usable timestamp reuse the channel's previous spacing
+    double dt_s = chain->last_dt_s[index];
+    if (chain->last_time_s[index] > 0.0 && time_s > chain->last_time_s[index]) {
+        dt_s = time_s - chain->last_time_s[index];
+        chain->last_dt_s[index] = dt_s;
+    }
+    if (time_s > 0.0) chain->last_time_s[index] = time_s;
+
+    FilterStage* stage = &chain->stages[chain->first_stage[index]];
+    for (int s = 0; s < chain->stage_count[index]; s++) {
+        value = stage_apply(&stage[s], value, dt_s);
+    }
+    return value;
+}
+
+void filter_chain_run(FilterChain* chain, Channel channels[], ChannelMask mask) {
+    if (!chain || !channels) return;
+
+    for (int i = 0; i < chain->count; i++) {
+        if (!(mask & CHANNEL_MASK_BIT(i))) continue;
+
+        Channel* channel = &channels[i];
+        if (chain->stage_count[i] == 0) {
+            channel_apply_filter(channel, channel->filter_alpha);
+            continue;
+        }
+        channel->filtered_adc_value = filter_chain_process(chain, i, (double)channel->raw_adc_value,
+                                                           channel->sample_time_s);
+    }
+}
+
+void filter_chain_destroy(FilterChain* chain) {
+    if (!chain) return;
+
+    free(chain->stages);
+    free(chain);
+}
+
+// --- Private Function Implementations ---
+
+static double stage_apply(FilterStage* stage, double value, double dt_s) {
+    const ChannelFilterStage* config = &stage->config;
+    bool first = !stage->primed;
+    stage->primed = true;
+
+    switch (config->type) {
+        case CHANNEL_FILTER_MEDIAN:
+            return window_push_median(stage, value);
+
+        case CHANNEL_FILTER_HAMPEL: {
+            double median = window_push_median(stage, value);
+            double deviations[CHANNEL_FILTER_MAX_WINDOW];
+            for (int k = 0; k < stage->ring_len; k++) {
+                deviations[k] = fabs(stage->ring[k] - median);
+            }
+            double sigma = MAD_TO_SIGMA * median_of(deviations, stage->ring_len);
+            return fabs(value - median) > config->threshold * sigma ? median : value;
+        }
+
+        case CHANNEL_FILTER_EMA:
+            if (first) {
+                stage->state = value;
+            } else if (dt_s > 0.0) {
+                stage->state += (1.0 - exp(-dt_s / config->time_constant_s)) * (value - stage->state);
+            }
+            return stage->state;
+
+        case CHANNEL_FILTER_LOWPASS: {
+            if (stage->design_dt_s <= 0.0) {
+                if (dt_s <= 0.0) {
+                    stage->state = value; // No sample spacing known yet
+                    return value;
+                }
+                lowpass_design(stage, dt_s);
+                // Start in steady state at the previous value (unity DC gain)
+                double start = first ? value : stage->state;
+                stage->z2 = (stage->b2 - stage->a2) * start;
+                stage->z1 = (stage->b1 - stage->a1) * start + stage->z2;
+            } else if (dt_s > 0.0 && fabs(dt_s - stage->design_dt_s) > LOWPASS_REDESIGN_RATIO * stage->design_dt_s) {
+                lowpass_design(stage, dt_s);
+            }
+            double output = stage->b0 * value + stage->z1;
+            stage->z1 = stage->b1 * value - stage->a1 * output + stage->z2;
+            stage->z2 = stage->b2 * value - stage->a2 * output;
+            return output;
+        }
+
+        case CHANNEL_FILTER_KALMAN: {
+            if (first) {
+                stage->state = value;
+                stage->variance = config->measurement_noise;
+                return value;
+            }
+            if (dt_s > 0.0) stage->variance += config->process_noise * dt_s;
+            double gain = stage->variance / (stage->variance + config->measurement_noise);
+            stage->state += gain * (value - stage->state);
+            stage->variance *= 1.0 - gain;
+            return stage->state;
+        }
+
+        default:
+            return value;
+    }
+}
+
+// Adds the sample to the stage's window and returns the window median
+static double window_push_median(FilterStage* stage, double value) {
+    int window = stage->config.window;
+    stage->ring[stage->ring_head] = value;
+    stage->ring_head = (stage->ring_head + 1) % window;
+    if (stage->ring_len < window) stage->ring_len++;
+
+    double sorted[CHANNEL_FILTER_MAX_WINDOW];
+    memcpy(sorted, stage->ring, stage->ring_len * sizeof(double));
+    return median_of(sorted, stage->ring_len);
+}
+
+// Sorts in place (insertion sort; windows are tiny) and returns the median
+static double median_of(double* values, int count) {
+    for (int i = 1; i < count; i++) {
+        double v = values[i];
+        int j = i - 1;
+        while (j >= 0 && values[j] > v) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = v;
+    }
+    if (count % 2 == 1) return values[count / 2];
+    return 0.5 * (values[count / 2 - 1] + values[count / 2]);
+}
+
+// Bilinear-transform low-pass (audio EQ cookbook) for the given sample spacing
+static void lowpass_design(FilterStage* stage, double dt_s) {
+    double cutoff_hz = stage->config.cutoff_hz;
+    double max_cutoff_hz = LOWPASS_MAX_CUTOFF_RATIO / dt_s;
+    if (cutoff_hz > max_cutoff_hz) cutoff_hz = max_cutoff_hz;
+
+    double w0 = 2.0 * M_PI * cutoff_hz * dt_s;
+    double cos_w0 = cos(w0);
+    double alpha = sin(w0) / (2.0 * stage->config.q);
+    double a0 = 1.0 + alpha;
+
+    stage->b0 = 0.5 * (1.0 - cos_w0) / a0;
+    stage->b1 = (1.0 - cos_w0) / a0;
+    stage->b2 = stage->b0;
+    stage->a1 = -2.0 * cos_w0 / a0;
+    stage->a2 = (1.0 - alpha) / a0;
+    stage->design_dt_s = dt_s;
+}
+
+static bool same_stages(const FilterStage* compiled, int compiled_count, const Channel* channel) {
+    for (int s = 0; s < compiled_count; s++) {
+        if (memcmp(&compiled[s].config, &channel->filters[s], sizeof(ChannelFilterStage)) != 0) return false;
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef FILTER_CHAIN_H
+#define FILTER_CHAIN_H
+
+#include <stdbool.h>
+#include "Channel.h"
+#include "SweepScheduler.h" // For ChannelMask
+
+/**
+ * @file FilterChain.h
+ * @brief Per-channel filter pipelines configured by the YAML `filters` list.
+ *
+ * Every channel's stages are compiled into one flat array, so a sweep runs
+ * all chains in a single pass over the channels that got a new sample. Each
+ * stage sees the output of the previous one and the real time between the
+ * channel's samples (from sample_time_s), so the EMA time constant, low-pass
+ * corner and Kalman process noise mean the same thing at any sweep rate or
+ * sample_interval_ms. Median and Hampel windows count samples.
+ *
+ * Chains work on raw ADC counts and write filtered_adc_value, like the plain
+ * filter_alpha EMA, so calibration changes apply immediately. Since the
+ * Kalman gain depends only on the ratio of its two noise parameters, they can
+ * be given in calibrated units. Channels without stages keep the filter_alpha EMA.
+ */
+
+typedef struct FilterChain FilterChain; // Opaque filter pipelines for all channels
+
+/**
+ * @brief Compiles the chains of the given channels.
+ * @param channels Channel array
+ * @param count Number of channels
+ * @return A pointer to the chains, or NULL on failure
+ */
+FilterChain* filter_chain_create(const Channel* channels, int count);
+
+/**
+ * @brief Recompiles after a reload. Channels whose stages are unchanged keep their filter state.
+ * @return true on success
+ */
+bool filter_chain_configure(FilterChain* chain, const Channel* channels, int count);
+
+/**
+ * @brief Returns the number of stages of a channel's chain (0 = filter_alpha EMA).
+ */
+int filter_chain_stage_count(const FilterChain* chain, int index);
+
+/**
+ * @brief Runs one sample through a channel's stages.
+ * @param time_s Monotonic time of the sample in seconds
+ * @return The filtered value (the input itself when the channel has no stages)
+ */
+double filter_chain_process(FilterChain* chain, int index, double value, double time_s);
+
+/**
+ * @brief Filters the latest raw value of every channel in mask into filtered_adc_value.
+ */
+void filter_chain_run(FilterChain* chain, Channel channels[], ChannelMask mask);
+
+/**
+ * @brief Frees the chains.
+ */
+void filter_chain_destroy(FilterChain* chain);
+
+#endif // FILTER_CHAIN_H
@@ -0,0 +1,664 @@
+#define _GNU_SOURCE // accept4()
+#include "Gateway.h"
+#include "ConfigYAML.h"
+#include "DataPublisher.h"
+#include "EventLoop.h"
+#include "LineProtocol.h"
+#include "MqttPublisher.h"
+#include "Sender.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <math.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#define GATEWAY_READ_BUFFER_SIZE 65536          // Per TCP connection; also the longest line accepted
+#define GATEWAY_NODE_ID_SIZE 64
+#define GATEWAY_NODE_TAG ",node="
+#define GATEWAY_DATAGRAMS_PER_WAKEUP 64         // Bounds a UDP burst so the TCP nodes are served too
+#define GATEWAY_UDP_RECEIVE_BUFFER (4 * 1024 * 1024)
+#define GATEWAY_OFFLINE_REPLAY_INTERVAL_MS 60000
+#define GATEWAY_BACKLOG_CHECK_MS 100            // Queue check while the TCP nodes are paused
+
+// A sending node, by announced id or peer address
+typedef struct {
+    char id[GATEWAY_NODE_ID_SIZE];
+    bool in_use;
+    int connections;                         // TCP connections sending as this node (never evicted while > 0)
+    double last_seen_s;                      // Monotonic
+    double tokens;                           // Lines (or frames) the node may send now
+    double refilled_s;
+    uint64_t newest_sequence;
+    uint64_t recent[GATEWAY_DEDUP_WINDOW];   // recent[sequence % window] = sequence
+    unsigned long lines;
+    unsigned long frames;
+    unsigned long duplicates;
+    unsigned long over_budget;               // UDP messages dropped over the node's budget
+    unsigned long malformed;
+} GatewayNode;
+
+typedef struct {
+    Gateway* gateway;
+    int fd;
+    int slot;
+    EventSource* source;                     // NULL while the node is over its budget or the gateway is paused
+    EventSource* resume_timer;
+    GatewayNode* node;                       // NULL until the first message
+    char peer[GATEWAY_NODE_ID_SIZE];
+    bool end_of_stream;                      // Closed by the peer: close once the buffer is consumed
+    bool overflow;                           // Discarding an over-long line up to its newline
+    size_t length;
+    uint8_t buffer[GATEWAY_READ_BUFFER_SIZE];
+} GatewayConnection;
+
+struct Gateway {
+    YAMLAppConfig* config;
+    SenderContext* sender;
+    EventLoop* loop;
+    int tcp_fd;
+    int udp_fd;
+    GatewayNode* nodes;                      // gateway.max_nodes entries
+    GatewayConnection** connections;         // Up to gateway.max_nodes at once
+    LineProtocolBuilder* builder;
+    AcquisitionFrame frame;                  // Last decoded binary frame
+    char* line;                              // Outgoing line, node tag included
+    unsigned long unassigned;                // Messages dropped because the node table was full
+    bool paused;                             // Sender queue over the high-water mark: TCP nodes are not read
+    EventSource* backlog_timer;              // Armed while paused
+    unsigned long spilled;                   // Lines sent to the offline queue while paused
+    uint8_t datagram[65536];
+};
+
+// --- Private Function Prototypes ---
+static bool open_sockets(Gateway* gateway);
+static void handle_accept(EventLoop* loop, int fd, uint32_t events, void* user_data);
+static void handle_connection_ready(EventLoop* loop, int fd, uint32_t events, void* user_data);
+static void handle_resume(EventLoop* loop, void* user_data);
+static void handle_datagrams(EventLoop* loop, int fd, uint32_t events, void* user_data);
+static void handle_replay_timer(EventLoop* loop, void* user_data);
+static void handle_backlog_timer(EventLoop* loop, void* user_data);
+static void drain_connection(GatewayConnection* connection);
+static void close_connection(GatewayConnection* connection);
+static size_t consume_messages(Gateway* gateway, GatewayNode** node, const char* peer, const uint8_t* data,
+                               size_t length, bool complete, bool drop_over_budget, bool* exhausted);
+static void handle_comment(Gateway* gateway, GatewayNode** node, const uint8_t* text, size_t length);
+static GatewayNode* resolve_node(Gateway* gateway, const char* id);
+static bool take_token(Gateway* gateway, GatewayNode* node);
+static void forward_line(Gateway* gateway, GatewayNode* node, const char* text, size_t length);
+static void forward_frame(Gateway* gateway, GatewayNode* node, const uint8_t* record, size_t length);
+static bool is_duplicate_frame(GatewayNode* node, uint64_t sequence);
+static bool submit_tagged(Gateway* gateway, const GatewayNode* node, const char* text, size_t length);
+static void print_node(const GatewayNode* node);
+static double monotonic_s(void);
+
+// --- Public Functions ---
+
+Gateway* gateway_create(const char* config_file) {
+    if (!config_file) return NULL;
+
+    Gateway* gateway = calloc(1, sizeof(Gateway));
+    if (!gateway) {
+        perror("Failed to allocate memory for Gateway");
+        return NULL;
+    }
+    gateway->tcp_fd = -1;
+    gateway->udp_fd = -1;
+
+    gateway->config = config_yaml_load(config_file);
+    if (!gateway->config) {
+        fprintf(stderr, "Gateway: Configuration file load failed: %s\n", config_file);
+        gateway_destroy(gateway);
+        return NULL;
+    }
+    char validation_error[512];
+    if (config_yaml_validate_comprehensive(gateway->config, validation_error, sizeof(validation_error)) != CONFIG_YAML_SUCCESS) {
+        fprintf(stderr, "Gateway: Configuration validation failed: %s\n", validation_error);
+        gateway_destroy(gateway);
+        return NULL;
+    }
+
+    // The site's single upstream writer always compresses its batches
+    gateway->config->influxdb.gzip = true;
+
+    int max_nodes = gateway->config->gateway.max_nodes;
+    gateway->nodes = calloc((size_t)max_nodes, sizeof(GatewayNode));
+    gateway->connections = calloc((size_t)max_nodes, sizeof(GatewayConnection*));
+    gateway->builder = lp_builder_create_default();
+    gateway->line = malloc(GATEWAY_READ_BUFFER_SIZE + GATEWAY_NODE_ID_SIZE + sizeof(GATEWAY_NODE_TAG));
+    if (!gateway->nodes || !gateway->connections || !gateway->builder || !gateway->line) {
+        fprintf(stderr, "Gateway: Memory allocation failed\n");
+        gateway_destroy(gateway);
+        return NULL;
+    }
+
+    gateway->sender = sender_create_from_yaml(gateway->config);
+    gateway->loop = event_loop_create();
+    if (!gateway->sender || !gateway->loop || !open_sockets(gateway)) {
+        gateway_destroy(gateway);
+        return NULL;
+    }
+
+    if (!event_loop_add_fd(gateway->loop, gateway->tcp_fd, EPOLLIN, handle_accept, gateway) ||
+        !event_loop_add_fd(gateway->loop, gateway->udp_fd, EPOLLIN, handle_datagrams, gateway) ||
+        !event_loop_add_timer(gateway->loop, GATEWAY_OFFLINE_REPLAY_INTERVAL_MS, GATEWAY_OFFLINE_REPLAY_INTERVAL_MS,
+                              handle_replay_timer, gateway) ||
+        !(gateway->backlog_timer = event_loop_add_timer(gateway->loop, 0, 0, handle_backlog_timer, gateway)) ||
+        !event_loop_start(gateway->loop)) {
+        fprintf(stderr, "Gateway: Failed to start the event loop\n");
+        gateway_destroy(gateway);
+        return NULL;
+    }
+
+    printf("Gateway: Listening on TCP and UDP port %d for up to %d nodes, %d lines/s each\n",
+           gateway->config->gateway.port, max_nodes, gateway->config->gateway.node_lines_per_s);
+    return gateway;
+}
+
+void gateway_run(Gateway* gateway, volatile sig_atomic_t* shutdown_requested) {
+    if (!gateway || !shutdown_requested) return;
+
+    // Everything happens on the event loop; termination signals interrupt the sleep
+    while (!*shutdown_requested) {
+        sleep(1);
+    }
+    event_loop_stop(gateway->loop);
+
+    for (int n = 0; n < gateway->config->gateway.max_nodes; n++) {
+        if (gateway->nodes[n].in_use) print_node(&gateway->nodes[n]);
+    }
+    if (gateway->unassigned > 0) {
+        printf("Gateway: %lu message(s) dropped with the node table full\n", gateway->unassigned);
+    }
+    if (gateway->spilled > 0) {
+        printf("Gateway: %lu line(s) sent to the offline queue behind an upstream backlog\n", gateway->spilled);
+    }
+}
+
+void gateway_destroy(Gateway* gateway) {
+    if (!gateway) return;
+
+    event_loop_stop(gateway->loop);
+    if (gateway->connections) {
+        for (int c = 0; c < gateway->config->gateway.max_nodes; c++) {
+            if (gateway->connections[c]) close_connection(gateway->connections[c]);
+        }
+    }
+    event_loop_destroy(gateway->loop);
+    if (gateway->tcp_fd >= 0) close(gateway->tcp_fd);
+    if (gateway->udp_fd >= 0) close(gateway->udp_fd);
+
+    // Lines still queued go to the sender's offline queue
+    sender_destroy(gateway->sender);
+
+    lp_builder_destroy(gateway->builder);
+    free(gateway->line);
+    free(gateway->connections);
+    free(gateway->nodes);
+    config_yaml_free(gateway->config);
+    free(gateway);
+}
+
+// --- Private Function Implementations ---
+
+static bool open_sockets(Gateway* gateway) {
+    struct sockaddr_in address = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+        .sin_port = htons((uint16_t)gateway->config->gateway.port),
+    };
+    int opt = 1;
+
+    gateway->tcp_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (gateway->tcp_fd < 0 ||
+        setsockopt(gateway->tcp_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) != 0 ||
+        bind(gateway->tcp_fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(gateway->tcp_fd, SOMAXCONN) != 0) {
+        fprintf(stderr, "Gateway: TCP listen on port %d failed: %s\n", gateway->config->gateway.port, strerror(errno));
+        return false;
+    }
+
+    gateway->udp_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (gateway->udp_fd < 0 ||
+        bind(gateway->udp_fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        fprintf(stderr, "Gateway: UDP bind on port %d failed: %s\n", gateway->config->gateway.port, strerror(errno));
+        return false;
+    }
+
+    // Absorbs bursts from many nodes between wake-ups (capped by net.core.rmem_max)
+    int receive_buffer = GATEWAY_UDP_RECEIVE_BUFFER;
+    setsockopt(gateway->udp_fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer, sizeof(receive_buffer));
+    return true;
+}
+
+static void handle_accept(EventLoop* loop, int fd, uint32_t events, void* user_data) {
+    Gateway* gateway = (Gateway*)user_data;
+
+    // Level-triggered: accept everything that is queued right now
+    while (true) {
+        struct sockaddr_in address;
+        socklen_t address_size = sizeof(address);
+        int node_socket = accept4(fd, (struct sockaddr*)&address, &address_size, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (node_socket < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                fprintf(stderr, "Gateway: Accept failed: %s\n", strerror(errno));
+            }
+            return;
+        }
+
+        int slot = -1;
+        for (int c = 0; c < gateway->config->gateway.max_nodes && slot < 0; c++) {
+            if (!gateway->connections[c]) slot = c;
+        }
+        GatewayConnection* connection = slot >= 0 ? calloc(1, sizeof(GatewayConnection)) : NULL;
+        if (!connection) {
+            fprintf(stderr, "Gateway: Too many node connections, rejecting socket %d\n", node_socket);
+            close(node_socket);
+            continue;
+        }
+
+        connection->gateway = gateway;
+        connection->fd = node_socket;
+        connection->slot = slot;
+        inet_ntop(AF_INET, &address.sin_addr, connection->peer, sizeof(connection->peer));
+        connection->source = event_loop_add_fd(loop, node_socket, EPOLLIN, handle_connection_ready, connection);
+        connection->resume_timer = event_loop_add_timer(loop, 0, 0, handle_resume, connection);
+        gateway->connections[slot] = connection;
+        if (!connection->source || !connection->resume_timer) {
+            fprintf(stderr, "Gateway: Failed to register node connection from %s\n", connection->peer);
+            close_connection(connection);
+            continue;
+        }
+        printf("Gateway: Node connected from %s\n", connection->peer);
+    }
+}
+
+static void handle_connection_ready(EventLoop* loop, int fd, uint32_t events, void* user_data) {
+    GatewayConnection* connection = (GatewayConnection*)user_data;
+
+    ssize_t received = recv(fd, connection->buffer + connection->length,
+                            sizeof(connection->buffer) - connection->length, MSG_DONTWAIT);
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return;
+        fprintf(stderr, "Gateway: Receive from %s failed: %s\n", connection->peer, strerror(errno));
+        connection->end_of_stream = true;
+    } else if (received == 0) {
+        connection->end_of_stream = true;
+    } else {
+        connection->length += (size_t)received;
+    }
+    drain_connection(connection);
+}
+
+// The node's budget has had time to refill
+static void handle_resume(EventLoop* loop, void* user_data) {
+    drain_connection((GatewayConnection*)user_data);
+}
+
+static void handle_datagrams(EventLoop* loop, int fd, uint32_t events, void* user_data) {
+    Gateway* gateway = (Gateway*)user_data;
+
+    for (int d = 0; d < GATEWAY_DATAGRAMS_PER_WAKEUP; d++) {
+        struct sockaddr_in address;
+        socklen_t address_size = sizeof(address);
+        ssize_t received = recvfrom(fd, gateway->datagram, sizeof(gateway->datagram), 0,
+                                    (struct sockaddr*)&address, &address_size);
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                fprintf(stderr, "Gateway: UDP receive failed: %s\n", strerror(errno));
+            }
+            return;
+        }
+
+        // A datagram is read once: what exceeds the node's budget is dropped
+        char peer[GATEWAY_NODE_ID_SIZE];
+        inet_ntop(AF_INET, &address.sin_addr, peer, sizeof(peer));
+        GatewayNode* node = NULL;
+        bool exhausted = false;
+        consume_messages(gateway, &node, peer, gateway->datagram, (size_t)received, true, true, &exhausted);
+    }
+}
+
+static void handle_replay_timer(EventLoop* loop, void* user_data) {
+    sender_request_offline_replay(((Gateway*)user_data)->sender);
+}
+
+// Resumes the TCP nodes once the upstream has worked the sender queue down to the low-water mark
+static void handle_backlog_timer(EventLoop* loop, void* user_data) {
+    Gateway* gateway = (Gateway*)user_data;
+    if (sender_queue_length(gateway->sender) > GATEWAY_QUEUE_LOW_WATER) return;
+
+    printf("Gateway: Upstream caught up, resuming the TCP nodes\n");
+    gateway->paused = false;
+    event_loop_set_timer(gateway->backlog_timer, 0, 0);
+    for (int c = 0; c < gateway->config->gateway.max_nodes; c++) {
+        GatewayConnection* connection = gateway->connections[c];
+        if (connection && !connection->source) drain_connection(connection);
+    }
+}
+
+// Forwards the buffered messages. A node over its budget is not read until it has refilled,
+// so TCP flow control slows that node down and no other.
+static void drain_connection(GatewayConnection* connection) {
+    Gateway* gateway = connection->gateway;
+
+    if (connection->overflow) {
+        uint8_t* newline = memchr(connection->buffer, '\n', connection->length);
+        size_t discarded = newline ? (size_t)(newline - connection->buffer) + 1 : connection->length;
+        memmove(connection->buffer, connection->buffer + discarded, connection->length - discarded);
+        connection->length -= discarded;
+        connection->overflow = newline == NULL;
+    }
+
+    GatewayNode* previous = connection->node;
+    bool exhausted = false;
+    size_t used = consume_messages(gateway, &connection->node, connection->peer, connection->buffer,
+                                   connection->length, connection->end_of_stream, false, &exhausted);
+    memmove(connection->buffer, connection->buffer + used, connection->length - used);
+    connection->length -= used;
+    if (connection->node != previous) {
+        if (previous) previous->connections--;
+        if (connection->node) connection->node->connections++;
+    }
+
+    if (exhausted) {
+        if (connection->source) {
+            event_loop_remove(gateway->loop, connection->source);
+            connection->source = NULL;
+        }
+        // About the time one more line takes to become available
+        unsigned resume_ms = (unsigned)ceil(1000.0 / gateway->config->gateway.node_lines_per_s);
+        event_loop_set_timer(connection->resume_timer, resume_ms, 0);
+        return;
+    }
+
+    if (connection->end_of_stream) {
+        printf("Gateway: Node %s disconnected\n", connection->node ? connection->node->id : connection->peer);
+        close_connection(connection);
+        return;
+    }
+
+    if (connection->length == sizeof(connection->buffer)) {
+        // No complete message in a full buffer: a line longer than the buffer
+        if (connection->node) connection->node->malformed++;
+        connection->length = 0;
+        connection->overflow = true;
+    }
+
+    if (gateway->paused) {
+        // What is buffered went out (or to the offline queue); the rest waits in the socket
+        if (connection->source) {
+            event_loop_remove(gateway->loop, connection->source);
+            connection->source = NULL;
+        }
+    } else if (!connection->source) {
+        connection->source = event_loop_add_fd(gateway->loop, connection->fd, EPOLLIN,
+                                               handle_connection_ready, connection);
+        if (!connection->source) {
+            fprintf(stderr, "Gateway: Failed to resume node connection from %s\n", connection->peer);
+            close_connection(connection);
+        }
+    }
+}
+
+static void close_connection(GatewayConnection* connection) {
+    Gateway* gateway = connection->gateway;
+
+    if (connection->source) event_loop_remove(gateway->loop, connection->source);
+    if (connection->resume_timer) event_loop_remove(gateway->loop, connection->resume_timer);
+    if (connection->node) connection->node->connections--;
+    close(connection->fd);
+    gateway->connections[connection->slot] = NULL;
+    free(connection);
+}
+
+// Forwards the complete messages at the start of data and returns the bytes used. Each message is
+// a binary frame or a line; with complete set, the data ends with the last message (a datagram,
+// or a closed stream). A message over the node's budget is dropped if drop_over_budget is set;
+// otherwise it stops the processing and sets *exhausted.
+static size_t consume_messages(Gateway* gateway, GatewayNode** node, const char* peer, const uint8_t* data,
+                               size_t length, bool complete, bool drop_over_budget, bool* exhausted) {
+    size_t used = 0;
+
+    while (used < length) {
+        const uint8_t* message = data + used;
+        size_t available = length - used;
+        size_t size;
+        bool binary = available >= 4 && memcmp(message, MQTT_BINARY_MAGIC, 4) == 0;
+
+        if (binary) {
+            size = available >= MQTT_BINARY_HEADER_SIZE
+                       ? MQTT_BINARY_HEADER_SIZE + (size_t)message[5] * MQTT_BINARY_ENTRY_SIZE
+                       : MQTT_BINARY_HEADER_SIZE;
+            if (size > available) {
+                if (!complete) break;
+                size = available; // Truncated: rejected by the decoder
+            }
+        } else {
+            const uint8_t* newline = memchr(message, '\n', available);
+            if (!newline && !complete) break;
+            size = newline ? (size_t)(newline - message) + 1 : available;
+
+            if (message[0] == '#') {
+                handle_comment(gateway, node, message, size);
+                used += size;
+                continue;
+            }
+            if (message[0] == '\n' || message[0] == '\r') {
+                used += size;
+                continue;
+            }
+        }
+
+        if (!*node && !(*node = resolve_node(gateway, peer))) {
+            if (gateway->unassigned++ == 0) {
+                fprintf(stderr, "Gateway: Node table full (max_nodes %d), dropping messages from %s\n",
+                        gateway->config->gateway.max_nodes, peer);
+            }
+            used += size;
+            continue;
+        }
+
+        if (!take_token(gateway, *node)) {
+            if (!drop_over_budget) {
+                *exhausted = true;
+                break;
+            }
+            (*node)->over_budget++;
+            used += size;
+            continue;
+        }
+
+        if (binary) {
+            forward_frame(gateway, *node, message, size);
+        } else {
+            forward_line(gateway, *node, (const char*)message, size);
+        }
+        used += size;
+    }
+    return used;
+}
+
+// "# node=<id>" names the node sending the following messages; other comments are ignored
+static void handle_comment(Gateway* gateway, GatewayNode** node, const uint8_t* text, size_t length) {
+    static const char directive[] = "node=";
+    size_t start = 1;
+    while (start < length && text[start] == ' ') start++;
+    if (length - start < sizeof(directive) || memcmp(text + start, directive, sizeof(directive) - 1) != 0) return;
+    start += sizeof(directive) - 1;
+
+    char id[GATEWAY_NODE_ID_SIZE];
+    size_t id_length = 0;
+    while (start + id_length < length && id_length < sizeof(id) - 1) {
+        char c = (char)text[start + id_length];
+        bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                     c == '.' || c == '_' || c == ':' || c == '-';
+        if (!valid) break;
+        id[id_length++] = c;
+    }
+    id[id_length] = '\0';
+    if (id_length == 0) return;
+
+    GatewayNode* named = resolve_node(gateway, id);
+    if (named) {
+        *node = named;
+    } else if (gateway->unassigned++ == 0) {
+        fprintf(stderr, "Gateway: Node table full (max_nodes %d), cannot add node %s\n",
+                gateway->config->gateway.max_nodes, id);
+    }
+}
+
+// Finds the node, or takes a free entry (else the least recently seen one without a connection)
+static GatewayNode* resolve_node(Gateway* gateway, const char* id) {
+    GatewayNode* free_node = NULL;
+    GatewayNode* oldest = NULL;
+
+    for (int n = 0; n < gateway->config->gateway.max_nodes; n++) {
+        GatewayNode* node = &gateway->nodes[n];
+        if (!node->in_use) {
+            if (!free_node) free_node = node;
+        } else if (strcmp(node->id, id) == 0) {
+            return node;
+        } else if (node->connections == 0 && (!oldest || node->last_seen_s < oldest->last_seen_s)) {
+            oldest = node;
+        }
+    }
+
+    GatewayNode* node = free_node ? free_node : oldest;
+    if (!node) return NULL;
+    if (node->in_use) {
+        printf("Gateway: Forgetting idle node to make room for %s\n", id);
+        print_node(node);
+    }
+
+    memset(node, 0, sizeof(*node));
+    node->in_use = true;
+    snprintf(node->id, sizeof(node->id), "%s", id);
+    node->last_seen_s = node->refilled_s = monotonic_s();
+    node->tokens = gateway->config->gateway.node_lines_per_s; // Starts with a full burst
+    return node;
+}
+
+// Token bucket: node_lines_per_s, in bursts of up to one second's worth
+static bool take_token(Gateway* gateway, GatewayNode* node) {
+    double now_s = monotonic_s();
+    double rate = gateway->config->gateway.node_lines_per_s;
+    node->tokens = fmin(rate, node->tokens + (now_s - node->refilled_s) * rate);
+    node->refilled_s = now_s;
+    node->last_seen_s = now_s;
+    if (node->tokens < 1.0) return false;
+    node->tokens -= 1.0;
+    return true;
+}
+
+static void forward_line(Gateway* gateway, GatewayNode* node, const char* text, size_t length) {
+    while (length > 0 && (text[length - 1] == '\n' || text[length - 1] == '\r')) length--;
+
+    // Measurement and field set at least; a bad line would fail the whole upstream batch
+    const char* space = memchr(text, ' ', length);
+    bool valid = length > 0 && text[0] != ' ' && text[0] != ',' && space && space + 1 < text + length &&
+                 !memchr(text, '\0', length);
+    if (!valid || !submit_tagged(gateway, node, text, length)) {
+        node->malformed++;
+        return;
+    }
+    node->lines++;
+}
+
+static void forward_frame(Gateway* gateway, GatewayNode* node, const uint8_t* record, size_t length) {
+    AcquisitionFrame* frame = &gateway->frame;
+    if (mqtt_publisher_decode_binary(record, length, frame) == 0) {
+        node->malformed++;
+        return;
+    }
+    if (is_duplicate_frame(node, frame->sequence)) {
+        node->duplicates++;
+        return;
+    }
+
+    // Channel indexes are the configuration order, shared by the nodes of a site
+    for (int i = 0; i < frame->channel_count; i++) {
+        FrameChannel* channel = &frame->channels[i];
+        if (!channel->is_active) continue;
+        if ((size_t)i < gateway->config->channel_count) {
+            snprintf(channel->id, sizeof(channel->id), "%s", gateway->config->channels[i].id);
+        } else {
+            snprintf(channel->id, sizeof(channel->id), "ch%d", i);
+        }
+    }
+
+    const char* line = data_publisher_format_frame(gateway->builder, frame) ? lp_view(gateway->builder) : NULL;
+    if (!line || !submit_tagged(gateway, node, line, strlen(line))) {
+        node->malformed++;
+        return;
+    }
+    node->frames++;
+}
+
+// Remembers the sequence; true if it was seen already. Sequence 1 (the first frame of a run) and
+// sequences far behind the newest mean the node has restarted.
+static bool is_duplicate_frame(GatewayNode* node, uint64_t sequence) {
+    if (sequence == 1 || sequence + GATEWAY_DEDUP_WINDOW <= node->newest_sequence) {
+        memset(node->recent, 0, sizeof(node->recent));
+        node->newest_sequence = 0;
+    } else if (node->recent[sequence % GATEWAY_DEDUP_WINDOW] == sequence) {
+        return true;
+    }
+
+    node->recent[sequence % GATEWAY_DEDUP_WINDOW] = sequence;
+    if (sequence > node->newest_sequence) node->newest_sequence = sequence;
+    return false;
+}
+
+// Submits the line with ",node=<id>" after its tags, unless it has a node tag already. Over the
+// high-water mark, the gateway pauses and the line goes to the offline queue instead.
+static bool submit_tagged(Gateway* gateway, const GatewayNode* node, const char* text, size_t length) {
+    if (length > GATEWAY_READ_BUFFER_SIZE) return false;
+
+    // Measurement and tags end at the first unescaped space
+    size_t tags_end = 0;
+    while (tags_end < length && text[tags_end] != ' ') {
+        if (text[tags_end] == '\\') tags_end++;
+        tags_end++;
+    }
+    if (tags_end >= length) return false;
+
+    char* line = gateway->line;
+    memcpy(line, text, tags_end);
+    line[tags_end] = '\0';
+    size_t position = tags_end;
+    if (!strstr(line, GATEWAY_NODE_TAG)) {
+        position += (size_t)sprintf(line + position, GATEWAY_NODE_TAG "%s", node->id);
+    }
+    memcpy(line + position, text + tags_end, length - tags_end);
+    line[position + length - tags_end] = '\0';
+
+    if (!gateway->paused && sender_queue_length(gateway->sender) >= GATEWAY_QUEUE_HIGH_WATER) {
+        fprintf(stderr, "Gateway: Upstream backlog of %d lines, pausing the TCP nodes\n", GATEWAY_QUEUE_HIGH_WATER);
+        gateway->paused = true;
+        event_loop_set_timer(gateway->backlog_timer, GATEWAY_BACKLOG_CHECK_MS, GATEWAY_BACKLOG_CHECK_MS);
+    }
+    if (gateway->paused) {
+        sender_submit_deferred(gateway->sender, line);
+        gateway->spilled++;
+    } else {
+        sender_submit(gateway->sender, line);
+    }
+    return true;
+}
+
+static void print_node(const GatewayNode* node) {
+    printf("Gateway: Node %s: %lu line(s), %lu frame(s), %lu duplicate(s), %lu over budget, %lu malformed\n",
+           node->id, node->lines, node->frames, node->duplicates, node->over_budget, node->malformed);
+}
+
+static double monotonic_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
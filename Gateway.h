@@ -0,0 +1,63 @@
+#ifndef GATEWAY_H
+#define GATEWAY_H
+
+#include <stdbool.h>
+#include <signal.h>
+
+/**
+ * @file Gateway.h
+ * @brief Gateway mode (--gateway): one upstream InfluxDB writer for all the nodes of a site.
+ *
+ * Listens on gateway.port over TCP and UDP. Nodes send line protocol (newline-separated, e.g.
+ * the UDP transport of a node's sender) or binary frames in the layout of MqttPublisher.h,
+ * which are converted to "measurements" lines named after the gateway's channels. Everything
+ * goes upstream through one Sender as large gzip-compressed batches (influxdb.batch_size,
+ * flush_interval_ms), with its offline queue and replay, so the server sees one writer and
+ * one token per site instead of one per device.
+ *
+ * Every line is tagged node=<id> unless it carries a node tag already. The id is the peer
+ * address, or what the node announces with a comment line "# node=<id>" ([A-Za-z0-9._:-]):
+ * for the rest of a TCP connection, or for the rest of a UDP datagram.
+ *
+ * Backpressure is per node: each node may send gateway.node_lines_per_s lines (or frames) per
+ * second, in bursts of up to one second's worth. A TCP node over its budget is no longer read
+ * until the budget refills, so TCP flow control slows that node alone; the excess of a UDP
+ * datagram is dropped and counted.
+ *
+ * Binary frames are deduplicated by sequence number per node, so frames resent after a
+ * reconnect are written once. A sequence more than GATEWAY_DEDUP_WINDOW behind the newest
+ * is taken as a restarted node. Duplicate lines need no filtering: InfluxDB keeps one point
+ * per series and timestamp.
+ *
+ * Backpressure is also site-wide: when GATEWAY_QUEUE_HIGH_WATER lines wait for the upstream
+ * (an outage, a slow server), the TCP nodes are no longer read and what still arrives goes to
+ * the sender's offline queue, until the queue is down to GATEWAY_QUEUE_LOW_WATER.
+ */
+
+#define GATEWAY_DEDUP_WINDOW 256
+#define GATEWAY_QUEUE_HIGH_WATER 100000
+#define GATEWAY_QUEUE_LOW_WATER (GATEWAY_QUEUE_HIGH_WATER / 2)
+
+typedef struct Gateway Gateway; // Opaque gateway
+
+/**
+ * @brief Loads and validates the configuration, starts the upstream sender and opens the
+ *        TCP and UDP sockets.
+ * @param config_file YAML configuration (influxdb, logging.csv_directory, channels, gateway)
+ * @return A pointer to the gateway, or NULL on failure
+ */
+Gateway* gateway_create(const char* config_file);
+
+/**
+ * @brief Serves the nodes until *shutdown_requested becomes non-zero (set by a signal
+ *        handler), then prints per-node counters.
+ */
+void gateway_run(Gateway* gateway, volatile sig_atomic_t* shutdown_requested);
+
+/**
+ * @brief Closes the sockets, flushes the sender (unsent lines go to its offline queue) and
+ *        frees the gateway.
+ */
+void gateway_destroy(Gateway* gateway);
+
+#endif // GATEWAY_H
@@ -1,12 +1,31 @@
 #include "HardwareManager.h"
 #include "ADS1115.h"
 #include "ConfigYAML.h"
+#include "ChannelValidation.h"
+#include "ChannelStats.h"
+#include "ChannelSpectrum.h"
+#include "FilterChain.h"
+#include "CalibrationTable.h"
+#include "CalibrationSession.h"
+#include "Resampler.h"
+#include "StateStore.h"
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include <gps.h>
 #include <stdint.h>
 #include "math.h"
 #include <stdlib.h>
+#include <unistd.h>
+#include <limits.h>
+#include <zlib.h>     // For crc32
+
+// Linear fit applied with CAL APPLY, as persisted in its state file
+typedef struct {
+    double slope;
+    double offset;
+    uint32_t config_fingerprint; // Of the YAML calibration block the fit replaced
+} FittedCalibration;
 
 // The internal structure of HardwareManager
 struct HardwareManager {
@@ -18,11 +37,16 @@ struct HardwareManager {
     // GPS state management
     GPSData last_valid_gps;     // Last known valid GPS data
     bool has_valid_gps;         // Whether we ever received valid GPS data
+    struct timespec last_fix_time; // Receiver time of last_valid_gps, to tell new fixes from repeats
     
     // Multi-board I2C management
     int board_handles[MAX_BOARDS];     // I2C handles for each board
     int board_addresses[MAX_BOARDS];   // I2C addresses for each board
     int active_board_count;
+
+    // Boards requested by the configuration (including ones that failed to respond)
+    int configured_addresses[MAX_BOARDS];
+    int configured_board_count;
     
     // I2C retry configuration
     int i2c_max_retries;
@@ -36,8 +60,125 @@ struct HardwareManager {
     // Optional post-processing hook for synthetic or derived channels
     HardwareManagerPostProcessFn post_process_callback;
     void* post_process_user_data;
+
+    // Range and stale-data checks from the YAML validation section
+    ValidationTable validation;
+
+    // Per-channel statistics windows from the YAML statistics section
+    ChannelStatsTable* stats;
+
+    // Per-channel spectral analysis from the YAML spectrum section
+    ChannelSpectrumTable* spectra;
+
+    // Alignment of each sweep's samples onto its start time (system.resample)
+    Resampler* resampler;
+
+    // Per-channel filter pipelines from the YAML filters lists
+    FilterChain* filters;
+
+    // Compiled polynomial/piecewise calibration curves the channels point at
+    CalibrationTable* calibration;
+
+    // Remote calibration driven by the socket server, fed with every raw sample
+    CalibrationSession* calibration_session;
+
+    // Channels running on a persisted fit instead of their YAML calibration
+    bool fitted[MAX_TOTAL_CHANNELS];
+    uint32_t fitted_fingerprint[MAX_TOTAL_CHANNELS]; // YAML calibration block the fit replaced
+
+    // Channels that got a new value in the latest sweep (reads plus virtual channels)
+    ChannelMask fresh_mask;
 };
 
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// CRC of a channel's configured calibration (the fields channel_copy_calibration takes over)
+static uint32_t calibration_fingerprint(const Channel* channel) {
+    int terms = channel->calibration_term_count;
+    int points = channel->calibration_point_count;
+    if (terms < 0 || terms > CHANNEL_MAX_CALIBRATION_TERMS) terms = CHANNEL_MAX_CALIBRATION_TERMS;
+    if (points < 0 || points > CHANNEL_MAX_CALIBRATION_POINTS) points = CHANNEL_MAX_CALIBRATION_POINTS;
+
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, (const Bytef*)&channel->slope, sizeof(channel->slope));
+    crc = crc32(crc, (const Bytef*)&channel->offset, sizeof(channel->offset));
+    crc = crc32(crc, (const Bytef*)&channel->calibration_type, sizeof(channel->calibration_type));
+    crc = crc32(crc, (const Bytef*)&terms, sizeof(terms));
+    crc = crc32(crc, (const Bytef*)channel->calibration_terms, (uInt)(terms * sizeof(double)));
+    crc = crc32(crc, (const Bytef*)&points, sizeof(points));
+    crc = crc32(crc, (const Bytef*)channel->calibration_point_raw, (uInt)(points * sizeof(double)));
+    crc = crc32(crc, (const Bytef*)channel->calibration_point_value, (uInt)(points * sizeof(double)));
+    uint8_t lut = channel->calibration_lut ? 1 : 0;
+    crc = crc32(crc, (const Bytef*)&lut, sizeof(lut));
+    return (uint32_t)crc;
+}
+
+static void fitted_state_path(const Channel* channel, char* path, size_t path_size) {
+    snprintf(path, path_size, HARDWARE_CALIBRATION_STATE_FORMAT, channel->id);
+}
+
+static void save_fitted_calibration(HardwareManager* hw_manager, int index) {
+    const Channel* channel = &hw_manager->channels[index];
+    char path[PATH_MAX];
+    fitted_state_path(channel, path, sizeof(path));
+
+    FittedCalibration fit = {
+        .slope = channel->slope,
+        .offset = channel->offset,
+        .config_fingerprint = hw_manager->fitted_fingerprint[index]
+    };
+    StateStore* store = state_store_open(path, sizeof(fit));
+    if (!store || !state_store_save(store, &fit)) {
+        fprintf(stderr, "Hardware: Calibration of channel %s not persisted; it lasts until restart\n", channel->id);
+    }
+    state_store_close(store);
+}
+
+static void discard_fitted_calibration(HardwareManager* hw_manager, int index) {
+    char path[PATH_MAX];
+    fitted_state_path(&hw_manager->channels[index], path, sizeof(path));
+    unlink(path);
+    hw_manager->fitted[index] = false;
+}
+
+// Puts back the fits applied in earlier runs, unless the YAML calibration they replaced was edited
+static void restore_fitted_calibrations(HardwareManager* hw_manager) {
+    for (int i = 0; i < hw_manager->channel_count; i++) {
+        Channel* channel = &hw_manager->channels[i];
+        if (!channel->is_active || channel->is_virtual) continue;
+
+        char path[PATH_MAX];
+        fitted_state_path(channel, path, sizeof(path));
+        if (access(path, F_OK) != 0) continue;
+
+        FittedCalibration fit;
+        StateStore* store = state_store_open(path, sizeof(fit));
+        bool loaded = store && state_store_load(store, &fit) && isfinite(fit.slope) && isfinite(fit.offset);
+        state_store_close(store);
+        if (!loaded) continue;
+
+        uint32_t fingerprint = calibration_fingerprint(channel);
+        if (fit.config_fingerprint != fingerprint) {
+            printf("Hardware: Calibration of channel %s was edited in the configuration; discarding its fitted calibration\n",
+                   channel->id);
+            discard_fitted_calibration(hw_manager, i);
+            continue;
+        }
+
+        channel->slope = fit.slope;
+        channel->offset = fit.offset;
+        channel->calibration_type = CHANNEL_CALIBRATION_LINEAR;
+        hw_manager->fitted[i] = true;
+        hw_manager->fitted_fingerprint[i] = fingerprint;
+        printf("Hardware: Restored fitted calibration for channel %s: slope=%.6f, offset=%.6f\n",
+               channel->id, fit.slope, fit.offset);
+    }
+}
+
 HardwareManager* hardware_manager_init(const char* i2c_bus_path, int* board_addresses, int board_count) {                        
     if (!i2c_bus_path || !board_addresses || board_count <= 0 || board_count > MAX_BOARDS) {
         return NULL;
@@ -59,6 +200,7 @@ HardwareManager* hardware_manager_init(const char* i2c_bus_path, int* board_addr
     hw_manager->last_valid_gps.longitude = NAN;
     hw_manager->last_valid_gps.altitude = NAN;
     hw_manager->last_valid_gps.speed = NAN;
+    hw_manager->last_valid_gps.fix_time_s = 0.0;
     
     // Set default I2C retry parameters
     hw_manager->i2c_max_retries = 3;
@@ -72,6 +214,10 @@ HardwareManager* hardware_manager_init(const char* i2c_bus_path, int* board_addr
 
     // Initialize I2C for each board
     hw_manager->active_board_count = 0;
+    hw_manager->configured_board_count = board_count;
+    for (int i = 0; i < board_count; i++) {
+        hw_manager->configured_addresses[i] = board_addresses[i];
+    }
     for (int i = 0; i < board_count; i++) {
         int board_handle = ads1115_init(i2c_bus_path, board_addresses[i]);
         if (board_handle < 0) {
@@ -154,6 +300,13 @@ void hardware_manager_cleanup(HardwareManager* hw_manager) {
         hw_manager->gps_connected = false;
         printf("Hardware: GPS disconnected\n");
     }
+
+    channel_stats_destroy(hw_manager->stats);
+    channel_spectrum_destroy(hw_manager->spectra);
+    resampler_destroy(hw_manager->resampler);
+    filter_chain_destroy(hw_manager->filters);
+    calibration_table_destroy(hw_manager->calibration);
+    calibration_session_destroy(hw_manager->calibration_session);
     
     free(hw_manager);
 }
@@ -181,8 +334,51 @@ bool hardware_manager_init_channels(HardwareManager* hw_manager, const YAMLAppCo
 
     hw_manager->channel_count = config->channel_count < MAX_TOTAL_CHANNELS ? 
                                config->channel_count : MAX_TOTAL_CHANNELS;
+
+    hw_manager->stats = channel_stats_create(hw_manager->channels, hw_manager->channel_count);
+    if (!hw_manager->stats) {
+        fprintf(stderr, "Hardware: Failed to create channel statistics\n");
+        return false;
+    }
+
+    hw_manager->spectra = channel_spectrum_create(hw_manager->channels, hw_manager->channel_count);
+    if (!hw_manager->spectra) {
+        fprintf(stderr, "Hardware: Failed to create channel spectra\n");
+        return false;
+    }
+
+    hw_manager->resampler = resampler_create(hw_manager->channel_count);
+    if (!hw_manager->resampler) {
+        fprintf(stderr, "Hardware: Failed to create resampler\n");
+        return false;
+    }
+    resampler_set_mode(hw_manager->resampler, config->system.resample);
+
+    hw_manager->filters = filter_chain_create(hw_manager->channels, hw_manager->channel_count);
+    if (!hw_manager->filters) {
+        fprintf(stderr, "Hardware: Failed to create channel filters\n");
+        return false;
+    }
+
+    hw_manager->calibration = calibration_table_create();
+    if (!hw_manager->calibration) {
+        fprintf(stderr, "Hardware: Failed to create calibration table\n");
+        return false;
+    }
+    restore_fitted_calibrations(hw_manager);
+    calibration_table_attach(hw_manager->calibration, hw_manager->channels, hw_manager->channel_count);
+
+    hw_manager->calibration_session = calibration_session_create();
+    if (!hw_manager->calibration_session) {
+        fprintf(stderr, "Hardware: Failed to create calibration session\n");
+        return false;
+    }
+
     hw_manager->channels_initialized = true;
 
+    validation_table_build(&hw_manager->validation, hw_manager->channels,
+                           hw_manager->channel_count, monotonic_seconds());
+
     printf("Hardware: Initialized %d channels from YAML configuration\n", hw_manager->channel_count);
     return true;
 }
@@ -196,17 +392,57 @@ static int find_board_handle(HardwareManager* hw_manager, int board_address) {
     return -1; // Board not found
 }
 
+// Runs the validation pass over the calibrated values and the unfiltered samples of
+// this sweep and stores the resulting quality flags on each channel.
+static void evaluate_channel_quality(HardwareManager* hw_manager, double now) {
+    ValidationTable* table = &hw_manager->validation;
+
+    for (int i = 0; i < table->count; i++) {
+        const Channel* channel = &hw_manager->channels[i];
+        table->value[i] = channel_get_calibrated_value(channel);
+        table->sample[i] = channel_get_sample_value(channel);
+        // Synthetic values are produced by software every sweep and never go stale
+        if (channel_has_calibrated_override(channel)) {
+            validation_table_mark_updated(table, i, now);
+        }
+    }
+
+    validation_table_evaluate(table, now);
+
+    for (int i = 0; i < table->count; i++) {
+        // Inactive channels are never read or published; keep them clean
+        bool active = hw_manager->channels[i].is_active;
+        hw_manager->channels[i].quality_flags = active ? table->flags[i] : CHANNEL_QUALITY_OK;
+        hw_manager->channels[i].sample_quality_flags = active ? table->sample_flags[i] : CHANNEL_QUALITY_OK;
+    }
+}
+
 bool hardware_manager_collect_measurements(HardwareManager* hw_manager) {
+    return hardware_manager_collect_channels(hw_manager, CHANNEL_MASK_ALL);
+}
+
+bool hardware_manager_collect_channels(HardwareManager* hw_manager, ChannelMask channel_mask) {
     if (!hw_manager) return false;
+    hw_manager->fresh_mask = 0;
     if (!hw_manager->channels_initialized) return false;
     if (hw_manager->active_board_count == 0) return false;
 
+    // A remote calibration accepted since the last sweep takes effect before this one
+    int calibrated_index;
+    double slope, offset;
+    if (calibration_session_take_result(hw_manager->calibration_session, &calibrated_index, &slope, &offset)) {
+        hardware_manager_update_channel_calibration(hw_manager, calibrated_index, slope, offset);
+    }
+
     bool all_success = true;
+    double now = monotonic_seconds();
+    ChannelMask read_mask = 0; // Channels that produced a new sample in this sweep
 
     for (int i = 0; i < hw_manager->channel_count; i++) {
         Channel* channel = &hw_manager->channels[i];
         
-        if (!channel->is_active) continue;
+        if (!channel->is_active || channel->is_virtual) continue;
+        if (!(channel_mask & CHANNEL_MASK_BIT(i))) continue; // Not due in this slot
 
         // Find the I2C handle for this channel's board
         int board_handle = find_board_handle(hw_manager, channel->board_address);
@@ -216,24 +452,54 @@ bool hardware_manager_collect_measurements(HardwareManager* hw_manager) {
         }
 
         int16_t raw_value;
+        double read_start = monotonic_seconds();
         int result = ads1115_read_with_retry(board_handle, channel->pin, 
                                            channel->gain_setting, &raw_value, 
                                            hw_manager->i2c_max_retries);
         
         if (result == 0) {
             channel_update_raw_value(channel, (int)raw_value);
-            // Apply filtering using channel's alpha value from YAML
-            channel_apply_filter(channel, channel->filter_alpha);
+            // Stamp the sample at the middle of its conversion, not at the start of the sweep,
+            // so integrators see the real spacing between samples despite sweep jitter
+            channel->sample_time_s = 0.5 * (read_start + monotonic_seconds());
+            validation_table_mark_updated(&hw_manager->validation, i, now);
+            read_mask |= CHANNEL_MASK_BIT(i);
         } else {
             all_success = false;
         }
     }
 
+    calibration_session_add_samples(hw_manager->calibration_session, hw_manager->channels, read_mask);
+
+    // Interpolate every sample back to the start of the sweep, so products of channels are in phase
+    resampler_run(hw_manager->resampler, hw_manager->channels, read_mask, now);
+
+    // Filter every new sample in one pass (filter chains, or the filter_alpha EMA)
+    filter_chain_run(hw_manager->filters, hw_manager->channels, read_mask);
+
     if (hw_manager->post_process_callback) {
         bool post_process_ok = hw_manager->post_process_callback(hw_manager, hw_manager->post_process_user_data);
         all_success = all_success && post_process_ok;
     }
 
+    evaluate_channel_quality(hw_manager, now);
+
+    // Virtual channels are recomputed by software every sweep
+    hw_manager->fresh_mask = read_mask;
+    for (int i = 0; i < hw_manager->channel_count; i++) {
+        if (hw_manager->channels[i].is_virtual) hw_manager->fresh_mask |= CHANNEL_MASK_BIT(i);
+    }
+
+    // Only fresh, in-range samples enter the statistics windows and spectra
+    for (int i = 0; i < hw_manager->channel_count; i++) {
+        const Channel* channel = &hw_manager->channels[i];
+        if (!(read_mask & CHANNEL_MASK_BIT(i))) continue;
+        if (!channel_is_sample_quality_ok(channel)) continue;
+        double value = channel_get_sample_value(channel);
+        channel_stats_add(hw_manager->stats, i, value);
+        channel_spectrum_add(hw_manager->spectra, i, value, channel->sample_time_s);
+    }
+
     return all_success;
 }
 
@@ -259,6 +525,65 @@ int hardware_manager_get_channel_count(const HardwareManager* hw_manager) {
     return hw_manager->channel_count;
 }
 
+ChannelMask hardware_manager_get_fresh_mask(const HardwareManager* hw_manager) {
+    if (!hw_manager || !hw_manager->channels_initialized) {
+        return 0;
+    }
+    return hw_manager->fresh_mask;
+}
+
+ChannelStatsTable* hardware_manager_get_channel_stats(const HardwareManager* hw_manager) {
+    if (!hw_manager || !hw_manager->channels_initialized) {
+        return NULL;
+    }
+    return hw_manager->stats;
+}
+
+ChannelSpectrumTable* hardware_manager_get_channel_spectra(const HardwareManager* hw_manager) {
+    if (!hw_manager || !hw_manager->channels_initialized) {
+        return NULL;
+    }
+    return hw_manager->spectra;
+}
+
+CalibrationSession* hardware_manager_get_calibration_session(const HardwareManager* hw_manager) {
+    if (!hw_manager || !hw_manager->channels_initialized) {
+        return NULL;
+    }
+    return hw_manager->calibration_session;
+}
+
+int hardware_manager_add_virtual_channel(HardwareManager* hw_manager, const char* id, const char* unit) {
+    if (!hw_manager || !hw_manager->channels_initialized || !id || !unit) {
+        return -1;
+    }
+
+    if (hw_manager->channel_count >= MAX_TOTAL_CHANNELS) {
+        fprintf(stderr, "Hardware: No room for virtual channel '%s'\n", id);
+        return -1;
+    }
+
+    int index = hw_manager->channel_count;
+    Channel* channel = &hw_manager->channels[index];
+    channel_init(channel);
+    snprintf(channel->id, sizeof(channel->id), "%s", id);
+    snprintf(channel->unit, sizeof(channel->unit), "%s", unit);
+    channel->is_virtual = true;
+    channel->is_active = true;
+    channel->board_address = -1;
+    channel_set_calibrated_override(channel, NAN); // No value until the producer sets one
+
+    hw_manager->channel_count++;
+    validation_table_build(&hw_manager->validation, hw_manager->channels,
+                           hw_manager->channel_count, monotonic_seconds());
+    channel_stats_configure(hw_manager->stats, hw_manager->channels, hw_manager->channel_count);
+    channel_spectrum_configure(hw_manager->spectra, hw_manager->channels, hw_manager->channel_count);
+    filter_chain_configure(hw_manager->filters, hw_manager->channels, hw_manager->channel_count);
+
+    printf("Hardware: Added virtual channel '%s' [%s]\n", channel->id, channel->unit);
+    return index;
+}
+
 bool hardware_manager_update_channel_calibration(HardwareManager* hw_manager, 
                                                 int index, double slope, double offset) {
     if (!hw_manager || !hw_manager->channels_initialized || 
@@ -266,14 +591,101 @@ bool hardware_manager_update_channel_calibration(HardwareManager* hw_manager,
         return false;
     }
 
+    // The fingerprint is always that of the YAML block, also when a fit replaces an earlier fit
+    if (!hw_manager->fitted[index]) {
+        hw_manager->fitted_fingerprint[index] = calibration_fingerprint(&hw_manager->channels[index]);
+    }
+
     hw_manager->channels[index].slope = slope;
     hw_manager->channels[index].offset = offset;
+    // A measured linear fit replaces any configured curve
+    hw_manager->channels[index].calibration_type = CHANNEL_CALIBRATION_LINEAR;
+    calibration_table_attach(hw_manager->calibration, hw_manager->channels, hw_manager->channel_count);
+
+    hw_manager->fitted[index] = true;
+    save_fitted_calibration(hw_manager, index);
     
     printf("Hardware: Updated calibration for channel %s: slope=%.6f, offset=%.6f\n",
            hw_manager->channels[index].id, slope, offset);
     return true;
 }
 
+bool hardware_manager_apply_channel_settings(HardwareManager* hw_manager, const YAMLAppConfig* config) {
+    if (!hw_manager || !hw_manager->channels_initialized || !config) {
+        return false;
+    }
+
+    int count = (int)config->channel_count < hw_manager->channel_count ?
+                (int)config->channel_count : hw_manager->channel_count;
+
+    // Check the whole layout first so a mismatch never leaves channels half-updated
+    for (int i = 0; i < count; i++) {
+        if (strcmp(hw_manager->channels[i].id, config->channels[i].id) != 0) {
+            fprintf(stderr, "Hardware: Channel %d id mismatch on reload ('%s' vs '%s')\n",
+                    i, hw_manager->channels[i].id, config->channels[i].id);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        Channel* channel = &hw_manager->channels[i];
+        const Channel* source = &config->channels[i];
+
+        // A fitted calibration survives the reload unless this channel's calibration block changed
+        if (!hw_manager->fitted[i] || calibration_fingerprint(source) != hw_manager->fitted_fingerprint[i]) {
+            if (hw_manager->fitted[i]) {
+                printf("Hardware: Calibration of channel %s changed; replacing its fitted calibration\n", channel->id);
+                discard_fitted_calibration(hw_manager, i);
+            }
+            channel_copy_calibration(channel, source);
+        }
+        channel->filter_alpha = source->filter_alpha;
+        channel->filter_count = source->filter_count;
+        memcpy(channel->filters, source->filters, sizeof(channel->filters));
+        channel->min_value = source->min_value;
+        channel->max_value = source->max_value;
+        channel->timeout_threshold_s = source->timeout_threshold_s;
+        channel->sample_interval_ms = source->sample_interval_ms;
+        channel->publish_interval_ms = source->publish_interval_ms;
+        channel->stats_window = source->stats_window;
+        channel->stats_window_samples = source->stats_window_samples;
+        channel->publish_value = source->publish_value;
+        channel->stats_quantiles = source->stats_quantiles;
+        channel->trigger_above = source->trigger_above;
+        channel->trigger_below = source->trigger_below;
+        channel->trigger_rate = source->trigger_rate;
+        channel->spectrum_size = source->spectrum_size;
+        channel->spectrum_band_count = source->spectrum_band_count;
+        memcpy(channel->spectrum_band_edges_hz, source->spectrum_band_edges_hz,
+               sizeof(channel->spectrum_band_edges_hz));
+    }
+
+    validation_table_update_limits(&hw_manager->validation, hw_manager->channels, count);
+    resampler_set_mode(hw_manager->resampler, config->system.resample);
+
+    if (!channel_stats_configure(hw_manager->stats, hw_manager->channels, hw_manager->channel_count)) {
+        fprintf(stderr, "Hardware: Failed to apply statistics windows\n");
+        return false;
+    }
+
+    if (!channel_spectrum_configure(hw_manager->spectra, hw_manager->channels, hw_manager->channel_count)) {
+        fprintf(stderr, "Hardware: Failed to apply spectrum settings\n");
+        return false;
+    }
+
+    if (!filter_chain_configure(hw_manager->filters, hw_manager->channels, hw_manager->channel_count)) {
+        fprintf(stderr, "Hardware: Failed to apply filter chains\n");
+        return false;
+    }
+
+    if (!calibration_table_attach(hw_manager->calibration, hw_manager->channels, hw_manager->channel_count)) {
+        fprintf(stderr, "Hardware: Failed to apply calibration curves\n");
+        return false;
+    }
+
+    return true;
+}
+
 bool hardware_manager_set_channel_calibrated_override(HardwareManager* hw_manager, int index, double calibrated_value) {
     if (!hw_manager || !hw_manager->channels_initialized || 
         index < 0 || index >= hw_manager->channel_count) {
@@ -294,6 +706,28 @@ bool hardware_manager_clear_channel_calibrated_override(HardwareManager* hw_mana
     return true;
 }
 
+int hardware_manager_reprobe_boards(HardwareManager* hw_manager) {
+    if (!hw_manager) return 0;
+
+    int recovered = 0;
+    for (int i = 0; i < hw_manager->configured_board_count; i++) {
+        int address = hw_manager->configured_addresses[i];
+        if (find_board_handle(hw_manager, address) >= 0) continue; // Already active
+
+        int board_handle = ads1115_init(hw_manager->i2c_bus_path, address);
+        if (board_handle < 0) continue;
+
+        hw_manager->board_handles[hw_manager->active_board_count] = board_handle;
+        hw_manager->board_addresses[hw_manager->active_board_count] = address;
+        hw_manager->active_board_count++;
+        recovered++;
+
+        printf("Hardware: Board at address 0x%02x is back online\n", address);
+    }
+
+    return recovered;
+}
+
 bool hardware_manager_get_current_gps(HardwareManager* hw_manager, GPSData* gps_data) {
     if (!hw_manager || !gps_data) {
         return false;
@@ -340,6 +774,14 @@ bool hardware_manager_get_current_gps(HardwareManager* hw_manager, GPSData* gps_
             hw_manager->last_valid_gps.longitude = hw_manager->gps_data.fix.longitude;
             hw_manager->last_valid_gps.altitude = hw_manager->gps_data.fix.altHAE;
             hw_manager->last_valid_gps.speed = hw_manager->gps_data.fix.speed;
+            if (!hw_manager->has_valid_gps ||
+                hw_manager->gps_data.fix.time.tv_sec != hw_manager->last_fix_time.tv_sec ||
+                hw_manager->gps_data.fix.time.tv_nsec != hw_manager->last_fix_time.tv_nsec) {
+                // Other gpsd reports (SKY, ...) repeat the last fix; only a new fix time is a new fix
+                hw_manager->last_fix_time.tv_sec = hw_manager->gps_data.fix.time.tv_sec;
+                hw_manager->last_fix_time.tv_nsec = hw_manager->gps_data.fix.time.tv_nsec;
+                hw_manager->last_valid_gps.fix_time_s = monotonic_seconds();
+            }
             hw_manager->has_valid_gps = true;
             
             // Return the new valid data
@@ -4,6 +4,10 @@
 #include <stdbool.h>
 #include "ConfigYAML.h"
 #include "Channel.h"
+#include "SweepScheduler.h"
+#include "ChannelStats.h"
+#include "ChannelSpectrum.h"
+#include "CalibrationSession.h"
 
 // Simpler GPS data structure for application use
 // Must be checked with isfinite() before each use
@@ -12,6 +16,7 @@ typedef struct {
     double longitude;
     double altitude;
     double speed;
+    double fix_time_s;  // Monotonic time the fix was received; changes only with a new fix (0 = none)
 } GPSData;
 
 // Opaque HardwareManager structure
@@ -44,18 +49,56 @@ void hardware_manager_cleanup(HardwareManager* hw_manager);
 // Collect measurements from all active channels
 bool hardware_manager_collect_measurements(HardwareManager* hw_manager);
 
+// Collect measurements only from the channels selected in channel_mask (multi-rate sweeps).
+// Unselected channels keep their last value; validation and post-processing still run.
+bool hardware_manager_collect_channels(HardwareManager* hw_manager, ChannelMask channel_mask);
+
 // Get channel data (read-only access)
 const Channel* hardware_manager_get_channels(const HardwareManager* hw_manager);
 const Channel* hardware_manager_get_channel(const HardwareManager* hw_manager, int index);
 int hardware_manager_get_channel_count(const HardwareManager* hw_manager);
 
+// Channels that got a new value in the latest collect: the ones read successfully plus
+// virtual channels (recomputed every sweep). Channels not due in a slot are excluded.
+ChannelMask hardware_manager_get_fresh_mask(const HardwareManager* hw_manager);
+
+// Per-channel statistics windows, fed with every good sample (NULL before init_channels)
+ChannelStatsTable* hardware_manager_get_channel_stats(const HardwareManager* hw_manager);
+
+// Per-channel spectral analysis, fed with the same samples (NULL before init_channels)
+ChannelSpectrumTable* hardware_manager_get_channel_spectra(const HardwareManager* hw_manager);
+
+// Remote calibration session, fed with every raw sample; an accepted fit is applied with
+// hardware_manager_update_channel_calibration before the next sweep (NULL before init_channels).
+// Applied fits are persisted (HARDWARE_CALIBRATION_STATE_FORMAT) with a fingerprint of the YAML
+// calibration block they replaced. At start-up and on reload a fit stays in force while that
+// channel's calibration block is unchanged; once the block is edited, the YAML wins and the
+// fit is discarded.
+CalibrationSession* hardware_manager_get_calibration_session(const HardwareManager* hw_manager);
+
+// Append a software-computed channel after the configured ones (never read from hardware).
+// Its value is set with hardware_manager_set_channel_calibrated_override. Call before creating
+// consumers that size themselves from the channel list (CSV header, sweep scheduler).
+// Returns the channel index, or -1 on failure.
+int hardware_manager_add_virtual_channel(HardwareManager* hw_manager, const char* id, const char* unit);
+
+// State file of the fit applied to a channel (per channel id)
+#define HARDWARE_CALIBRATION_STATE_FORMAT "logs/calibration_%s.bin"
+
 // Update channel calibration
 bool hardware_manager_update_channel_calibration(HardwareManager* hw_manager, int index, double slope, double offset);
 
+// Apply reloadable channel settings (calibration, filter, validation limits) from a reloaded YAML configuration.
+// Live data and filter state are preserved. Channel layout must match (see config_yaml_check_reload_compatible).
+bool hardware_manager_apply_channel_settings(HardwareManager* hw_manager, const YAMLAppConfig* config);
+
 // Override or clear a channel's calibrated value
 bool hardware_manager_set_channel_calibrated_override(HardwareManager* hw_manager, int index, double calibrated_value);
 bool hardware_manager_clear_channel_calibrated_override(HardwareManager* hw_manager, int index);
 
+// Retry boards that failed to initialize. Returns the number of boards brought online.
+int hardware_manager_reprobe_boards(HardwareManager* hw_manager);
+
 // === GPS Data Interface ===
 // Get current GPS data (on-demand)
 bool hardware_manager_get_current_gps(HardwareManager* hw_manager, GPSData* gps_data);
@@ -0,0 +1,664 @@
+#include "MqttClient.h"
+#include "OfflineQueue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+// MQTT 3.1.1 control packet types (upper nibble of the first byte)
+#define MQTT_PACKET_CONNECT 0x10
+#define MQTT_PACKET_CONNACK 0x20
+#define MQTT_PACKET_PUBLISH 0x30
+#define MQTT_PACKET_PUBACK 0x40
+#define MQTT_PACKET_PINGREQ 0xC0
+#define MQTT_PACKET_PINGRESP 0xD0
+#define MQTT_PACKET_DISCONNECT 0xE0
+
+#define MQTT_PUBLISH_QOS1 0x02
+#define MQTT_PUBLISH_DUP 0x08
+#define MQTT_CONNECT_USERNAME 0x80
+#define MQTT_CONNECT_PASSWORD 0x40       // CleanSession (0x02) stays 0: the broker keeps the session
+#define MQTT_PROTOCOL_LEVEL 4            // 3.1.1
+#define MQTT_MAX_REMAINING_LENGTH 268435455
+
+#define MQTT_RX_BUFFER_SIZE 64           // The broker only sends us CONNACK, PUBACK and PINGRESP
+#define MQTT_POLL_STEP_MS 50             // Longest wait for the broker between checks
+#define MQTT_INITIAL_BACKOFF_S 1.0
+
+typedef struct {
+    uint16_t packet_id;
+    uint8_t* packet;        // Encoded PUBLISH, sent again as is (with DUP) after a reconnect; NULL = done
+    size_t length;
+    char* offline_line;     // Queued offline if the client stops before the PUBACK
+    bool backlog;           // A replayed batch; its lines are still in the offline queue
+    double sent_s;
+} InflightMessage;
+
+struct MqttClient {
+    MqttConfig config;
+    OfflineQueue* offline_queue;
+    pthread_mutex_t lock;           // Guards everything below
+
+    int socket_fd;                  // -1 = disconnected
+    uint8_t rx_buffer[MQTT_RX_BUFFER_SIZE];
+    size_t rx_length;
+    bool connack_received;
+    uint8_t connack_code;
+    bool session_present;
+
+    // In-flight window: a ring in send order, so messages are resent in their original order
+    InflightMessage* inflight;
+    int head;
+    int count;                      // Slots in use, acknowledged ones behind the head included
+    int pending;                    // Messages still waiting for their PUBACK
+    uint16_t next_packet_id;
+
+    double last_send_s;             // Keepalive: a PINGREQ goes out after keepalive_s of silence
+    double ping_sent_s;             // 0 = no PINGREQ outstanding
+    double next_connect_s;          // Reconnect back-off
+    double backoff_s;
+    MqttClientStats stats;
+
+    pthread_t replay_thread;
+    pthread_cond_t replay_cond;
+    bool replay_requested;
+    bool running;
+};
+
+// --- Private Function Prototypes ---
+static void* replay_thread_function(void* arg);
+static bool publish_backlog_batch(const void* data, size_t size, void* user_context);
+static uint16_t send_message(MqttClient* client, const char* topic, const void* payload, size_t size,
+                             const char* offline_line, bool backlog);
+static bool connect_to_broker(MqttClient* client);
+static int open_connection(const MqttConfig* config);
+static void disconnect(MqttClient* client, const char* reason);
+static void check_connection(MqttClient* client);
+static bool read_packets(MqttClient* client, int timeout_ms);
+static void wait_for_broker(MqttClient* client);
+static void handle_packet(MqttClient* client, uint8_t type, const uint8_t* body, size_t length);
+static bool send_all(MqttClient* client, const uint8_t* data, size_t length);
+static uint8_t* build_publish(const char* topic, const void* payload, size_t size, uint16_t packet_id, size_t* length);
+static size_t build_connect(const MqttConfig* config, uint8_t* packet);
+static size_t put_remaining_length(uint8_t* out, size_t length);
+static size_t put_string(uint8_t* out, const char* value);
+static InflightMessage* find_message(MqttClient* client, uint16_t packet_id);
+static void release_message(MqttClient* client, InflightMessage* message);
+static double monotonic_seconds(void);
+
+// --- Public Functions ---
+
+MqttClient* mqtt_client_create(const MqttConfig* config, const char* offline_queue_path) {
+    if (!config || !offline_queue_path || config->max_inflight < 1) return NULL;
+
+    MqttClient* client = calloc(1, sizeof(MqttClient));
+    if (!client) {
+        perror("Failed to allocate memory for MqttClient");
+        return NULL;
+    }
+    client->config = *config;
+    client->socket_fd = -1;
+    client->next_packet_id = 1;
+    client->backoff_s = MQTT_INITIAL_BACKOFF_S;
+    client->inflight = calloc((size_t)config->max_inflight, sizeof(InflightMessage));
+    client->offline_queue = offline_queue_create(offline_queue_path);
+    if (!client->inflight || !client->offline_queue) {
+        fprintf(stderr, "MQTT: Failed to create the in-flight window or offline queue\n");
+        offline_queue_destroy(client->offline_queue);
+        free(client->inflight);
+        free(client);
+        return NULL;
+    }
+    pthread_mutex_init(&client->lock, NULL);
+    pthread_cond_init(&client->replay_cond, NULL);
+
+    client->running = true;
+    if (pthread_create(&client->replay_thread, NULL, replay_thread_function, client) != 0) {
+        perror("Failed to create MQTT replay thread");
+        pthread_cond_destroy(&client->replay_cond);
+        pthread_mutex_destroy(&client->lock);
+        offline_queue_destroy(client->offline_queue);
+        free(client->inflight);
+        free(client);
+        return NULL;
+    }
+
+    printf("MQTT client '%s' for %s:%d, topic %s (QoS 1, window %d)\n", config->client_id,
+           config->host, config->port, config->topic, config->max_inflight);
+    return client;
+}
+
+bool mqtt_client_publish(MqttClient* client, const void* payload, size_t size, const char* offline_line) {
+    if (!client || !payload) return false;
+
+    char* text = NULL;
+    if (!offline_line) {
+        text = strndup((const char*)payload, size);
+        offline_line = text;
+    }
+
+    pthread_mutex_lock(&client->lock);
+    bool sent = send_message(client, client->config.topic, payload, size, offline_line, false) != 0;
+    if (!sent && offline_line) {
+        offline_queue_add(client->offline_queue, offline_line);
+        client->stats.offline++;
+    }
+    read_packets(client, 0);
+    check_connection(client);
+    pthread_mutex_unlock(&client->lock);
+
+    free(text);
+    return sent;
+}
+
+void mqtt_client_poll(MqttClient* client) {
+    if (!client) return;
+
+    // A client in use by another thread is not idle; that thread reads and checks the link
+    if (pthread_mutex_trylock(&client->lock) != 0) return;
+    read_packets(client, 0);
+    check_connection(client);
+    pthread_mutex_unlock(&client->lock);
+}
+
+void mqtt_client_request_replay(MqttClient* client) {
+    if (!client) return;
+
+    pthread_mutex_lock(&client->lock);
+    client->replay_requested = true;
+    pthread_cond_signal(&client->replay_cond);
+    pthread_mutex_unlock(&client->lock);
+}
+
+void mqtt_client_get_stats(MqttClient* client, MqttClientStats* stats) {
+    if (!client || !stats) return;
+
+    pthread_mutex_lock(&client->lock);
+    *stats = client->stats;
+    stats->inflight = client->pending;
+    stats->connected = client->socket_fd >= 0;
+    pthread_mutex_unlock(&client->lock);
+}
+
+void mqtt_client_destroy(MqttClient* client) {
+    if (!client) return;
+
+    pthread_mutex_lock(&client->lock);
+    client->running = false;
+    pthread_cond_signal(&client->replay_cond);
+    pthread_mutex_unlock(&client->lock);
+    pthread_join(client->replay_thread, NULL);
+
+    // Give the broker a last chance to acknowledge, then leave cleanly
+    pthread_mutex_lock(&client->lock);
+    double deadline_s = monotonic_seconds() + client->config.ack_timeout_ms / 1000.0;
+    while (client->pending > 0 && client->socket_fd >= 0 && monotonic_seconds() < deadline_s) {
+        read_packets(client, MQTT_POLL_STEP_MS);
+    }
+    if (client->socket_fd >= 0) {
+        const uint8_t packet[] = { MQTT_PACKET_DISCONNECT, 0 };
+        send_all(client, packet, sizeof(packet));
+        close(client->socket_fd);
+        client->socket_fd = -1;
+    }
+
+    // Unacknowledged live messages are kept for the next run
+    while (client->count > 0) {
+        InflightMessage* message = &client->inflight[client->head]; // Releasing advances the head
+        if (!message->backlog && message->offline_line) {
+            offline_queue_add(client->offline_queue, message->offline_line);
+            client->stats.offline++;
+        }
+        release_message(client, message);
+    }
+    pthread_mutex_unlock(&client->lock);
+
+    printf("MQTT: %lu acknowledged, %lu resent, %lu queued offline, %lu backlog batch(es), %lu connection(s)\n",
+           client->stats.acknowledged, client->stats.retransmitted, client->stats.offline,
+           client->stats.replayed, client->stats.connects);
+
+    offline_queue_destroy(client->offline_queue);
+    pthread_cond_destroy(&client->replay_cond);
+    pthread_mutex_destroy(&client->lock);
+    free(client->inflight);
+    free(client);
+}
+
+// --- Private Function Implementations ---
+
+static void* replay_thread_function(void* arg) {
+    MqttClient* client = (MqttClient*)arg;
+
+    pthread_mutex_lock(&client->lock);
+    while (client->running) {
+        // Idle until a replay is requested
+        while (!client->replay_requested && client->running) {
+            pthread_cond_wait(&client->replay_cond, &client->lock);
+        }
+        client->replay_requested = false;
+        if (!client->running) break;
+
+        // Also serves as a keepalive tick when no frames are flowing
+        read_packets(client, 0);
+        check_connection(client);
+        bool connected = client->socket_fd >= 0 || connect_to_broker(client);
+        pthread_mutex_unlock(&client->lock);
+
+        if (connected) {
+            offline_queue_process(client->offline_queue, publish_backlog_batch, client);
+        }
+        pthread_mutex_lock(&client->lock);
+    }
+    pthread_mutex_unlock(&client->lock);
+    return NULL;
+}
+
+// Publishes one compressed batch and waits for its PUBACK; the batch stays queued otherwise
+static bool publish_backlog_batch(const void* data, size_t size, void* user_context) {
+    MqttClient* client = (MqttClient*)user_context;
+
+    pthread_mutex_lock(&client->lock);
+    uint16_t packet_id = send_message(client, client->config.backlog_topic, data, size, NULL, true);
+    bool acknowledged = false;
+    while (packet_id != 0) {
+        InflightMessage* message = find_message(client, packet_id);
+        if (!message) {
+            acknowledged = true;
+            break;
+        }
+        if (client->socket_fd < 0 || !client->running) {
+            release_message(client, message); // Not resent: its lines go back to the queue
+            break;
+        }
+        wait_for_broker(client); // Live publishing goes on meanwhile
+        check_connection(client);
+    }
+    pthread_mutex_unlock(&client->lock);
+    return acknowledged;
+}
+
+// Puts a message into the window and sends it (lock held; released while waiting for a free
+// slot). A message in the window is owned by it: a failed send is repeated after the reconnect.
+// Returns its packet id, or 0 if the broker cannot be reached.
+static uint16_t send_message(MqttClient* client, const char* topic, const void* payload, size_t size,
+                             const char* offline_line, bool backlog) {
+    while (true) {
+        if (client->socket_fd < 0 && !connect_to_broker(client)) return 0;
+        if (client->count < client->config.max_inflight) break;
+
+        wait_for_broker(client);
+        check_connection(client);
+    }
+
+    uint16_t packet_id = client->next_packet_id;
+    client->next_packet_id = packet_id == UINT16_MAX ? 1 : packet_id + 1;
+
+    size_t length = 0;
+    uint8_t* packet = build_publish(topic, payload, size, packet_id, &length);
+    char* line = offline_line ? strdup(offline_line) : NULL;
+    if (!packet || (offline_line && !line)) {
+        fprintf(stderr, "MQTT: Cannot build a PUBLISH of %zu bytes\n", size);
+        free(packet);
+        free(line);
+        return 0;
+    }
+
+    InflightMessage* message = &client->inflight[(client->head + client->count) % client->config.max_inflight];
+    *message = (InflightMessage){ packet_id, packet, length, line, backlog, monotonic_seconds() };
+    client->count++;
+    client->pending++;
+
+    send_all(client, packet, length);
+    return packet_id;
+}
+
+// Opens the connection and the session, then resends the unacknowledged messages
+static bool connect_to_broker(MqttClient* client) {
+    double now = monotonic_seconds();
+    if (now < client->next_connect_s) return false;
+
+    int fd = open_connection(&client->config);
+    if (fd >= 0) {
+        client->socket_fd = fd;
+        client->rx_length = 0;
+        client->ping_sent_s = 0.0;
+        client->connack_received = false;
+
+        uint8_t packet[256];
+        size_t length = build_connect(&client->config, packet);
+        double deadline_s = now + client->config.ack_timeout_ms / 1000.0;
+        bool sent = send_all(client, packet, length);
+        while (sent && client->socket_fd >= 0 && !client->connack_received && monotonic_seconds() < deadline_s) {
+            read_packets(client, MQTT_POLL_STEP_MS);
+        }
+
+        if (client->connack_received && client->connack_code == 0) {
+            client->stats.connects++;
+            client->backoff_s = MQTT_INITIAL_BACKOFF_S;
+            printf("MQTT: Connected to %s:%d (%s session, %d message(s) to resend)\n", client->config.host,
+                   client->config.port, client->session_present ? "resumed" : "new", client->pending);
+
+            for (int i = 0; i < client->count && client->socket_fd >= 0; i++) {
+                InflightMessage* message = &client->inflight[(client->head + i) % client->config.max_inflight];
+                if (!message->packet) continue;
+                message->packet[0] |= MQTT_PUBLISH_DUP;
+                message->sent_s = monotonic_seconds();
+                if (send_all(client, message->packet, message->length)) client->stats.retransmitted++;
+            }
+            return client->socket_fd >= 0;
+        }
+
+        if (client->connack_received) {
+            static const char* reasons[] = { "", "unacceptable protocol version", "client id rejected",
+                                             "server unavailable", "bad user name or password", "not authorized" };
+            fprintf(stderr, "MQTT: Connection refused by %s: %s\n", client->config.host,
+                    client->connack_code < 6 ? reasons[client->connack_code] : "unknown reason");
+        } else {
+            fprintf(stderr, "MQTT: No CONNACK from %s\n", client->config.host);
+        }
+        if (client->socket_fd >= 0) close(client->socket_fd);
+        client->socket_fd = -1;
+    }
+
+    client->next_connect_s = now + client->backoff_s;
+    client->backoff_s *= 2.0;
+    if (client->backoff_s > client->config.reconnect_max_s) client->backoff_s = client->config.reconnect_max_s;
+    return false;
+}
+
+// Resolves the broker and connects with a timeout; returns a non-blocking socket or -1
+static int open_connection(const MqttConfig* config) {
+    char port[8];
+    snprintf(port, sizeof(port), "%d", config->port);
+
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
+    struct addrinfo* addresses = NULL;
+    int error = getaddrinfo(config->host, port, &hints, &addresses);
+    if (error != 0) {
+        fprintf(stderr, "MQTT: Cannot resolve %s: %s\n", config->host, gai_strerror(error));
+        return -1;
+    }
+
+    int fd = -1;
+    int connect_error = 0;
+    for (struct addrinfo* address = addresses; address; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) continue;
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        connect_error = 0;
+        if (connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+            connect_error = errno;
+            if (connect_error == EINPROGRESS) {
+                struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+                socklen_t error_size = sizeof(connect_error);
+                if (poll(&pfd, 1, config->ack_timeout_ms) <= 0) {
+                    connect_error = ETIMEDOUT;
+                } else if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &connect_error, &error_size) != 0) {
+                    connect_error = errno;
+                }
+            }
+        }
+        if (connect_error == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (fd < 0) {
+        fprintf(stderr, "MQTT: Cannot connect to %s:%d: %s\n", config->host, config->port,
+                strerror(connect_error ? connect_error : EHOSTUNREACH));
+        return -1;
+    }
+
+    int no_delay = 1; // Small frames go out at once; the window does the batching
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+    return fd;
+}
+
+static void disconnect(MqttClient* client, const char* reason) {
+    if (client->socket_fd < 0) return;
+
+    fprintf(stderr, "MQTT: Connection to %s lost (%s), %d message(s) unacknowledged\n",
+            client->config.host, reason, client->pending);
+    close(client->socket_fd);
+    client->socket_fd = -1;
+    client->rx_length = 0;
+    client->ping_sent_s = 0.0;
+    client->next_connect_s = 0.0; // The first retry is immediate; failed ones back off
+}
+
+// Drops a connection whose acknowledgements are overdue and keeps an idle one alive
+static void check_connection(MqttClient* client) {
+    if (client->socket_fd < 0) return;
+
+    double now = monotonic_seconds();
+    double timeout_s = client->config.ack_timeout_ms / 1000.0;
+    if (client->count > 0 && now - client->inflight[client->head].sent_s > timeout_s) {
+        disconnect(client, "acknowledgement timed out");
+    } else if (client->ping_sent_s > 0.0 && now - client->ping_sent_s > timeout_s) {
+        disconnect(client, "no answer to ping");
+    } else if (client->config.keepalive_s > 0 && client->ping_sent_s == 0.0 &&
+               now - client->last_send_s >= client->config.keepalive_s) {
+        const uint8_t packet[] = { MQTT_PACKET_PINGREQ, 0 };
+        if (send_all(client, packet, sizeof(packet))) client->ping_sent_s = now;
+    }
+}
+
+// Reads what the broker sent (waiting up to timeout_ms) and handles every complete packet.
+// Returns false if the connection is down.
+static bool read_packets(MqttClient* client, int timeout_ms) {
+    if (client->socket_fd < 0) return false;
+
+    struct pollfd pfd = { .fd = client->socket_fd, .events = POLLIN };
+    if (poll(&pfd, 1, timeout_ms) <= 0) return true;
+
+    ssize_t received = recv(client->socket_fd, client->rx_buffer + client->rx_length,
+                            sizeof(client->rx_buffer) - client->rx_length, 0);
+    if (received == 0) {
+        disconnect(client, "closed by the broker");
+        return false;
+    }
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return true;
+        disconnect(client, strerror(errno));
+        return false;
+    }
+    client->rx_length += (size_t)received;
+
+    while (client->rx_length >= 2) {
+        // Fixed header: type byte, then the remaining length in 1-4 bytes of 7 bits
+        size_t remaining = 0;
+        size_t header = 1;
+        bool complete = false;
+        while (header < client->rx_length && header <= 4) {
+            uint8_t byte = client->rx_buffer[header];
+            remaining |= (size_t)(byte & 0x7F) << (7 * (header - 1));
+            header++;
+            if (!(byte & 0x80)) {
+                complete = true;
+                break;
+            }
+        }
+        if (!complete && header > 4) {
+            disconnect(client, "malformed packet");
+            return false;
+        }
+        if (!complete) break;
+        if (header + remaining > sizeof(client->rx_buffer)) {
+            disconnect(client, "unexpected packet");
+            return false;
+        }
+        if (client->rx_length < header + remaining) break;
+
+        handle_packet(client, client->rx_buffer[0] & 0xF0, client->rx_buffer + header, remaining);
+        client->rx_length -= header + remaining;
+        memmove(client->rx_buffer, client->rx_buffer + header + remaining, client->rx_length);
+    }
+    return client->socket_fd >= 0;
+}
+
+// Waits up to MQTT_POLL_STEP_MS for the broker without holding the lock, then reads what came
+// (lock held on entry and on return). Another thread may have read it or reconnected meanwhile.
+static void wait_for_broker(MqttClient* client) {
+    struct pollfd pfd = { .fd = client->socket_fd, .events = POLLIN };
+    if (pfd.fd < 0) return;
+
+    pthread_mutex_unlock(&client->lock);
+    poll(&pfd, 1, MQTT_POLL_STEP_MS);
+    pthread_mutex_lock(&client->lock);
+    read_packets(client, 0);
+}
+
+static void handle_packet(MqttClient* client, uint8_t type, const uint8_t* body, size_t length) {
+    switch (type) {
+        case MQTT_PACKET_CONNACK:
+            if (length < 2) break;
+            client->session_present = body[0] & 0x01;
+            client->connack_code = body[1];
+            client->connack_received = true;
+            break;
+
+        case MQTT_PACKET_PUBACK: {
+            if (length < 2) break;
+            InflightMessage* message = find_message(client, (uint16_t)((body[0] << 8) | body[1]));
+            if (!message) break; // Late duplicate
+            if (message->backlog) {
+                client->stats.replayed++;
+            } else {
+                client->stats.acknowledged++;
+            }
+            release_message(client, message);
+            break;
+        }
+
+        case MQTT_PACKET_PINGRESP:
+            client->ping_sent_s = 0.0;
+            break;
+
+        default:
+            break; // Nothing else is expected by a publisher
+    }
+}
+
+static bool send_all(MqttClient* client, const uint8_t* data, size_t length) {
+    size_t sent = 0;
+    while (sent < length) {
+        if (client->socket_fd < 0) return false;
+
+        ssize_t result = send(client->socket_fd, data + sent, length - sent, MSG_NOSIGNAL);
+        if (result > 0) {
+            sent += (size_t)result;
+        } else if (result < 0 && errno == EINTR) {
+            continue;
+        } else if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd pfd = { .fd = client->socket_fd, .events = POLLOUT };
+            if (poll(&pfd, 1, client->config.ack_timeout_ms) <= 0) {
+                disconnect(client, "send timed out");
+                return false;
+            }
+        } else {
+            disconnect(client, strerror(errno));
+            return false;
+        }
+    }
+    client->last_send_s = monotonic_seconds();
+    return true;
+}
+
+static uint8_t* build_publish(const char* topic, const void* payload, size_t size, uint16_t packet_id, size_t* length) {
+    size_t topic_length = strlen(topic);
+    size_t remaining = 2 + topic_length + 2 + size;
+    if (remaining > MQTT_MAX_REMAINING_LENGTH) return NULL;
+
+    uint8_t* packet = malloc(5 + remaining);
+    if (!packet) return NULL;
+
+    size_t position = 0;
+    packet[position++] = MQTT_PACKET_PUBLISH | MQTT_PUBLISH_QOS1;
+    position += put_remaining_length(packet + position, remaining);
+    position += put_string(packet + position, topic);
+    packet[position++] = (uint8_t)(packet_id >> 8);
+    packet[position++] = (uint8_t)(packet_id & 0xFF);
+    memcpy(packet + position, payload, size);
+    *length = position + size;
+    return packet;
+}
+
+// CONNECT for a persistent session (CleanSession = 0); packet must hold 256 bytes
+static size_t build_connect(const MqttConfig* config, uint8_t* packet) {
+    bool has_username = strlen(config->username) > 0;
+    bool has_password = has_username && strlen(config->password) > 0;
+
+    uint8_t body[240];
+    size_t position = put_string(body, "MQTT");
+    body[position++] = MQTT_PROTOCOL_LEVEL;
+    body[position++] = (has_username ? MQTT_CONNECT_USERNAME : 0) | (has_password ? MQTT_CONNECT_PASSWORD : 0);
+    body[position++] = (uint8_t)(config->keepalive_s >> 8);
+    body[position++] = (uint8_t)(config->keepalive_s & 0xFF);
+    position += put_string(body + position, config->client_id);
+    if (has_username) position += put_string(body + position, config->username);
+    if (has_password) position += put_string(body + position, config->password);
+
+    size_t length = 0;
+    packet[length++] = MQTT_PACKET_CONNECT;
+    length += put_remaining_length(packet + length, position);
+    memcpy(packet + length, body, position);
+    return length + position;
+}
+
+static size_t put_remaining_length(uint8_t* out, size_t length) {
+    size_t count = 0;
+    do {
+        uint8_t byte = length & 0x7F;
+        length >>= 7;
+        out[count++] = byte | (length > 0 ? 0x80 : 0);
+    } while (length > 0);
+    return count;
+}
+
+static size_t put_string(uint8_t* out, const char* value) {
+    size_t length = strlen(value);
+    out[0] = (uint8_t)(length >> 8);
+    out[1] = (uint8_t)(length & 0xFF);
+    memcpy(out + 2, value, length);
+    return 2 + length;
+}
+
+static InflightMessage* find_message(MqttClient* client, uint16_t packet_id) {
+    for (int i = 0; i < client->count; i++) {
+        InflightMessage* message = &client->inflight[(client->head + i) % client->config.max_inflight];
+        if (message->packet && message->packet_id == packet_id) return message;
+    }
+    return NULL;
+}
+
+// Frees a message and shrinks the window past the finished messages at its front
+static void release_message(MqttClient* client, InflightMessage* message) {
+    free(message->packet);
+    free(message->offline_line);
+    message->packet = NULL;
+    message->offline_line = NULL;
+    client->pending--;
+
+    while (client->count > 0 && !client->inflight[client->head].packet) {
+        client->head = (client->head + 1) % client->config.max_inflight;
+        client->count--;
+    }
+}
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,84 @@
+#ifndef MQTT_CLIENT_H
+#define MQTT_CLIENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "ConfigYAML.h"
+
+/**
+ * @file MqttClient.h
+ * @brief Minimal MQTT 3.1.1 publisher (QoS 1) with a persistent session and an offline queue.
+ *
+ * The protocol framing (CONNECT, PUBLISH, PUBACK, PINGREQ, DISCONNECT) is done in-process
+ * over one TCP connection. Up to max_inflight messages may wait for their PUBACK; a further
+ * publish waits for a free slot. The client connects with CleanSession = 0 under a fixed
+ * client id, so the broker keeps the session across reconnects, and after every reconnect
+ * the unacknowledged messages are sent again with the DUP flag (at-least-once delivery).
+ *
+ * While the broker cannot be reached, messages go to the offline queue file instead, as
+ * line protocol. A replay (mqtt_client_request_replay) runs on the client's own thread and
+ * publishes the queue as gzip-compressed batches of lines to the backlog topic; a batch
+ * leaves the queue only once the broker has acknowledged it.
+ *
+ * All functions are thread-safe.
+ */
+
+typedef struct MqttClient MqttClient; // Opaque MQTT client
+
+typedef struct {
+    unsigned long acknowledged;   // Live messages acknowledged by the broker
+    unsigned long retransmitted;  // Messages sent again (DUP) after a reconnect
+    unsigned long offline;        // Messages written to the offline queue
+    unsigned long replayed;       // Offline batches acknowledged
+    unsigned long connects;       // Successful connections (the first one included)
+    int inflight;                 // Messages waiting for their PUBACK now
+    bool connected;
+} MqttClientStats;
+
+/**
+ * @brief Creates the client and starts its replay thread. Connects lazily, on the first publish.
+ * @param config MQTT settings (copied)
+ * @param offline_queue_path File that keeps the messages published while disconnected
+ * @return A pointer to the client, or NULL on failure
+ */
+MqttClient* mqtt_client_create(const MqttConfig* config, const char* offline_queue_path);
+
+/**
+ * @brief Publishes a payload to the configured topic with QoS 1.
+ *
+ * Connects first if needed (at most once per reconnect back-off) and waits while the in-flight
+ * window is full. If the message cannot be sent, offline_line goes to the offline queue; it is
+ * also kept with the in-flight copy and queued if the client is destroyed before the PUBACK.
+ *
+ * @param payload Message body (copied)
+ * @param offline_line Line-protocol form of the message for the offline queue (NULL = payload as text)
+ * @return true if the message was sent, false if it went to the offline queue
+ */
+bool mqtt_client_publish(MqttClient* client, const void* payload, size_t size, const char* offline_line);
+
+/**
+ * @brief Reads pending acknowledgements, sends a keepalive ping when due and drops a
+ *        connection whose acknowledgements are overdue. Never waits for the network.
+ *
+ * Returns at once if another thread is using the client. Must run at least every
+ * keepalive_s / 2 while the link may be idle (see mqtt_publisher_poll).
+ */
+void mqtt_client_poll(MqttClient* client);
+
+/**
+ * @brief Asks the replay thread to publish the offline queue to the backlog topic. Non-blocking.
+ */
+void mqtt_client_request_replay(MqttClient* client);
+
+/**
+ * @brief Copies the client's counters.
+ */
+void mqtt_client_get_stats(MqttClient* client, MqttClientStats* stats);
+
+/**
+ * @brief Waits up to ack_timeout_ms for outstanding acknowledgements, disconnects, queues
+ *        the messages still unacknowledged offline and frees the client.
+ */
+void mqtt_client_destroy(MqttClient* client);
+
+#endif // MQTT_CLIENT_H
@@ -0,0 +1,182 @@
+#include "MqttPublisher.h"
+#include "DataPublisher.h"
+#include "LineProtocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct MqttPublisher {
+    MqttClient* client;
+    MqttPayloadFormat format;
+    LineProtocolBuilder* builder;
+    uint8_t binary[MQTT_BINARY_HEADER_SIZE + NUM_CHANNELS * MQTT_BINARY_ENTRY_SIZE];
+};
+
+// --- Private Function Prototypes ---
+static void consume_frame(void* state, const AcquisitionFrame* frame);
+static void poll_client(void* state);
+static uint8_t* put_u64(uint8_t* out, uint64_t value);
+static uint8_t* put_double(uint8_t* out, double value);
+static uint64_t get_u64(const uint8_t* in);
+static double get_double(const uint8_t* in);
+
+// --- Public Functions ---
+
+MqttPublisher* mqtt_publisher_create(const MqttConfig* config, const char* offline_queue_path) {
+    if (!config) return NULL;
+
+    MqttPublisher* publisher = calloc(1, sizeof(MqttPublisher));
+    if (!publisher) {
+        perror("Failed to allocate memory for MqttPublisher");
+        return NULL;
+    }
+    publisher->format = config->format;
+    publisher->builder = lp_builder_create_default();
+    publisher->client = publisher->builder ? mqtt_client_create(config, offline_queue_path) : NULL;
+    if (!publisher->client) {
+        lp_builder_destroy(publisher->builder);
+        free(publisher);
+        return NULL;
+    }
+    return publisher;
+}
+
+PipelineSink mqtt_publisher_sink(MqttPublisher* publisher) {
+    return (PipelineSink){
+        .name = "mqtt",
+        .state = publisher,
+        .consume = consume_frame,
+        .flush = poll_client,
+    };
+}
+
+void mqtt_publisher_request_replay(MqttPublisher* publisher) {
+    if (publisher) mqtt_client_request_replay(publisher->client);
+}
+
+void mqtt_publisher_poll(MqttPublisher* publisher) {
+    if (publisher) mqtt_client_poll(publisher->client);
+}
+
+size_t mqtt_publisher_encode_binary(const AcquisitionFrame* frame, uint8_t* buffer, size_t size) {
+    if (!frame || !buffer || size < MQTT_BINARY_HEADER_SIZE) return 0;
+
+    uint8_t* entry = buffer + MQTT_BINARY_HEADER_SIZE;
+    int entry_count = 0;
+    for (int i = 0; i < NUM_CHANNELS && i < frame->channel_count; i++) {
+        const FrameChannel* channel = &frame->channels[i];
+        if (!channel->is_active || !channel->publish_value) continue;
+        if ((size_t)(entry - buffer) + MQTT_BINARY_ENTRY_SIZE > size) return 0;
+
+        float value = (float)channel->value;
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        entry[0] = (uint8_t)i;
+        entry[1] = channel->quality_flags;
+        for (int b = 0; b < 4; b++) entry[2 + b] = (uint8_t)(bits >> (8 * b));
+        entry += MQTT_BINARY_ENTRY_SIZE;
+        entry_count++;
+    }
+
+    memcpy(buffer, MQTT_BINARY_MAGIC, 4);
+    buffer[4] = MQTT_BINARY_VERSION;
+    buffer[5] = (uint8_t)entry_count;
+    buffer[6] = buffer[7] = 0;
+    uint8_t* position = put_u64(buffer + 8, frame->sequence);
+    position = put_double(position, frame->wall_time_s);
+    position = put_double(position, frame->gps.latitude);
+    position = put_double(position, frame->gps.longitude);
+    position = put_double(position, frame->gps.altitude);
+    put_double(position, frame->gps.speed);
+    return (size_t)(entry - buffer);
+}
+
+size_t mqtt_publisher_decode_binary(const uint8_t* buffer, size_t size, AcquisitionFrame* frame) {
+    if (!buffer || !frame || size < MQTT_BINARY_HEADER_SIZE ||
+        memcmp(buffer, MQTT_BINARY_MAGIC, 4) != 0 || buffer[4] != MQTT_BINARY_VERSION) {
+        return 0;
+    }
+    size_t record_size = MQTT_BINARY_HEADER_SIZE + (size_t)buffer[5] * MQTT_BINARY_ENTRY_SIZE;
+    if (size < record_size) return 0;
+
+    memset(frame, 0, sizeof(*frame));
+    frame->sequence = get_u64(buffer + 8);
+    frame->wall_time_s = get_double(buffer + 16);
+    frame->gps.latitude = get_double(buffer + 24);
+    frame->gps.longitude = get_double(buffer + 32);
+    frame->gps.altitude = get_double(buffer + 40);
+    frame->gps.speed = get_double(buffer + 48);
+
+    const uint8_t* entry = buffer + MQTT_BINARY_HEADER_SIZE;
+    for (int e = 0; e < buffer[5]; e++, entry += MQTT_BINARY_ENTRY_SIZE) {
+        if (entry[0] >= NUM_CHANNELS) continue;
+        FrameChannel* channel = &frame->channels[entry[0]];
+        uint32_t bits = 0;
+        for (int b = 0; b < 4; b++) bits |= (uint32_t)entry[2 + b] << (8 * b);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+
+        channel->is_active = true;
+        channel->publish_value = true;
+        channel->quality_flags = entry[1];
+        channel->value = value;
+        if (entry[0] >= frame->channel_count) frame->channel_count = entry[0] + 1;
+    }
+    return record_size;
+}
+
+void mqtt_publisher_destroy(MqttPublisher* publisher) {
+    if (!publisher) return;
+
+    mqtt_client_destroy(publisher->client);
+    lp_builder_destroy(publisher->builder);
+    free(publisher);
+}
+
+// --- Private Function Implementations ---
+
+// Pipeline callback, on the sink's thread
+static void consume_frame(void* state, const AcquisitionFrame* frame) {
+    MqttPublisher* publisher = (MqttPublisher*)state;
+
+    // The line form is also what the offline queue keeps
+    if (!data_publisher_format_frame(publisher->builder, frame)) return;
+    const char* line = lp_view(publisher->builder);
+    if (!line) return;
+
+    if (publisher->format == MQTT_FORMAT_BINARY) {
+        size_t size = mqtt_publisher_encode_binary(frame, publisher->binary, sizeof(publisher->binary));
+        if (size > 0) mqtt_client_publish(publisher->client, publisher->binary, size, line);
+    } else {
+        mqtt_client_publish(publisher->client, line, strlen(line), line);
+    }
+}
+
+// Pipeline callback once the queue has drained: acknowledgements and keepalive
+static void poll_client(void* state) {
+    mqtt_client_poll(((MqttPublisher*)state)->client);
+}
+
+static uint8_t* put_u64(uint8_t* out, uint64_t value) {
+    for (int b = 0; b < 8; b++) out[b] = (uint8_t)(value >> (8 * b));
+    return out + 8;
+}
+
+static uint8_t* put_double(uint8_t* out, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return put_u64(out, bits);
+}
+
+static uint64_t get_u64(const uint8_t* in) {
+    uint64_t value = 0;
+    for (int b = 0; b < 8; b++) value |= (uint64_t)in[b] << (8 * b);
+    return value;
+}
+
+static double get_double(const uint8_t* in) {
+    uint64_t bits = get_u64(in);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
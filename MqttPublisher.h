@@ -0,0 +1,85 @@
+#ifndef MQTT_PUBLISHER_H
+#define MQTT_PUBLISHER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ConfigYAML.h"
+#include "MqttClient.h"
+#include "Pipeline.h"
+
+/**
+ * @file MqttPublisher.h
+ * @brief Output sink publishing every frame it receives to the MQTT topic.
+ *
+ * Frames are published as one line-protocol "measurements" line (as sent to InfluxDB, without
+ * statistics fields) or, with format binary, packed little-endian:
+ *
+ *   offset  size  field
+ *        0     4  magic "DAQF"
+ *        4     1  version (1)
+ *        5     1  N, number of channel entries
+ *        6     2  reserved (0)
+ *        8     8  sequence (uint64)
+ *       16     8  wall-clock capture time in seconds (double)
+ *       24    32  latitude, longitude, altitude, speed (double; NaN = no fix)
+ *       56  N x 6 channel index (uint8, configuration order), quality flags (uint8,
+ *                 CHANNEL_QUALITY_*), calibrated value (float; meaningful when the flags are 0)
+ *
+ * Entries cover the active channels that publish a value. Frames that cannot be sent go to the
+ * client's offline queue as line protocol, whatever the format.
+ */
+
+#define MQTT_BINARY_MAGIC "DAQF"
+#define MQTT_BINARY_VERSION 1
+#define MQTT_BINARY_HEADER_SIZE 56
+#define MQTT_BINARY_ENTRY_SIZE 6
+
+typedef struct MqttPublisher MqttPublisher; // Opaque MQTT sink
+
+/**
+ * @brief Creates the publisher and its client.
+ * @param config MQTT settings (copied)
+ * @param offline_queue_path File that keeps frames published while disconnected
+ * @return A pointer to the publisher, or NULL on failure
+ */
+MqttPublisher* mqtt_publisher_create(const MqttConfig* config, const char* offline_queue_path);
+
+/**
+ * @brief Returns the pipeline sink that publishes the frames ("mqtt").
+ */
+PipelineSink mqtt_publisher_sink(MqttPublisher* publisher);
+
+/**
+ * @brief Asks the client to replay its offline queue to the backlog topic. Non-blocking.
+ */
+void mqtt_publisher_request_replay(MqttPublisher* publisher);
+
+/**
+ * @brief Keepalive tick (mqtt_client_poll), for a timer every keepalive_s / 2: frames alone
+ *        do not keep the link alive when the sink interval is long or frames stop. Non-blocking.
+ */
+void mqtt_publisher_poll(MqttPublisher* publisher);
+
+/**
+ * @brief Encodes a frame in the binary layout above.
+ * @return Bytes written, or 0 if the buffer is too small
+ */
+size_t mqtt_publisher_encode_binary(const AcquisitionFrame* frame, uint8_t* buffer, size_t size);
+
+/**
+ * @brief Decodes a frame in the binary layout above (used by the gateway).
+ *
+ * Fills the sequence, wall time, GPS fix and, at their configuration index, the channels the
+ * record carries (active and published); the other channels are inactive. Channel ids and
+ * units are left empty.
+ *
+ * @return Bytes used, or 0 if the buffer does not start with a complete version 1 frame
+ */
+size_t mqtt_publisher_decode_binary(const uint8_t* buffer, size_t size, AcquisitionFrame* frame);
+
+/**
+ * @brief Disconnects (see mqtt_client_destroy) and frees the publisher. Remove its sink first.
+ */
+void mqtt_publisher_destroy(MqttPublisher* publisher);
+
+#endif // MQTT_PUBLISHER_H
@@ -3,35 +3,85 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <pthread.h>
 #include <zlib.h> // For gzip compression
 
 #define MAX_BATCH_SIZE 5000
-#define MAX_LINE_LENGTH 2048
+#define MAX_LINE_LENGTH 8192 // Room for a full sweep with statistics fields
 #define BATCH_BUFFER_SIZE (MAX_BATCH_SIZE * MAX_LINE_LENGTH)
 
-static char g_log_file_path[256];
-static char g_temp_log_file_path[256];
+struct OfflineQueue {
+    char log_file_path[256];
+    char replay_file_path[264];   // Log moved aside while it is being replayed
+    char temp_file_path[264];     // Lines of failed batches during a replay
+    pthread_mutex_t mutex;        // Guards the log file against concurrent add/process
+};
 
 // --- Public Functions ---
 
-void offline_queue_init(const char* log_file_path) {
+OfflineQueue* offline_queue_create(const char* log_file_path) {
+    if (!log_file_path) return NULL;
+
+    OfflineQueue* queue = calloc(1, sizeof(OfflineQueue));
+    if (!queue) {
+        perror("Failed to allocate memory for OfflineQueue");
+        return NULL;
+    }
+
     mkdir("logs", 0755); // Ensure the directory exists
-    strncpy(g_log_file_path, log_file_path, sizeof(g_log_file_path) - 1);
-    g_log_file_path[sizeof(g_log_file_path) - 1] = '\0';
+    strncpy(queue->log_file_path, log_file_path, sizeof(queue->log_file_path) - 1);
+    queue->log_file_path[sizeof(queue->log_file_path) - 1] = '\0';
 
-    snprintf(g_temp_log_file_path, sizeof(g_temp_log_file_path), "%s.tmp", g_log_file_path);
+    snprintf(queue->replay_file_path, sizeof(queue->replay_file_path), "%s.replay", queue->log_file_path);
+    snprintf(queue->temp_file_path, sizeof(queue->temp_file_path), "%s.tmp", queue->log_file_path);
+    pthread_mutex_init(&queue->mutex, NULL);
+    return queue;
 }
 
-void offline_queue_add(const char* line_protocol) {
-    FILE* file = fopen(g_log_file_path, "a");
+void offline_queue_add(OfflineQueue* queue, const char* line_protocol) {
+    if (!queue || !line_protocol) return;
+
+    pthread_mutex_lock(&queue->mutex);
+    FILE* file = fopen(queue->log_file_path, "a");
     if (file) {
         fprintf(file, "%s\n", line_protocol);
         fclose(file);
     } else {
         perror("Failed to open offline log file");
     }
+    pthread_mutex_unlock(&queue->mutex);
 }
 
+void offline_queue_destroy(OfflineQueue* queue) {
+    if (!queue) return;
+
+    pthread_mutex_destroy(&queue->mutex);
+    free(queue);
+}
+
+void* offline_queue_gzip(const void* data, size_t size, size_t* compressed_size) {
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return NULL;
+    }
+
+    size_t capacity = deflateBound(&zs, size);
+    void* compressed = malloc(capacity);
+    zs.next_in = (Bytef*)data;
+    zs.avail_in = size;
+    zs.next_out = compressed;
+    zs.avail_out = capacity;
+    if (!compressed || deflate(&zs, Z_FINISH) != Z_STREAM_END) {
+        free(compressed);
+        deflateEnd(&zs);
+        return NULL;
+    }
+
+    *compressed_size = zs.total_out;
+    deflateEnd(&zs);
+    return compressed;
+}
 
 // Helper function to process a batch of lines
 static bool process_batch(send_batch_func_t send_func, void* user_context, char* line_batch[], int line_count) {
@@ -60,41 +110,14 @@ static bool process_batch(send_batch_func_t send_func, void* user_context, char*
     *current_pos = '\0';
 
     // 2. Gzip the buffer
-    z_stream zs;
-    memset(&zs, 0, sizeof(zs));
-    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
-        fprintf(stderr, "deflateInit2 failed\n");
-        free(uncompressed_buffer);
-        return false;
-    }
-
-    zs.avail_in = total_size;
-    zs.next_in = (Bytef*)uncompressed_buffer;
-
-    size_t compressed_buffer_size = deflateBound(&zs, total_size);
-    void* compressed_buffer = malloc(compressed_buffer_size);
+    size_t compressed_size = 0;
+    void* compressed_buffer = offline_queue_gzip(uncompressed_buffer, total_size, &compressed_size);
+    free(uncompressed_buffer);
     if (!compressed_buffer) {
-        perror("Failed to allocate memory for compressed batch");
-        free(uncompressed_buffer);
-        deflateEnd(&zs);
+        fprintf(stderr, "Failed to compress offline batch\n");
         return false;
     }
 
-    zs.avail_out = compressed_buffer_size;
-    zs.next_out = (Bytef*)compressed_buffer;
-
-    if (deflate(&zs, Z_FINISH) != Z_STREAM_END) {
-        fprintf(stderr, "deflate failed\n");
-        free(uncompressed_buffer);
-        free(compressed_buffer);
-        deflateEnd(&zs);
-        return false;
-    }
-
-    size_t compressed_size = zs.total_out;
-    deflateEnd(&zs);
-    free(uncompressed_buffer);
-
     // 3. Send the compressed data via the callback
     printf("Sending batch of %d lines (compressed size: %zu bytes)...\n", line_count, compressed_size);
     bool success = send_func(compressed_buffer, compressed_size, user_context);
@@ -103,22 +126,51 @@ static bool process_batch(send_batch_func_t send_func, void* user_context, char*
     return success;
 }
 
-void offline_queue_process(send_batch_func_t send_func, void* user_context) {
-    if (!send_func) return;
-
-    FILE* infile = fopen(g_log_file_path, "r");
-    if (!infile) return; // No file to process
+// Moves the log aside so new lines can keep arriving while it is replayed.
+// A replay file left by an interrupted run is replayed first.
+static bool take_log_for_replay(OfflineQueue* queue) {
+    struct stat st;
+    if (stat(queue->replay_file_path, &st) == 0) return true;
+
+    pthread_mutex_lock(&queue->mutex);
+    bool has_data = stat(queue->log_file_path, &st) == 0 && st.st_size > 0 &&
+                    rename(queue->log_file_path, queue->replay_file_path) == 0;
+    pthread_mutex_unlock(&queue->mutex);
+    return has_data;
+}
 
-    fseek(infile, 0, SEEK_END);
-    if (ftell(infile) == 0) {
-        fclose(infile);
-        return; // File is empty
+// Appends the lines of failed batches back to the log
+static void return_failed_lines(OfflineQueue* queue) {
+    FILE* failed = fopen(queue->temp_file_path, "r");
+    if (!failed) return;
+
+    pthread_mutex_lock(&queue->mutex);
+    FILE* log = fopen(queue->log_file_path, "a");
+    if (log) {
+        char buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), failed)) > 0) {
+            fwrite(buffer, 1, n, log);
+        }
+        fclose(log);
+    } else {
+        perror("Failed to reopen offline log file");
     }
-    fseek(infile, 0, SEEK_SET);
+    pthread_mutex_unlock(&queue->mutex);
 
-    printf("Processing offline data queue...\n");
+    fclose(failed);
+}
+
+void offline_queue_process(OfflineQueue* queue, send_batch_func_t send_func, void* user_context) {
+    if (!queue || !send_func) return;
+    if (!take_log_for_replay(queue)) return; // Nothing queued
+
+    FILE* infile = fopen(queue->replay_file_path, "r");
+    if (!infile) return;
 
-    FILE* tmpfile = fopen(g_temp_log_file_path, "w");
+    printf("Processing offline data queue %s...\n", queue->log_file_path);
+
+    FILE* tmpfile = fopen(queue->temp_file_path, "w");
     if (!tmpfile) {
         perror("Could not open temp file for offline queue processing");
         fclose(infile);
@@ -141,6 +193,9 @@ void offline_queue_process(send_batch_func_t send_func, void* user_context) {
         if (!line_with_newline) {
             perror("malloc failed for line");
             any_batch_failed = true;
+            // Keep this line and everything after it for the next replay
+            fprintf(tmpfile, "%s\n", line);
+            while (fgets(line, sizeof(line), infile)) fputs(line, tmpfile);
             break;
         }
         snprintf(line_with_newline, line_len + 2, "%s\n", line);
@@ -177,15 +232,11 @@ void offline_queue_process(send_batch_func_t send_func, void* user_context) {
     fclose(tmpfile);
 
     if (any_batch_failed) {
-        // If any batch failed, the original log is replaced by the temp file
-        // which contains only the lines from failed batches.
-        remove(g_log_file_path);
-        rename(g_temp_log_file_path, g_log_file_path);
+        return_failed_lines(queue);
         printf("Offline queue processing finished with failures. Remaining data saved.\n");
     } else {
-        // If all batches succeeded, both files are removed.
-        remove(g_log_file_path);
-        remove(g_temp_log_file_path);
         printf("Offline queue fully processed and sent successfully.\n");
     }
-}
\ No newline at end of file
+    remove(queue->replay_file_path);
+    remove(queue->temp_file_path);
+}
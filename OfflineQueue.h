@@ -8,29 +8,58 @@
 // The function should return true on success and false on failure.
 typedef bool (*send_batch_func_t)(const void* data, size_t size, void* user_context);
 
+typedef struct OfflineQueue OfflineQueue; // Opaque offline queue (one file per sender)
+
 /**
- * @brief Initializes the offline queue module.
+ * @brief Creates an offline queue backed by a file.
+ *
+ * Lines are appended to the file while the network is down and replayed later.
  *
  * @param log_file_path The path to the file to use for the offline log.
+ * @return A pointer to the queue, or NULL on failure.
  */
-void offline_queue_init(const char* log_file_path);
+OfflineQueue* offline_queue_create(const char* log_file_path);
 
 /**
  * @brief Adds a line protocol string to the offline queue file.
  *
- * @param line_protocol The null-terminated string to add.
+ * Thread-safe; may be called while the queue is being processed.
+ *
+ * @param queue The offline queue.
+ * @param line_protocol The null-terminated string to add (one or more lines).
  */
-void offline_queue_add(const char* line_protocol);
+void offline_queue_add(OfflineQueue* queue, const char* line_protocol);
 
 /**
  * @brief Processes the offline queue, sending data in compressed batches.
  *
- * This function reads the offline log file, groups lines into batches,
+ * This function moves the offline log aside, groups its lines into batches,
  * compresses them, and calls the provided callback function to send them.
+ * Lines of failed batches are appended back to the log.
  *
+ * @param queue The offline queue.
  * @param send_func The callback function to use for sending a batch.
  * @param user_context A pointer to user-defined context that will be passed to the callback.
  */
-void offline_queue_process(send_batch_func_t send_func, void* user_context);
+void offline_queue_process(OfflineQueue* queue, send_batch_func_t send_func, void* user_context);
+
+/**
+ * @brief Gzips a buffer, as the batches handed to send_batch_func_t are.
+ *
+ * Shared by the senders that compress their live write requests.
+ *
+ * @param data The bytes to compress.
+ * @param size Their length.
+ * @param compressed_size Receives the length of the result.
+ * @return A malloc'ed gzip stream (the caller frees it), or NULL on failure.
+ */
+void* offline_queue_gzip(const void* data, size_t size, size_t* compressed_size);
+
+/**
+ * @brief Frees the queue. The log file is kept for the next run.
+ *
+ * @param queue The offline queue.
+ */
+void offline_queue_destroy(OfflineQueue* queue);
 
 #endif // OFFLINE_QUEUE_H
@@ -0,0 +1,258 @@
+#include "Pipeline.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+typedef struct {
+    PipelineSink sink;
+    char name[PIPELINE_SINK_NAME_SIZE];
+    AcquisitionFrameStore* frames; // Where consumed and dropped frames are released
+    double interval_s;
+    double next_due_s;            // Capture time from which the next frame is taken
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_t thread;
+    bool started;
+    bool running;
+    const AcquisitionFrame** queue; // Ring of held frames
+    int queue_size;
+    int head;
+    int count;
+    PipelineSinkStats stats;
+} SinkSlot;
+
+struct Pipeline {
+    AcquisitionFrameStore* frames;
+    SinkSlot* sinks[PIPELINE_MAX_SINKS];
+    int sink_count;
+};
+
+// --- Private Function Prototypes ---
+static void* sink_thread_function(void* arg);
+static void enqueue_frame(Pipeline* pipeline, SinkSlot* slot, const AcquisitionFrame* frame);
+static double monotonic_seconds(void);
+
+// --- Public Functions ---
+
+Pipeline* pipeline_create(AcquisitionFrameStore* frames) {
+    if (!frames) return NULL;
+
+    Pipeline* pipeline = calloc(1, sizeof(Pipeline));
+    if (!pipeline) {
+        perror("Failed to allocate memory for Pipeline");
+        return NULL;
+    }
+    pipeline->frames = frames;
+    return pipeline;
+}
+
+PipelineSinkId pipeline_add_sink(Pipeline* pipeline, const PipelineSink* sink, int queue_size, double interval_s) {
+    if (!pipeline || !sink || !sink->consume || queue_size < 1) return -1;
+    if (pipeline->sink_count >= PIPELINE_MAX_SINKS) {
+        fprintf(stderr, "Pipeline: Sink limit (%d) reached\n", PIPELINE_MAX_SINKS);
+        return -1;
+    }
+
+    SinkSlot* slot = calloc(1, sizeof(SinkSlot));
+    if (!slot) {
+        perror("Failed to allocate memory for pipeline sink");
+        return -1;
+    }
+    slot->queue = calloc((size_t)queue_size, sizeof(slot->queue[0]));
+    if (!slot->queue || pthread_mutex_init(&slot->lock, NULL) != 0) {
+        fprintf(stderr, "Pipeline: Failed to create the queue of sink %s\n", sink->name ? sink->name : "?");
+        free(slot->queue);
+        free(slot);
+        return -1;
+    }
+    pthread_cond_init(&slot->wake, NULL);
+
+    slot->sink = *sink;
+    snprintf(slot->name, sizeof(slot->name), "%s", sink->name ? sink->name : "sink");
+    slot->sink.name = slot->name;
+    slot->frames = pipeline->frames;
+    slot->queue_size = queue_size;
+    slot->interval_s = interval_s > 0.0 ? interval_s : 0.0;
+
+    pipeline->sinks[pipeline->sink_count] = slot;
+    return pipeline->sink_count++;
+}
+
+void pipeline_set_interval(Pipeline* pipeline, PipelineSinkId sink_id, double interval_s) {
+    if (!pipeline || sink_id < 0 || sink_id >= pipeline->sink_count) return;
+    // Only the producer reads it
+    pipeline->sinks[sink_id]->interval_s = interval_s > 0.0 ? interval_s : 0.0;
+}
+
+int pipeline_frames_needed(const int queue_sizes[], int sink_count) {
+    int frames = ACQUISITION_FRAME_POOL_SIZE;
+    for (int s = 0; s < sink_count; s++) {
+        frames += queue_sizes[s] + 1; // Queued frames + the one being consumed
+    }
+    return frames;
+}
+
+bool pipeline_start(Pipeline* pipeline) {
+    if (!pipeline) return false;
+
+    bool all_started = true;
+    for (int s = 0; s < pipeline->sink_count; s++) {
+        SinkSlot* slot = pipeline->sinks[s];
+        if (slot->started) continue;
+
+        if (slot->sink.init && !slot->sink.init(slot->sink.state)) {
+            fprintf(stderr, "Pipeline: Sink %s failed to initialize\n", slot->name);
+            all_started = false;
+            continue;
+        }
+
+        slot->running = true;
+        if (pthread_create(&slot->thread, NULL, sink_thread_function, slot) != 0) {
+            fprintf(stderr, "Pipeline: Failed to start the thread of sink %s\n", slot->name);
+            slot->running = false;
+            all_started = false;
+            continue;
+        }
+        slot->started = true;
+    }
+    return all_started;
+}
+
+void pipeline_submit(Pipeline* pipeline) {
+    if (!pipeline) return;
+
+    const AcquisitionFrame* latest = acquisition_frame_acquire(pipeline->frames);
+    if (!latest) return;
+
+    for (int s = 0; s < pipeline->sink_count; s++) {
+        SinkSlot* slot = pipeline->sinks[s];
+        if (!slot->started || latest->time_s < slot->next_due_s) continue;
+
+        // Keep to the interval grid; start it with the first frame and restart it after a gap
+        double next_due_s = slot->next_due_s + slot->interval_s;
+        bool on_grid = slot->next_due_s > 0.0 && next_due_s > latest->time_s;
+        slot->next_due_s = on_grid ? next_due_s : latest->time_s + slot->interval_s;
+
+        enqueue_frame(pipeline, slot, acquisition_frame_acquire(pipeline->frames));
+    }
+    acquisition_frame_release(pipeline->frames, latest);
+}
+
+bool pipeline_get_stats(Pipeline* pipeline, PipelineSinkId sink_id, PipelineSinkStats* stats) {
+    if (!pipeline || !stats || sink_id < 0 || sink_id >= pipeline->sink_count) return false;
+
+    SinkSlot* slot = pipeline->sinks[sink_id];
+    pthread_mutex_lock(&slot->lock);
+    *stats = slot->stats;
+    stats->queued = slot->count;
+    pthread_mutex_unlock(&slot->lock);
+    return true;
+}
+
+void pipeline_print_stats(Pipeline* pipeline) {
+    if (!pipeline) return;
+
+    for (int s = 0; s < pipeline->sink_count; s++) {
+        PipelineSinkStats stats;
+        pipeline_get_stats(pipeline, s, &stats);
+        printf("Pipeline: %-14s consumed %lu  dropped %lu  queued %d  max consume %.3f s\n",
+               pipeline->sinks[s]->name, stats.consumed, stats.dropped, stats.queued, stats.max_consume_s);
+    }
+}
+
+void pipeline_destroy(Pipeline* pipeline) {
+    if (!pipeline) return;
+
+    for (int s = 0; s < pipeline->sink_count; s++) {
+        SinkSlot* slot = pipeline->sinks[s];
+        if (slot->started) {
+            pthread_mutex_lock(&slot->lock);
+            slot->running = false;
+            pthread_cond_signal(&slot->wake);
+            pthread_mutex_unlock(&slot->lock);
+            pthread_join(slot->thread, NULL);
+        }
+
+        // Frames of a sink that never started
+        while (slot->count > 0) {
+            acquisition_frame_release(pipeline->frames, slot->queue[slot->head]);
+            slot->head = (slot->head + 1) % slot->queue_size;
+            slot->count--;
+        }
+        pthread_cond_destroy(&slot->wake);
+        pthread_mutex_destroy(&slot->lock);
+        free(slot->queue);
+        free(slot);
+    }
+    free(pipeline);
+}
+
+// --- Private Function Implementations ---
+
+// Consumes until stopped, then drains the queue; flushes whenever the queue runs empty
+static void* sink_thread_function(void* arg) {
+    SinkSlot* slot = (SinkSlot*)arg;
+    bool pending_flush = false;
+
+    pthread_mutex_lock(&slot->lock);
+    while (true) {
+        if (slot->count == 0) {
+            if (pending_flush && slot->sink.flush) {
+                pthread_mutex_unlock(&slot->lock);
+                slot->sink.flush(slot->sink.state);
+                pthread_mutex_lock(&slot->lock);
+                pending_flush = false;
+                continue; // Frames may have arrived meanwhile
+            }
+            if (!slot->running) break;
+            pthread_cond_wait(&slot->wake, &slot->lock);
+            continue;
+        }
+
+        const AcquisitionFrame* frame = slot->queue[slot->head];
+        slot->head = (slot->head + 1) % slot->queue_size;
+        slot->count--;
+        pthread_mutex_unlock(&slot->lock);
+
+        double start_s = monotonic_seconds();
+        slot->sink.consume(slot->sink.state, frame);
+        double elapsed_s = monotonic_seconds() - start_s;
+        acquisition_frame_release(slot->frames, frame);
+        pending_flush = true;
+
+        pthread_mutex_lock(&slot->lock);
+        slot->stats.consumed++;
+        if (elapsed_s > slot->stats.max_consume_s) slot->stats.max_consume_s = elapsed_s;
+    }
+    pthread_mutex_unlock(&slot->lock);
+    return NULL;
+}
+
+static void enqueue_frame(Pipeline* pipeline, SinkSlot* slot, const AcquisitionFrame* frame) {
+    if (!frame) return;
+
+    const AcquisitionFrame* dropped = NULL;
+    pthread_mutex_lock(&slot->lock);
+    if (slot->count == slot->queue_size) {
+        // The sink is behind: its oldest frame makes room for the newest
+        dropped = slot->queue[slot->head];
+        slot->head = (slot->head + 1) % slot->queue_size;
+        slot->count--;
+        slot->stats.dropped++;
+    }
+    slot->queue[(slot->head + slot->count) % slot->queue_size] = frame;
+    slot->count++;
+    pthread_cond_signal(&slot->wake);
+    pthread_mutex_unlock(&slot->lock);
+
+    acquisition_frame_release(pipeline->frames, dropped);
+}
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
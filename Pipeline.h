@@ -0,0 +1,97 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdbool.h>
+#include "AcquisitionFrame.h"
+
+/**
+ * @file Pipeline.h
+ * @brief Fan-out of the published acquisition frames to output sinks, each on its own thread.
+ *
+ * The acquisition task publishes a frame and calls pipeline_submit. Every sink that is due
+ * (at most one frame per interval) gets a hold on the frame in its own bounded queue and
+ * consumes it on its own thread, so a slow sink (an SD card, a terminal) never delays the
+ * sweep or the other sinks. A full queue drops its oldest frame, counted in the sink's
+ * statistics. A sink is flushed whenever its queue runs empty and once more at shutdown,
+ * after the frames still queued have been consumed.
+ *
+ * The frame store must have room for every queued frame: ACQUISITION_FRAME_POOL_SIZE plus
+ * queue_size + 1 per sink (see pipeline_frames_needed).
+ */
+
+#define PIPELINE_MAX_SINKS 8
+#define PIPELINE_SINK_NAME_SIZE 32
+
+// An output stage. Only consume is required; all callbacks get the sink's state.
+typedef struct {
+    const char* name;
+    void* state;
+    bool (*init)(void* state);  // Runs in pipeline_start; a sink that fails is not started
+    void (*consume)(void* state, const AcquisitionFrame* frame); // On the sink's thread
+    void (*flush)(void* state); // On the sink's thread, when its queue has drained
+} PipelineSink;
+
+typedef struct {
+    unsigned long consumed;   // Frames passed to consume
+    unsigned long dropped;    // Frames pushed out of a full queue
+    int queued;               // Frames waiting now
+    double max_consume_s;     // Slowest consume call
+} PipelineSinkStats;
+
+typedef int PipelineSinkId; // Negative on error
+
+typedef struct Pipeline Pipeline; // Opaque pipeline type
+
+/**
+ * @brief Creates a pipeline without sinks.
+ * @param frames Store the frames are acquired from (not owned)
+ * @return A pointer to the pipeline, or NULL on failure
+ */
+Pipeline* pipeline_create(AcquisitionFrameStore* frames);
+
+/**
+ * @brief Adds a sink; call before pipeline_start.
+ * @param queue_size Frames the sink may fall behind before the oldest is dropped (>= 1)
+ * @param interval_s Minimum spacing of the frames it receives (0 = every frame)
+ * @return Sink id, or -1 on failure
+ */
+PipelineSinkId pipeline_add_sink(Pipeline* pipeline, const PipelineSink* sink, int queue_size, double interval_s);
+
+/**
+ * @brief Changes how often a sink receives frames (e.g. after a configuration reload).
+ */
+void pipeline_set_interval(Pipeline* pipeline, PipelineSinkId sink_id, double interval_s);
+
+/**
+ * @brief Frame pool size needed by sinks with the given queue sizes.
+ */
+int pipeline_frames_needed(const int queue_sizes[], int sink_count);
+
+/**
+ * @brief Initializes the sinks and starts their threads.
+ * @return true if every sink started
+ */
+bool pipeline_start(Pipeline* pipeline);
+
+/**
+ * @brief Queues the latest published frame for every sink that is due. Never blocks on a sink.
+ */
+void pipeline_submit(Pipeline* pipeline);
+
+/**
+ * @brief Copies the statistics of one sink.
+ * @return false for an unknown sink
+ */
+bool pipeline_get_stats(Pipeline* pipeline, PipelineSinkId sink_id, PipelineSinkStats* stats);
+
+/**
+ * @brief Prints one line of statistics per sink.
+ */
+void pipeline_print_stats(Pipeline* pipeline);
+
+/**
+ * @brief Consumes what is still queued, flushes and stops every sink, then frees the pipeline.
+ */
+void pipeline_destroy(Pipeline* pipeline);
+
+#endif // PIPELINE_H
@@ -0,0 +1,286 @@
+#include "QuantileSketch.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define QUANTILE_SKETCH_MAGIC 0x314b5351u  // "QSK1"
+#define QUANTILE_SKETCH_MIN_INDEXABLE 1e-9  // Smaller magnitudes count as zero
+
+// Bucket counts for one sign. counts[i] holds key offset + i.
+typedef struct {
+    uint64_t counts[QUANTILE_SKETCH_MAX_BINS];
+    int32_t offset;
+    int32_t max_key;      // Highest occupied key (valid when total > 0)
+    uint64_t total;
+} SketchStore;
+
+struct QuantileSketch {
+    double accuracy;
+    double gamma;
+    double inv_log_gamma;
+
+    SketchStore positive;
+    SketchStore negative;   // Keyed by magnitude
+    uint64_t zero_count;
+
+    uint64_t count;
+    double min;
+    double max;
+};
+
+// --- Private Function Prototypes ---
+static int32_t key_for(const QuantileSketch* sketch, double magnitude);
+static double value_for(const QuantileSketch* sketch, int32_t key);
+static void store_add(SketchStore* store, int32_t key, uint64_t count);
+static void store_reoffset(SketchStore* store, int32_t new_offset);
+static bool store_write(const SketchStore* store, FILE* file);
+static bool store_read(SketchStore* store, FILE* file, uint64_t* total);
+
+// --- Public Functions ---
+
+QuantileSketch* quantile_sketch_create(double relative_accuracy) {
+    if (!(relative_accuracy > 0.0 && relative_accuracy < 1.0)) {
+        fprintf(stderr, "QuantileSketch: Invalid relative accuracy %g\n", relative_accuracy);
+        return NULL;
+    }
+
+    QuantileSketch* sketch = calloc(1, sizeof(QuantileSketch));
+    if (!sketch) {
+        perror("Failed to allocate memory for QuantileSketch");
+        return NULL;
+    }
+
+    sketch->accuracy = relative_accuracy;
+    sketch->gamma = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+    sketch->inv_log_gamma = 1.0 / log(sketch->gamma);
+    quantile_sketch_reset(sketch);
+    return sketch;
+}
+
+void quantile_sketch_add(QuantileSketch* sketch, double value) {
+    if (!sketch || !isfinite(value)) return;
+
+    if (value >= QUANTILE_SKETCH_MIN_INDEXABLE) {
+        store_add(&sketch->positive, key_for(sketch, value), 1);
+    } else if (value <= -QUANTILE_SKETCH_MIN_INDEXABLE) {
+        store_add(&sketch->negative, key_for(sketch, -value), 1);
+    } else {
+        sketch->zero_count++;
+    }
+
+    sketch->count++;
+    if (value < sketch->min) sketch->min = value;
+    if (value > sketch->max) sketch->max = value;
+}
+
+bool quantile_sketch_merge(QuantileSketch* dst, const QuantileSketch* src) {
+    if (!dst || !src) return false;
+    if (dst->accuracy != src->accuracy) {
+        fprintf(stderr, "QuantileSketch: Cannot merge sketches with accuracies %g and %g\n",
+                dst->accuracy, src->accuracy);
+        return false;
+    }
+    if (src->count == 0) return true;
+
+    for (int i = 0; i < QUANTILE_SKETCH_MAX_BINS; i++) {
+        if (src->positive.counts[i]) store_add(&dst->positive, src->positive.offset + i, src->positive.counts[i]);
+        if (src->negative.counts[i]) store_add(&dst->negative, src->negative.offset + i, src->negative.counts[i]);
+    }
+    dst->zero_count += src->zero_count;
+    dst->count += src->count;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    return true;
+}
+
+double quantile_sketch_quantile(const QuantileSketch* sketch, double q) {
+    if (!sketch || sketch->count == 0 || !(q >= 0.0 && q <= 1.0)) return NAN;
+    if (q == 0.0) return sketch->min;
+    if (q == 1.0) return sketch->max;
+
+    // Walk the buckets in value order: large negatives, zero, positives
+    double rank = q * (double)(sketch->count - 1);
+    double result = sketch->max;
+    uint64_t seen = 0;
+    bool found = false;
+
+    for (int i = QUANTILE_SKETCH_MAX_BINS - 1; i >= 0 && !found; i--) {
+        seen += sketch->negative.counts[i];
+        if (sketch->negative.counts[i] && (double)seen > rank) {
+            result = -value_for(sketch, sketch->negative.offset + i);
+            found = true;
+        }
+    }
+    if (!found) {
+        seen += sketch->zero_count;
+        if (sketch->zero_count && (double)seen > rank) {
+            result = 0.0;
+            found = true;
+        }
+    }
+    for (int i = 0; i < QUANTILE_SKETCH_MAX_BINS && !found; i++) {
+        seen += sketch->positive.counts[i];
+        if (sketch->positive.counts[i] && (double)seen > rank) {
+            result = value_for(sketch, sketch->positive.offset + i);
+            found = true;
+        }
+    }
+
+    // Bucket midpoints can fall just outside the exact extremes
+    if (result < sketch->min) result = sketch->min;
+    if (result > sketch->max) result = sketch->max;
+    return result;
+}
+
+uint64_t quantile_sketch_count(const QuantileSketch* sketch) {
+    return sketch ? sketch->count : 0;
+}
+
+double quantile_sketch_min(const QuantileSketch* sketch) {
+    return sketch && sketch->count ? sketch->min : NAN;
+}
+
+double quantile_sketch_max(const QuantileSketch* sketch) {
+    return sketch && sketch->count ? sketch->max : NAN;
+}
+
+void quantile_sketch_reset(QuantileSketch* sketch) {
+    if (!sketch) return;
+
+    memset(&sketch->positive, 0, sizeof(sketch->positive));
+    memset(&sketch->negative, 0, sizeof(sketch->negative));
+    sketch->zero_count = 0;
+    sketch->count = 0;
+    sketch->min = INFINITY;
+    sketch->max = -INFINITY;
+}
+
+bool quantile_sketch_write(const QuantileSketch* sketch, FILE* file) {
+    if (!sketch || !file) return false;
+
+    uint32_t magic = QUANTILE_SKETCH_MAGIC;
+    return fwrite(&magic, sizeof(magic), 1, file) == 1 &&
+           fwrite(&sketch->accuracy, sizeof(sketch->accuracy), 1, file) == 1 &&
+           fwrite(&sketch->count, sizeof(sketch->count), 1, file) == 1 &&
+           fwrite(&sketch->zero_count, sizeof(sketch->zero_count), 1, file) == 1 &&
+           fwrite(&sketch->min, sizeof(sketch->min), 1, file) == 1 &&
+           fwrite(&sketch->max, sizeof(sketch->max), 1, file) == 1 &&
+           store_write(&sketch->positive, file) &&
+           store_write(&sketch->negative, file);
+}
+
+QuantileSketch* quantile_sketch_read(FILE* file) {
+    if (!file) return NULL;
+
+    uint32_t magic;
+    double accuracy;
+    if (fread(&magic, sizeof(magic), 1, file) != 1 || magic != QUANTILE_SKETCH_MAGIC ||
+        fread(&accuracy, sizeof(accuracy), 1, file) != 1) {
+        return NULL;
+    }
+
+    QuantileSketch* sketch = quantile_sketch_create(accuracy);
+    if (!sketch) return NULL;
+
+    uint64_t positive_total = 0, negative_total = 0;
+    bool ok = fread(&sketch->count, sizeof(sketch->count), 1, file) == 1 &&
+              fread(&sketch->zero_count, sizeof(sketch->zero_count), 1, file) == 1 &&
+              fread(&sketch->min, sizeof(sketch->min), 1, file) == 1 &&
+              fread(&sketch->max, sizeof(sketch->max), 1, file) == 1 &&
+              store_read(&sketch->positive, file, &positive_total) &&
+              store_read(&sketch->negative, file, &negative_total);
+
+    // Bucket counts must account for every value
+    if (!ok || positive_total + negative_total + sketch->zero_count != sketch->count) {
+        fprintf(stderr, "QuantileSketch: Malformed sketch data\n");
+        quantile_sketch_destroy(sketch);
+        return NULL;
+    }
+    if (sketch->count == 0) {
+        sketch->min = INFINITY;
+        sketch->max = -INFINITY;
+    }
+    return sketch;
+}
+
+void quantile_sketch_destroy(QuantileSketch* sketch) {
+    free(sketch);
+}
+
+// --- Private Function Implementations ---
+
+static int32_t key_for(const QuantileSketch* sketch, double magnitude) {
+    return (int32_t)ceil(log(magnitude) * sketch->inv_log_gamma);
+}
+
+// Representative value of bucket (gamma^(k-1), gamma^k]: relative error <= accuracy for all of it
+static double value_for(const QuantileSketch* sketch, int32_t key) {
+    return 2.0 * pow(sketch->gamma, key) / (sketch->gamma + 1.0);
+}
+
+static void store_add(SketchStore* store, int32_t key, uint64_t count) {
+    if (store->total == 0) {
+        memset(store->counts, 0, sizeof(store->counts));
+        store->offset = key - QUANTILE_SKETCH_MAX_BINS / 2;
+        store->max_key = key;
+    } else if (key >= store->offset + QUANTILE_SKETCH_MAX_BINS) {
+        // Slide up; buckets that fall off the bottom are folded into the lowest one
+        store_reoffset(store, key - QUANTILE_SKETCH_MAX_BINS + 1);
+    } else if (key < store->offset) {
+        int32_t lowest = store->max_key - QUANTILE_SKETCH_MAX_BINS + 1;
+        if (key < lowest) key = lowest; // Too small to keep its own bucket
+        if (key < store->offset) store_reoffset(store, key);
+    }
+
+    store->counts[key - store->offset] += count;
+    store->total += count;
+    if (key > store->max_key) store->max_key = key;
+}
+
+static void store_reoffset(SketchStore* store, int32_t new_offset) {
+    uint64_t moved[QUANTILE_SKETCH_MAX_BINS] = {0};
+
+    for (int i = 0; i < QUANTILE_SKETCH_MAX_BINS; i++) {
+        if (!store->counts[i]) continue;
+        int64_t index = (int64_t)store->offset + i - new_offset;
+        if (index < 0) index = 0;
+        if (index >= QUANTILE_SKETCH_MAX_BINS) index = QUANTILE_SKETCH_MAX_BINS - 1;
+        moved[index] += store->counts[i];
+    }
+
+    memcpy(store->counts, moved, sizeof(moved));
+    store->offset = new_offset;
+}
+
+static bool store_write(const SketchStore* store, FILE* file) {
+    int first = 0, last = -1;
+    if (store->total > 0) {
+        while (!store->counts[first]) first++;
+        last = QUANTILE_SKETCH_MAX_BINS - 1;
+        while (!store->counts[last]) last--;
+    }
+
+    int32_t first_key = store->offset + first;
+    uint32_t length = (uint32_t)(last - first + 1);
+    return fwrite(&first_key, sizeof(first_key), 1, file) == 1 &&
+           fwrite(&length, sizeof(length), 1, file) == 1 &&
+           fwrite(&store->counts[first], sizeof(uint64_t), length, file) == length;
+}
+
+static bool store_read(SketchStore* store, FILE* file, uint64_t* total) {
+    int32_t first_key;
+    uint32_t length;
+    if (fread(&first_key, sizeof(first_key), 1, file) != 1 ||
+        fread(&length, sizeof(length), 1, file) != 1 ||
+        length > QUANTILE_SKETCH_MAX_BINS) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < length; i++) {
+        uint64_t count;
+        if (fread(&count, sizeof(count), 1, file) != 1) return false;
+        if (count) store_add(store, first_key + (int32_t)i, count);
+        *total += count;
+    }
+    return true;
+}
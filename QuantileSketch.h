@@ -0,0 +1,78 @@
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @file QuantileSketch.h
+ * @brief Mergeable quantile sketch with bounded memory (DDSketch).
+ *
+ * Values are counted in logarithmic buckets: bucket k holds the values in
+ * (gamma^(k-1), gamma^k] with gamma = (1 + a) / (1 - a), so any quantile is
+ * returned within a relative error of a. Positive and negative values have
+ * their own bucket store; values within 1e-9 of zero share a zero bucket.
+ * Each store keeps at most QUANTILE_SKETCH_MAX_BINS buckets; beyond that the
+ * smallest magnitudes are folded into the lowest bucket, so only values
+ * close to zero lose accuracy. Two sketches with the same accuracy merge
+ * exactly by adding bucket counts, which is what makes per-trip files
+ * combinable offline.
+ */
+
+#define QUANTILE_SKETCH_DEFAULT_ACCURACY 0.01 // 1% relative error
+#define QUANTILE_SKETCH_MAX_BINS 1024         // Buckets per sign (covers ~9 decades at 1%)
+
+typedef struct QuantileSketch QuantileSketch; // Opaque sketch
+
+/**
+ * @brief Creates an empty sketch.
+ * @param relative_accuracy Relative error bound, between 0 and 1 (exclusive)
+ * @return A pointer to the sketch, or NULL on failure
+ */
+QuantileSketch* quantile_sketch_create(double relative_accuracy);
+
+/**
+ * @brief Adds a value. Non-finite values are ignored.
+ */
+void quantile_sketch_add(QuantileSketch* sketch, double value);
+
+/**
+ * @brief Adds every value counted by src to dst.
+ * @return false if the sketches were created with different accuracies
+ */
+bool quantile_sketch_merge(QuantileSketch* dst, const QuantileSketch* src);
+
+/**
+ * @brief Returns the q-quantile (0 <= q <= 1), or NAN when the sketch is empty.
+ * q = 0 and q = 1 return the exact minimum and maximum.
+ */
+double quantile_sketch_quantile(const QuantileSketch* sketch, double q);
+
+uint64_t quantile_sketch_count(const QuantileSketch* sketch);
+double quantile_sketch_min(const QuantileSketch* sketch);   // NAN when empty
+double quantile_sketch_max(const QuantileSketch* sketch);   // NAN when empty
+
+/**
+ * @brief Empties the sketch, keeping its accuracy.
+ */
+void quantile_sketch_reset(QuantileSketch* sketch);
+
+/**
+ * @brief Serializes the sketch (host byte order, only occupied buckets).
+ * @return true on success
+ */
+bool quantile_sketch_write(const QuantileSketch* sketch, FILE* file);
+
+/**
+ * @brief Reads a sketch written by quantile_sketch_write.
+ * @return A new sketch, or NULL on a read error or malformed data
+ */
+QuantileSketch* quantile_sketch_read(FILE* file);
+
+/**
+ * @brief Frees the sketch.
+ */
+void quantile_sketch_destroy(QuantileSketch* sketch);
+
+#endif // QUANTILE_SKETCH_H
@@ -0,0 +1,107 @@
+#include "Resampler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#define HISTORY_LENGTH 3            // Taps of the longest kernel
+#define MAX_SPACING_RATIO 2.0       // Quadratic only over roughly even spacing (no read gaps)
+
+typedef struct {
+    double time_s[HISTORY_LENGTH];  // Oldest first
+    double value[HISTORY_LENGTH];
+    int count;
+} SampleHistory;
+
+struct Resampler {
+    ResampleMode mode;
+    int channel_count;
+    SampleHistory history[MAX_TOTAL_CHANNELS];
+};
+
+// --- Private Function Prototypes ---
+static void history_push(SampleHistory* history, double time_s, double value);
+static bool interpolate(const SampleHistory* history, ResampleMode mode, double time_s, double* value);
+
+// --- Public Functions ---
+
+Resampler* resampler_create(int channel_count) {
+    if (channel_count <= 0 || channel_count > MAX_TOTAL_CHANNELS) return NULL;
+
+    Resampler* resampler = calloc(1, sizeof(Resampler));
+    if (!resampler) {
+        perror("Failed to allocate memory for Resampler");
+        return NULL;
+    }
+    resampler->channel_count = channel_count;
+    resampler->mode = RESAMPLE_NONE;
+    return resampler;
+}
+
+void resampler_set_mode(Resampler* resampler, ResampleMode mode) {
+    if (resampler) resampler->mode = mode;
+}
+
+void resampler_run(Resampler* resampler, Channel channels[], ChannelMask read_mask, double grid_time_s) {
+    if (!resampler || !channels) return;
+
+    for (int i = 0; i < resampler->channel_count; i++) {
+        if (!(read_mask & CHANNEL_MASK_BIT(i))) continue;
+
+        Channel* channel = &channels[i];
+        SampleHistory* history = &resampler->history[i];
+        history_push(history, channel->sample_time_s, (double)channel->raw_adc_value);
+
+        double value;
+        if (resampler->mode == RESAMPLE_NONE || !interpolate(history, resampler->mode, grid_time_s, &value)) continue;
+
+        value = round(value);
+        if (value < INT16_MIN) value = INT16_MIN;
+        if (value > INT16_MAX) value = INT16_MAX;
+        channel_update_raw_value(channel, (int)value);
+        channel->sample_time_s = grid_time_s;
+    }
+}
+
+void resampler_destroy(Resampler* resampler) {
+    free(resampler);
+}
+
+// --- Private Function Implementations ---
+
+static void history_push(SampleHistory* history, double time_s, double value) {
+    if (history->count == HISTORY_LENGTH) {
+        for (int k = 1; k < HISTORY_LENGTH; k++) {
+            history->time_s[k - 1] = history->time_s[k];
+            history->value[k - 1] = history->value[k];
+        }
+        history->count--;
+    }
+    history->time_s[history->count] = time_s;
+    history->value[history->count] = value;
+    history->count++;
+}
+
+// Value at time_s, which must lie between the last two samples
+static bool interpolate(const SampleHistory* history, ResampleMode mode, double time_s, double* value) {
+    if (history->count < 2) return false;
+
+    int newest = history->count - 1;
+    double t1 = history->time_s[newest - 1], t2 = history->time_s[newest];
+    double y1 = history->value[newest - 1], y2 = history->value[newest];
+    if (!(t1 < time_s && time_s <= t2)) return false;
+
+    if (mode == RESAMPLE_QUADRATIC && history->count == HISTORY_LENGTH) {
+        double t0 = history->time_s[0], y0 = history->value[0];
+        double spacing_ratio = (t1 - t0) / (t2 - t1);
+        if (t0 < t1 && spacing_ratio >= 1.0 / MAX_SPACING_RATIO && spacing_ratio <= MAX_SPACING_RATIO) {
+            *value = y0 * (time_s - t1) * (time_s - t2) / ((t0 - t1) * (t0 - t2)) +
+                     y1 * (time_s - t0) * (time_s - t2) / ((t1 - t0) * (t1 - t2)) +
+                     y2 * (time_s - t0) * (time_s - t1) / ((t2 - t0) * (t2 - t1));
+            return true;
+        }
+    }
+
+    *value = y1 + (y2 - y1) * (time_s - t1) / (t2 - t1);
+    return true;
+}
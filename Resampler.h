@@ -0,0 +1,53 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include "Channel.h"
+#include "ConfigYAML.h"
+#include "SweepScheduler.h" // For ChannelMask
+
+/**
+ * @file Resampler.h
+ * @brief Time alignment of a sweep's samples onto one common instant (system.resample).
+ *
+ * Channels are read one after another, so the samples of a sweep are spread
+ * over its duration and V·I products of two channels carry a phase error
+ * during transients. The resampler interpolates every fresh sample back to
+ * the grid instant of its sweep, the moment the sweep started, from the
+ * channel's own timestamped history: two taps (linear) or three
+ * (quadratic Lagrange, falling back to linear when the spacing is very
+ * uneven). Every grid instant lies between the channel's previous and
+ * current reads, so nothing is extrapolated.
+ *
+ * It runs before the filters, so everything downstream (filters, derived
+ * channels, integrators, triggers, publishing) sees aligned samples stamped
+ * with the grid time. Interpolated values are rounded back to ADC counts.
+ * The history holds the original reads and is kept in every mode, so the
+ * mode can change on a configuration reload.
+ */
+
+typedef struct Resampler Resampler; // Opaque per-channel sample history
+
+/**
+ * @brief Creates a resampler for the given number of channels.
+ * @return A pointer to the resampler, or NULL on failure
+ */
+Resampler* resampler_create(int channel_count);
+
+/**
+ * @brief Selects the interpolation (RESAMPLE_NONE leaves samples untouched).
+ */
+void resampler_set_mode(Resampler* resampler, ResampleMode mode);
+
+/**
+ * @brief Records the fresh samples and replaces them with their values at the grid instant.
+ * @param read_mask Channels read in this sweep (raw_adc_value and sample_time_s are fresh)
+ * @param grid_time_s Monotonic start time of the sweep
+ */
+void resampler_run(Resampler* resampler, Channel channels[], ChannelMask read_mask, double grid_time_s);
+
+/**
+ * @brief Frees the resampler.
+ */
+void resampler_destroy(Resampler* resampler);
+
+#endif // RESAMPLER_H
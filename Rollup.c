@@ -0,0 +1,108 @@
+#include "Rollup.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+struct RollupTier {
+    double interval_s;
+
+    double current_start;     // NAN until the first advance
+    uint32_t current_samples; // Samples of all channels in the current period
+    RollupCell current[MAX_TOTAL_CHANNELS];
+
+    double completed_start;
+    RollupCell completed[MAX_TOTAL_CHANNELS];
+};
+
+// --- Private Function Prototypes ---
+static void reset_cells(RollupCell cells[]);
+static void complete_current(RollupTier* tier);
+
+// --- Public Functions ---
+
+RollupTier* rollup_tier_create(double interval_s) {
+    if (!(interval_s > 0.0)) {
+        fprintf(stderr, "Rollup: Invalid interval %g s\n", interval_s);
+        return NULL;
+    }
+
+    RollupTier* tier = calloc(1, sizeof(RollupTier));
+    if (!tier) {
+        perror("Failed to allocate memory for RollupTier");
+        return NULL;
+    }
+
+    tier->interval_s = interval_s;
+    tier->current_start = NAN;
+    tier->completed_start = NAN;
+    reset_cells(tier->current);
+    reset_cells(tier->completed);
+    return tier;
+}
+
+bool rollup_tier_advance(RollupTier* tier, double now_s) {
+    if (!tier) return false;
+
+    double period_start = floor(now_s / tier->interval_s) * tier->interval_s;
+    if (isnan(tier->current_start)) {
+        tier->current_start = period_start;
+        return false;
+    }
+    if (period_start <= tier->current_start) return false; // Still inside (or clock stepped back)
+
+    bool had_samples = tier->current_samples > 0;
+    complete_current(tier);
+    tier->current_start = period_start; // Empty periods in between are skipped
+    return had_samples;
+}
+
+void rollup_tier_add(RollupTier* tier, int index, double value) {
+    if (!tier || index < 0 || index >= MAX_TOTAL_CHANNELS || !isfinite(value)) return;
+
+    RollupCell* cell = &tier->current[index];
+    cell->count++;
+    cell->sum += value;
+    if (value < cell->min) cell->min = value;
+    if (value > cell->max) cell->max = value;
+    tier->current_samples++;
+}
+
+double rollup_tier_completed_start(const RollupTier* tier) {
+    return tier ? tier->completed_start : NAN;
+}
+
+bool rollup_tier_get_completed(const RollupTier* tier, int index, RollupCell* cell) {
+    if (!tier || !cell || index < 0 || index >= MAX_TOTAL_CHANNELS) return false;
+    if (tier->completed[index].count == 0) return false;
+
+    *cell = tier->completed[index];
+    return true;
+}
+
+bool rollup_tier_close(RollupTier* tier) {
+    if (!tier || isnan(tier->current_start)) return false;
+
+    bool had_samples = tier->current_samples > 0;
+    complete_current(tier);
+    return had_samples;
+}
+
+void rollup_tier_destroy(RollupTier* tier) {
+    free(tier);
+}
+
+// --- Private Function Implementations ---
+
+static void reset_cells(RollupCell cells[]) {
+    for (int i = 0; i < MAX_TOTAL_CHANNELS; i++) {
+        cells[i] = (RollupCell){ .count = 0, .sum = 0.0, .min = INFINITY, .max = -INFINITY };
+    }
+}
+
+static void complete_current(RollupTier* tier) {
+    memcpy(tier->completed, tier->current, sizeof(tier->completed));
+    tier->completed_start = tier->current_start;
+    reset_cells(tier->current);
+    tier->current_samples = 0;
+}
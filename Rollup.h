@@ -0,0 +1,71 @@
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Channel.h"
+
+/**
+ * @file Rollup.h
+ * @brief Incremental per-channel aggregates over fixed wall-clock periods.
+ *
+ * A rollup tier accumulates count, sum, min and max of every channel over
+ * periods of interval_s aligned to multiples of interval_s since the epoch
+ * (a 10 s tier covers hh:mm:00-10, hh:mm:10-20, ...). When the clock passes
+ * the end of the current period, it becomes the completed period and a new
+ * one starts. Adding a sample is O(1); nothing is buffered.
+ */
+
+typedef struct {
+    uint32_t count;
+    double sum;
+    double min;
+    double max;
+} RollupCell;
+
+typedef struct RollupTier RollupTier; // Opaque rollup tier
+
+/**
+ * @brief Creates a tier with an empty current period.
+ * @param interval_s Period length in seconds (> 0)
+ * @return A pointer to the tier, or NULL on failure
+ */
+RollupTier* rollup_tier_create(double interval_s);
+
+/**
+ * @brief Closes the current period if now_s (seconds since the epoch) is past its end.
+ *
+ * Call before adding the samples taken at now_s.
+ *
+ * @return true if a period was completed and can be read with rollup_tier_get_completed
+ */
+bool rollup_tier_advance(RollupTier* tier, double now_s);
+
+/**
+ * @brief Adds a sample to the current period. Non-finite values are ignored.
+ */
+void rollup_tier_add(RollupTier* tier, int index, double value);
+
+/**
+ * @brief Returns the start (seconds since the epoch) of the completed period.
+ */
+double rollup_tier_completed_start(const RollupTier* tier);
+
+/**
+ * @brief Reads a channel's aggregate of the completed period.
+ * @return false if the channel had no samples in it
+ */
+bool rollup_tier_get_completed(const RollupTier* tier, int index, RollupCell* cell);
+
+/**
+ * @brief Completes the current period immediately (e.g. at shutdown).
+ * @return true if it held any sample
+ */
+bool rollup_tier_close(RollupTier* tier);
+
+/**
+ * @brief Frees the tier.
+ */
+void rollup_tier_destroy(RollupTier* tier);
+
+#endif // ROLLUP_H
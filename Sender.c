@@ -1,3 +1,4 @@
+#define _GNU_SOURCE // sendmmsg()
 #include "Sender.h"
 #include "DataQueue.h"
 #include "OfflineQueue.h"
@@ -6,29 +7,72 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h> 
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <curl/curl.h>
 
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+#define UDP_MAX_PAYLOAD 65507   // Largest UDP payload over IPv4
+
 typedef struct _InfluxDBContext {
-    char *url;
-    char *bucket;
-    char *org;
-    char *token;
+    char url[256];
+    char bucket[128];
+    char org[128];
+    char token[256];
+    pthread_mutex_t mutex; // Guards the fields above against runtime reconfiguration
 } InfluxDBContext;
 
-#define OFFLINE_QUEUE_PROCESS_INTERVAL_S 60
-
 // The full definition of the SenderContext is here, making it opaque.
 struct SenderContext {
     DataQueue* queue;
+    OfflineQueue* offline_queue;
     pthread_t sender_thread_id;
     pthread_t offline_processor_thread_id;
     volatile bool is_running;
     InfluxDBContext influxdb_context;
+    char name[ROLLUP_TIER_NAME_SIZE];   // "raw" or the rollup tier name (for log messages)
+    bool fixed_bucket;                  // Tier senders keep their bucket across config reloads
+
+    // Batching: up to batch_size lines per write, waiting at most flush_interval_ms for them
+    int batch_size;
+    int flush_interval_ms;
+    volatile bool flush_requested;      // An urgent line is queued; send the batch without waiting
+    volatile bool gzip;                 // Compress the live write requests (raw sender only)
+
+    // UDP transport of the live batches (raw sender only); the offline replay stays on HTTP
+    bool use_udp;
+    int udp_fd;                         // Connected datagram socket
+    size_t udp_payload_size;            // Bytes per datagram: the MTU less the IP and UDP headers
+    struct mmsghdr* udp_messages;       // batch_size datagrams, at worst one line each
+    struct iovec* udp_iov;              // A line and its newline per entry pair
+    unsigned long udp_datagrams;        // Datagrams sent (sender thread only)
+
+    // Offline replay requests (from the application's scheduler)
+    pthread_mutex_t replay_mutex;
+    pthread_cond_t replay_cond;
+    bool replay_requested;
 };
 
 // --- Private Function Prototypes ---
+static SenderContext* sender_start(SenderContext* context, const char* offline_queue_path);
+static void sender_free_unstarted(SenderContext* context);
+static void set_batching(SenderContext* context, int batch_size, int flush_interval_ms);
 static bool send_http_post(const SenderContext* context, const char* url, struct curl_slist* headers, const void* post_data, long post_size);
-static bool send_line_protocol(SenderContext* context, const char* line_protocol);
+static bool send_line_protocol(SenderContext* context, const void* body, size_t size, bool gzipped);
+static void send_batch(SenderContext* context, char* lines[], int line_count);
+static bool open_udp_transport(SenderContext* context, const InfluxDBConfig* influxdb);
+static void close_udp_transport(SenderContext* context);
+static void send_udp_batch(SenderContext* context, char* lines[], int line_count);
+static double monotonic_ms(void);
+static void copy_influxdb_setting(char* target, size_t target_size, const char* value);
 static bool send_compressed_batch_callback(const void* data, size_t size, void* user_context);
 static void* sender_thread_function(void* arg);
 static void* offline_processor_thread_function(void* arg);
@@ -42,47 +86,25 @@ SenderContext* sender_create_from_env() {
         return NULL;
     }
 
-    context->influxdb_context.url = getenv("INFLUXDB_URL");
-    context->influxdb_context.bucket = getenv("INFLUXDB_BUCKET");
-    context->influxdb_context.org = getenv("INFLUXDB_ORG");
-    context->influxdb_context.token = getenv("INFLUXDB_TOKEN");
+    const char* url = getenv("INFLUXDB_URL");
+    const char* bucket = getenv("INFLUXDB_BUCKET");
+    const char* org = getenv("INFLUXDB_ORG");
+    const char* token = getenv("INFLUXDB_TOKEN");
 
-    if (!context->influxdb_context.url || !context->influxdb_context.bucket || !context->influxdb_context.org || !context->influxdb_context.token) {
+    if (!url || !bucket || !org || !token) {
         fprintf(stderr, "Failed to get InfluxDB configuration from environment variables.\n");
         free(context);
         return NULL;
     }
 
-    context->queue = data_queue_create();
-    if (!context->queue) {
-        fprintf(stderr, "Failed to create sender queue.\n");
-        free(context);
-        return NULL;
-    }
-
-    offline_queue_init("logs/offline_log.txt");
-
-    context->is_running = true;
-
-    if (pthread_create(&context->sender_thread_id, NULL, sender_thread_function, context) != 0) {
-        perror("Failed to create sender thread");
-        data_queue_destroy(context->queue);
-        free(context);
-        return NULL;
-    }
-
-    if (pthread_create(&context->offline_processor_thread_id, NULL, offline_processor_thread_function, context) != 0) {
-        perror("Failed to create offline processor thread");
-        // Stop the already running sender thread
-        context->is_running = false;
-        data_queue_shutdown(context->queue);
-        pthread_join(context->sender_thread_id, NULL);
-        data_queue_destroy(context->queue);
-        free(context);
-        return NULL;
-    }
+    copy_influxdb_setting(context->influxdb_context.url, sizeof(context->influxdb_context.url), url);
+    copy_influxdb_setting(context->influxdb_context.bucket, sizeof(context->influxdb_context.bucket), bucket);
+    copy_influxdb_setting(context->influxdb_context.org, sizeof(context->influxdb_context.org), org);
+    copy_influxdb_setting(context->influxdb_context.token, sizeof(context->influxdb_context.token), token);
+    snprintf(context->name, sizeof(context->name), "raw");
+    set_batching(context, 1, 0);
 
-    return context;
+    return sender_start(context, "logs/offline_log.txt");
 }
 
 SenderContext* sender_create_from_yaml(const YAMLAppConfig* config) {
@@ -97,61 +119,77 @@ SenderContext* sender_create_from_yaml(const YAMLAppConfig* config) {
         return NULL;
     }
 
-    // Set InfluxDB configuration from YAML
-    context->influxdb_context.url = config->influxdb.url;
-    context->influxdb_context.bucket = config->influxdb.bucket;
-    context->influxdb_context.org = config->influxdb.org;
-    context->influxdb_context.token = config->influxdb.token;
+    // Set InfluxDB configuration from YAML (copied, so the config may be reloaded later)
+    copy_influxdb_setting(context->influxdb_context.url, sizeof(context->influxdb_context.url), config->influxdb.url);
+    copy_influxdb_setting(context->influxdb_context.bucket, sizeof(context->influxdb_context.bucket), config->influxdb.bucket);
+    copy_influxdb_setting(context->influxdb_context.org, sizeof(context->influxdb_context.org), config->influxdb.org);
+    copy_influxdb_setting(context->influxdb_context.token, sizeof(context->influxdb_context.token), config->influxdb.token);
 
     // Validate configuration
-    if (!context->influxdb_context.url || strlen(context->influxdb_context.url) == 0 ||
-        !context->influxdb_context.bucket || strlen(context->influxdb_context.bucket) == 0 ||
-        !context->influxdb_context.org || strlen(context->influxdb_context.org) == 0 ||
-        !context->influxdb_context.token || strlen(context->influxdb_context.token) == 0) {
+    if (strlen(context->influxdb_context.url) == 0 ||
+        strlen(context->influxdb_context.bucket) == 0 ||
+        strlen(context->influxdb_context.org) == 0 ||
+        strlen(context->influxdb_context.token) == 0) {
         fprintf(stderr, "Incomplete InfluxDB configuration in YAML file.\n");
         free(context);
         return NULL;
     }
-
-    context->queue = data_queue_create();
-    if (!context->queue) {
-        fprintf(stderr, "Failed to create sender queue.\n");
-        free(context);
-        return NULL;
+    snprintf(context->name, sizeof(context->name), "raw");
+    set_batching(context, config->influxdb.batch_size, config->influxdb.flush_interval_ms);
+    context->gzip = config->influxdb.gzip;
+    if (config->influxdb.transport == INFLUX_TRANSPORT_UDP && !open_udp_transport(context, &config->influxdb)) {
+        fprintf(stderr, "Sender: UDP transport unavailable, sending over HTTP.\n");
     }
 
     // Use CSV directory from YAML config for offline queue
     char offline_queue_path[512];
     snprintf(offline_queue_path, sizeof(offline_queue_path), "%s/offline_log.txt", 
              config->logging.csv_directory);
-    offline_queue_init(offline_queue_path);
+    if (!sender_start(context, offline_queue_path)) return NULL;
 
-    context->is_running = true;
+    printf("Sender module initialized with YAML configuration:\n");
+    printf("  - InfluxDB URL: %s\n", context->influxdb_context.url);
+    printf("  - Bucket: %s\n", context->influxdb_context.bucket);
+    printf("  - Organization: %s\n", context->influxdb_context.org);
+    printf("  - Batch: %d line(s), flush after %d ms%s\n", context->batch_size, context->flush_interval_ms,
+           context->gzip && !context->use_udp ? ", gzip" : "");
+    if (context->use_udp) {
+        printf("  - Transport: UDP %s:%d, %zu-byte datagrams (backlog over HTTP)\n",
+               config->influxdb.udp_host, config->influxdb.udp_port, context->udp_payload_size);
+    }
+    printf("  - Offline queue: %s\n", offline_queue_path);
 
-    if (pthread_create(&context->sender_thread_id, NULL, sender_thread_function, context) != 0) {
-        perror("Failed to create sender thread");
-        data_queue_destroy(context->queue);
-        free(context);
+    return context;
+}
+
+SenderContext* sender_create_for_tier(const YAMLAppConfig* config, const RollupTierConfig* tier) {
+    if (!config || !tier) {
+        fprintf(stderr, "NULL configuration provided to sender_create_for_tier\n");
         return NULL;
     }
 
-    if (pthread_create(&context->offline_processor_thread_id, NULL, offline_processor_thread_function, context) != 0) {
-        perror("Failed to create offline processor thread");
-        // Stop the already running sender thread
-        context->is_running = false;
-        data_queue_shutdown(context->queue);
-        pthread_join(context->sender_thread_id, NULL);
-        data_queue_destroy(context->queue);
-        free(context);
+    SenderContext* context = calloc(1, sizeof(SenderContext));
+    if (!context) {
+        perror("Failed to allocate memory for SenderContext");
         return NULL;
     }
 
-    printf("Sender module initialized with YAML configuration:\n");
-    printf("  - InfluxDB URL: %s\n", context->influxdb_context.url);
-    printf("  - Bucket: %s\n", context->influxdb_context.bucket);
-    printf("  - Organization: %s\n", context->influxdb_context.org);
-    printf("  - Offline queue: %s\n", offline_queue_path);
+    // Shared server and credentials, the tier's own bucket
+    copy_influxdb_setting(context->influxdb_context.url, sizeof(context->influxdb_context.url), config->influxdb.url);
+    copy_influxdb_setting(context->influxdb_context.bucket, sizeof(context->influxdb_context.bucket), tier->bucket);
+    copy_influxdb_setting(context->influxdb_context.org, sizeof(context->influxdb_context.org), config->influxdb.org);
+    copy_influxdb_setting(context->influxdb_context.token, sizeof(context->influxdb_context.token), config->influxdb.token);
+    snprintf(context->name, sizeof(context->name), "%s", tier->name);
+    context->fixed_bucket = true;
+    set_batching(context, tier->batch_size, tier->flush_interval_ms);
 
+    char offline_queue_path[512];
+    snprintf(offline_queue_path, sizeof(offline_queue_path), "%s/offline_%s.txt",
+             config->logging.csv_directory, tier->name);
+    if (!sender_start(context, offline_queue_path)) return NULL;
+
+    printf("Sender for tier '%s': bucket %s, batch %d line(s), flush after %d ms\n",
+           context->name, context->influxdb_context.bucket, context->batch_size, context->flush_interval_ms);
     return context;
 }
 
@@ -165,30 +203,145 @@ void sender_destroy(SenderContext* context) {
     // Signal the queue to shut down, waking up the sender thread if it's waiting
     data_queue_shutdown(context->queue);
 
+    // Wake the offline processor thread as well
+    pthread_mutex_lock(&context->replay_mutex);
+    pthread_cond_signal(&context->replay_cond);
+    pthread_mutex_unlock(&context->replay_mutex);
+
     // Wait for the threads to finish
     pthread_join(context->sender_thread_id, NULL);
     pthread_join(context->offline_processor_thread_id, NULL);
 
+    if (context->use_udp) {
+        printf("Sender '%s': %lu UDP datagram(s) sent.\n", context->name, context->udp_datagrams);
+    }
+
     // Clean up resources
     data_queue_destroy(context->queue);
+    offline_queue_destroy(context->offline_queue);
+    close_udp_transport(context);
+    pthread_mutex_destroy(&context->influxdb_context.mutex);
+    pthread_mutex_destroy(&context->replay_mutex);
+    pthread_cond_destroy(&context->replay_cond);
     free(context);
     printf("Sender module stopped.\n");
 }
 
+void sender_update_influxdb_config(SenderContext* context, const InfluxDBConfig* influxdb) {
+    if (!context || !influxdb) return;
+
+    if (strlen(influxdb->url) == 0 || strlen(influxdb->bucket) == 0 ||
+        strlen(influxdb->org) == 0 || strlen(influxdb->token) == 0) {
+        fprintf(stderr, "Sender: Ignoring incomplete InfluxDB configuration update.\n");
+        return;
+    }
+
+    pthread_mutex_lock(&context->influxdb_context.mutex);
+    copy_influxdb_setting(context->influxdb_context.url, sizeof(context->influxdb_context.url), influxdb->url);
+    if (!context->fixed_bucket) {
+        copy_influxdb_setting(context->influxdb_context.bucket, sizeof(context->influxdb_context.bucket), influxdb->bucket);
+        context->gzip = influxdb->gzip;
+    }
+    copy_influxdb_setting(context->influxdb_context.org, sizeof(context->influxdb_context.org), influxdb->org);
+    copy_influxdb_setting(context->influxdb_context.token, sizeof(context->influxdb_context.token), influxdb->token);
+    pthread_mutex_unlock(&context->influxdb_context.mutex);
+}
+
+void sender_request_offline_replay(SenderContext* context) {
+    if (!context || !context->is_running) return;
+
+    pthread_mutex_lock(&context->replay_mutex);
+    context->replay_requested = true;
+    pthread_cond_signal(&context->replay_cond);
+    pthread_mutex_unlock(&context->replay_mutex);
+}
+
 void sender_submit(SenderContext* context, const char* line_protocol) {
     if (!context || !context->is_running) {
         fprintf(stderr, "Cannot submit measurement, sender is not running.\n");
-        offline_queue_add(line_protocol); // Fallback to offline queue
+        if (context) offline_queue_add(context->offline_queue, line_protocol); // Fallback to offline queue
         return;
     }
     data_queue_enqueue(context->queue, line_protocol);
 }
 
+void sender_submit_urgent(SenderContext* context, const char* line_protocol) {
+    if (!context || !context->is_running) {
+        sender_submit(context, line_protocol); // Same offline fallback
+        return;
+    }
+    context->flush_requested = true;
+    data_queue_enqueue_front(context->queue, line_protocol);
+}
+
+void sender_submit_deferred(SenderContext* context, const char* line_protocol) {
+    if (!context || !line_protocol) return;
+    offline_queue_add(context->offline_queue, line_protocol);
+}
+
+size_t sender_queue_length(SenderContext* context) {
+    if (!context || !context->is_running) return 0;
+    return data_queue_length(context->queue);
+}
+
 // --- Private Function Implementations ---
 
+// Frees whatever sender_start managed to create, after a failed start
+static void sender_free_unstarted(SenderContext* context) {
+    if (context->queue) data_queue_destroy(context->queue);
+    offline_queue_destroy(context->offline_queue);
+    close_udp_transport(context);
+    pthread_mutex_destroy(&context->influxdb_context.mutex);
+    pthread_mutex_destroy(&context->replay_mutex);
+    pthread_cond_destroy(&context->replay_cond);
+    free(context);
+}
+
+// Creates the queues and starts the threads. Frees the context on failure.
+static SenderContext* sender_start(SenderContext* context, const char* offline_queue_path) {
+    pthread_mutex_init(&context->influxdb_context.mutex, NULL);
+    pthread_mutex_init(&context->replay_mutex, NULL);
+    pthread_cond_init(&context->replay_cond, NULL);
+
+    context->queue = data_queue_create();
+    context->offline_queue = offline_queue_create(offline_queue_path);
+    if (!context->queue || !context->offline_queue) {
+        fprintf(stderr, "Failed to create sender queues.\n");
+        sender_free_unstarted(context);
+        return NULL;
+    }
+
+    context->is_running = true;
+
+    if (pthread_create(&context->sender_thread_id, NULL, sender_thread_function, context) != 0) {
+        perror("Failed to create sender thread");
+        sender_free_unstarted(context);
+        return NULL;
+    }
+
+    if (pthread_create(&context->offline_processor_thread_id, NULL, offline_processor_thread_function, context) != 0) {
+        perror("Failed to create offline processor thread");
+        // Stop the already running sender thread
+        context->is_running = false;
+        data_queue_shutdown(context->queue);
+        pthread_join(context->sender_thread_id, NULL);
+        sender_free_unstarted(context);
+        return NULL;
+    }
+
+    return context;
+}
+
+static void set_batching(SenderContext* context, int batch_size, int flush_interval_ms) {
+    context->batch_size = batch_size > 0 ? batch_size : 1;
+    if (context->batch_size > SENDER_MAX_BATCH_LINES) context->batch_size = SENDER_MAX_BATCH_LINES;
+    context->flush_interval_ms = flush_interval_ms > 0 ? flush_interval_ms : 0;
+}
+
 static void* sender_thread_function(void* arg) {
     SenderContext* context = (SenderContext*)arg;
-    printf("Sender thread started.\n");
+    char* batch[SENDER_MAX_BATCH_LINES];
+    printf("Sender thread '%s' started.\n", context->name);
 
     while (context->is_running) {
         char* data_to_send = data_queue_dequeue(context->queue);
@@ -197,29 +350,221 @@ static void* sender_thread_function(void* arg) {
             continue;
         }
 
-        if (!send_line_protocol(context, data_to_send)) {
-            fprintf(stderr, "Sender: Failed to send data, queuing to offline file.\n");
-            offline_queue_add(data_to_send);
+        // Fill the batch until it is full or its oldest line has waited flush_interval_ms
+        int line_count = 0;
+        batch[line_count++] = data_to_send;
+        double flush_at_ms = monotonic_ms() + context->flush_interval_ms;
+        while (line_count < context->batch_size && !context->flush_requested) {
+            double remaining_ms = flush_at_ms - monotonic_ms();
+            char* next = data_queue_dequeue_timeout(context->queue, remaining_ms > 0.0 ? (int)remaining_ms : 0);
+            if (!next) break;
+            batch[line_count++] = next;
         }
 
-        free(data_to_send);
+        context->flush_requested = false;
+        send_batch(context, batch, line_count);
+    }
+
+    // Lines still queued at shutdown are kept for the next run
+    char* leftover;
+    while ((leftover = data_queue_dequeue_timeout(context->queue, 0)) != NULL) {
+        offline_queue_add(context->offline_queue, leftover);
+        free(leftover);
     }
 
-    printf("Sender thread finished.\n");
+    printf("Sender thread '%s' finished.\n", context->name);
     return NULL;
 }
 
+// Sends the lines as one write request and frees them; a failed request goes to the offline queue
+static void send_batch(SenderContext* context, char* lines[], int line_count) {
+    if (context->use_udp) {
+        send_udp_batch(context, lines, line_count);
+        return;
+    }
+
+    char* body = lines[0];
+    bool joined = false;
+
+    if (line_count > 1) {
+        size_t total_size = 0;
+        for (int i = 0; i < line_count; i++) total_size += strlen(lines[i]) + 1;
+
+        body = malloc(total_size);
+        if (body) {
+            char* position = body;
+            for (int i = 0; i < line_count; i++) {
+                size_t length = strlen(lines[i]);
+                memcpy(position, lines[i], length);
+                position += length;
+                *position++ = '\n';
+            }
+            position[-1] = '\0';
+            joined = true;
+        }
+    }
+
+    if (!body) {
+        // Out of memory: send line by line
+        for (int i = 0; i < line_count; i++) send_batch(context, &lines[i], 1);
+        return;
+    }
+
+    bool sent;
+    size_t compressed_size = 0;
+    void* compressed = context->gzip ? offline_queue_gzip(body, strlen(body), &compressed_size) : NULL;
+    if (compressed) {
+        sent = send_line_protocol(context, compressed, compressed_size, true);
+        free(compressed);
+    } else {
+        sent = send_line_protocol(context, body, 0, false);
+    }
+
+    if (!sent) {
+        fprintf(stderr, "Sender '%s': Failed to send %d line(s), queuing to offline file.\n",
+                context->name, line_count);
+        offline_queue_add(context->offline_queue, body);
+    }
+
+    if (joined) free(body);
+    for (int i = 0; i < line_count; i++) free(lines[i]);
+}
+
+// Resolves the listener and connects a datagram socket to it (so send errors are reported)
+static bool open_udp_transport(SenderContext* context, const InfluxDBConfig* influxdb) {
+    char port[8];
+    snprintf(port, sizeof(port), "%d", influxdb->udp_port);
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM };
+    struct addrinfo* addresses = NULL;
+    int error = getaddrinfo(influxdb->udp_host, port, &hints, &addresses);
+    if (error != 0) {
+        fprintf(stderr, "Sender: Cannot resolve UDP host %s: %s\n", influxdb->udp_host, gai_strerror(error));
+        return false;
+    }
+
+    int fd = -1;
+    int header_size = 0;
+    for (struct addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+            continue;
+        }
+        header_size = (address->ai_family == AF_INET6 ? 40 : 20) + 8;
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) {
+        fprintf(stderr, "Sender: Cannot open UDP socket to %s:%d\n", influxdb->udp_host, influxdb->udp_port);
+        return false;
+    }
+
+    context->udp_messages = calloc((size_t)context->batch_size, sizeof(struct mmsghdr));
+    context->udp_iov = calloc((size_t)context->batch_size * 2, sizeof(struct iovec));
+    if (!context->udp_messages || !context->udp_iov) {
+        perror("Failed to allocate UDP send buffers");
+        free(context->udp_messages);
+        free(context->udp_iov);
+        context->udp_messages = NULL;
+        context->udp_iov = NULL;
+        close(fd);
+        return false;
+    }
+
+    context->udp_fd = fd;
+    context->udp_payload_size = (size_t)(influxdb->udp_mtu - header_size);
+    if (context->udp_payload_size > UDP_MAX_PAYLOAD) context->udp_payload_size = UDP_MAX_PAYLOAD;
+    context->use_udp = true;
+    return true;
+}
+
+static void close_udp_transport(SenderContext* context) {
+    if (!context->use_udp) return;
+    close(context->udp_fd);
+    free(context->udp_messages);
+    free(context->udp_iov);
+    context->use_udp = false;
+}
+
+// Packs the lines into as few datagrams as the payload size allows and sends them with one
+// sendmmsg() call (more if interrupted), then frees them. A line longer than the payload
+// travels alone (fragmented by IP); lines of datagrams that could not be sent go to the offline
+// queue. Delivery is not acknowledged: a datagram lost on the way is not noticed.
+static void send_udp_batch(SenderContext* context, char* lines[], int line_count) {
+    static char newline[] = "\n";
+    struct mmsghdr* messages = context->udp_messages;
+    struct iovec* iov = context->udp_iov;
+    int message_count = 0;
+    size_t datagram_size = 0;
+
+    for (int i = 0; i < line_count; i++) {
+        size_t length = strlen(lines[i]) + 1;
+        if (length > UDP_MAX_PAYLOAD) {
+            fprintf(stderr, "Sender '%s': Line of %zu bytes exceeds a datagram, queuing to offline file.\n",
+                    context->name, length);
+            offline_queue_add(context->offline_queue, lines[i]);
+            continue;
+        }
+
+        struct msghdr* current = message_count > 0 ? &messages[message_count - 1].msg_hdr : NULL;
+        if (!current || datagram_size + length > context->udp_payload_size || current->msg_iovlen + 2 > IOV_MAX) {
+            current = &messages[message_count++].msg_hdr;
+            memset(current, 0, sizeof(*current));
+            current->msg_iov = iov;
+            datagram_size = 0;
+        }
+        iov[0] = (struct iovec){ .iov_base = lines[i], .iov_len = length - 1 };
+        iov[1] = (struct iovec){ .iov_base = newline, .iov_len = 1 };
+        iov += 2;
+        current->msg_iovlen += 2;
+        datagram_size += length;
+    }
+
+    int sent = 0;
+    while (sent < message_count) {
+        int result = sendmmsg(context->udp_fd, messages + sent, (unsigned int)(message_count - sent), 0);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) break;
+        sent += result;
+    }
+    context->udp_datagrams += (unsigned long)sent;
+
+    if (sent < message_count) {
+        fprintf(stderr, "Sender '%s': Failed to send %d UDP datagram(s) (%s), queuing to offline file.\n",
+                context->name, message_count - sent, strerror(errno));
+        for (int m = sent; m < message_count; m++) {
+            const struct msghdr* message = &messages[m].msg_hdr;
+            for (size_t v = 0; v < message->msg_iovlen; v += 2) {
+                offline_queue_add(context->offline_queue, (const char*)message->msg_iov[v].iov_base);
+            }
+        }
+    }
+
+    for (int i = 0; i < line_count; i++) free(lines[i]);
+}
+
+static double monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
 static void* offline_processor_thread_function(void* arg) {
     SenderContext* context = (SenderContext*)arg;
     printf("Offline queue processor thread started.\n");
 
     while (context->is_running) {
-        for (int i = 0; i < OFFLINE_QUEUE_PROCESS_INTERVAL_S && context->is_running; ++i) {
-            sleep(1);
+        // Idle until a replay is requested; no polling between requests
+        pthread_mutex_lock(&context->replay_mutex);
+        while (!context->replay_requested && context->is_running) {
+            pthread_cond_wait(&context->replay_cond, &context->replay_mutex);
         }
+        context->replay_requested = false;
+        pthread_mutex_unlock(&context->replay_mutex);
 
         if (context->is_running) {
-            offline_queue_process(send_compressed_batch_callback, context);
+            offline_queue_process(context->offline_queue, send_compressed_batch_callback, context);
         }
     }
 
@@ -232,13 +577,14 @@ static void* offline_processor_thread_function(void* arg) {
 static bool send_compressed_batch_callback(const void* data, size_t size, void* user_context) {
     SenderContext* context = (SenderContext*)user_context;
     
-    char url[256];
+    char url[768];
+    char auth_header[512];
+    pthread_mutex_lock(&context->influxdb_context.mutex);
     snprintf(url, sizeof(url), "%s/api/v2/write?org=%s&bucket=%s&precision=ns",
              context->influxdb_context.url,
              context->influxdb_context.org, context->influxdb_context.bucket);
-
-    char auth_header[512];
     snprintf(auth_header, sizeof(auth_header), "Authorization: Token %s", context->influxdb_context.token);
+    pthread_mutex_unlock(&context->influxdb_context.mutex);
 
     struct curl_slist *headers = NULL;
     headers = curl_slist_append(headers, auth_header);
@@ -251,21 +597,23 @@ static bool send_compressed_batch_callback(const void* data, size_t size, void*
     return success;
 }
 
-// A wrapper around the core curl logic for sending a single line protocol string.
-static bool send_line_protocol(SenderContext* context, const char* line_protocol) {
-    char url[256];
+// A wrapper around the core curl logic for sending line protocol: a string (size 0) or a gzip body.
+static bool send_line_protocol(SenderContext* context, const void* body, size_t size, bool gzipped) {
+    char url[768];
+    char auth_header[512];
+    pthread_mutex_lock(&context->influxdb_context.mutex);
     snprintf(url, sizeof(url), "http://%s:8086/api/v2/write?org=%s&bucket=%s&precision=ns",
              context->influxdb_context.url,
              context->influxdb_context.org, context->influxdb_context.bucket);
-
-    char auth_header[512];
     snprintf(auth_header, sizeof(auth_header), "Authorization: Token %s", context->influxdb_context.token);
+    pthread_mutex_unlock(&context->influxdb_context.mutex);
 
     struct curl_slist *headers = NULL;
     headers = curl_slist_append(headers, auth_header);
     headers = curl_slist_append(headers, "Content-Type: text/plain; charset=utf-8");
+    if (gzipped) headers = curl_slist_append(headers, "Content-Encoding: gzip");
 
-    bool success = send_http_post(context, url, headers, line_protocol, 0); // 0 post_size for null-terminated string
+    bool success = send_http_post(context, url, headers, body, (long)size); // 0 post_size for null-terminated string
 
     curl_slist_free_all(headers);
     return success;
@@ -325,4 +673,13 @@ static bool send_http_post(const SenderContext* context, const char* url, struct
     free(chunk.memory);
 
     return success;
+}
+
+static void copy_influxdb_setting(char* target, size_t target_size, const char* value) {
+    if (!value) {
+        target[0] = '\0';
+        return;
+    }
+    strncpy(target, value, target_size - 1);
+    target[target_size - 1] = '\0';
 }
\ No newline at end of file
@@ -27,6 +27,19 @@ SenderContext* sender_create_from_env(void);
  */
 SenderContext* sender_create_from_yaml(const YAMLAppConfig* config);
 
+/**
+ * @brief Creates a sender for one rollup tier.
+ *
+ * Uses the server and credentials of config->influxdb with the tier's bucket,
+ * batching settings and its own offline queue (<csv_directory>/offline_<name>.txt).
+ * Configuration reloads update the server and credentials but never the bucket.
+ *
+ * @param config The YAML configuration containing InfluxDB settings
+ * @param tier The tier to send
+ * @return A pointer to the SenderContext on success, NULL on failure.
+ */
+SenderContext* sender_create_for_tier(const YAMLAppConfig* config, const RollupTierConfig* tier);
+
 /**
  * @brief Destroys the sender module and cleans up its resources.
  *
@@ -37,16 +50,74 @@ SenderContext* sender_create_from_yaml(const YAMLAppConfig* config);
  */
 void sender_destroy(SenderContext* context);
 
+/**
+ * @brief Replaces the InfluxDB connection settings used for subsequent sends.
+ *
+ * Safe to call while the sender threads are running; used when the YAML
+ * configuration is reloaded at runtime. Incomplete settings are ignored.
+ *
+ * @param context The sender context.
+ * @param influxdb The new InfluxDB settings (copied).
+ */
+void sender_update_influxdb_config(SenderContext* context, const InfluxDBConfig* influxdb);
+
+/**
+ * @brief Asks the offline processor thread to replay the offline queue.
+ *
+ * Non-blocking; the replay (compression and upload) runs on the sender's own
+ * thread. Called periodically from a timer on the application's event loop.
+ *
+ * @param context The sender context.
+ */
+void sender_request_offline_replay(SenderContext* context);
+
 /**
  * @brief Submits a measurement string to the sending queue.
  *
  * This function is the main interface for other threads to send data. It adds the
  * data to a thread-safe queue to be processed by the sender thread.
  * This function is non-blocking and makes a copy of the provided data.
+ * Lines are grouped into write requests of up to batch_size lines; lines still
+ * queued when the sender is destroyed go to its offline queue.
  *
  * @param context The sender context.
  * @param line_protocol The null-terminated string (in line protocol format) to be sent.
  */
 void sender_submit(SenderContext* context, const char* line_protocol);
 
+/**
+ * @brief Submits a high-priority line (alarms) ahead of the queued measurements.
+ *
+ * The line jumps the live queue and ends the batch being collected, so it is
+ * written without waiting for flush_interval_ms. Like sender_submit, it goes
+ * to the offline queue when the write fails.
+ *
+ * @param context The sender context.
+ * @param line_protocol The null-terminated line to be sent.
+ */
+void sender_submit_urgent(SenderContext* context, const char* line_protocol);
+
+/**
+ * @brief Queues bulk, low-priority data for the next offline replay.
+ *
+ * The lines bypass the live queue and are appended to the offline queue file,
+ * so they never delay live measurements. They are compressed and uploaded with
+ * the next replay (see sender_request_offline_replay) and survive restarts.
+ *
+ * @param context The sender context.
+ * @param line_protocol One or more newline-separated lines.
+ */
+void sender_submit_deferred(SenderContext* context, const char* line_protocol);
+
+/**
+ * @brief Returns the number of lines waiting in the live queue.
+ *
+ * The queue is unbounded; producers that can outpace the upstream (the gateway)
+ * use this to pause their sources and divert lines to sender_submit_deferred.
+ *
+ * @param context The sender context.
+ * @return Queued lines, or 0 if the sender is not running.
+ */
+size_t sender_queue_length(SenderContext* context);
+
 #endif // SENDER_H
\ No newline at end of file
@@ -1,41 +1,73 @@
+#define _GNU_SOURCE // accept4()
 #include "SocketServer.h"
 #include "Channel.h"
 #include "HardwareManager.h"  // For GPSData
 #include "ApplicationManager.h"
+#include "CalibrationSession.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
-#include <pthread.h>
 #include <math.h>
 #include <errno.h>
 #include <time.h>
 #include <string.h>  // For memset
+#include <pthread.h>
 
-#define MAX_CLIENTS 5
 #define JSON_BUFFER_SIZE 4096  // Increased buffer size for safety
 #define CLIENT_TIMEOUT_SECONDS 30
+#define COMMAND_BUFFER_SIZE 128
+#define ALARM_QUEUE_SIZE 16
+#define ALARM_LINE_SIZE 256
+#define OUTPUT_BUFFER_SIZE (2 * JSON_BUFFER_SIZE) // Unsent tail of the messages to a slow client
+#define CLIENT_EVENTS (EPOLLIN | EPOLLRDHUP)
 
 // Client connection context
-typedef struct {
+struct SocketClient {
     int socket;
     SocketServerContext* server_ctx;
-    pthread_t thread;
-    time_t last_activity;
-} ClientContext;
+    EventSource* socket_source;   // Hang-up detection and input draining
+    EventSource* update_timer;    // Periodic JSON push
+    time_t last_activity;         // Last successful send
+    char command[COMMAND_BUFFER_SIZE]; // Partial command line received so far
+    size_t command_len;
+    bool command_overflow;        // Current line is too long; dropped up to its newline
+    char output[OUTPUT_BUFFER_SIZE]; // Bytes accepted for sending but not yet taken by the socket
+    size_t output_len;            // Non-zero while EPOLLOUT is watched
+};
+
+// Alarm lines posted by the acquisition thread
+struct SocketAlarmQueue {
+    pthread_mutex_t lock;
+    char lines[ALARM_QUEUE_SIZE][ALARM_LINE_SIZE];
+    int count;
+};
 
 // Forward declarations
-static void* server_thread_func(void* arg);
-static void* client_thread_func(void* arg);
-static int create_json_response(char* buffer, size_t buffer_size, 
-                               const Channel* channels, const GPSData* gps_data);
+static void handle_listen_ready(EventLoop* loop, int fd, uint32_t events, void* user_data);
+static void handle_client_ready(EventLoop* loop, int fd, uint32_t events, void* user_data);
+static void handle_client_update(EventLoop* loop, void* user_data);
+static void handle_alarm_event(EventLoop* loop, void* user_data);
+static void close_client(SocketClient* client);
+static int create_json_response(char* buffer, size_t buffer_size, const AcquisitionFrame* frame,
+                                const CalibrationSessionStatus* calibration);
+static bool receive_commands(SocketClient* client, const char* data, size_t length);
+static bool handle_command(SocketClient* client, char* line);
+static bool start_calibration(SocketServerContext* ctx, const char* channel_name, int samples_per_point);
+static bool send_message(SocketClient* client, const char* message, size_t length);
+static bool flush_output(SocketClient* client);
+static void report_send_error(const SocketClient* client);
+static int append_calibration_status(char* buffer, size_t buffer_size, size_t offset,
+                                     const CalibrationSessionStatus* status, const char* channel_id);
+static void format_json_number(char* output, size_t output_size, double value);
 static bool is_valid_json_char(char c);
 static void safe_json_escape(const char* input, char* output, size_t output_size);
 
-SocketServerContext* socket_server_create(HardwareManager* hardware_manager, YAMLAppConfig* config) {
-    if (!hardware_manager || !config) {
+SocketServerContext* socket_server_create(HardwareManager* hardware_manager, AcquisitionFrameStore* frames,
+                                          YAMLAppConfig* config) {
+    if (!hardware_manager || !frames || !config) {
         fprintf(stderr, "SocketServer: Invalid parameters\n");
         return NULL;
     }
@@ -52,75 +84,48 @@ SocketServerContext* socket_server_create(HardwareManager* hardware_manager, YAM
     }
 
     ctx->hardware_manager = hardware_manager;
+    ctx->frames = frames;
     ctx->config = config;
+    ctx->listen_fd = -1;
     ctx->running = false;
-    ctx->shutdown_requested = false;
+
+    ctx->alarms = calloc(1, sizeof(SocketAlarmQueue));
+    if (!ctx->alarms || pthread_mutex_init(&ctx->alarms->lock, NULL) != 0) {
+        fprintf(stderr, "SocketServer: Failed to create the alarm queue\n");
+        free(ctx->alarms);
+        free(ctx);
+        return NULL;
+    }
 
     return ctx;
 }
 
-bool socket_server_start(SocketServerContext* ctx) {
-    if (!ctx || ctx->running) {
+bool socket_server_start(SocketServerContext* ctx, EventLoop* loop) {
+    if (!ctx || !loop || ctx->running) {
         return false;
     }
 
     printf("SocketServer: Starting server on port %d\n", ctx->config->network.socket_port);
 
-    if (pthread_create(&ctx->server_thread, NULL, server_thread_func, ctx) != 0) {
-        fprintf(stderr, "SocketServer: Failed to create server thread: %s\n", strerror(errno));
-        return false;
-    }
-
-    ctx->running = true;
-    return true;
-}
-
-void socket_server_shutdown(SocketServerContext* ctx) {
-    if (!ctx || !ctx->running) {
-        return;
-    }
-
-    printf("SocketServer: Shutdown requested\n");
-    ctx->shutdown_requested = true;
-}
-
-void socket_server_destroy(SocketServerContext* ctx) {
-    if (!ctx) {
-        return;
-    }
-
-    if (ctx->running) {
-        socket_server_shutdown(ctx);
-        pthread_join(ctx->server_thread, NULL);
-    }
-
-    printf("SocketServer: Server stopped\n");
-    free(ctx);
-}
-
-static void* server_thread_func(void* arg) {
-    SocketServerContext* ctx = (SocketServerContext*)arg;
     int server_fd;
     struct sockaddr_in address;
     int opt = 1;
-    int addrlen = sizeof(address);
 
-    // Create socket
-    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == 0) {
+    // Create socket (non-blocking: accepted from the event loop)
+    if ((server_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) {
         fprintf(stderr, "SocketServer: Socket creation failed: %s\n", strerror(errno));
-        ctx->running = false;
-        return NULL;
+        return false;
     }
 
     // Set socket options
     if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt))) {
         fprintf(stderr, "SocketServer: setsockopt failed: %s\n", strerror(errno));
         close(server_fd);
-        ctx->running = false;
-        return NULL;
+        return false;
     }
 
     // Configure address
+    memset(&address, 0, sizeof(address));
     address.sin_family = AF_INET;
     address.sin_addr.s_addr = INADDR_ANY;
     address.sin_port = htons(ctx->config->network.socket_port);
@@ -129,144 +134,238 @@ static void* server_thread_func(void* arg) {
     if (bind(server_fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
         fprintf(stderr, "SocketServer: Bind failed: %s\n", strerror(errno));
         close(server_fd);
-        ctx->running = false;
-        return NULL;
+        return false;
     }
 
     // Listen for connections
-    if (listen(server_fd, MAX_CLIENTS) < 0) {
+    if (listen(server_fd, SOCKET_SERVER_MAX_CLIENTS) < 0) {
         fprintf(stderr, "SocketServer: Listen failed: %s\n", strerror(errno));
         close(server_fd);
-        ctx->running = false;
-        return NULL;
+        return false;
+    }
+
+    ctx->listen_source = event_loop_add_fd(loop, server_fd, EPOLLIN, handle_listen_ready, ctx);
+    if (!ctx->listen_source) {
+        close(server_fd);
+        return false;
     }
 
+    ctx->alarm_event = event_loop_add_event(loop, handle_alarm_event, ctx);
+    if (!ctx->alarm_event) {
+        event_loop_remove(loop, ctx->listen_source);
+        close(server_fd);
+        return false;
+    }
+
+    ctx->loop = loop;
+    ctx->listen_fd = server_fd;
+    ctx->running = true;
     printf("SocketServer: Listening on port %d\n", ctx->config->network.socket_port);
+    return true;
+}
 
-    while (!ctx->shutdown_requested) {
-        // Accept new client
-        int client_socket = accept(server_fd, (struct sockaddr*)&address, (socklen_t*)&addrlen);
-        
+void socket_server_destroy(SocketServerContext* ctx) {
+    if (!ctx) {
+        return;
+    }
+
+    if (ctx->running) {
+        for (int i = 0; i < SOCKET_SERVER_MAX_CLIENTS; i++) {
+            if (ctx->clients[i]) close_client(ctx->clients[i]);
+        }
+        event_loop_remove(ctx->loop, ctx->listen_source);
+        event_loop_remove(ctx->loop, ctx->alarm_event);
+        close(ctx->listen_fd);
+        ctx->running = false;
+    }
+
+    pthread_mutex_destroy(&ctx->alarms->lock);
+    free(ctx->alarms);
+    printf("SocketServer: Server stopped\n");
+    free(ctx);
+}
+
+void socket_server_post_alarm(SocketServerContext* ctx, const char* json_line) {
+    if (!ctx || !ctx->running || !json_line) return;
+
+    SocketAlarmQueue* alarms = ctx->alarms;
+    pthread_mutex_lock(&alarms->lock);
+    bool queued = alarms->count < ALARM_QUEUE_SIZE;
+    if (queued) snprintf(alarms->lines[alarms->count++], ALARM_LINE_SIZE, "%s", json_line);
+    pthread_mutex_unlock(&alarms->lock);
+
+    if (queued) {
+        event_loop_signal(ctx->alarm_event);
+    } else {
+        fprintf(stderr, "SocketServer: Alarm queue full, alarm not pushed to clients\n");
+    }
+}
+
+static void handle_listen_ready(EventLoop* loop, int fd, uint32_t events, void* user_data) {
+    SocketServerContext* ctx = (SocketServerContext*)user_data;
+
+    // Level-triggered: accept everything that is queued right now
+    while (true) {
+        int client_socket = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
         if (client_socket < 0) {
-            if (ctx->shutdown_requested) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                fprintf(stderr, "SocketServer: Accept failed: %s\n", strerror(errno));
+            }
+            return;
+        }
+
+        int slot = -1;
+        for (int i = 0; i < SOCKET_SERVER_MAX_CLIENTS; i++) {
+            if (!ctx->clients[i]) {
+                slot = i;
                 break;
             }
-            fprintf(stderr, "SocketServer: Accept failed: %s\n", strerror(errno));
+        }
+        if (slot < 0) {
+            fprintf(stderr, "SocketServer: Too many clients, rejecting socket %d\n", client_socket);
+            close(client_socket);
             continue;
         }
 
         printf("SocketServer: New client connected (socket %d)\n", client_socket);
 
         // Create client context
-        ClientContext* client_ctx = malloc(sizeof(ClientContext));
-        if (!client_ctx) {
+        SocketClient* client = calloc(1, sizeof(SocketClient));
+        if (!client) {
             fprintf(stderr, "SocketServer: Failed to allocate client context\n");
             close(client_socket);
             continue;
         }
 
-        client_ctx->socket = client_socket;
-        client_ctx->server_ctx = ctx;
-        client_ctx->last_activity = time(NULL);
+        client->socket = client_socket;
+        client->server_ctx = ctx;
+        client->last_activity = time(NULL);
 
-        // Create client handler thread
-        if (pthread_create(&client_ctx->thread, NULL, client_thread_func, client_ctx) != 0) {
-            fprintf(stderr, "SocketServer: Failed to create client thread: %s\n", strerror(errno));
-            close(client_socket);
-            free(client_ctx);
-            continue;
+        // Get update interval from configuration (default 500ms if not configured)
+        int update_interval_ms = ctx->config->network.update_interval_ms > 0 ? 
+                                ctx->config->network.update_interval_ms : 500;
+
+        client->socket_source = event_loop_add_fd(loop, client_socket, CLIENT_EVENTS,
+                                                  handle_client_ready, client);
+        client->update_timer = event_loop_add_timer(loop, 1, (unsigned)update_interval_ms,
+                                                    handle_client_update, client);
+        ctx->clients[slot] = client;
+
+        if (!client->socket_source || !client->update_timer) {
+            fprintf(stderr, "SocketServer: Failed to register client (socket %d)\n", client_socket);
+            close_client(client);
         }
+    }
+}
 
-        pthread_detach(client_ctx->thread);
+static void handle_client_ready(EventLoop* loop, int fd, uint32_t events, void* user_data) {
+    SocketClient* client = (SocketClient*)user_data;
+
+    if (events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP)) {
+        printf("SocketServer: Client disconnected (socket %d)\n", client->socket);
+        close_client(client);
+        return;
     }
 
-    close(server_fd);
-    ctx->running = false;
-    printf("SocketServer: Server thread exiting\n");
-    return NULL;
+    if ((events & EPOLLOUT) && !flush_output(client)) return;
+    if (!(events & EPOLLIN)) return;
+
+    // Measurements are pushed; the only input is newline-terminated calibration commands
+    char data[256];
+    ssize_t received = recv(fd, data, sizeof(data), MSG_DONTWAIT);
+    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        printf("SocketServer: Client disconnected (socket %d)\n", client->socket);
+        close_client(client);
+        return;
+    }
+    if (received > 0) receive_commands(client, data, (size_t)received);
 }
 
-static void* client_thread_func(void* arg) {
-    ClientContext* client_ctx = (ClientContext*)arg;
-    SocketServerContext* server_ctx = client_ctx->server_ctx;
+static void handle_client_update(EventLoop* loop, void* user_data) {
+    SocketClient* client = (SocketClient*)user_data;
+    SocketServerContext* server_ctx = client->server_ctx;
     char json_buffer[JSON_BUFFER_SIZE];
-    Channel channels[NUM_CHANNELS];
-    GPSData gps_data;
-
-    // Get update interval from configuration (default 500ms if not configured)
-    int update_interval_ms = server_ctx->config->network.update_interval_ms > 0 ? 
-                            server_ctx->config->network.update_interval_ms : 500;
-
-    while (!server_ctx->shutdown_requested) {
-        // Check for client timeout
-        time_t now = time(NULL);
-        if (now - client_ctx->last_activity > CLIENT_TIMEOUT_SECONDS) {
-            printf("SocketServer: Client timeout (socket %d)\n", client_ctx->socket);
-            break;
-        }
+    time_t now = time(NULL);
 
-        // Get current data from HardwareManager
-        const Channel* hw_channels = hardware_manager_get_channels(server_ctx->hardware_manager);
-        bool gps_success = hardware_manager_get_current_gps(server_ctx->hardware_manager, &gps_data);
-        
-        if (!hw_channels) {
-            fprintf(stderr, "SocketServer: Failed to get channel data from hardware manager\n");
-            usleep(update_interval_ms * 1000);
-            continue;
-        }
-        
-        // Copy channels for JSON generation (create_json_response expects non-const)
-        for (int i = 0; i < NUM_CHANNELS && i < hardware_manager_get_channel_count(server_ctx->hardware_manager); i++) {
-            channels[i] = hw_channels[i];
-        }
-        
-        // Use empty GPS data if GPS is not available
-        if (!gps_success) {
-            memset(&gps_data, 0, sizeof(GPSData));
-            gps_data.latitude = NAN;
-            gps_data.longitude = NAN;
-            gps_data.altitude = NAN;
-            gps_data.speed = NAN;
+    // Slow reader still taking the previous update: skip this one, give up after a long stall
+    if (client->output_len > 0) {
+        if (now - client->last_activity > CLIENT_TIMEOUT_SECONDS) {
+            printf("SocketServer: Client timeout (socket %d)\n", client->socket);
+            close_client(client);
         }
+        return;
+    }
 
-        // Create JSON response
-        int json_len = create_json_response(json_buffer, JSON_BUFFER_SIZE, channels, &gps_data);
-        if (json_len <= 0) {
-            fprintf(stderr, "SocketServer: Failed to create JSON response\n");
-            break;
-        }
+    // Latest sweep, shared with the other sinks; nothing to send before the first one
+    const AcquisitionFrame* frame = acquisition_frame_acquire(server_ctx->frames);
+    if (!frame) return;
+
+    // A running calibration session is reported with every update
+    CalibrationSessionStatus calibration;
+    CalibrationSession* session = hardware_manager_get_calibration_session(server_ctx->hardware_manager);
+    calibration_session_get_status(session, &calibration);
+    bool calibrating = session && calibration.state != CALIBRATION_SESSION_IDLE;
+
+    // Create JSON response
+    int json_len = create_json_response(json_buffer, JSON_BUFFER_SIZE, frame, calibrating ? &calibration : NULL);
+    acquisition_frame_release(server_ctx->frames, frame);
+    if (json_len <= 0) {
+        fprintf(stderr, "SocketServer: Failed to create JSON response\n");
+        close_client(client);
+        return;
+    }
 
-        // Send response to client
-        ssize_t sent = send(client_ctx->socket, json_buffer, json_len, MSG_NOSIGNAL);
-        if (sent < 0) {
-            if (errno == EPIPE || errno == ECONNRESET) {
-                printf("SocketServer: Client disconnected (socket %d)\n", client_ctx->socket);
-            } else {
-                fprintf(stderr, "SocketServer: Send failed: %s\n", strerror(errno));
-            }
-            break;
-        }
+    // Send response to client without blocking the event loop
+    send_message(client, json_buffer, (size_t)json_len);
+}
 
-        client_ctx->last_activity = now;
-        usleep(update_interval_ms * 1000);
+// Sends every queued alarm line to every client
+static void handle_alarm_event(EventLoop* loop, void* user_data) {
+    SocketServerContext* ctx = (SocketServerContext*)user_data;
+    SocketAlarmQueue* alarms = ctx->alarms;
+    char lines[ALARM_QUEUE_SIZE][ALARM_LINE_SIZE];
+
+    pthread_mutex_lock(&alarms->lock);
+    int count = alarms->count;
+    memcpy(lines, alarms->lines, (size_t)count * ALARM_LINE_SIZE);
+    alarms->count = 0;
+    pthread_mutex_unlock(&alarms->lock);
+
+    for (int i = 0; i < SOCKET_SERVER_MAX_CLIENTS; i++) {
+        SocketClient* client = ctx->clients[i];
+        if (!client) continue;
+        for (int a = 0; a < count; a++) {
+            if (!send_message(client, lines[a], strlen(lines[a]))) break; // Client closed
+        }
     }
+}
+
+static void close_client(SocketClient* client) {
+    SocketServerContext* ctx = client->server_ctx;
 
-    printf("SocketServer: Client handler exiting (socket %d)\n", client_ctx->socket);
-    close(client_ctx->socket);
-    free(client_ctx);
-    return NULL;
+    printf("SocketServer: Client handler exiting (socket %d)\n", client->socket);
+    event_loop_remove(ctx->loop, client->socket_source);
+    event_loop_remove(ctx->loop, client->update_timer);
+    close(client->socket);
+
+    for (int i = 0; i < SOCKET_SERVER_MAX_CLIENTS; i++) {
+        if (ctx->clients[i] == client) ctx->clients[i] = NULL;
+    }
+    free(client);
 }
 
-static int create_json_response(char* buffer, size_t buffer_size, 
-                               const Channel* channels, const GPSData* gps_data) {
+static int create_json_response(char* buffer, size_t buffer_size, const AcquisitionFrame* frame,
+                                const CalibrationSessionStatus* calibration) {
     if (!buffer || buffer_size < 512) {
         return -1;
     }
 
+    const FrameChannel* channels = frame->channels;
+    const GPSData* gps_data = &frame->gps;
     char escaped_id[64];
     char escaped_unit[32];
     size_t offset = 0;
-    time_t timestamp = time(NULL);
+    time_t timestamp = (time_t)frame->wall_time_s;
 
     // Start JSON object
     int written = snprintf(buffer + offset, buffer_size - offset,
@@ -276,7 +375,7 @@ static int create_json_response(char* buffer, size_t buffer_size,
 
     // Add channel measurements
     bool first_channel = true;
-    for (int i = 0; i < NUM_CHANNELS; i++) {
+    for (int i = 0; i < frame->channel_count; i++) {
         if (!channels[i].is_active) {
             continue;
         }
@@ -291,12 +390,13 @@ static int create_json_response(char* buffer, size_t buffer_size,
         safe_json_escape(channels[i].unit, escaped_unit, sizeof(escaped_unit));
 
         written = snprintf(buffer + offset, buffer_size - offset,
-            "{\"id\":\"%s\",\"pin\":%d,\"adc\":%d,\"value\":%.6f,\"unit\":\"%s\"}",
+            "{\"id\":\"%s\",\"pin\":%d,\"adc\":%d,\"value\":%.6f,\"unit\":\"%s\",\"quality\":%u}",
             escaped_id,
             channels[i].pin,
             channels[i].raw_adc_value,
-            channel_get_calibrated_value(&channels[i]),
-            escaped_unit);
+            channels[i].value,
+            escaped_unit,
+            (unsigned)channels[i].quality_flags);
 
         if (written < 0 || (size_t)written >= buffer_size - offset) return -1;
         offset += written;
@@ -353,14 +453,238 @@ static int create_json_response(char* buffer, size_t buffer_size,
         offset += written;
     }
 
+    // Close GPS object
+    if (offset + 1 >= buffer_size) return -1;
+    buffer[offset++] = '}';
+
+    if (calibration) {
+        written = snprintf(buffer + offset, buffer_size - offset, ",\"calibration\":");
+        if (written < 0 || (size_t)written >= buffer_size - offset) return -1;
+        offset += written;
+        int index = calibration->channel_index;
+        written = append_calibration_status(buffer, buffer_size, offset, calibration,
+                                            index >= 0 && index < frame->channel_count ? channels[index].id : NULL);
+        if (written < 0) return -1;
+        offset = (size_t)written;
+    }
+
     // Close JSON object
-    written = snprintf(buffer + offset, buffer_size - offset, "}}\n");
+    written = snprintf(buffer + offset, buffer_size - offset, "}\n");
     if (written < 0 || (size_t)written >= buffer_size - offset) return -1;
     offset += written;
 
     return (int)offset;
 }
 
+// Assembles newline-terminated command lines from the received bytes; false once the client is closed
+static bool receive_commands(SocketClient* client, const char* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        char c = data[i];
+        if (c == '\n') {
+            if (!client->command_overflow) {
+                client->command[client->command_len] = '\0';
+                if (!handle_command(client, client->command)) return false;
+            }
+            client->command_len = 0;
+            client->command_overflow = false;
+        } else if (c != '\r' && !client->command_overflow) {
+            if (client->command_len + 1 >= COMMAND_BUFFER_SIZE) {
+                client->command_overflow = true;
+            } else {
+                client->command[client->command_len++] = c;
+            }
+        }
+    }
+    return true;
+}
+
+// CAL START <channel> [samples] | CAL POINT <reference> | CAL APPLY | CAL CANCEL | CAL STATUS
+// Returns false if the client was closed while replying
+static bool handle_command(SocketClient* client, char* line) {
+    SocketServerContext* ctx = client->server_ctx;
+    CalibrationSession* session = hardware_manager_get_calibration_session(ctx->hardware_manager);
+    const char* error = NULL;
+
+    char* save = NULL;
+    char* verb = strtok_r(line, " \t", &save);
+    if (!verb) return true; // Blank line
+    char* action = strtok_r(NULL, " \t", &save);
+    char* argument = strtok_r(NULL, " \t", &save);
+    char* extra = strtok_r(NULL, " \t", &save);
+
+    if (strcmp(verb, "CAL") != 0 || !action) {
+        error = "unknown command";
+    } else if (!session) {
+        error = "channels not initialized";
+    } else if (strcmp(action, "START") == 0) {
+        char* end = NULL;
+        long samples = extra ? strtol(extra, &end, 10) : 0;
+        if (!argument || (extra && *end != '\0')) {
+            error = "usage: CAL START <channel> [samples]";
+        } else if (!start_calibration(ctx, argument, (int)samples)) {
+            error = "cannot start calibration (unknown channel or sample count out of range)";
+        }
+    } else if (strcmp(action, "POINT") == 0) {
+        char* end = NULL;
+        double reference = argument ? strtod(argument, &end) : NAN;
+        if (!argument || *end != '\0' || !calibration_session_capture(session, reference)) {
+            error = "cannot capture point (no session waiting or invalid reference)";
+        }
+    } else if (strcmp(action, "APPLY") == 0) {
+        if (!calibration_session_apply(session)) error = "cannot apply (need two distinct points, not capturing)";
+    } else if (strcmp(action, "CANCEL") == 0) {
+        calibration_session_cancel(session);
+    } else if (strcmp(action, "STATUS") != 0) {
+        error = "unknown calibration command";
+    }
+
+    char reply[1024];
+    int length;
+    if (error) {
+        length = snprintf(reply, sizeof(reply), "{\"error\":\"%s\"}\n", error);
+    } else {
+        CalibrationSessionStatus status;
+        calibration_session_get_status(session, &status);
+        length = snprintf(reply, sizeof(reply), "{\"calibration\":");
+        const Channel* channel = hardware_manager_get_channel(ctx->hardware_manager, status.channel_index);
+        length = append_calibration_status(reply, sizeof(reply), (size_t)length, &status,
+                                           channel ? channel->id : NULL);
+        if (length >= 0 && (size_t)length + 2 < sizeof(reply)) {
+            reply[length++] = '}';
+            reply[length++] = '\n';
+        } else {
+            length = -1;
+        }
+    }
+    if (length <= 0 || (size_t)length >= sizeof(reply)) return true;
+    return send_message(client, reply, (size_t)length);
+}
+
+// The channel is given by id or by index; only channels read from hardware can be calibrated
+static bool start_calibration(SocketServerContext* ctx, const char* channel_name, int samples_per_point) {
+    const Channel* channels = hardware_manager_get_channels(ctx->hardware_manager);
+    int channel_count = hardware_manager_get_channel_count(ctx->hardware_manager);
+
+    int index = -1;
+    for (int i = 0; i < channel_count; i++) {
+        if (strcmp(channels[i].id, channel_name) == 0) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        char* end = NULL;
+        long number = strtol(channel_name, &end, 10);
+        if (end != channel_name && *end == '\0' && number >= 0 && number < channel_count) index = (int)number;
+    }
+    if (index < 0 || !channels[index].is_active || channels[index].is_virtual) return false;
+
+    CalibrationSession* session = hardware_manager_get_calibration_session(ctx->hardware_manager);
+    if (!calibration_session_start(session, index, samples_per_point)) return false;
+
+    printf("SocketServer: Calibration session started on channel %s\n", channels[index].id);
+    return true;
+}
+
+// Sends one newline-terminated message without blocking. Whatever the socket does not take
+// is kept and written on EPOLLOUT, so a message is never cut short; one that does not fit
+// behind the pending output is dropped whole. Returns false if the client was closed.
+static bool send_message(SocketClient* client, const char* message, size_t length) {
+    size_t sent = 0;
+    if (client->output_len == 0) {
+        ssize_t result = send(client->socket, message, length, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            report_send_error(client);
+            close_client(client);
+            return false;
+        }
+        if (result > 0) {
+            sent = (size_t)result;
+            client->last_activity = time(NULL);
+        }
+        if (sent == length) return true;
+    }
+
+    size_t rest = length - sent;
+    if (client->output_len + rest > sizeof(client->output)) {
+        fprintf(stderr, "SocketServer: Client output full, message dropped (socket %d)\n", client->socket);
+        return true;
+    }
+
+    memcpy(client->output + client->output_len, message + sent, rest);
+    bool was_idle = client->output_len == 0;
+    client->output_len += rest;
+    if (was_idle && !event_loop_modify_fd(client->server_ctx->loop, client->socket_source,
+                                          CLIENT_EVENTS | EPOLLOUT)) {
+        close_client(client);
+        return false;
+    }
+    return true;
+}
+
+// Writes pending output once the socket has room; returns false if the client was closed
+static bool flush_output(SocketClient* client) {
+    ssize_t result = send(client->socket, client->output, client->output_len, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (result < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return true;
+        report_send_error(client);
+        close_client(client);
+        return false;
+    }
+
+    client->last_activity = time(NULL);
+    client->output_len -= (size_t)result;
+    memmove(client->output, client->output + result, client->output_len);
+    if (client->output_len == 0 &&
+        !event_loop_modify_fd(client->server_ctx->loop, client->socket_source, CLIENT_EVENTS)) {
+        close_client(client);
+        return false;
+    }
+    return true;
+}
+
+static void report_send_error(const SocketClient* client) {
+    if (errno == EPIPE || errno == ECONNRESET) {
+        printf("SocketServer: Client disconnected (socket %d)\n", client->socket);
+    } else {
+        fprintf(stderr, "SocketServer: Send failed: %s\n", strerror(errno));
+    }
+}
+
+// Writes the session as a JSON object at offset; returns the new offset, or -1 if it does not fit
+static int append_calibration_status(char* buffer, size_t buffer_size, size_t offset,
+                                     const CalibrationSessionStatus* status, const char* channel_id) {
+    static const char* state_names[] = { "idle", "waiting", "capturing", "applying" };
+    char escaped_id[64] = "";
+    char reference[32], raw_mean[32], slope[32], fit_offset[32], r_squared[32];
+
+    if (channel_id) {
+        safe_json_escape(channel_id, escaped_id, sizeof(escaped_id));
+    }
+    format_json_number(reference, sizeof(reference), status->last_reference);
+    format_json_number(raw_mean, sizeof(raw_mean), status->last_raw_mean);
+    format_json_number(slope, sizeof(slope), status->slope);
+    format_json_number(fit_offset, sizeof(fit_offset), status->offset);
+    format_json_number(r_squared, sizeof(r_squared), status->r_squared);
+
+    int written = snprintf(buffer + offset, buffer_size - offset,
+        "{\"state\":\"%s\",\"channel\":\"%s\",\"points\":%d,\"samples\":%d,\"samples_per_point\":%d,"
+        "\"reference\":%s,\"adc_mean\":%s,\"rejected\":%d,\"slope\":%s,\"offset\":%s,\"r2\":%s}",
+        state_names[status->state], escaped_id, status->point_count, status->samples_captured,
+        status->samples_per_point, reference, raw_mean, status->last_rejected, slope, fit_offset, r_squared);
+    if (written < 0 || (size_t)written >= buffer_size - offset) return -1;
+    return (int)(offset + written);
+}
+
+// JSON has no NaN; values not known yet are sent as null
+static void format_json_number(char* output, size_t output_size, double value) {
+    if (isfinite(value)) {
+        snprintf(output, output_size, "%.9g", value);
+    } else {
+        snprintf(output, output_size, "null");
+    }
+}
+
 static bool is_valid_json_char(char c) {
     return c >= 32 && c != '"' && c != '\\';
 }
@@ -392,8 +716,3 @@ static void safe_json_escape(const char* input, char* output, size_t output_size
     
     output[out_pos] = '\0';
 }
-
-// Legacy function for backward compatibility
-void* socket_server_thread_func(void* arg) {
-    return server_thread_func(arg);
-}
\ No newline at end of file
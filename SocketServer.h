@@ -2,49 +2,66 @@
 #define SOCKET_SERVER_H
 
 #include "ConfigYAML.h"
-#include <pthread.h>
 #include <stdbool.h>
 #include "HardwareManager.h"
+#include "AcquisitionFrame.h"
+#include "EventLoop.h"
+
+#define SOCKET_SERVER_MAX_CLIENTS 5
+
+typedef struct SocketClient SocketClient; // Per-connection state (private)
+typedef struct SocketAlarmQueue SocketAlarmQueue; // Alarm lines waiting for the event loop (private)
 
 // Socket server context structure
 typedef struct {
     HardwareManager* hardware_manager;  // Use HardwareManager directly instead of ApplicationManager
+    AcquisitionFrameStore* frames;      // Latest sweep for the periodic pushes (not owned)
     YAMLAppConfig* config;
-    pthread_t server_thread;
-    volatile bool running;
-    volatile bool shutdown_requested;
+    EventLoop* loop;                    // Accept, hang-up and periodic pushes run here
+    EventSource* listen_source;
+    int listen_fd;
+    SocketClient* clients[SOCKET_SERVER_MAX_CLIENTS];
+    SocketAlarmQueue* alarms;
+    EventSource* alarm_event;           // Wakes the loop to push queued alarm lines
+    bool running;
 } SocketServerContext;
 
 /**
  * @brief Creates and initializes a socket server context
  * @param hardware_manager Pointer to the HardwareManager instance for direct hardware access
+ * @param frames Store of the published acquisition frames sent to the clients
  * @param config YAML configuration containing network settings
  * @return SocketServerContext pointer or NULL on failure
  */
-SocketServerContext* socket_server_create(HardwareManager* hardware_manager, YAMLAppConfig* config);
+SocketServerContext* socket_server_create(HardwareManager* hardware_manager, AcquisitionFrameStore* frames,
+                                          YAMLAppConfig* config);
 
 /**
- * @brief Starts the socket server in a separate thread
+ * @brief Opens the listening socket and registers it with the event loop
  * @param ctx Socket server context
+ * @param loop Background event loop that serves all clients
  * @return true on success, false on failure
  */
-bool socket_server_start(SocketServerContext* ctx);
+bool socket_server_start(SocketServerContext* ctx, EventLoop* loop);
 
 /**
- * @brief Requests graceful shutdown of the socket server
- * @param ctx Socket server context
+ * @brief Pushes an alarm line to every connected client, ahead of the next periodic update.
+ *
+ * Callable from any thread: the line is queued and sent from the event loop.
+ * Lines beyond the queue's capacity are dropped until the loop catches up.
+ *
+ * @param ctx Socket server context (NULL is ignored)
+ * @param json_line A newline-terminated JSON object
  */
-void socket_server_shutdown(SocketServerContext* ctx);
+void socket_server_post_alarm(SocketServerContext* ctx, const char* json_line);
 
 /**
- * @brief Waits for socket server thread to complete and cleans up resources
+ * @brief Disconnects all clients, closes the listening socket and frees the context.
+ * The event loop must be stopped first.
  * @param ctx Socket server context
  */
 void socket_server_destroy(SocketServerContext* ctx);
 
-// Legacy function for backward compatibility
-void* socket_server_thread_func(void* arg);
-
 #endif // SOCKET_SERVER_H
 
 
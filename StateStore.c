@@ -0,0 +1,168 @@
+#include "StateStore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h> // For mkdir
+#include <zlib.h> // For crc32
+
+#define STATE_STORE_MAGIC   0x53544f52u // "STOR"
+#define STATE_STORE_VERSION 1
+#define STATE_STORE_SLOTS   2
+
+// On-disk slot layout; the CRC covers every byte before it
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t payload_size;
+    uint64_t sequence;
+    uint8_t payload[STATE_STORE_MAX_PAYLOAD];
+    uint32_t crc;
+} StateSlot;
+
+struct StateStore {
+    int fd;
+    uint8_t* map;
+    size_t slot_stride;    // One page per slot so a sync never touches the other slot
+    size_t map_size;
+    size_t payload_size;
+
+    int newest_slot;       // -1 until a valid record has been loaded or saved
+    uint64_t sequence;
+};
+
+// --- Private Function Prototypes ---
+static StateSlot* slot_at(const StateStore* store, int index);
+static uint32_t slot_crc(const StateSlot* slot);
+static bool slot_is_valid(const StateStore* store, const StateSlot* slot);
+
+// --- Public Functions ---
+
+StateStore* state_store_open(const char* path, size_t payload_size) {
+    if (!path || payload_size == 0 || payload_size > STATE_STORE_MAX_PAYLOAD) {
+        fprintf(stderr, "StateStore: Invalid parameters\n");
+        return NULL;
+    }
+
+    StateStore* store = calloc(1, sizeof(StateStore));
+    if (!store) {
+        perror("Failed to allocate memory for StateStore");
+        return NULL;
+    }
+
+    long page_size = sysconf(_SC_PAGESIZE);
+    store->slot_stride = page_size > (long)sizeof(StateSlot) ? (size_t)page_size : sizeof(StateSlot);
+    store->map_size = store->slot_stride * STATE_STORE_SLOTS;
+    store->payload_size = payload_size;
+    store->newest_slot = -1;
+
+    // Create the file's directory if needed; open() reports any failure
+    char directory[PATH_MAX];
+    snprintf(directory, sizeof(directory), "%s", path);
+    char* slash = strrchr(directory, '/');
+    if (slash && slash != directory) {
+        *slash = '\0';
+        mkdir(directory, 0755);
+    }
+
+    store->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (store->fd < 0) {
+        fprintf(stderr, "StateStore: Cannot open '%s': %s\n", path, strerror(errno));
+        free(store);
+        return NULL;
+    }
+
+    // Reserve the blocks now: a sparse file would fail on a full disk with SIGBUS at the
+    // first store through the mapping instead of here
+    int alloc_error = posix_fallocate(store->fd, 0, (off_t)store->map_size);
+    if (alloc_error != 0) {
+        fprintf(stderr, "StateStore: Cannot allocate '%s': %s\n", path, strerror(alloc_error));
+        close(store->fd);
+        free(store);
+        return NULL;
+    }
+
+    store->map = mmap(NULL, store->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, store->fd, 0);
+    if (store->map == MAP_FAILED) {
+        fprintf(stderr, "StateStore: Cannot map '%s': %s\n", path, strerror(errno));
+        close(store->fd);
+        free(store);
+        return NULL;
+    }
+
+    // Locate the newest valid slot so saves continue its sequence
+    for (int i = 0; i < STATE_STORE_SLOTS; i++) {
+        const StateSlot* slot = slot_at(store, i);
+        if (slot_is_valid(store, slot) && (store->newest_slot < 0 || slot->sequence > store->sequence)) {
+            store->newest_slot = i;
+            store->sequence = slot->sequence;
+        }
+    }
+
+    return store;
+}
+
+bool state_store_load(StateStore* store, void* payload) {
+    if (!store || !payload || store->newest_slot < 0) return false;
+
+    memcpy(payload, slot_at(store, store->newest_slot)->payload, store->payload_size);
+    return true;
+}
+
+bool state_store_save(StateStore* store, const void* payload) {
+    if (!store || !payload) return false;
+
+    // Never overwrite the newest good record
+    int target = store->newest_slot < 0 ? 0 : (store->newest_slot + 1) % STATE_STORE_SLOTS;
+    StateSlot* slot = slot_at(store, target);
+
+    memset(slot, 0, sizeof(*slot));
+    slot->magic = STATE_STORE_MAGIC;
+    slot->version = STATE_STORE_VERSION;
+    slot->payload_size = (uint16_t)store->payload_size;
+    slot->sequence = store->sequence + 1;
+    memcpy(slot->payload, payload, store->payload_size);
+    slot->crc = slot_crc(slot);
+
+    if (msync(slot, store->slot_stride, MS_SYNC) != 0) {
+        fprintf(stderr, "StateStore: msync failed: %s\n", strerror(errno));
+        return false;
+    }
+
+    store->newest_slot = target;
+    store->sequence = slot->sequence;
+    return true;
+}
+
+uint64_t state_store_sequence(const StateStore* store) {
+    return store ? store->sequence : 0;
+}
+
+void state_store_close(StateStore* store) {
+    if (!store) return;
+
+    munmap(store->map, store->map_size);
+    close(store->fd);
+    free(store);
+}
+
+// --- Private Function Implementations ---
+
+static StateSlot* slot_at(const StateStore* store, int index) {
+    return (StateSlot*)(store->map + (size_t)index * store->slot_stride);
+}
+
+static uint32_t slot_crc(const StateSlot* slot) {
+    return (uint32_t)crc32(0L, (const Bytef*)slot, (uInt)offsetof(StateSlot, crc));
+}
+
+static bool slot_is_valid(const StateStore* store, const StateSlot* slot) {
+    return slot->magic == STATE_STORE_MAGIC &&
+           slot->version == STATE_STORE_VERSION &&
+           slot->payload_size == store->payload_size &&
+           slot->crc == slot_crc(slot);
+}
@@ -0,0 +1,58 @@
+#ifndef STATE_STORE_H
+#define STATE_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file StateStore.h
+ * @brief Crash-safe persistence of a small fixed-size record.
+ *
+ * The file is memory-mapped and holds two slots, each on its own page. Every
+ * save goes to the older slot with the next sequence number and a CRC32, and
+ * only that page is synced to disk. A power cut during a save can only damage
+ * the slot being written; state_store_load() returns the newest slot whose
+ * CRC checks out.
+ */
+
+#define STATE_STORE_MAX_PAYLOAD 256
+
+typedef struct StateStore StateStore; // Opaque store type
+
+/**
+ * @brief Opens (or creates) a state file, creating its parent directory if needed.
+ * @param path File path
+ * @param payload_size Size of the record in bytes (at most STATE_STORE_MAX_PAYLOAD)
+ * @return A pointer to the store, or NULL on failure
+ */
+StateStore* state_store_open(const char* path, size_t payload_size);
+
+/**
+ * @brief Reads the newest valid record.
+ * @param store The store
+ * @param payload Receives payload_size bytes
+ * @return true if a valid record was found, false if the file is new or both slots are damaged
+ */
+bool state_store_load(StateStore* store, void* payload);
+
+/**
+ * @brief Writes a record to the older slot and syncs that page to disk.
+ * @param store The store
+ * @param payload payload_size bytes to persist
+ * @return true once the record is durable
+ */
+bool state_store_save(StateStore* store, const void* payload);
+
+/**
+ * @brief Returns the sequence number of the newest record (0 if none).
+ */
+uint64_t state_store_sequence(const StateStore* store);
+
+/**
+ * @brief Unmaps and closes the file.
+ * @param store The store (may be NULL)
+ */
+void state_store_close(StateStore* store);
+
+#endif // STATE_STORE_H
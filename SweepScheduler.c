@@ -0,0 +1,185 @@
+#include "SweepScheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct SweepScheduler {
+    int base_period_ms;
+
+    // Acquisition table
+    int slot_count;
+    int current_slot;
+    ChannelMask slot_masks[SWEEP_TABLE_MAX_SLOTS];
+    int peak_slot_load;
+
+    // Publish schedule (in units of the send period)
+    int publish_divisor[MAX_TOTAL_CHANNELS];
+    int channel_count;
+    unsigned long publish_counter;
+};
+
+// --- Private Function Prototypes ---
+static int interval_to_divisor(int interval_ms, int period_ms);
+static int gcd_int(int a, int b);
+static int round_down_power_of_two(int value);
+
+// --- Public Functions ---
+
+SweepScheduler* sweep_scheduler_create(const Channel* channels, int count,
+                                       int base_period_ms, int publish_period_ms) {
+    if (!channels || count < 0 || count > MAX_TOTAL_CHANNELS || base_period_ms <= 0 || publish_period_ms <= 0) {
+        fprintf(stderr, "SweepScheduler: Invalid parameters\n");
+        return NULL;
+    }
+
+    SweepScheduler* scheduler = calloc(1, sizeof(SweepScheduler));
+    if (!scheduler) {
+        perror("Failed to allocate memory for SweepScheduler");
+        return NULL;
+    }
+
+    scheduler->base_period_ms = base_period_ms;
+    scheduler->channel_count = count;
+
+    // Periods in slots, and the hyperperiod they repeat over
+    int divisor[MAX_TOTAL_CHANNELS];
+    long hyperperiod = 1;
+    for (int i = 0; i < count; i++) {
+        divisor[i] = interval_to_divisor(channels[i].sample_interval_ms, base_period_ms);
+    }
+    for (int i = 0; i < count && hyperperiod <= SWEEP_TABLE_MAX_SLOTS; i++) {
+        if (channels[i].is_active) {
+            hyperperiod = hyperperiod / gcd_int((int)hyperperiod, divisor[i]) * divisor[i];
+        }
+    }
+
+    if (hyperperiod > SWEEP_TABLE_MAX_SLOTS) {
+        // Pathological period mix: powers of two always nest, so the LCM is the largest one
+        fprintf(stderr, "SweepScheduler: Sample periods have no common cycle within %d slots; "
+                        "rounding periods down to powers of two\n", SWEEP_TABLE_MAX_SLOTS);
+        hyperperiod = 1;
+        for (int i = 0; i < count; i++) {
+            divisor[i] = round_down_power_of_two(divisor[i]);
+            if (divisor[i] > SWEEP_TABLE_MAX_SLOTS) divisor[i] = SWEEP_TABLE_MAX_SLOTS;
+            if (channels[i].is_active && divisor[i] > hyperperiod) hyperperiod = divisor[i];
+        }
+    }
+    scheduler->slot_count = (int)hyperperiod;
+
+    // Rate-monotonic order: shortest period first (stable on channel index)
+    int order[MAX_TOTAL_CHANNELS];
+    int active = 0;
+    for (int i = 0; i < count; i++) {
+        if (!channels[i].is_active) continue;
+        int j = active++;
+        while (j > 0 && divisor[order[j - 1]] > divisor[i]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    // Place each channel at the phase that minimises the peak load it adds to
+    int load[SWEEP_TABLE_MAX_SLOTS] = {0};
+    for (int k = 0; k < active; k++) {
+        int ch = order[k];
+        int period = divisor[ch];
+        int best_phase = 0;
+        int best_peak = -1;
+        long best_total = -1;
+
+        for (int phase = 0; phase < period; phase++) {
+            int peak = 0;
+            long total = 0;
+            for (int slot = phase; slot < scheduler->slot_count; slot += period) {
+                if (load[slot] > peak) peak = load[slot];
+                total += load[slot];
+            }
+            if (best_peak < 0 || peak < best_peak || (peak == best_peak && total < best_total)) {
+                best_peak = peak;
+                best_total = total;
+                best_phase = phase;
+            }
+        }
+
+        for (int slot = best_phase; slot < scheduler->slot_count; slot += period) {
+            scheduler->slot_masks[slot] |= CHANNEL_MASK_BIT(ch);
+            load[slot]++;
+        }
+    }
+
+    for (int slot = 0; slot < scheduler->slot_count; slot++) {
+        if (load[slot] > scheduler->peak_slot_load) scheduler->peak_slot_load = load[slot];
+    }
+
+    for (int i = 0; i < count; i++) {
+        scheduler->publish_divisor[i] = interval_to_divisor(channels[i].publish_interval_ms, publish_period_ms);
+    }
+
+    printf("SweepScheduler: %d-slot cycle of %d ms, peak %d conversions per slot\n",
+           scheduler->slot_count, base_period_ms, scheduler->peak_slot_load);
+    return scheduler;
+}
+
+ChannelMask sweep_scheduler_next_sample_mask(SweepScheduler* scheduler) {
+    if (!scheduler) return CHANNEL_MASK_ALL;
+
+    ChannelMask mask = scheduler->slot_masks[scheduler->current_slot];
+    scheduler->current_slot++;
+    if (scheduler->current_slot >= scheduler->slot_count) scheduler->current_slot = 0;
+    return mask;
+}
+
+ChannelMask sweep_scheduler_next_publish_mask(SweepScheduler* scheduler) {
+    if (!scheduler) return CHANNEL_MASK_ALL;
+
+    ChannelMask mask = 0;
+    for (int i = 0; i < scheduler->channel_count; i++) {
+        if (scheduler->publish_counter % (unsigned long)scheduler->publish_divisor[i] == 0) {
+            mask |= CHANNEL_MASK_BIT(i);
+        }
+    }
+    scheduler->publish_counter++;
+    return mask;
+}
+
+int sweep_scheduler_get_slot_count(const SweepScheduler* scheduler) {
+    return scheduler ? scheduler->slot_count : 0;
+}
+
+ChannelMask sweep_scheduler_get_slot_mask(const SweepScheduler* scheduler, int slot) {
+    if (!scheduler || slot < 0 || slot >= scheduler->slot_count) return 0;
+    return scheduler->slot_masks[slot];
+}
+
+int sweep_scheduler_get_peak_slot_load(const SweepScheduler* scheduler) {
+    return scheduler ? scheduler->peak_slot_load : 0;
+}
+
+void sweep_scheduler_destroy(SweepScheduler* scheduler) {
+    free(scheduler);
+}
+
+// --- Private Function Implementations ---
+
+// Rounds an interval to a whole number of periods (unset or shorter intervals run every period)
+static int interval_to_divisor(int interval_ms, int period_ms) {
+    if (interval_ms <= period_ms) return 1;
+    int divisor = (interval_ms + period_ms / 2) / period_ms;
+    return divisor < 1 ? 1 : divisor;
+}
+
+static int gcd_int(int a, int b) {
+    while (b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static int round_down_power_of_two(int value) {
+    int result = 1;
+    while (result * 2 <= value) result *= 2;
+    return result;
+}
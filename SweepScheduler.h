@@ -0,0 +1,64 @@
+#ifndef SWEEP_SCHEDULER_H
+#define SWEEP_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "Channel.h"
+
+/**
+ * @file SweepScheduler.h
+ * @brief Multi-rate acquisition: decides which channels are read in each sweep.
+ *
+ * The main loop period (system.main_loop_interval_ms) is the slot length. Each
+ * channel's sample_interval_ms is rounded to a whole number of slots, and a
+ * static table covering the hyperperiod (least common multiple of all channel
+ * periods) is built once. Channels are placed rate-monotonically: shortest
+ * period first, each at the phase that keeps the busiest slot lightest, so slow
+ * channels fill gaps instead of stacking onto the same conversion slot.
+ *
+ * Publishing works the same way on the send timer: a channel with a longer
+ * publish_interval_ms is only included in every Nth transmission.
+ */
+
+// Upper bound on the table length; period sets with a larger LCM are rounded to powers of two
+#define SWEEP_TABLE_MAX_SLOTS 1024
+
+typedef uint64_t ChannelMask; // Bit i selects channel i (MAX_TOTAL_CHANNELS <= 64)
+
+#define CHANNEL_MASK_ALL (~(ChannelMask)0)
+#define CHANNEL_MASK_BIT(index) ((ChannelMask)1 << (index))
+
+typedef struct SweepScheduler SweepScheduler; // Opaque scheduler type
+
+/**
+ * @brief Builds the sweep and publish tables for a channel set.
+ * @param channels Channel array (sample_interval_ms / publish_interval_ms are read)
+ * @param count Number of channels (at most MAX_TOTAL_CHANNELS)
+ * @param base_period_ms Main loop period in milliseconds (slot length)
+ * @param publish_period_ms Data send period in milliseconds
+ * @return A new scheduler, or NULL on failure
+ */
+SweepScheduler* sweep_scheduler_create(const Channel* channels, int count,
+                                       int base_period_ms, int publish_period_ms);
+
+/**
+ * @brief Returns the channels due in the current slot and advances to the next one.
+ */
+ChannelMask sweep_scheduler_next_sample_mask(SweepScheduler* scheduler);
+
+/**
+ * @brief Returns the channels due in the current transmission and advances the publish counter.
+ */
+ChannelMask sweep_scheduler_next_publish_mask(SweepScheduler* scheduler);
+
+// Table introspection (for logging and tests)
+int sweep_scheduler_get_slot_count(const SweepScheduler* scheduler);
+ChannelMask sweep_scheduler_get_slot_mask(const SweepScheduler* scheduler, int slot);
+int sweep_scheduler_get_peak_slot_load(const SweepScheduler* scheduler);
+
+/**
+ * @brief Frees the scheduler.
+ */
+void sweep_scheduler_destroy(SweepScheduler* scheduler);
+
+#endif // SWEEP_SCHEDULER_H
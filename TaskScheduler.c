@@ -0,0 +1,220 @@
+#include "TaskScheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#define NS_PER_SECOND 1000000000ULL
+
+typedef struct {
+    char name[TASK_NAME_SIZE];
+    uint64_t period_ns;
+    uint64_t deadline_ns;
+    TaskOverrunPolicy policy;
+    TaskFn fn;
+    void* user_data;
+    TaskStats stats;
+} Task;
+
+struct TaskScheduler {
+    Task tasks[TASK_SCHEDULER_MAX_TASKS];
+    int task_count;
+
+    // Binary min-heap of task ids keyed by (deadline, id)
+    int heap[TASK_SCHEDULER_MAX_TASKS];
+    int heap_position[TASK_SCHEDULER_MAX_TASKS];
+};
+
+// --- Private Function Prototypes ---
+static uint64_t monotonic_now_ns(void);
+static uint64_t seconds_to_ns(double seconds);
+static bool task_before(const TaskScheduler* scheduler, int a, int b);
+static void heap_swap(TaskScheduler* scheduler, int i, int j);
+static void heap_sift_up(TaskScheduler* scheduler, int index);
+static void heap_sift_down(TaskScheduler* scheduler, int index);
+
+// --- Public Functions ---
+
+TaskScheduler* task_scheduler_create(void) {
+    TaskScheduler* scheduler = calloc(1, sizeof(TaskScheduler));
+    if (!scheduler) {
+        perror("Failed to allocate memory for TaskScheduler");
+        return NULL;
+    }
+    return scheduler;
+}
+
+TaskId task_scheduler_add(TaskScheduler* scheduler, const char* name, double period_s,
+                          TaskOverrunPolicy policy, TaskFn fn, void* user_data) {
+    if (!scheduler || !fn || !(period_s > 0.0)) {
+        fprintf(stderr, "TaskScheduler: Invalid task parameters\n");
+        return -1;
+    }
+    if (scheduler->task_count >= TASK_SCHEDULER_MAX_TASKS) {
+        fprintf(stderr, "TaskScheduler: Too many tasks (max %d)\n", TASK_SCHEDULER_MAX_TASKS);
+        return -1;
+    }
+
+    int id = scheduler->task_count++;
+    Task* task = &scheduler->tasks[id];
+    memset(task, 0, sizeof(*task));
+    snprintf(task->name, sizeof(task->name), "%s", name ? name : "task");
+    task->period_ns = seconds_to_ns(period_s);
+    task->deadline_ns = monotonic_now_ns();
+    task->policy = policy;
+    task->fn = fn;
+    task->user_data = user_data;
+
+    scheduler->heap[id] = id;
+    scheduler->heap_position[id] = id;
+    heap_sift_up(scheduler, id);
+    return id;
+}
+
+bool task_scheduler_set_period(TaskScheduler* scheduler, TaskId id, double period_s) {
+    if (!scheduler || id < 0 || id >= scheduler->task_count || !(period_s > 0.0)) return false;
+
+    Task* task = &scheduler->tasks[id];
+    uint64_t new_period = seconds_to_ns(period_s);
+    if (new_period == task->period_ns) return true;
+
+    // Next deadline = last release + new period (never in the past)
+    uint64_t last_release = task->deadline_ns - task->period_ns;
+    uint64_t now = monotonic_now_ns();
+    task->deadline_ns = last_release + new_period;
+    if (task->deadline_ns < now) task->deadline_ns = now;
+    task->period_ns = new_period;
+
+    int position = scheduler->heap_position[id];
+    heap_sift_up(scheduler, position);
+    heap_sift_down(scheduler, scheduler->heap_position[id]);
+    return true;
+}
+
+int task_scheduler_run_due(TaskScheduler* scheduler) {
+    if (!scheduler || scheduler->task_count == 0) return 0;
+
+    // A fixed "now" bounds the amount of catch-up work done in one call
+    uint64_t now = monotonic_now_ns();
+    int executed = 0;
+
+    while (scheduler->tasks[scheduler->heap[0]].deadline_ns <= now) {
+        int id = scheduler->heap[0];
+        Task* task = &scheduler->tasks[id];
+
+        uint64_t lateness = now - task->deadline_ns;
+        uint64_t missed = lateness / task->period_ns;
+
+        double lateness_s = (double)lateness / NS_PER_SECOND;
+        if (lateness_s > task->stats.max_lateness_s) task->stats.max_lateness_s = lateness_s;
+        if (missed > 0) task->stats.overruns++;
+
+        task->fn(task->user_data);
+        task->stats.runs++;
+        executed++;
+
+        if (task->policy == TASK_POLICY_CATCH_UP) {
+            // Replay at most the newest TASK_SCHEDULER_MAX_CATCH_UP missed releases
+            if (missed > TASK_SCHEDULER_MAX_CATCH_UP) {
+                uint64_t dropped = missed - TASK_SCHEDULER_MAX_CATCH_UP;
+                task->stats.skipped += dropped;
+                task->deadline_ns += dropped * task->period_ns;
+            }
+            task->deadline_ns += task->period_ns;
+        } else {
+            // Stay on the original grid, jumping over the missed releases
+            task->stats.skipped += missed;
+            task->deadline_ns += (missed + 1) * task->period_ns;
+        }
+
+        heap_sift_down(scheduler, 0);
+    }
+
+    return executed;
+}
+
+bool task_scheduler_wait(TaskScheduler* scheduler) {
+    if (!scheduler || scheduler->task_count == 0) return false;
+
+    uint64_t deadline = scheduler->tasks[scheduler->heap[0]].deadline_ns;
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadline / NS_PER_SECOND),
+        .tv_nsec = (long)(deadline % NS_PER_SECOND)
+    };
+
+    // Returns early on signals so shutdown and reload requests are handled promptly
+    return clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == 0;
+}
+
+bool task_scheduler_get_stats(const TaskScheduler* scheduler, TaskId id, TaskStats* stats) {
+    if (!scheduler || !stats || id < 0 || id >= scheduler->task_count) return false;
+    *stats = scheduler->tasks[id].stats;
+    return true;
+}
+
+void task_scheduler_print_stats(const TaskScheduler* scheduler) {
+    if (!scheduler) return;
+
+    for (int i = 0; i < scheduler->task_count; i++) {
+        const Task* task = &scheduler->tasks[i];
+        printf("Scheduler: %-14s period %8.3f s  runs %lu  overruns %lu  skipped %lu  max late %.3f s\n",
+               task->name, (double)task->period_ns / NS_PER_SECOND, task->stats.runs,
+               task->stats.overruns, task->stats.skipped, task->stats.max_lateness_s);
+    }
+}
+
+void task_scheduler_destroy(TaskScheduler* scheduler) {
+    free(scheduler);
+}
+
+// --- Private Function Implementations ---
+
+static uint64_t monotonic_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SECOND + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t seconds_to_ns(double seconds) {
+    uint64_t ns = (uint64_t)(seconds * (double)NS_PER_SECOND + 0.5);
+    return ns > 0 ? ns : 1;
+}
+
+static bool task_before(const TaskScheduler* scheduler, int a, int b) {
+    uint64_t da = scheduler->tasks[a].deadline_ns;
+    uint64_t db = scheduler->tasks[b].deadline_ns;
+    return da < db || (da == db && a < b);
+}
+
+static void heap_swap(TaskScheduler* scheduler, int i, int j) {
+    int a = scheduler->heap[i];
+    int b = scheduler->heap[j];
+    scheduler->heap[i] = b;
+    scheduler->heap[j] = a;
+    scheduler->heap_position[b] = i;
+    scheduler->heap_position[a] = j;
+}
+
+static void heap_sift_up(TaskScheduler* scheduler, int index) {
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!task_before(scheduler, scheduler->heap[index], scheduler->heap[parent])) break;
+        heap_swap(scheduler, index, parent);
+        index = parent;
+    }
+}
+
+static void heap_sift_down(TaskScheduler* scheduler, int index) {
+    int count = scheduler->task_count;
+    while (true) {
+        int smallest = index;
+        int left = 2 * index + 1;
+        int right = left + 1;
+        if (left < count && task_before(scheduler, scheduler->heap[left], scheduler->heap[smallest])) smallest = left;
+        if (right < count && task_before(scheduler, scheduler->heap[right], scheduler->heap[smallest])) smallest = right;
+        if (smallest == index) break;
+        heap_swap(scheduler, index, smallest);
+        index = smallest;
+    }
+}
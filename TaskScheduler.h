@@ -0,0 +1,95 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file TaskScheduler.h
+ * @brief Central scheduler for the periodic jobs of the main loop.
+ *
+ * Tasks are kept in a min-heap ordered by absolute deadline (CLOCK_MONOTONIC).
+ * Each release advances the deadline by exactly one period, so late runs never
+ * push the schedule back and long-term rates match the configured periods.
+ * The main loop sleeps until the earliest deadline instead of polling timers.
+ */
+
+#define TASK_SCHEDULER_MAX_TASKS 16
+#define TASK_NAME_SIZE 32
+
+// Number of missed releases a CATCH_UP task may replay back-to-back; older ones are skipped
+#define TASK_SCHEDULER_MAX_CATCH_UP 3
+
+typedef int TaskId; // Negative on error
+
+typedef void (*TaskFn)(void* user_data);
+
+// What to do when a task is released one or more whole periods late
+typedef enum {
+    TASK_POLICY_SKIP = 0,   // Run once and realign to the next future deadline
+    TASK_POLICY_CATCH_UP    // Run every missed release (up to TASK_SCHEDULER_MAX_CATCH_UP)
+} TaskOverrunPolicy;
+
+typedef struct {
+    unsigned long runs;       // Times the task function was called
+    unsigned long overruns;   // Releases that started at least one full period late
+    unsigned long skipped;    // Releases dropped without running
+    double max_lateness_s;    // Worst start delay relative to the deadline
+} TaskStats;
+
+typedef struct TaskScheduler TaskScheduler; // Opaque scheduler type
+
+/**
+ * @brief Creates an empty scheduler.
+ * @return A new scheduler, or NULL on failure
+ */
+TaskScheduler* task_scheduler_create(void);
+
+/**
+ * @brief Registers a periodic task. Its first release is due immediately.
+ *
+ * Tasks with the same deadline run in registration order.
+ * @param scheduler The scheduler
+ * @param name Short name used in statistics
+ * @param period_s Period in seconds (must be > 0)
+ * @param policy Overrun policy
+ * @param fn Task function
+ * @param user_data Passed to fn
+ * @return Task id, or -1 on failure
+ */
+TaskId task_scheduler_add(TaskScheduler* scheduler, const char* name, double period_s,
+                          TaskOverrunPolicy policy, TaskFn fn, void* user_data);
+
+/**
+ * @brief Changes a task's period, keeping its phase (the next deadline moves by the difference).
+ */
+bool task_scheduler_set_period(TaskScheduler* scheduler, TaskId id, double period_s);
+
+/**
+ * @brief Runs every task whose deadline has passed.
+ * @return Number of task executions
+ */
+int task_scheduler_run_due(TaskScheduler* scheduler);
+
+/**
+ * @brief Sleeps until the earliest deadline.
+ * @return true if the deadline was reached, false if interrupted by a signal (or no tasks)
+ */
+bool task_scheduler_wait(TaskScheduler* scheduler);
+
+/**
+ * @brief Copies the statistics of a task.
+ */
+bool task_scheduler_get_stats(const TaskScheduler* scheduler, TaskId id, TaskStats* stats);
+
+/**
+ * @brief Prints a one-line summary per task (runs, overruns, skipped, worst lateness).
+ */
+void task_scheduler_print_stats(const TaskScheduler* scheduler);
+
+/**
+ * @brief Frees the scheduler.
+ */
+void task_scheduler_destroy(TaskScheduler* scheduler);
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,281 @@
+#include "TriggerEngine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+struct TriggerEngine {
+    int channel_count;
+    int pre_samples;
+    int post_samples;
+    double holdoff_s;
+
+    // Ring of the latest `capacity` frames (pre + trigger + post)
+    int capacity;
+    double* times;
+    ChannelMask* masks;
+    float* values;          // capacity * channel_count samples, one row per frame
+    int head;               // Slot of the next frame
+    int filled;             // Frames written so far (up to capacity)
+
+    // Capture in progress / completed
+    bool recording;
+    int post_remaining;
+    double rearm_time_s;    // Triggers are ignored until then (holdoff)
+    TriggerEvent event;
+    bool has_event;         // The ring holds a completed capture (until the next frame)
+    int event_start;        // Slot of the capture's oldest frame
+
+    // Edge detection per channel
+    uint8_t active_conditions[MAX_TOTAL_CHANNELS]; // Bit per TRIGGER_CONDITION_* currently true
+    bool has_previous[MAX_TOTAL_CHANNELS];
+    double previous_value[MAX_TOTAL_CHANNELS];
+    double previous_time_s[MAX_TOTAL_CHANNELS];
+};
+
+// --- Private Function Prototypes ---
+static void store_frame(TriggerEngine* engine, const Channel channels[], ChannelMask fresh_mask, double now_s);
+static uint8_t evaluate_conditions(TriggerEngine* engine, int index, const Channel* channel,
+                                   double now_s, double values[]);
+static bool write_u32(FILE* file, uint32_t value);
+
+// --- Public Functions ---
+
+TriggerEngine* trigger_engine_create(int channel_count, int pre_samples, int post_samples, double holdoff_s) {
+    if (channel_count <= 0 || channel_count > MAX_TOTAL_CHANNELS || pre_samples < 0 || post_samples < 1) {
+        fprintf(stderr, "TriggerEngine: Invalid parameters (channels=%d, pre=%d, post=%d)\n",
+                channel_count, pre_samples, post_samples);
+        return NULL;
+    }
+
+    TriggerEngine* engine = calloc(1, sizeof(TriggerEngine));
+    if (!engine) {
+        perror("Failed to allocate memory for TriggerEngine");
+        return NULL;
+    }
+
+    engine->channel_count = channel_count;
+    engine->pre_samples = pre_samples;
+    engine->post_samples = post_samples;
+    engine->holdoff_s = holdoff_s > 0.0 ? holdoff_s : 0.0;
+    engine->capacity = pre_samples + 1 + post_samples;
+    engine->times = calloc(engine->capacity, sizeof(double));
+    engine->masks = calloc(engine->capacity, sizeof(ChannelMask));
+    engine->values = calloc((size_t)engine->capacity * channel_count, sizeof(float));
+    if (!engine->times || !engine->masks || !engine->values) {
+        perror("Failed to allocate memory for the trigger capture ring");
+        trigger_engine_destroy(engine);
+        return NULL;
+    }
+
+    engine->rearm_time_s = -INFINITY;
+    return engine;
+}
+
+bool trigger_engine_process(TriggerEngine* engine, const Channel channels[], ChannelMask fresh_mask, double now_s) {
+    if (!engine || !channels) return false;
+
+    engine->has_event = false; // The previous capture is overwritten from here on
+    store_frame(engine, channels, fresh_mask, now_s);
+
+    if (engine->recording && --engine->post_remaining == 0) {
+        engine->recording = false;
+        engine->has_event = true;
+        engine->event.frame_count = engine->event.trigger_frame + 1 + engine->post_samples;
+        engine->event_start = (engine->head - engine->event.frame_count + engine->capacity) % engine->capacity;
+        engine->rearm_time_s = now_s + engine->holdoff_s;
+    }
+
+    // Edge states are tracked on every sweep so a condition already true at re-arm does not fire
+    bool can_fire = !engine->recording && !engine->has_event && now_s >= engine->rearm_time_s;
+    for (int i = 0; i < engine->channel_count; i++) {
+        const Channel* channel = &channels[i];
+        if (!channel->is_active || !(fresh_mask & CHANNEL_MASK_BIT(i))) continue;
+        if (channel->sample_quality_flags & (CHANNEL_QUALITY_STALE | CHANNEL_QUALITY_INVALID)) continue;
+
+        double values[TRIGGER_CONDITION_COUNT];
+        uint8_t conditions = evaluate_conditions(engine, i, channel, now_s, values);
+        uint8_t rising = conditions & (uint8_t)~engine->active_conditions[i];
+        engine->active_conditions[i] = conditions;
+        if (!can_fire || !rising) continue;
+
+        int condition = 0;
+        while (!(rising & (1u << condition))) condition++;
+
+        engine->recording = true;
+        engine->post_remaining = engine->post_samples;
+        engine->event.channel_index = i;
+        engine->event.condition = condition;
+        engine->event.value = values[condition];
+        engine->event.time_s = now_s;
+        engine->event.trigger_frame = engine->filled - 1 < engine->pre_samples ?
+                                      engine->filled - 1 : engine->pre_samples;
+        can_fire = false;
+    }
+
+    return engine->has_event;
+}
+
+const TriggerEvent* trigger_engine_get_event(const TriggerEngine* engine) {
+    return engine && engine->has_event ? &engine->event : NULL;
+}
+
+bool trigger_engine_get_frame(const TriggerEngine* engine, int frame, double* time_s,
+                              ChannelMask* fresh_mask, const float** values) {
+    if (!engine || !engine->has_event || frame < 0 || frame >= engine->event.frame_count) return false;
+
+    int slot = (engine->event_start + frame) % engine->capacity;
+    if (time_s) *time_s = engine->times[slot];
+    if (fresh_mask) *fresh_mask = engine->masks[slot];
+    if (values) *values = &engine->values[(size_t)slot * engine->channel_count];
+    return true;
+}
+
+TriggerCapture* trigger_engine_copy_capture(const TriggerEngine* engine, const Channel channels[]) {
+    if (!engine || !engine->has_event || !channels) return NULL;
+
+    const int frames = engine->event.frame_count;
+    const size_t row = (size_t)engine->channel_count;
+    TriggerCapture* capture = calloc(1, sizeof(TriggerCapture));
+    if (!capture) {
+        perror("Failed to allocate memory for TriggerCapture");
+        return NULL;
+    }
+    capture->channel_ids = calloc(row, MEASUREMENT_ID_SIZE);
+    capture->times = malloc((size_t)frames * sizeof(double));
+    capture->masks = malloc((size_t)frames * sizeof(ChannelMask));
+    capture->values = malloc((size_t)frames * row * sizeof(float));
+    if (!capture->channel_ids || !capture->times || !capture->masks || !capture->values) {
+        perror("Failed to allocate memory for TriggerCapture");
+        trigger_capture_free(capture);
+        return NULL;
+    }
+
+    capture->event = engine->event;
+    capture->channel_count = engine->channel_count;
+    for (int i = 0; i < engine->channel_count; i++) {
+        strncpy(capture->channel_ids[i], channels[i].id, MEASUREMENT_ID_SIZE - 1);
+    }
+    for (int f = 0; f < frames; f++) {
+        int slot = (engine->event_start + f) % engine->capacity;
+        capture->times[f] = engine->times[slot];
+        capture->masks[f] = engine->masks[slot];
+        memcpy(&capture->values[(size_t)f * row], &engine->values[(size_t)slot * row], row * sizeof(float));
+    }
+    return capture;
+}
+
+bool trigger_capture_write(const TriggerCapture* capture, const char* path) {
+    if (!capture || !path) return false;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        perror("Failed to open trigger capture file");
+        return false;
+    }
+
+    const TriggerEvent* event = &capture->event;
+    const size_t row = (size_t)capture->channel_count;
+    bool ok = fwrite(TRIGGER_CAPTURE_MAGIC, 1, 4, file) == 4 &&
+              write_u32(file, TRIGGER_CAPTURE_VERSION) &&
+              write_u32(file, (uint32_t)capture->channel_count) &&
+              write_u32(file, (uint32_t)event->frame_count) &&
+              write_u32(file, (uint32_t)event->trigger_frame) &&
+              write_u32(file, (uint32_t)event->channel_index) &&
+              write_u32(file, (uint32_t)event->condition) &&
+              fwrite(&event->value, sizeof(double), 1, file) == 1 &&
+              fwrite(&event->time_s, sizeof(double), 1, file) == 1 &&
+              fwrite(capture->channel_ids, MEASUREMENT_ID_SIZE, row, file) == row;
+
+    for (int f = 0; ok && f < event->frame_count; f++) {
+        uint64_t mask = capture->masks[f];
+        ok = fwrite(&capture->times[f], sizeof(double), 1, file) == 1 &&
+             fwrite(&mask, sizeof(mask), 1, file) == 1 &&
+             fwrite(&capture->values[(size_t)f * row], sizeof(float), row, file) == row;
+    }
+
+    if (fclose(file) != 0) ok = false;
+    if (!ok) {
+        fprintf(stderr, "TriggerEngine: Failed to write capture '%s'\n", path);
+        remove(path);
+    }
+    return ok;
+}
+
+void trigger_capture_free(TriggerCapture* capture) {
+    if (!capture) return;
+    free(capture->channel_ids);
+    free(capture->times);
+    free(capture->masks);
+    free(capture->values);
+    free(capture);
+}
+
+const char* trigger_engine_condition_name(int condition) {
+    switch (condition) {
+        case TRIGGER_CONDITION_ABOVE: return "above";
+        case TRIGGER_CONDITION_BELOW: return "below";
+        case TRIGGER_CONDITION_RATE:  return "rate";
+        default:                      return "unknown";
+    }
+}
+
+void trigger_engine_destroy(TriggerEngine* engine) {
+    if (!engine) return;
+
+    free(engine->times);
+    free(engine->masks);
+    free(engine->values);
+    free(engine);
+}
+
+// --- Private Function Implementations ---
+
+// Unfiltered samples: the EMA would smooth away the transients this is meant to catch
+static void store_frame(TriggerEngine* engine, const Channel channels[], ChannelMask fresh_mask, double now_s) {
+    int slot = engine->head;
+    float* row = &engine->values[(size_t)slot * engine->channel_count];
+
+    for (int i = 0; i < engine->channel_count; i++) {
+        bool fresh = channels[i].is_active && (fresh_mask & CHANNEL_MASK_BIT(i)) &&
+                     !(channels[i].sample_quality_flags & (CHANNEL_QUALITY_STALE | CHANNEL_QUALITY_INVALID));
+        row[i] = fresh ? (float)channel_get_sample_value(&channels[i]) : NAN;
+    }
+    engine->times[slot] = now_s;
+    engine->masks[slot] = fresh_mask;
+
+    engine->head = (engine->head + 1) % engine->capacity;
+    if (engine->filled < engine->capacity) engine->filled++;
+}
+
+// Returns the conditions that hold for this sample; values[] receives the quantity each one tested
+static uint8_t evaluate_conditions(TriggerEngine* engine, int index, const Channel* channel,
+                                   double now_s, double values[]) {
+    double value = channel_get_sample_value(channel);
+    double time_s = channel->sample_time_s > 0.0 ? channel->sample_time_s : now_s;
+    uint8_t conditions = 0;
+
+    values[TRIGGER_CONDITION_ABOVE] = value;
+    values[TRIGGER_CONDITION_BELOW] = value;
+    values[TRIGGER_CONDITION_RATE] = NAN;
+
+    // Comparisons with an unset (NAN) threshold are false
+    if (value > channel->trigger_above) conditions |= 1u << TRIGGER_CONDITION_ABOVE;
+    if (value < channel->trigger_below) conditions |= 1u << TRIGGER_CONDITION_BELOW;
+
+    if (engine->has_previous[index] && time_s > engine->previous_time_s[index]) {
+        double rate = (value - engine->previous_value[index]) / (time_s - engine->previous_time_s[index]);
+        values[TRIGGER_CONDITION_RATE] = rate;
+        if (fabs(rate) > channel->trigger_rate) conditions |= 1u << TRIGGER_CONDITION_RATE;
+    }
+
+    engine->has_previous[index] = true;
+    engine->previous_value[index] = value;
+    engine->previous_time_s[index] = time_s;
+    return conditions;
+}
+
+static bool write_u32(FILE* file, uint32_t value) {
+    return fwrite(&value, sizeof(value), 1, file) == 1;
+}
@@ -0,0 +1,124 @@
+#ifndef TRIGGER_ENGINE_H
+#define TRIGGER_ENGINE_H
+
+#include <stdbool.h>
+#include "Channel.h"
+#include "SweepScheduler.h" // For ChannelMask
+
+/**
+ * @file TriggerEngine.h
+ * @brief Triggered burst capture of full-rate samples around transients.
+ *
+ * Every sweep's unfiltered samples go into a ring of pre + 1 + post frames.
+ * When a channel crosses its trigger.above / trigger.below threshold, or its
+ * rate of change exceeds trigger.rate, the engine keeps recording post frames
+ * and then reports a completed capture: the pre frames that were already in
+ * the ring, the trigger frame and the post frames, oldest first. No samples
+ * are copied when the trigger fires; the ring simply stops being overwritten
+ * until the capture has been read. trigger_engine_copy_capture takes it out of
+ * the ring, so the file and the upload can be done off the sweep thread.
+ *
+ * Triggers are edge-sensitive: a condition fires when it becomes true, and
+ * must clear before it can fire again. Thresholds are read from the channels
+ * on every sweep, so they follow configuration reloads.
+ */
+
+#define TRIGGER_CONDITION_ABOVE 0
+#define TRIGGER_CONDITION_BELOW 1
+#define TRIGGER_CONDITION_RATE  2
+#define TRIGGER_CONDITION_COUNT 3
+
+#define TRIGGER_CAPTURE_MAGIC "TRGC"
+#define TRIGGER_CAPTURE_VERSION 1
+
+// The trigger that started a capture
+typedef struct {
+    int channel_index;   // Channel that fired
+    int condition;       // TRIGGER_CONDITION_*
+    double value;        // Sample that fired (units per second for a rate trigger)
+    double time_s;       // Wall-clock time of the trigger frame (seconds since the epoch)
+    int trigger_frame;   // Index of the trigger frame in the capture
+    int frame_count;     // Frames in the capture (fewer pre frames right after start-up)
+} TriggerEvent;
+
+typedef struct TriggerEngine TriggerEngine; // Opaque trigger engine
+
+// A completed capture copied out of the engine (see trigger_engine_copy_capture)
+typedef struct {
+    TriggerEvent event;
+    int channel_count;
+    char (*channel_ids)[MEASUREMENT_ID_SIZE]; // Ids of the channels when the capture completed
+    double* times;                            // Wall-clock time per frame, oldest first
+    ChannelMask* masks;                       // Fresh channels per frame
+    float* values;                            // frame_count * channel_count samples, NAN where not fresh
+} TriggerCapture;
+
+/**
+ * @brief Creates an engine for the given number of channels.
+ * @param channel_count Channels per frame (including virtual channels)
+ * @param pre_samples Frames kept before the trigger
+ * @param post_samples Frames recorded after the trigger (at least 1)
+ * @param holdoff_s Minimum time from the end of a capture to the next trigger
+ * @return A pointer to the engine, or NULL on failure
+ */
+TriggerEngine* trigger_engine_create(int channel_count, int pre_samples, int post_samples, double holdoff_s);
+
+/**
+ * @brief Records one sweep and evaluates the triggers on its fresh samples.
+ *
+ * The capture reported by a true return stays readable until the next call.
+ *
+ * @param channels The channel array (channel_count entries)
+ * @param fresh_mask Channels that got a new sample in this sweep
+ * @param now_s Wall-clock time of the sweep (seconds since the epoch)
+ * @return true if a capture has just completed
+ */
+bool trigger_engine_process(TriggerEngine* engine, const Channel channels[], ChannelMask fresh_mask, double now_s);
+
+/**
+ * @brief Returns the trigger of the latest completed capture (NULL if none).
+ */
+const TriggerEvent* trigger_engine_get_event(const TriggerEngine* engine);
+
+/**
+ * @brief Reads a frame of the latest completed capture (0 = oldest).
+ * @param values Receives channel_count samples; NAN where the channel had no fresh sample
+ * @return false if the frame index is out of range
+ */
+bool trigger_engine_get_frame(const TriggerEngine* engine, int frame, double* time_s,
+                              ChannelMask* fresh_mask, const float** values);
+
+/**
+ * @brief Copies the latest completed capture, with the channel ids, into a standalone object.
+ * @return The copy (free with trigger_capture_free), or NULL if there is none or on failure
+ */
+TriggerCapture* trigger_engine_copy_capture(const TriggerEngine* engine, const Channel channels[]);
+
+/**
+ * @brief Writes a capture as a compact binary file.
+ *
+ * Layout (little-endian): magic "TRGC", u32 version, u32 channel_count,
+ * u32 frame_count, u32 trigger_frame, i32 trigger channel, u32 condition,
+ * f64 trigger value, f64 trigger time; channel ids (MEASUREMENT_ID_SIZE bytes
+ * each); then per frame f64 time, u64 fresh mask and f32 value per channel.
+ *
+ * @return true on success
+ */
+bool trigger_capture_write(const TriggerCapture* capture, const char* path);
+
+/**
+ * @brief Frees a capture copy (NULL is ignored).
+ */
+void trigger_capture_free(TriggerCapture* capture);
+
+/**
+ * @brief Returns the name of a condition ("above", "below" or "rate").
+ */
+const char* trigger_engine_condition_name(int condition);
+
+/**
+ * @brief Frees the engine.
+ */
+void trigger_engine_destroy(TriggerEngine* engine);
+
+#endif // TRIGGER_ENGINE_H
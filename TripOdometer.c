@@ -0,0 +1,213 @@
+#include "TripOdometer.h"
+#include "StateStore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define EARTH_RADIUS_KM 6371.0088         // Mean Earth radius
+#define DEG_TO_RAD (M_PI / 180.0)
+#define CHECKPOINT_CAPACITY 1024          // One checkpoint per second covers the longest window
+#define CHECKPOINT_SPACING_S 1.0
+
+// Distance and energy at a fix, for the rolling Wh/km
+typedef struct {
+    double time_s;
+    double distance_km;
+    double energy_wh;
+} Checkpoint;
+
+// Record kept in the state file
+typedef struct {
+    double odometer_km;
+} PersistedOdometer;
+
+struct TripOdometer {
+    double min_speed_mps;
+    double window_s;
+    StateStore* store;          // NULL if the state file is unavailable
+
+    double odometer_km;
+    double trip_km;
+
+    // Anchor: the last fix distance was measured to
+    bool has_anchor;
+    double anchor_latitude;
+    double anchor_longitude;
+    double anchor_time_s;
+    double last_fix_time_s;
+
+    double energy_wh;           // Latest net energy (NAN without a meter)
+    double trip_start_energy_wh;
+
+    Checkpoint checkpoints[CHECKPOINT_CAPACITY];
+    int checkpoint_head;        // Index of the oldest checkpoint
+    int checkpoint_count;
+};
+
+// --- Private Function Prototypes ---
+static void open_store(TripOdometer* odometer, const char* state_file);
+static void integrate_fix(TripOdometer* odometer, const GPSData* gps);
+static double haversine_km(double lat1, double lon1, double lat2, double lon2);
+static void add_checkpoint(TripOdometer* odometer, double time_s);
+static double efficiency(double energy_wh, double distance_km);
+
+// --- Public Functions ---
+
+TripOdometer* trip_odometer_create(const TripConfig* config) {
+    if (!config || !config->enabled) return NULL;
+
+    TripOdometer* odometer = calloc(1, sizeof(TripOdometer));
+    if (!odometer) {
+        perror("Failed to allocate memory for TripOdometer");
+        return NULL;
+    }
+
+    trip_odometer_configure(odometer, config);
+    odometer->energy_wh = NAN;
+    odometer->trip_start_energy_wh = NAN;
+    open_store(odometer, config->state_file);
+
+    printf("TripOdometer: Restored at %.3f km\n", odometer->odometer_km);
+    return odometer;
+}
+
+void trip_odometer_configure(TripOdometer* odometer, const TripConfig* config) {
+    if (!odometer || !config) return;
+
+    odometer->min_speed_mps = config->min_speed_mps > 0.0 ? config->min_speed_mps : TRIP_DEFAULT_MIN_SPEED_MPS;
+    odometer->window_s = config->window_s > 0.0 ? config->window_s : TRIP_DEFAULT_WINDOW_S;
+}
+
+void trip_odometer_update(TripOdometer* odometer, const GPSData* gps, double energy_wh) {
+    if (!odometer) return;
+
+    odometer->energy_wh = energy_wh;
+    if (isfinite(energy_wh) && !isfinite(odometer->trip_start_energy_wh)) {
+        odometer->trip_start_energy_wh = energy_wh;
+    }
+
+    if (!gps || gps->fix_time_s <= odometer->last_fix_time_s) return; // No new fix
+    odometer->last_fix_time_s = gps->fix_time_s;
+    if (!isfinite(gps->latitude) || !isfinite(gps->longitude)) return;
+
+    integrate_fix(odometer, gps);
+    add_checkpoint(odometer, gps->fix_time_s);
+}
+
+void trip_odometer_get_reading(const TripOdometer* odometer, TripReading* reading) {
+    if (!odometer || !reading) return;
+
+    reading->odometer_km = odometer->odometer_km;
+    reading->trip_km = odometer->trip_km;
+    reading->trip_wh_per_km = efficiency(odometer->energy_wh - odometer->trip_start_energy_wh, odometer->trip_km);
+    reading->wh_per_km = NAN;
+    if (odometer->checkpoint_count > 0) {
+        const Checkpoint* oldest = &odometer->checkpoints[odometer->checkpoint_head];
+        reading->wh_per_km = efficiency(odometer->energy_wh - oldest->energy_wh,
+                                        odometer->trip_km - oldest->distance_km);
+    }
+}
+
+void trip_odometer_save(const TripOdometer* odometer) {
+    if (!odometer || !odometer->store) return;
+
+    PersistedOdometer persisted = { .odometer_km = odometer->odometer_km };
+    if (!state_store_save(odometer->store, &persisted)) {
+        fprintf(stderr, "TripOdometer: Failed to save the odometer\n");
+    }
+}
+
+void trip_odometer_destroy(TripOdometer* odometer) {
+    if (!odometer) return;
+
+    state_store_close(odometer->store);
+    free(odometer);
+}
+
+// --- Private Function Implementations ---
+
+// Opens the state file and restores the lifetime distance (zero for a new or damaged file)
+static void open_store(TripOdometer* odometer, const char* state_file) {
+    odometer->store = state_store_open(state_file, sizeof(PersistedOdometer));
+    if (!odometer->store) {
+        fprintf(stderr, "TripOdometer: Odometer will not be persisted\n");
+        return;
+    }
+
+    PersistedOdometer persisted;
+    if (state_store_load(odometer->store, &persisted) &&
+        isfinite(persisted.odometer_km) && persisted.odometer_km >= 0.0) {
+        odometer->odometer_km = persisted.odometer_km;
+    }
+}
+
+// Adds the distance from the anchor fix to this one, unless the receiver reports standing
+// still (the anchor is kept, so drift is never summed) or the step is a position jump
+static void integrate_fix(TripOdometer* odometer, const GPSData* gps) {
+    if (!odometer->has_anchor) {
+        odometer->has_anchor = true;
+        odometer->anchor_latitude = gps->latitude;
+        odometer->anchor_longitude = gps->longitude;
+        odometer->anchor_time_s = gps->fix_time_s;
+        return;
+    }
+
+    double distance_km = haversine_km(odometer->anchor_latitude, odometer->anchor_longitude,
+                                      gps->latitude, gps->longitude);
+    double elapsed_s = gps->fix_time_s - odometer->anchor_time_s;
+    double implied_speed_mps = 1000.0 * distance_km / elapsed_s;
+
+    // Without a reported speed, the displacement since the anchor decides
+    double speed_mps = isfinite(gps->speed) ? gps->speed : implied_speed_mps;
+    if (speed_mps < odometer->min_speed_mps) return;
+
+    if (implied_speed_mps <= TRIP_MAX_SPEED_MPS) {
+        odometer->trip_km += distance_km;
+        odometer->odometer_km += distance_km;
+    }
+    odometer->anchor_latitude = gps->latitude;
+    odometer->anchor_longitude = gps->longitude;
+    odometer->anchor_time_s = gps->fix_time_s;
+}
+
+static double haversine_km(double lat1, double lon1, double lat2, double lon2) {
+    double sin_dlat = sin(0.5 * (lat2 - lat1) * DEG_TO_RAD);
+    double sin_dlon = sin(0.5 * (lon2 - lon1) * DEG_TO_RAD);
+    double a = sin_dlat * sin_dlat + cos(lat1 * DEG_TO_RAD) * cos(lat2 * DEG_TO_RAD) * sin_dlon * sin_dlon;
+    return 2.0 * EARTH_RADIUS_KM * asin(sqrt(fmin(a, 1.0)));
+}
+
+// Records the trip state at most once per second, then drops the checkpoints the window
+// no longer needs: the oldest one kept is the newest at or before the window start
+static void add_checkpoint(TripOdometer* odometer, double time_s) {
+    int count = odometer->checkpoint_count;
+    if (count > 0) {
+        int newest = (odometer->checkpoint_head + count - 1) % CHECKPOINT_CAPACITY;
+        if (time_s - odometer->checkpoints[newest].time_s < CHECKPOINT_SPACING_S) return;
+    }
+
+    if (count == CHECKPOINT_CAPACITY) {
+        odometer->checkpoint_head = (odometer->checkpoint_head + 1) % CHECKPOINT_CAPACITY;
+        count--;
+    }
+    odometer->checkpoints[(odometer->checkpoint_head + count) % CHECKPOINT_CAPACITY] = (Checkpoint){
+        .time_s = time_s,
+        .distance_km = odometer->trip_km,
+        .energy_wh = odometer->energy_wh
+    };
+    count++;
+
+    double window_start_s = time_s - odometer->window_s;
+    while (count > 1 &&
+           odometer->checkpoints[(odometer->checkpoint_head + 1) % CHECKPOINT_CAPACITY].time_s <= window_start_s) {
+        odometer->checkpoint_head = (odometer->checkpoint_head + 1) % CHECKPOINT_CAPACITY;
+        count--;
+    }
+    odometer->checkpoint_count = count;
+}
+
+static double efficiency(double energy_wh, double distance_km) {
+    if (!isfinite(energy_wh) || distance_km < TRIP_MIN_EFFICIENCY_DISTANCE_KM) return NAN;
+    return energy_wh / distance_km;
+}
@@ -0,0 +1,71 @@
+#ifndef TRIP_ODOMETER_H
+#define TRIP_ODOMETER_H
+
+#include <stdbool.h>
+#include "ConfigYAML.h"
+#include "HardwareManager.h"
+
+/**
+ * @file TripOdometer.h
+ * @brief On-device fusion of GPS distance and energy counters (the YAML `trip` section).
+ *
+ * Distance is integrated incrementally from successive fixes with the
+ * haversine formula. Fixes reporting less than `min_speed_mps` add no
+ * distance and keep the anchor fix, so the wander of a stationary receiver
+ * is never summed; fixes implying an impossible speed are treated as
+ * position jumps and re-anchor without adding distance. The lifetime
+ * odometer is kept in a StateStore file; the trip distance starts at zero
+ * with every run.
+ *
+ * Fed with the net energy (Wh out minus Wh in) of an energy meter, the
+ * odometer also gives Wh/km over the trip and over a rolling time window,
+ * so consumption per distance no longer needs a join of the power and GPS
+ * series at query time.
+ */
+
+#define TRIP_MAX_SPEED_MPS 100.0          // Faster implied motion between fixes is a position jump
+#define TRIP_MIN_EFFICIENCY_DISTANCE_KM 0.05 // Wh/km is undefined over shorter distances
+
+typedef struct {
+    double odometer_km;         // Lifetime distance, restored at start-up
+    double trip_km;             // Distance since start-up
+    double wh_per_km;           // Net Wh/km over the rolling window (NAN without energy or distance)
+    double trip_wh_per_km;      // Net Wh/km since start-up (NAN without energy or distance)
+} TripReading;
+
+typedef struct TripOdometer TripOdometer; // Opaque odometer state
+
+/**
+ * @brief Creates the odometer and restores its lifetime distance from the state file.
+ * @return A pointer to the odometer, or NULL on failure or when the section is disabled
+ */
+TripOdometer* trip_odometer_create(const TripConfig* config);
+
+/**
+ * @brief Applies the hot-reloadable settings (minimum speed and window).
+ */
+void trip_odometer_configure(TripOdometer* odometer, const TripConfig* config);
+
+/**
+ * @brief Integrates the fix if it is new, and records the meter's energy.
+ * @param gps Latest GPS data; only a changed fix_time_s counts as a new fix
+ * @param energy_wh Net energy counter of the configured meter, or NAN without one
+ */
+void trip_odometer_update(TripOdometer* odometer, const GPSData* gps, double energy_wh);
+
+/**
+ * @brief Returns the current distances and efficiencies.
+ */
+void trip_odometer_get_reading(const TripOdometer* odometer, TripReading* reading);
+
+/**
+ * @brief Persists the lifetime distance to the state file.
+ */
+void trip_odometer_save(const TripOdometer* odometer);
+
+/**
+ * @brief Closes the state file and frees the odometer. Save first to keep the latest distance.
+ */
+void trip_odometer_destroy(TripOdometer* odometer);
+
+#endif // TRIP_ODOMETER_H
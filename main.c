@@ -1,40 +1,72 @@
 #define _POSIX_C_SOURCE 200809L //Enables POSIX functions such as sigaction to be exposed by C library headers
 #include "ApplicationManager.h"
+#include "Gateway.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include <unistd.h>
 #include <signal.h>
 
-// Global pointer to the app manager, allowing the signal handler to access it.
-static ApplicationManager* g_app_manager = NULL;
+// Set by the signal handlers and polled by the main loop. The handlers touch nothing else,
+// so a signal arriving during startup or teardown can't reach a freed application.
+static volatile sig_atomic_t g_shutdown_requested = 0;
+static volatile sig_atomic_t g_reload_requested = 0;
 
 /**
  * @brief Signal handler to catch SIGINT and SIGTERM for graceful shutdown.
  */
 static void signal_handler(int signum) {
-    if (!g_app_manager) return;
-    app_manager_signal_shutdown(g_app_manager);
+    if (!g_shutdown_requested) {
+        const char msg[] = "\nTermination signal received. Shutting down...\n";
+        write(STDOUT_FILENO, msg, sizeof(msg) - 1);
+    }
+    g_shutdown_requested = 1;
+}
+
+/**
+ * @brief Signal handler for SIGHUP: reload the YAML configuration without restarting.
+ */
+static void reload_signal_handler(int signum) {
+    g_reload_requested = 1;
 }
 
 /**
  * @brief Prints a usage error message to stderr.
  */
 static int usage_error(const char* prog_name) {
-    fprintf(stderr, "Usage: %s <config-file.yaml>\n", prog_name);
+    fprintf(stderr, "Usage: %s [--gateway] <config-file.yaml>\n", prog_name);
     return 1;
 }
 
+/**
+ * @brief Gateway mode: forwards the data of other nodes upstream instead of acquiring.
+ */
+static int run_gateway(const char* config_file) {
+    Gateway* gateway = gateway_create(config_file);
+    if (!gateway) {
+        fprintf(stderr, "[Main] Gateway creation failed. Exiting.\n");
+        return 1;
+    }
+
+    gateway_run(gateway, &g_shutdown_requested);
+    gateway_destroy(gateway);
+
+    printf("[Main] Shutdown complete.\n");
+    return 0;
+}
+
 /**
  * @brief The main entry point of the application.
  */
 int main(int argc, char **argv) {
     // Check if correct number of arguments was provided
-    if (argc != 2) {
+    bool gateway_mode = argc == 3 && strcmp(argv[1], "--gateway") == 0;
+    if (argc != 2 && !gateway_mode) {
         return usage_error(argv[0]);
     }
 
-    const char* config_file = argv[1];
+    const char* config_file = argv[argc - 1];
 
     // File accessibility validation before initialization
     if (access(config_file, R_OK) != 0) {
@@ -54,26 +86,39 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    struct sigaction reload_sa;
+    reload_sa.sa_handler = reload_signal_handler;
+    sigemptyset(&reload_sa.sa_mask);
+    reload_sa.sa_flags = SA_RESTART;
+    if (sigaction(SIGHUP, &reload_sa, NULL) == -1) {
+        perror("Failed to register SIGHUP handler");
+        return 1;
+    }
+
+    if (gateway_mode) {
+        return run_gateway(config_file);
+    }
+
     // Create and initialize the application manager with YAML config.
-    g_app_manager = app_manager_create(config_file);
-    if (!g_app_manager) {
+    ApplicationManager* app_manager = app_manager_create(config_file);
+    if (!app_manager) {
         fprintf(stderr, "[Main] Application creation failed. Exiting.\n");
         return 1;
     }
     
-    AppManagerError init_result = app_manager_init(g_app_manager);
+    AppManagerError init_result = app_manager_init(app_manager);
     if (init_result != APP_SUCCESS) {
         fprintf(stderr, "[Main] Application initialization failed: %s\n", 
                 app_manager_error_string(init_result));
-        app_manager_destroy(g_app_manager);
+        app_manager_destroy(app_manager);
         return 1;
     }
 
     // Run the main application loop.
-    app_manager_run(g_app_manager);
+    app_manager_run(app_manager, &g_shutdown_requested, &g_reload_requested);
 
     // Clean up and destroy the application manager.
-    app_manager_destroy(g_app_manager);
+    app_manager_destroy(app_manager);
 
     printf("[Main] Shutdown complete.\n");
     return 0;
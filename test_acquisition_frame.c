@@ -0,0 +1,73 @@
+#include "AcquisitionFrame.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+static AcquisitionFrame* publish(AcquisitionFrameStore* store, Channel channels[], int raw_value) {
+    AcquisitionFrame* frame = acquisition_frame_begin(store);
+    if (!frame) return NULL;
+    channel_update_raw_value(&channels[0], raw_value);
+    acquisition_frame_capture(frame, channels, 2, CHANNEL_MASK_BIT(0), NULL, 1.0, 1700000000.0);
+    acquisition_frame_publish(store, frame);
+    return frame;
+}
+
+int main(void) {
+    Channel channels[2];
+    for (int i = 0; i < 2; i++) {
+        channel_init(&channels[i]);
+        channels[i].is_active = true;
+    }
+    snprintf(channels[0].id, sizeof(channels[0].id), "v");
+    channels[0].slope = 0.5;
+    channels[0].offset = 1.0;
+    channel_set_calibrated_override(&channels[1], 42.0);
+
+    AcquisitionFrameStore* store = acquisition_frame_store_create(ACQUISITION_FRAME_POOL_SIZE);
+    if (!store) return fail("create failed");
+    if (acquisition_frame_acquire(store)) return fail("no frame expected before the first publish");
+
+    // Capture: calibrated once, synthetic channels carry no ADC code, no GPS = NAN
+    if (!publish(store, channels, 100)) return fail("begin failed");
+    const AcquisitionFrame* first = acquisition_frame_acquire(store);
+    if (!first || first->sequence != 1 || first->channel_count != 2) return fail("first frame mismatch");
+    if (strcmp(first->channels[0].id, "v") != 0 || first->channels[0].raw_adc_value != 100 ||
+        first->channels[0].value != channel_get_calibrated_value(&channels[0]) || !first->channels[0].has_raw_value) {
+        return fail("captured channel mismatch");
+    }
+    if (first->channels[1].has_raw_value || first->channels[1].value != 42.0) return fail("override not captured");
+    if (!isnan(first->gps.latitude) || first->fresh_mask != CHANNEL_MASK_BIT(0)) return fail("frame metadata mismatch");
+
+    // A held frame is never rewritten, however many sweeps follow
+    for (int sweep = 0; sweep < 3 * ACQUISITION_FRAME_POOL_SIZE; sweep++) {
+        AcquisitionFrame* frame = publish(store, channels, 200 + sweep);
+        if (!frame) return fail("free frames must be recycled");
+        if (frame == first) return fail("a held frame was handed out for writing");
+    }
+    if (first->channels[0].raw_adc_value != 100 || first->sequence != 1) return fail("held frame changed");
+
+    const AcquisitionFrame* latest = acquisition_frame_acquire(store);
+    if (latest->sequence != 1 + 3 * ACQUISITION_FRAME_POOL_SIZE) return fail("latest sequence mismatch");
+    acquisition_frame_release(store, latest);
+    acquisition_frame_release(store, first);
+
+    // Readers that never let go exhaust the pool: the producer is told instead of overwriting
+    const AcquisitionFrame* held[ACQUISITION_FRAME_POOL_SIZE];
+    int held_count = 0;
+    for (int i = 0; i < ACQUISITION_FRAME_POOL_SIZE; i++) {
+        held[held_count++] = acquisition_frame_acquire(store);
+        if (!publish(store, channels, 300 + i)) break;
+    }
+    if (acquisition_frame_begin(store)) return fail("begin must fail while every frame is held");
+    for (int i = 0; i < held_count; i++) acquisition_frame_release(store, held[i]);
+    if (!publish(store, channels, 400)) return fail("released frames must be reused");
+
+    acquisition_frame_store_destroy(store);
+    printf("Acquisition frame tests passed\n");
+    return 0;
+}
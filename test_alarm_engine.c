@@ -0,0 +1,102 @@
+#include "AlarmEngine.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+static void add_condition(AlarmRuleConfig* rule, const char* channel, AlarmConditionType type,
+                          double threshold, double hysteresis, double for_s) {
+    AlarmConditionConfig* condition = &rule->conditions[rule->condition_count++];
+    snprintf(condition->channel_id, sizeof(condition->channel_id), "%s", channel);
+    condition->type = type;
+    condition->threshold = threshold;
+    condition->hysteresis = hysteresis;
+    condition->for_s = for_s;
+}
+
+// Channel 0 is a voltage, channel 1 a current; both sampled at time_s
+static int sweep(AlarmEngine* engine, Channel channels[], double volts, double amps, double time_s) {
+    channel_set_calibrated_override(&channels[0], volts);
+    channel_set_calibrated_override(&channels[1], amps);
+    channels[0].sample_time_s = channels[1].sample_time_s = time_s;
+    return alarm_engine_process(engine, channels, CHANNEL_MASK_BIT(0) | CHANNEL_MASK_BIT(1), time_s);
+}
+
+int main(void) {
+    Channel channels[2];
+    for (int i = 0; i < 2; i++) {
+        channel_init(&channels[i]);
+        channels[i].is_active = true;
+    }
+    snprintf(channels[0].id, sizeof(channels[0].id), "v");
+    snprintf(channels[1].id, sizeof(channels[1].id), "i");
+
+    AlarmConfig config = {0};
+    AlarmRuleConfig* rule = &config.rules[config.rule_count++];
+    snprintf(rule->id, sizeof(rule->id), "unknown");
+    add_condition(rule, "missing", ALARM_CONDITION_ABOVE, 1.0, 0.0, 0.0);
+    if (alarm_engine_create(&config, channels, 2)) return fail("a rule on an unknown channel must be skipped");
+
+    // low_v: below 44 V for 1 s, releases at 44.5 V
+    rule = &config.rules[config.rule_count++];
+    snprintf(rule->id, sizeof(rule->id), "low_v");
+    rule->severity = ALARM_SEVERITY_CRITICAL;
+    add_condition(rule, "v", ALARM_CONDITION_BELOW, 44.0, 0.5, 1.0);
+
+    // overload: over 100 A while the voltage sags below 48 V
+    rule = &config.rules[config.rule_count++];
+    snprintf(rule->id, sizeof(rule->id), "overload");
+    add_condition(rule, "i", ALARM_CONDITION_ABOVE, 100.0, 0.0, 0.0);
+    add_condition(rule, "v", ALARM_CONDITION_BELOW, 48.0, 0.0, 0.0);
+
+    // surge: current changing faster than 200 A/s, or above 300 A
+    rule = &config.rules[config.rule_count++];
+    snprintf(rule->id, sizeof(rule->id), "surge");
+    rule->any = true;
+    add_condition(rule, "i", ALARM_CONDITION_RATE, 200.0, 0.0, 0.0);
+    add_condition(rule, "i", ALARM_CONDITION_ABOVE, 300.0, 0.0, 0.0);
+
+    AlarmEngine* engine = alarm_engine_create(&config, channels, 2);
+    if (!engine) return fail("create failed");
+
+    // Duration: the low voltage only counts after 1 s
+    if (sweep(engine, channels, 50.0, 10.0, 0.0) != 0) return fail("nothing must fire at rest");
+    if (sweep(engine, channels, 43.9, 10.0, 0.5) != 0) return fail("for_s must delay the alarm");
+    if (sweep(engine, channels, 43.8, 10.0, 1.5) != 1) return fail("alarm after for_s expected");
+    const AlarmEvent* event = alarm_engine_get_event(engine, 0);
+    if (strcmp(event->id, "low_v") != 0 || !event->raised || event->severity != ALARM_SEVERITY_CRITICAL ||
+        event->channel_index != 0 || event->value != 43.8) {
+        return fail("low_v event mismatch");
+    }
+
+    // Hysteresis: 44.2 V is still in the band, 44.6 V clears
+    if (sweep(engine, channels, 44.2, 10.0, 2.0) != 0) return fail("hysteresis must hold the alarm");
+    if (sweep(engine, channels, 44.6, 10.0, 2.5) != 1 || alarm_engine_get_event(engine, 0)->raised) {
+        return fail("alarm must clear past the hysteresis band");
+    }
+
+    // Combination: overload needs both channels; samples that are not fresh change nothing
+    channel_set_calibrated_override(&channels[1], 150.0);
+    if (alarm_engine_process(engine, channels, CHANNEL_MASK_BIT(0), 3.0) != 0) return fail("stale sample must be ignored");
+    if (sweep(engine, channels, 49.0, 110.0, 10.0) != 0) return fail("one condition of an all-rule must not raise it");
+    if (sweep(engine, channels, 47.0, 110.0, 11.0) != 1 || alarm_engine_get_event(engine, 0)->rule_index != 1) {
+        return fail("overload must raise with both conditions");
+    }
+    if (alarm_engine_active_count(engine) != 1) return fail("active count mismatch");
+
+    // Rate: 110 A -> 200 A in 0.1 s is 900 A/s
+    if (sweep(engine, channels, 47.0, 200.0, 11.1) != 1) return fail("surge must raise on the rate");
+    event = alarm_engine_get_event(engine, 0);
+    if (strcmp(event->id, "surge") != 0 || fabs(event->value - 900.0) > 1e-6) return fail("surge event mismatch");
+    if (sweep(engine, channels, 47.0, 200.0, 12.0) != 1 || alarm_engine_get_event(engine, 0)->raised) {
+        return fail("surge must clear when the current settles");
+    }
+
+    alarm_engine_destroy(engine);
+    printf("Alarm engine tests passed\n");
+    return 0;
+}
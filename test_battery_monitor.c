@@ -0,0 +1,138 @@
+#include "BatteryMonitor.h"
+#include "Channel.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+static void set_sample(Channel* channel, int raw, double time_s) {
+    channel_update_raw_value(channel, raw);
+    channel->sample_time_s = time_s;
+}
+
+// One pack on channel 0 (current) and optionally channel 1 (voltage); no state file
+static void reset_state(BatteryState* state, int packs) {
+    memset(state, 0, sizeof(*state));
+    state->enabled = true;
+    state->pack_count = packs;
+    for (int p = 0; p < packs; p++) {
+        state->capacity_Ah[p] = 100.0;
+        state->soc_percent[p] = 100.0;
+        state->current_index[p] = 0;
+        state->voltage_index[p] = -1;
+        state->last_power_W[p] = NAN;
+    }
+}
+
+static double throughput(const BatteryState* state, int p) {
+    return state->ah_in[p] + state->ah_out[p];
+}
+
+int main(void) {
+    Channel channels[3];
+    for (int i = 0; i < 3; i++) {
+        channel_init(&channels[i]);
+        channels[i].is_active = true;
+    }
+    channels[0].slope = 0.01; // raw counts -> amps
+    channels[2].slope = 0.01;
+
+    BatteryState state;
+    reset_state(&state, 1);
+
+    // A current ramp from 0 A to 36 A over 100 s, sampled with jittery spacing.
+    // Trapezoids are exact for a linear current: 0.5 * 36 A * 100 s = 0.5 Ah.
+    double t = 1000.0;
+    for (int step = 0; step <= 100; step++) {
+        double sample_t = t + step + ((step % 3) - 1) * 0.2 * (step > 0 && step < 100);
+        double current_A = 36.0 * (sample_t - t) / 100.0;
+        set_sample(&channels[0], (int)lround(current_A * 100.0), sample_t);
+        battery_monitor_update(&state, channels);
+        battery_monitor_update(&state, channels); // Same sample again must not double count
+    }
+    if (fabs(state.ah_out[0] - 0.5) > 1e-3 || state.ah_in[0] != 0.0) {
+        return fail("ramp should integrate to 0.5 Ah out");
+    }
+    if (fabs(state.soc_percent[0] - 99.5) > 1e-3) {
+        return fail("0.5 Ah out of 100 Ah should leave 99.5% SoC");
+    }
+
+    // Flagged samples break the chain: the gap around them is not integrated, even when
+    // the filtered value still passes validation
+    reset_state(&state, 1);
+    set_sample(&channels[0], 1000, 10.0);
+    battery_monitor_update(&state, channels);
+    channels[0].sample_quality_flags = CHANNEL_QUALITY_ABOVE_MAX;
+    set_sample(&channels[0], 90000, 11.0);
+    battery_monitor_update(&state, channels);
+    channels[0].sample_quality_flags = CHANNEL_QUALITY_OK;
+    set_sample(&channels[0], 1000, 12.0);
+    battery_monitor_update(&state, channels);
+    if (throughput(&state, 0) != 0.0) {
+        return fail("samples around a flagged one must not be integrated");
+    }
+
+    // Gaps longer than the limit are not bridged either
+    set_sample(&channels[0], 1000, 12.0 + BATTERY_MAX_INTEGRATION_GAP_S + 1.0);
+    battery_monitor_update(&state, channels);
+    if (throughput(&state, 0) != 0.0) {
+        return fail("long gaps must not be integrated");
+    }
+
+    // Charging and discharging cancel in SoC but both count as throughput
+    reset_state(&state, 1);
+    state.soc_percent[0] = 50.0;
+    set_sample(&channels[0], 3600, 20.0);
+    battery_monitor_update(&state, channels);
+    set_sample(&channels[0], -3600, 22.0);
+    battery_monitor_update(&state, channels);
+    if (fabs(state.soc_percent[0] - 50.0) > 1e-9) {
+        return fail("symmetric charge/discharge should leave SoC unchanged");
+    }
+    // Two triangles of 36 A x 1 s each
+    if (fabs(state.ah_out[0] - 0.5 * 36.0 / 3600.0) > 1e-9 || fabs(state.ah_in[0] - 0.5 * 36.0 / 3600.0) > 1e-9) {
+        return fail("a zero crossing should split the charge into Ah out and Ah in");
+    }
+
+    // Two packs in one update: pack 0 with a 12 V voltage channel, pack 1 charging on its own current
+    reset_state(&state, 2);
+    state.voltage_index[0] = 1;
+    state.current_index[1] = 2;
+    channels[1].slope = 0.001;
+    channel_update_raw_value(&channels[1], 12000);
+    for (int step = 0; step <= 10; step++) {
+        set_sample(&channels[0], 1000, 30.0 + step);  // 10 A discharge
+        set_sample(&channels[2], -500, 30.0 + step);  // 5 A charge
+        battery_monitor_update(&state, channels);
+    }
+    if (fabs(state.ah_out[0] - 100.0 / 3600.0) > 1e-9 || fabs(state.ah_in[1] - 50.0 / 3600.0) > 1e-9) {
+        return fail("each pack should integrate its own current");
+    }
+    if (fabs(state.energy_Wh[0] - 120.0 * 10.0 / 3600.0) > 1e-9) {
+        return fail("pack energy should integrate V x I");
+    }
+    if (!isnan(battery_monitor_get_value(&state, 1, BATTERY_CHANNEL_ENERGY))) {
+        return fail("a pack without a voltage channel has no energy value");
+    }
+    if (battery_monitor_get_value(&state, 1, BATTERY_CHANNEL_SOC) != 100.0) {
+        return fail("charging a full pack should keep it at 100%");
+    }
+
+    // Power uses the unfiltered voltage sample, as the energy meter does: a lagging filter is ignored
+    reset_state(&state, 1);
+    state.voltage_index[0] = 1;
+    channels[1].filtered_adc_value = 10000.0; // Filter still at 10 V after a step to 12 V
+    for (int step = 0; step <= 10; step++) {
+        set_sample(&channels[0], 1000, 50.0 + step);
+        battery_monitor_update(&state, channels);
+    }
+    if (fabs(state.energy_Wh[0] - 120.0 * 10.0 / 3600.0) > 1e-9) {
+        return fail("pack energy should use the unfiltered voltage sample");
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "CalibrationSession.h"
+#include <stdio.h>
+#include <math.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+// Feeds one point: the channel reads around `adc` with ±1 count of noise and one glitch
+static void capture_point(CalibrationSession* session, Channel channels[], int adc, int samples) {
+    for (int n = 0; n < samples; n++) {
+        channels[1].raw_adc_value = (n == 3) ? adc + 5000 : adc + (n % 3) - 1;
+        channels[0].raw_adc_value = -20000; // Other channels never enter the point
+        calibration_session_add_samples(session, channels, CHANNEL_MASK_BIT(0) | CHANNEL_MASK_BIT(1));
+    }
+}
+
+int main(void) {
+    Channel channels[2];
+    for (int i = 0; i < 2; i++) channel_init(&channels[i]);
+
+    CalibrationSession* session = calibration_session_create();
+    if (!session) return fail("create failed");
+
+    if (calibration_session_capture(session, 1.0)) return fail("capture without a session must fail");
+    if (calibration_session_start(session, 1, 3)) return fail("too few samples per point must be rejected");
+    if (!calibration_session_start(session, 1, 30)) return fail("start failed");
+
+    // Samples arriving while no point is requested are ignored
+    capture_point(session, channels, 100, 10);
+    CalibrationSessionStatus status;
+    calibration_session_get_status(session, &status);
+    if (status.state != CALIBRATION_SESSION_WAITING || status.samples_captured != 0) {
+        return fail("samples before a point request must be ignored");
+    }
+
+    // value = 0.002 * adc - 1.5, three points; the glitch is rejected at every point
+    const int adc[] = { 1000, 6000, 11000 };
+    for (int p = 0; p < 3; p++) {
+        if (!calibration_session_capture(session, 0.002 * adc[p] - 1.5)) return fail("capture failed");
+        if (calibration_session_capture(session, 0.0)) return fail("a second point must wait for the first");
+        capture_point(session, channels, adc[p], 29);
+        calibration_session_get_status(session, &status);
+        if (status.state != CALIBRATION_SESSION_CAPTURING || status.samples_captured != 29) {
+            return fail("point must finish after samples_per_point samples");
+        }
+        if (p == 0 && calibration_session_apply(session)) return fail("apply while capturing must fail");
+        capture_point(session, channels, adc[p], 1);
+        calibration_session_get_status(session, &status);
+        if (status.point_count != p + 1 || status.last_rejected != 1) return fail("glitch must be rejected");
+        if (fabs(status.last_raw_mean - adc[p]) > 0.05) return fail("point mean mismatch");
+        if (p == 0 && (!isnan(status.slope) || calibration_session_apply(session))) {
+            return fail("one point must not give a fit");
+        }
+    }
+
+    if (fabs(status.slope - 0.002) > 1e-7 || fabs(status.offset + 1.5) > 1e-4 || status.r_squared < 0.999999) {
+        return fail("fit mismatch");
+    }
+
+    // Applying hands the fit over exactly once
+    int index;
+    double slope, offset;
+    if (calibration_session_take_result(session, &index, &slope, &offset)) return fail("result before apply");
+    if (!calibration_session_apply(session)) return fail("apply failed");
+    if (calibration_session_start(session, 0, 0)) return fail("a pending fit must not be discarded");
+    if (!calibration_session_take_result(session, &index, &slope, &offset) || index != 1 || slope != status.slope) {
+        return fail("take result mismatch");
+    }
+    if (calibration_session_take_result(session, &index, &slope, &offset)) return fail("result taken twice");
+
+    // A scattered set of points reports a lower R²; cancel leaves nothing to apply
+    if (!calibration_session_start(session, 1, 0)) return fail("restart failed");
+    const double reference[] = { 0.0, 3.0, 1.0 };
+    for (int p = 0; p < 3; p++) {
+        calibration_session_capture(session, reference[p]);
+        capture_point(session, channels, 1000 * (p + 1), CALIBRATION_SESSION_DEFAULT_SAMPLES);
+    }
+    calibration_session_get_status(session, &status);
+    if (status.point_count != 3 || fabs(status.r_squared - 3.0 / 28.0) > 1e-3) return fail("R² of scattered points mismatch");
+    calibration_session_cancel(session);
+    if (calibration_session_apply(session)) return fail("cancelled session must not apply");
+
+    calibration_session_destroy(session);
+    printf("Calibration session tests passed\n");
+    return 0;
+}
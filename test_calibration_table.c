@@ -0,0 +1,89 @@
+#include "CalibrationTable.h"
+#include <stdio.h>
+#include <math.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+int main(void) {
+    Channel channels[3];
+    for (int i = 0; i < 3; i++) channel_init(&channels[i]);
+
+    // 0: linear, 1: cubic polynomial, 2: piecewise thermistor-like curve without a lookup table
+    channels[0].slope = 0.5;
+    channels[0].offset = -10.0;
+
+    channels[1].calibration_type = CHANNEL_CALIBRATION_POLYNOMIAL;
+    channels[1].calibration_term_count = 4;
+    channels[1].calibration_terms[0] = 1.0;
+    channels[1].calibration_terms[1] = 2e-3;
+    channels[1].calibration_terms[2] = -1e-7;
+    channels[1].calibration_terms[3] = 5e-12;
+
+    channels[2].calibration_type = CHANNEL_CALIBRATION_PIECEWISE;
+    channels[2].calibration_lut = false;
+    channels[2].calibration_point_count = 3;
+    const double raw_points[] = { 1000, 5000, 20000 };
+    const double value_points[] = { 100.0, 50.0, 0.0 };
+    for (int k = 0; k < 3; k++) {
+        channels[2].calibration_point_raw[k] = raw_points[k];
+        channels[2].calibration_point_value[k] = value_points[k];
+    }
+
+    CalibrationTable* table = calibration_table_create();
+    if (!table || !calibration_table_attach(table, channels, 3)) return fail("attach failed");
+    if (channels[0].calibration_curve || !channels[1].calibration_curve || !channels[2].calibration_curve) {
+        return fail("only non-linear channels get a curve");
+    }
+    if (!channels[1].calibration_curve->lut || channels[2].calibration_curve->lut) {
+        return fail("lookup tables must follow calibration_lut");
+    }
+
+    // Linear path unchanged
+    channels[0].raw_adc_value = 100;
+    if (channel_get_sample_value(&channels[0]) != 40.0) return fail("linear calibration changed");
+
+    // Polynomial: the raw-code table and Horner evaluation agree with the formula at every code tested
+    for (int raw = -32768; raw <= 32767; raw += 511) {
+        double x = raw;
+        double expected = 1.0 + 2e-3 * x - 1e-7 * x * x + 5e-12 * x * x * x;
+        channels[1].raw_adc_value = raw;
+        if (fabs(channel_get_sample_value(&channels[1]) - expected) > 1e-5 * (1.0 + fabs(expected))) {
+            return fail("polynomial lookup table mismatch");
+        }
+        if (fabs(channel_calibrate(&channels[1], x + 0.5) -
+                 (1.0 + 2e-3 * (x + 0.5) - 1e-7 * (x + 0.5) * (x + 0.5) + 5e-12 * pow(x + 0.5, 3))) > 1e-9) {
+            return fail("polynomial evaluation of filtered values mismatch");
+        }
+    }
+
+    // Piecewise: interpolation inside, extrapolation of the end segments outside
+    if (fabs(channel_calibrate(&channels[2], 3000.0) - 75.0) > 1e-9) return fail("piecewise interpolation mismatch");
+    if (fabs(channel_calibrate(&channels[2], 12500.0) - 25.0) > 1e-9) return fail("piecewise second segment mismatch");
+    if (fabs(channel_calibrate(&channels[2], 0.0) - 112.5) > 1e-9) return fail("piecewise low extrapolation mismatch");
+    if (fabs(channel_calibrate(&channels[2], 23000.0) + 10.0) > 1e-9) return fail("piecewise high extrapolation mismatch");
+
+    // The filtered value goes through the curve as well
+    channels[2].filtered_adc_value = 5000.0;
+    if (fabs(channel_get_calibrated_value(&channels[2]) - 50.0) > 1e-9) return fail("filtered value must use the curve");
+
+    // Re-attaching an unchanged curve keeps its lookup table; switching to linear drops the curve
+    const float* lut = channels[1].calibration_curve->lut;
+    calibration_table_attach(table, channels, 3);
+    if (channels[1].calibration_curve->lut != lut) return fail("unchanged curve must not be rebuilt");
+    channels[1].calibration_type = CHANNEL_CALIBRATION_LINEAR;
+    calibration_table_attach(table, channels, 3);
+    if (channels[1].calibration_curve) return fail("linear channel must not keep a curve");
+
+    // Invalid points fall back to linear
+    channels[2].calibration_point_raw[1] = 500.0;
+    if (calibration_table_attach(table, channels, 3) || channels[2].calibration_curve) {
+        return fail("non-increasing points must be rejected");
+    }
+
+    calibration_table_destroy(table);
+    printf("Calibration table tests passed\n");
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "ChannelSpectrum.h"
+#include "FFT.h"
+#include <stdio.h>
+#include <math.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+// Compares the real FFT with a direct DFT of the same input
+static bool matches_direct_dft(int size) {
+    float input[256], re[129], im[129];
+    for (int n = 0; n < size; n++) {
+        input[n] = (float)(sin(0.37 * n) + 0.5 * cos(1.9 * n + 0.3) + (n % 7) * 0.1);
+    }
+
+    FFT* fft = fft_create(size);
+    if (!fft) return false;
+    fft_forward_real(fft, input, re, im);
+    fft_destroy(fft);
+
+    for (int k = 0; k <= size / 2; k++) {
+        double dft_re = 0.0, dft_im = 0.0;
+        for (int n = 0; n < size; n++) {
+            dft_re += input[n] * cos(2.0 * M_PI * k * n / size);
+            dft_im -= input[n] * sin(2.0 * M_PI * k * n / size);
+        }
+        if (fabs(re[k] - dft_re) > 1e-3 || fabs(im[k] - dft_im) > 1e-3) {
+            fprintf(stderr, "size %d bin %d: (%f, %f) vs (%f, %f)\n", size, k, re[k], im[k], dft_re, dft_im);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void) {
+    if (fft_create(48) || fft_create(2)) return fail("non power-of-two or tiny sizes must be rejected");
+
+    // 8 and 32 take a radix-2 stage before the radix-4 passes, 16 and 256 do not
+    const int sizes[] = { 8, 16, 32, 256 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        if (!matches_direct_dft(sizes[s])) return fail("FFT does not match the direct DFT");
+    }
+
+    Channel channels[2];
+    for (int i = 0; i < 2; i++) channel_init(&channels[i]);
+    channels[0].spectrum_size = 256;
+    channels[0].spectrum_band_count = 2;
+    channels[0].spectrum_band_edges_hz[0] = 0.0;
+    channels[0].spectrum_band_edges_hz[1] = 10.0;
+    channels[0].spectrum_band_edges_hz[2] = 15.0;
+
+    ChannelSpectrumTable* table = channel_spectrum_create(channels, 2);
+    if (!table) return fail("create failed");
+    if (!channel_spectrum_is_enabled(table, 0) || channel_spectrum_is_enabled(table, 1)) {
+        return fail("only the configured channel must be analysed");
+    }
+
+    // 12.5 Hz sine of amplitude 2 on a DC offset of 5, sampled at 100 Hz
+    ChannelSpectrumResult result;
+    for (int n = 0; n < 256; n++) {
+        if (channel_spectrum_take(table, 0, &result)) return fail("result before the block is full");
+        channel_spectrum_add(table, 0, 5.0 + 2.0 * sin(2.0 * M_PI * 12.5 * n / 100.0), 10.0 + n / 100.0);
+    }
+    if (!channel_spectrum_take(table, 0, &result)) return fail("no result after a full block");
+    if (channel_spectrum_take(table, 0, &result)) return fail("a result must be taken only once");
+
+    if (fabs(result.sample_rate_hz - 100.0) > 1e-6) return fail("sample rate mismatch");
+    if (fabs(result.dominant_hz - 12.5) > 0.05) return fail("dominant frequency mismatch");
+    if (fabs(result.dominant_amplitude - 2.0) > 0.02) return fail("dominant amplitude mismatch");
+    if (fabs(result.ac_rms - sqrt(2.0)) > 0.01) return fail("AC RMS must match the sine RMS");
+    if (result.band_count != 2 || result.band_rms[0] > 0.01 || fabs(result.band_rms[1] - sqrt(2.0)) > 0.01) {
+        return fail("band energy must fall in the 10-15 Hz band only");
+    }
+
+    // Off-bin frequency: interpolation lands between bins
+    for (int n = 0; n < 256; n++) {
+        channel_spectrum_add(table, 0, sin(2.0 * M_PI * 20.2 * n / 100.0), 20.0 + n / 100.0);
+    }
+    if (!channel_spectrum_take(table, 0, &result) || fabs(result.dominant_hz - 20.2) > 0.1) {
+        return fail("off-bin frequency mismatch");
+    }
+
+    // A new block size restarts the block
+    for (int n = 0; n < 100; n++) channel_spectrum_add(table, 0, n % 2, 30.0 + n / 100.0);
+    channels[0].spectrum_size = 64;
+    if (!channel_spectrum_configure(table, channels, 2)) return fail("configure failed");
+    for (int n = 0; n < 63; n++) channel_spectrum_add(table, 0, n % 2, 40.0 + n / 100.0);
+    if (channel_spectrum_take(table, 0, &result)) return fail("resized block must start empty");
+    channel_spectrum_add(table, 0, 1.0, 40.63);
+    if (!channel_spectrum_take(table, 0, &result) || fabs(result.dominant_hz - 50.0) > 0.5) {
+        return fail("resized block result mismatch");
+    }
+
+    channel_spectrum_destroy(table);
+    printf("Channel spectrum tests passed\n");
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "ChannelStats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define SAMPLES 3000
+#define SLIDING_WINDOW 50
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+static bool close_to(double a, double b) {
+    return fabs(a - b) <= 1e-9 * (1.0 + fabs(b));
+}
+
+// Two-pass reference over values[start, end)
+static ChannelStatsSummary naive_stats(const double* values, int start, int end) {
+    ChannelStatsSummary s = { .count = (uint32_t)(end - start), .min = INFINITY, .max = -INFINITY };
+    double sum = 0.0, sum_sq = 0.0;
+    for (int i = start; i < end; i++) {
+        sum += values[i];
+        sum_sq += values[i] * values[i];
+        if (values[i] < s.min) s.min = values[i];
+        if (values[i] > s.max) s.max = values[i];
+    }
+    s.mean = sum / s.count;
+    double m2 = 0.0;
+    for (int i = start; i < end; i++) {
+        m2 += (values[i] - s.mean) * (values[i] - s.mean);
+    }
+    s.stddev = s.count > 1 ? sqrt(m2 / (s.count - 1)) : 0.0;
+    s.rms = sqrt(sum_sq / s.count);
+    s.peak_to_peak = s.max - s.min;
+    return s;
+}
+
+static bool matches(const ChannelStatsSummary* got, const ChannelStatsSummary* want) {
+    return got->count == want->count && close_to(got->mean, want->mean) &&
+           close_to(got->stddev, want->stddev) && got->min == want->min &&
+           got->max == want->max && close_to(got->rms, want->rms) &&
+           close_to(got->peak_to_peak, want->peak_to_peak);
+}
+
+int main(void) {
+    Channel channels[3];
+    for (int i = 0; i < 3; i++) channel_init(&channels[i]);
+    channels[0].stats_window = CHANNEL_STATS_WINDOW_TUMBLING;
+    channels[1].stats_window = CHANNEL_STATS_WINDOW_SLIDING;
+    channels[1].stats_window_samples = SLIDING_WINDOW;
+    channels[2].stats_quantiles = true; // Sketch only, no window
+
+    ChannelStatsTable* table = channel_stats_create(channels, 3);
+    if (!table) return fail("create failed");
+    if (channel_stats_is_enabled(table, 2)) return fail("channel without a window must be disabled");
+    if (channel_stats_get_sketch(table, 0) || !channel_stats_get_sketch(table, 2)) {
+        return fail("only channels with quantiles get a sketch");
+    }
+
+    // Offset noisy signal with slow drift: stresses cancellation in the running sums
+    static double values[SAMPLES];
+    srand(42);
+    for (int i = 0; i < SAMPLES; i++) {
+        values[i] = 1000.0 + 0.01 * i + (double)rand() / RAND_MAX;
+    }
+
+    ChannelStatsSummary got, want;
+    int period_start = 0;
+    for (int i = 0; i < SAMPLES; i++) {
+        channel_stats_add(table, 0, values[i]);
+        channel_stats_add(table, 1, values[i]);
+        channel_stats_add(table, 2, values[i]);
+
+        int start = i + 1 > SLIDING_WINDOW ? i + 1 - SLIDING_WINDOW : 0;
+        want = naive_stats(values, start, i + 1);
+        if (!channel_stats_get(table, 1, &got) || !matches(&got, &want)) {
+            fprintf(stderr, "sliding window mismatch at sample %d\n", i);
+            return 1;
+        }
+
+        // Publish every 700 samples
+        if ((i + 1) % 700 == 0) {
+            want = naive_stats(values, period_start, i + 1);
+            if (!channel_stats_get(table, 0, &got) || !matches(&got, &want)) {
+                fprintf(stderr, "tumbling window mismatch at sample %d\n", i);
+                return 1;
+            }
+            channel_stats_end_period(table, 0);
+            channel_stats_end_period(table, 1);
+            period_start = i + 1;
+        }
+    }
+
+    // A reported tumbling window starts over; a sliding window keeps its samples
+    channel_stats_end_period(table, 0);
+    if (channel_stats_get(table, 0, &got)) return fail("tumbling window must be empty after end_period");
+    if (!channel_stats_get(table, 1, &got) || got.count != SLIDING_WINDOW) {
+        return fail("sliding window must survive end_period");
+    }
+
+    // The sketch covers every sample regardless of publishing
+    if (quantile_sketch_count(channel_stats_get_sketch(table, 2)) != SAMPLES) {
+        return fail("sketch must count every sample");
+    }
+
+    // Non-finite samples are ignored
+    channel_stats_add(table, 0, NAN);
+    channel_stats_add(table, 0, INFINITY);
+    if (channel_stats_get(table, 0, &got)) return fail("non-finite samples must be ignored");
+
+    // Reconfiguring an unchanged window keeps its data; a resized one starts over
+    if (!channel_stats_configure(table, channels, 3)) return fail("configure failed");
+    if (!channel_stats_get(table, 1, &got) || got.count != SLIDING_WINDOW) {
+        return fail("unchanged window must keep its samples");
+    }
+    channels[1].stats_window_samples = 10;
+    if (!channel_stats_configure(table, channels, 3)) return fail("reconfigure failed");
+    if (channel_stats_get(table, 1, &got)) return fail("resized window must start empty");
+
+    channel_stats_destroy(table);
+    printf("Channel stats tests passed\n");
+    return 0;
+}
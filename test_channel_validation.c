@@ -0,0 +1,92 @@
+#include "Channel.h"
+#include "ChannelValidation.h"
+#include <stdio.h>
+#include <math.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+int main(void) {
+    Channel channels[3];
+    for (int i = 0; i < 3; i++) {
+        channel_init(&channels[i]);
+    }
+
+    // Channel 0: range only, channel 1: watchdog only, channel 2: unconfigured
+    channels[0].min_value = -10.0;
+    channels[0].max_value = 10.0;
+    channels[1].timeout_threshold_s = 2.0;
+
+    ValidationTable table;
+    validation_table_build(&table, channels, 3, 100.0);
+
+    table.value[0] = 5.0;
+    table.value[1] = 1.0;
+    table.value[2] = 1e9;
+    if (validation_table_evaluate(&table, 101.0) != 0) {
+        return fail("in-range fresh values should not be flagged");
+    }
+
+    table.value[0] = -11.0;
+    validation_table_evaluate(&table, 101.0);
+    if (table.flags[0] != CHANNEL_QUALITY_BELOW_MIN) {
+        return fail("value below min_value should set BELOW_MIN");
+    }
+
+    table.value[0] = 11.0;
+    validation_table_evaluate(&table, 101.0);
+    if (table.flags[0] != CHANNEL_QUALITY_ABOVE_MAX) {
+        return fail("value above max_value should set ABOVE_MAX");
+    }
+
+    table.value[0] = NAN;
+    validation_table_evaluate(&table, 101.0);
+    if (table.flags[0] != CHANNEL_QUALITY_INVALID) {
+        return fail("NaN should set INVALID only");
+    }
+    if (table.violation_count[0] != 3) {
+        return fail("violation counter should count flagged sweeps");
+    }
+
+    // The unfiltered sample is checked on its own: a smoothed value can pass while it fails
+    table.value[0] = 5.0;
+    table.sample[0] = 12.0;
+    validation_table_evaluate(&table, 101.0);
+    if (table.flags[0] != CHANNEL_QUALITY_OK || table.sample_flags[0] != CHANNEL_QUALITY_ABOVE_MAX) {
+        return fail("out-of-range sample should be flagged apart from the filtered value");
+    }
+    table.sample[0] = NAN;
+    validation_table_evaluate(&table, 101.0);
+    if (table.sample_flags[0] != CHANNEL_QUALITY_INVALID) {
+        return fail("NaN sample should set INVALID");
+    }
+    table.sample[0] = 0.0;
+
+    // Watchdog: channel 1 last read at 100 s, threshold 2 s
+    if (validation_table_evaluate(&table, 103.0) < 1 || table.flags[1] != CHANNEL_QUALITY_STALE) {
+        return fail("channel without reads past its timeout should be STALE");
+    }
+    if (table.flags[2] != CHANNEL_QUALITY_OK) {
+        return fail("channel without a timeout must never go stale");
+    }
+
+    validation_table_mark_updated(&table, 1, 103.0);
+    validation_table_evaluate(&table, 103.5);
+    if (table.flags[1] != CHANNEL_QUALITY_OK) {
+        return fail("fresh read should clear STALE");
+    }
+
+    // Reloading limits keeps the watchdog timers
+    channels[0].max_value = 20.0;
+    validation_table_update_limits(&table, channels, 3);
+    table.value[0] = 15.0;
+    validation_table_evaluate(&table, 104.0);
+    if (table.flags[0] != CHANNEL_QUALITY_OK || table.flags[1] != CHANNEL_QUALITY_OK) {
+        return fail("updated limits should apply without resetting timers");
+    }
+
+    printf("Channel validation test passed\n");
+    return 0;
+}
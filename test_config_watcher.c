@@ -0,0 +1,184 @@
+#include "ConfigWatcher.h"
+#include "ConfigYAML.h"
+#include "EventLoop.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CONFIG_PATH "test_config_watcher.yaml"
+#define POLL_TIMEOUT_MS 3000
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+// What the tests vary in the configuration file
+typedef struct {
+    double slope;             // Hot-reloadable
+    const char* pin;          // Channel layout: restart
+    double alarm_below;       // Alarm rule: restart
+    const char* mqtt_topic;   // MQTT section: restart
+    const char* meter_state;  // Energy meter: restart
+} ConfigVariant;
+
+static const ConfigVariant BASE = { 0.002, "A0", 44.0, "daq/measurements", "./logs/energy_main.bin" };
+
+static bool write_config(const ConfigVariant* variant) {
+    FILE* file = fopen(CONFIG_PATH, "w");
+    if (!file) return false;
+    fprintf(file,
+            "hardware:\n"
+            "  i2c_bus: \"/dev/null\"\n"
+            "  boards:\n"
+            "    - address: 0x48\n"
+            "system:\n"
+            "  main_loop_interval_ms: 100\n"
+            "  data_send_interval_ms: 500\n"
+            "channels:\n"
+            "  - board_address: 0x48\n"
+            "    pin: \"%s\"\n"
+            "    id: \"pack_current\"\n"
+            "    unit: \"A\"\n"
+            "    calibration:\n"
+            "      slope: %.6f\n"
+            "      offset: -27.6\n"
+            "  - board_address: 0x48\n"
+            "    pin: \"A3\"\n"
+            "    id: \"pack_voltage\"\n"
+            "    unit: \"V\"\n"
+            "influxdb:\n"
+            "  url: \"localhost\"\n"
+            "  bucket: \"b\"\n"
+            "  org: \"o\"\n"
+            "  token: \"t\"\n"
+            "energy:\n"
+            "  meters:\n"
+            "    - id: \"main\"\n"
+            "      voltage_channel_id: \"pack_voltage\"\n"
+            "      current_channel_id: \"pack_current\"\n"
+            "      state_file: \"%s\"\n"
+            "alarms:\n"
+            "  rules:\n"
+            "    - id: \"low_voltage\"\n"
+            "      severity: critical\n"
+            "      conditions:\n"
+            "        - channel: \"pack_voltage\"\n"
+            "          below: %.1f\n"
+            "          hysteresis: 0.5\n"
+            "mqtt:\n"
+            "  host: \"localhost\"\n"
+            "  client_id: \"daq-test\"\n"
+            "  topic: \"%s\"\n",
+            variant->pin, variant->slope, variant->meter_state, variant->alarm_below, variant->mqtt_topic);
+    return fclose(file) == 0;
+}
+
+static YAMLAppConfig* load_variant(const ConfigVariant* variant) {
+    return write_config(variant) ? config_yaml_load(CONFIG_PATH) : NULL;
+}
+
+// Returns true if the variant may replace the base configuration at runtime
+static bool reload_compatible(const YAMLAppConfig* base, const ConfigVariant* variant, char* message, size_t size) {
+    YAMLAppConfig* candidate = load_variant(variant);
+    if (!candidate) return false;
+    bool compatible = config_yaml_check_reload_compatible(base, candidate, message, size) == CONFIG_YAML_SUCCESS;
+    config_yaml_free(candidate);
+    return compatible;
+}
+
+static ConfigReloadStatus wait_for_reload(ConfigWatcher* watcher, YAMLAppConfig** new_config,
+                                          char* message, size_t size) {
+    for (int waited = 0; waited < POLL_TIMEOUT_MS; waited += 10) {
+        ConfigReloadStatus status = config_watcher_poll(watcher, new_config, message, size);
+        if (status != CONFIG_RELOAD_NONE) return status;
+        usleep(10000);
+    }
+    return CONFIG_RELOAD_NONE;
+}
+
+int main(void) {
+    char message[512];
+    YAMLAppConfig* base = load_variant(&BASE);
+    if (!base) return fail("Cannot load the base configuration");
+
+    // A second parse of the same file compares equal, field by field
+    if (!reload_compatible(base, &BASE, message, sizeof(message))) return fail(message);
+
+    ConfigVariant calibrated = BASE;
+    calibrated.slope = 0.0021;
+    if (!reload_compatible(base, &calibrated, message, sizeof(message))) return fail("calibration change rejected");
+
+    ConfigVariant moved = BASE;
+    moved.pin = "A1";
+    if (reload_compatible(base, &moved, message, sizeof(message)) || !strstr(message, "channel 0")) {
+        return fail("channel pin change accepted");
+    }
+
+    ConfigVariant alarm = BASE;
+    alarm.alarm_below = 43.0;
+    if (reload_compatible(base, &alarm, message, sizeof(message)) || !strstr(message, "alarm rule 0")) {
+        return fail("alarm rule change accepted");
+    }
+
+    ConfigVariant topic = BASE;
+    topic.mqtt_topic = "daq/other";
+    if (reload_compatible(base, &topic, message, sizeof(message)) || !strstr(message, "mqtt")) {
+        return fail("mqtt change accepted");
+    }
+
+    ConfigVariant meter = BASE;
+    meter.meter_state = "./logs/energy_other.bin";
+    if (reload_compatible(base, &meter, message, sizeof(message)) || !strstr(message, "energy meter 0")) {
+        return fail("energy meter change accepted");
+    }
+
+    // The watcher: rewrites of the file and explicit requests
+    if (!write_config(&BASE)) return fail("Cannot restore the base configuration");
+    EventLoop* loop = event_loop_create();
+    ConfigWatcher* watcher = config_watcher_create(CONFIG_PATH, base);
+    if (!loop || !watcher || !config_watcher_start(watcher, loop) || !event_loop_start(loop)) {
+        return fail("Cannot start the config watcher");
+    }
+
+    YAMLAppConfig* reloaded = NULL;
+    if (config_watcher_poll(watcher, &reloaded, message, sizeof(message)) != CONFIG_RELOAD_NONE) {
+        return fail("reload reported without a change");
+    }
+
+    if (!write_config(&calibrated) ||
+        wait_for_reload(watcher, &reloaded, message, sizeof(message)) != CONFIG_RELOAD_READY || !reloaded) {
+        return fail("rewritten file not reloaded");
+    }
+    if (reloaded->channels[0].slope != 0.0021) return fail("reloaded configuration not the new file");
+    config_yaml_free(reloaded);
+    reloaded = NULL;
+
+    if (!write_config(&moved) ||
+        wait_for_reload(watcher, &reloaded, message, sizeof(message)) != CONFIG_RELOAD_REJECTED ||
+        reloaded || !strstr(message, "restart required")) {
+        return fail("structural change not rejected");
+    }
+
+    // A request reloads the file as it is now
+    if (!write_config(&BASE)) return fail("Cannot restore the base configuration");
+    if (wait_for_reload(watcher, &reloaded, message, sizeof(message)) != CONFIG_RELOAD_READY) {
+        return fail("restored file not reloaded");
+    }
+    config_yaml_free(reloaded);
+    reloaded = NULL;
+    config_watcher_request_reload(watcher);
+    if (wait_for_reload(watcher, &reloaded, message, sizeof(message)) != CONFIG_RELOAD_READY || !reloaded) {
+        return fail("requested reload not done");
+    }
+    config_yaml_free(reloaded);
+
+    event_loop_stop(loop);
+    config_watcher_destroy(watcher);
+    event_loop_destroy(loop);
+    config_yaml_free(base);
+    unlink(CONFIG_PATH);
+    printf("config watcher test passed\n");
+    return 0;
+}
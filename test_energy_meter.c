@@ -0,0 +1,110 @@
+#include "EnergyMeter.h"
+#include "StateStore.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define STATE_FILE "/tmp/energy_meter_test.bin"
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+// Channel 0 is the voltage, channel 1 the current (raw counts x 0.01)
+static void set_sample(Channel channels[], int volts_raw, int amps_raw, double time_s) {
+    channel_update_raw_value(&channels[0], volts_raw);
+    channel_update_raw_value(&channels[1], amps_raw);
+    channels[0].sample_time_s = time_s;
+    channels[1].sample_time_s = time_s;
+}
+
+static EnergyMeter* create_meter(const Channel channels[]) {
+    EnergyConfig config = {0};
+    config.meter_count = 1;
+    snprintf(config.meters[0].id, sizeof(config.meters[0].id), "motor");
+    snprintf(config.meters[0].voltage_channel_id, sizeof(config.meters[0].voltage_channel_id), "v");
+    snprintf(config.meters[0].current_channel_id, sizeof(config.meters[0].current_channel_id), "i");
+    snprintf(config.meters[0].state_file, sizeof(config.meters[0].state_file), STATE_FILE);
+    return energy_meter_create(&config, channels, 2);
+}
+
+int main(void) {
+    Channel channels[2];
+    for (int i = 0; i < 2; i++) {
+        channel_init(&channels[i]);
+        channels[i].is_active = true;
+        channels[i].slope = 0.01;
+    }
+    snprintf(channels[0].id, sizeof(channels[0].id), "v");
+    snprintf(channels[1].id, sizeof(channels[1].id), "i");
+    unlink(STATE_FILE);
+
+    EnergyMeter* meter = create_meter(channels);
+    if (!meter || energy_meter_count(meter) != 1) return fail("create failed");
+
+    // 50 V while the current ramps from +10 A to -10 A over 2 s: the crossing at 1 s splits
+    // each interval, giving 2.5 mAh (125 mWh at 50 V) each way
+    for (int step = 0; step <= 4; step++) {
+        set_sample(channels, 5000, 1000 - 500 * step, 100.0 + 0.5 * step);
+        energy_meter_update(meter, channels);
+        energy_meter_update(meter, channels); // Same sample again must not count twice
+    }
+    EnergyTotals totals;
+    energy_meter_get_totals(meter, 0, &totals);
+    if (fabs(totals.ah_out - 10.0 / 3600.0 / 2.0 * 1.0) > 1e-12 || fabs(totals.ah_in - totals.ah_out) > 1e-12) {
+        return fail("charge must split at the zero crossing");
+    }
+    if (fabs(totals.wh_out - 0.5 * 500.0 * 1.0 / 3600.0) > 1e-12 || fabs(totals.wh_in - totals.wh_out) > 1e-12) {
+        return fail("energy must split at the zero crossing");
+    }
+    if (totals.peak_out_w != 500.0 || totals.peak_in_w != 500.0) return fail("peak power mismatch");
+
+    // A bad sample and a long gap are not bridged
+    channels[1].sample_quality_flags = CHANNEL_QUALITY_ABOVE_MAX;
+    set_sample(channels, 5000, -1000, 102.5);
+    energy_meter_update(meter, channels);
+    channels[1].sample_quality_flags = CHANNEL_QUALITY_OK;
+    set_sample(channels, 5000, -1000, 103.0);
+    energy_meter_update(meter, channels);
+    set_sample(channels, 5000, -1000, 103.0 + 2.0 * ENERGY_MAX_INTEGRATION_GAP_S);
+    energy_meter_update(meter, channels);
+    EnergyTotals after_gap;
+    energy_meter_get_totals(meter, 0, &after_gap);
+    if (after_gap.ah_in != totals.ah_in || after_gap.wh_in != totals.wh_in) return fail("gaps must not be integrated");
+
+    // Counters survive a restart
+    energy_meter_save(meter);
+    energy_meter_destroy(meter);
+    meter = create_meter(channels);
+    energy_meter_get_totals(meter, 0, &totals);
+    if (totals.wh_in != after_gap.wh_in || totals.peak_in_w != 500.0) return fail("counters must be restored");
+    energy_meter_destroy(meter);
+
+    // Compensated summation: a million 100 Hz increments of 12 W on top of a 10 MWh lifetime total.
+    // A plain sum loses part of every increment (the ulp of 1e7 is 1.9e-9 Wh); the error stays below 1e-6 Wh.
+    StateStore* store = state_store_open(STATE_FILE, 10 * sizeof(double));
+    double seeded[10] = { 1e7 };
+    state_store_save(store, seeded);
+    state_store_close(store);
+    meter = create_meter(channels);
+    double start_s = 1000.0, end_s = start_s;
+    for (int n = 0; n <= 1000000; n++) {
+        end_s = start_s + n * 0.01;
+        set_sample(channels, 1200, 100, end_s);
+        energy_meter_update(meter, channels);
+    }
+    energy_meter_get_totals(meter, 0, &totals);
+    double power_W = channel_get_sample_value(&channels[0]) * channel_get_sample_value(&channels[1]);
+    double expected_Wh = 1e7 + power_W * (end_s - start_s) / 3600.0;
+    if (fabs(totals.wh_out - expected_Wh) > 1e-6) {
+        fprintf(stderr, "error %.3g Wh\n", totals.wh_out - expected_Wh);
+        return fail("compensated sum drifted");
+    }
+
+    energy_meter_destroy(meter);
+    unlink(STATE_FILE);
+    printf("Energy meter tests passed\n");
+    return 0;
+}
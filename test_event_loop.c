@@ -0,0 +1,157 @@
+#include "EventLoop.h"
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+static void sleep_ms(int ms) {
+    struct timespec ts = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+// Runs the loop for a while; the counters are read after the stop, from this thread
+static bool run_for(EventLoop* loop, int ms) {
+    if (!event_loop_start(loop)) return false;
+    sleep_ms(ms);
+    event_loop_stop(loop);
+    return true;
+}
+
+static void count_call(EventLoop* loop, void* user_data) {
+    (*(int*)user_data)++;
+}
+
+// A source that removes itself on its first call
+typedef struct {
+    EventSource* source;
+    int calls;
+} SelfRemoving;
+
+static void remove_self(EventLoop* loop, void* user_data) {
+    SelfRemoving* state = (SelfRemoving*)user_data;
+    state->calls++;
+    event_loop_remove(loop, state->source);
+}
+
+// Two timers due together, each removing the other: the removed one must not run afterwards
+typedef struct {
+    EventSource* other;
+    EventSource** other_slot;   // Where the other timer keeps its handle of this one
+    EventSource* self;
+    int calls;
+} RemovingPair;
+
+static void remove_other(EventLoop* loop, void* user_data) {
+    RemovingPair* state = (RemovingPair*)user_data;
+    state->calls++;
+    if (state->other) {
+        event_loop_remove(loop, state->other);
+        state->other = NULL;
+        *state->other_slot = NULL;
+    }
+}
+
+typedef struct {
+    EventSource* source;
+    int reads;
+    int bytes;
+} PipeReader;
+
+static void read_pipe(EventLoop* loop, int fd, uint32_t events, void* user_data) {
+    PipeReader* reader = (PipeReader*)user_data;
+    char buffer[16];
+    ssize_t received = read(fd, buffer, sizeof(buffer));
+    reader->reads++;
+    if (received > 0) reader->bytes += (int)received;
+    // Level-triggered: a source left with unread data would run again at once
+    if (received <= 0) {
+        event_loop_remove(loop, reader->source);
+        reader->source = NULL;
+    }
+}
+
+int main(void) {
+    // Periodic, one-shot and disarmed timers
+    EventLoop* loop = event_loop_create();
+    if (!loop) return fail("create failed");
+    int periodic = 0, one_shot = 0, disarmed = 0, rearmed = 0;
+    EventSource* periodic_timer = event_loop_add_timer(loop, 20, 20, count_call, &periodic);
+    EventSource* one_shot_timer = event_loop_add_timer(loop, 30, 0, count_call, &one_shot);
+    EventSource* disarmed_timer = event_loop_add_timer(loop, 0, 0, count_call, &disarmed);
+    EventSource* rearmed_timer = event_loop_add_timer(loop, 0, 0, count_call, &rearmed);
+    if (!periodic_timer || !one_shot_timer || !disarmed_timer || !rearmed_timer) return fail("add timer failed");
+    if (!event_loop_set_timer(rearmed_timer, 40, 0)) return fail("set timer failed");
+    if (!run_for(loop, 250)) return fail("start failed");
+    if (periodic < 5 || periodic > 14) return fail("periodic timer should fire about every 20 ms");
+    if (one_shot != 1) return fail("one-shot timer should fire once");
+    if (disarmed != 0) return fail("timer with no initial delay should stay disarmed");
+    if (rearmed != 1) return fail("re-armed timer should fire");
+
+    // Disarming stops a periodic timer; stopped loops keep their sources
+    event_loop_set_timer(periodic_timer, 0, 0);
+    periodic = 0;
+    if (!run_for(loop, 100)) return fail("restart failed");
+    if (periodic != 0) return fail("disarmed periodic timer fired");
+    event_loop_destroy(loop);
+
+    // Events: signals before the callback runs coalesce into one call
+    loop = event_loop_create();
+    int events = 0;
+    EventSource* event = event_loop_add_event(loop, count_call, &events);
+    if (!event) return fail("add event failed");
+    event_loop_signal(event);
+    event_loop_signal(event);
+    event_loop_signal(event);
+    if (!run_for(loop, 50)) return fail("start failed");
+    if (events != 1) return fail("pending signals should coalesce into one call");
+    if (!event_loop_start(loop)) return fail("restart failed");
+    event_loop_signal(event);
+    sleep_ms(50);
+    event_loop_signal(event);
+    sleep_ms(50);
+    event_loop_stop(loop);
+    if (events != 3) return fail("signals from another thread should each be handled");
+    event_loop_destroy(loop);
+
+    // Removal from inside callbacks: the source's own, and another one due in the same wake-up
+    loop = event_loop_create();
+    SelfRemoving self_timer = { 0 };
+    SelfRemoving self_event = { 0 };
+    self_timer.source = event_loop_add_timer(loop, 10, 10, remove_self, &self_timer);
+    self_event.source = event_loop_add_event(loop, remove_self, &self_event);
+    RemovingPair first = { 0 }, second = { 0 };
+    first.self = event_loop_add_timer(loop, 20, 5, remove_other, &first);
+    second.self = event_loop_add_timer(loop, 20, 5, remove_other, &second);
+    first.other = second.self;
+    first.other_slot = &second.other;
+    second.other = first.self;
+    second.other_slot = &first.other;
+    if (!self_timer.source || !self_event.source || !first.self || !second.self) return fail("add source failed");
+    event_loop_signal(self_event.source);
+    if (!run_for(loop, 150)) return fail("start failed");
+    if (self_timer.calls != 1 || self_event.calls != 1) return fail("self-removed source ran again");
+    if ((first.calls == 0) == (second.calls == 0)) return fail("removed timer ran after its removal");
+    event_loop_destroy(loop); // Frees the surviving timer
+
+    // File descriptors, level-triggered, removed from their own callback at end of stream
+    loop = event_loop_create();
+    int fds[2];
+    if (pipe(fds) != 0) return fail("pipe failed");
+    PipeReader reader = { 0 };
+    reader.source = event_loop_add_fd(loop, fds[0], EPOLLIN, read_pipe, &reader);
+    if (!reader.source) return fail("add fd failed");
+    if (write(fds[1], "0123456789abcdefXYZ", 19) != 19) return fail("write failed");
+    close(fds[1]);
+    if (!run_for(loop, 50)) return fail("start failed");
+    if (reader.bytes != 19) return fail("data left unread on a ready fd");
+    if (reader.source || reader.reads != 3) return fail("fd source should run until end of stream, then stop");
+    event_loop_destroy(loop);
+    close(fds[0]);
+
+    printf("event loop test passed\n");
+    return 0;
+}
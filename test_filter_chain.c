@@ -0,0 +1,107 @@
+#include "FilterChain.h"
+#include <stdio.h>
+#include <math.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+// Step from 0 to 1 at t = 0, sampled every dt_s for one second; returns the last output
+static double ema_step_response(FilterChain* chain, int index, double dt_s) {
+    double output = filter_chain_process(chain, index, 0.0, 10.0);
+    int samples = (int)lround(1.0 / dt_s);
+    for (int n = 1; n <= samples; n++) {
+        output = filter_chain_process(chain, index, 1.0, 10.0 + n * dt_s);
+    }
+    return output;
+}
+
+int main(void) {
+    Channel channels[4];
+    for (int i = 0; i < 4; i++) channel_init(&channels[i]);
+
+    // 0: Hampel outlier rejection, 1 and 2: EMA with a 1 s time constant, 3: low-pass at 1 Hz
+    channels[0].filter_count = 1;
+    channels[0].filters[0] = (ChannelFilterStage){ .type = CHANNEL_FILTER_HAMPEL, .window = 5, .threshold = 3.0 };
+    for (int i = 1; i <= 2; i++) {
+        channels[i].filter_count = 1;
+        channels[i].filters[0] = (ChannelFilterStage){ .type = CHANNEL_FILTER_EMA, .time_constant_s = 1.0 };
+    }
+    channels[3].filter_count = 1;
+    channels[3].filters[0] = (ChannelFilterStage){ .type = CHANNEL_FILTER_LOWPASS, .cutoff_hz = 1.0, .q = M_SQRT1_2 };
+
+    FilterChain* chain = filter_chain_create(channels, 4);
+    if (!chain) return fail("create failed");
+
+    // A single-sample glitch is replaced by the window median; normal noise passes unchanged
+    const double input[] = { 100, 101, 99, 100, 102, 5000, 101, 98 };
+    for (int n = 0; n < 8; n++) {
+        double output = filter_chain_process(chain, 0, input[n], 1.0 + 0.1 * n);
+        if (n == 5 && output > 102) return fail("Hampel stage must reject the glitch");
+        if (n != 5 && output != input[n]) return fail("Hampel stage must pass inliers unchanged");
+    }
+
+    // The EMA reaches 1 - 1/e after one time constant at any sample rate
+    double slow = ema_step_response(chain, 1, 0.1);
+    double fast = ema_step_response(chain, 2, 0.01);
+    if (fabs(slow - (1.0 - exp(-1.0))) > 1e-9 || fabs(fast - slow) > 1e-9) {
+        return fail("EMA response must depend on elapsed time, not sample count");
+    }
+
+    // Low-pass: DC passes, a 10 Hz sine at 100 Hz sampling is attenuated ~40 dB
+    double peak = 0.0;
+    for (int n = 0; n < 400; n++) {
+        double output = filter_chain_process(chain, 3, 5.0 + sin(2.0 * M_PI * 10.0 * n / 100.0), 1.0 + n / 100.0);
+        if (n >= 200 && fabs(output - 5.0) > peak) peak = fabs(output - 5.0);
+    }
+    if (peak > 0.02 || peak < 0.005) return fail("low-pass attenuation mismatch");
+
+    // Kalman output depends only on the ratio of its noise parameters
+    Channel kalman[2];
+    for (int i = 0; i < 2; i++) {
+        channel_init(&kalman[i]);
+        kalman[i].filter_count = 2;
+        kalman[i].filters[0] = (ChannelFilterStage){ .type = CHANNEL_FILTER_MEDIAN, .window = 3 };
+        kalman[i].filters[1] = (ChannelFilterStage){ .type = CHANNEL_FILTER_KALMAN,
+                                                     .process_noise = 0.5 * (i + 1), .measurement_noise = 2.0 * (i + 1) };
+    }
+    FilterChain* kalman_chain = filter_chain_create(kalman, 2);
+    double out[2] = {0};
+    for (int n = 0; n < 50; n++) {
+        double noisy = 10.0 + ((n * 7919) % 13 - 6) * 0.1;
+        for (int i = 0; i < 2; i++) out[i] = filter_chain_process(kalman_chain, i, noisy, 1.0 + 0.1 * n);
+    }
+    if (fabs(out[0] - out[1]) > 1e-9 || fabs(out[0] - 10.0) > 0.3) return fail("Kalman stage mismatch");
+    filter_chain_destroy(kalman_chain);
+
+    // Batch run: chains write filtered_adc_value, channels without stages keep the filter_alpha EMA
+    Channel batch[2];
+    channel_init(&batch[0]);
+    channel_init(&batch[1]);
+    batch[0].filter_count = 1;
+    batch[0].filters[0] = (ChannelFilterStage){ .type = CHANNEL_FILTER_MEDIAN, .window = 3 };
+    batch[1].filter_alpha = 0.5;
+    FilterChain* batch_chain = filter_chain_create(batch, 2);
+    const int raw[] = { 1000, 3000, 1100 };
+    for (int n = 0; n < 3; n++) {
+        batch[0].raw_adc_value = batch[1].raw_adc_value = raw[n];
+        batch[0].sample_time_s = batch[1].sample_time_s = 1.0 + n;
+        filter_chain_run(batch_chain, batch, CHANNEL_MASK_BIT(0) | CHANNEL_MASK_BIT(1));
+    }
+    if (batch[0].filtered_adc_value != 1100.0) return fail("median chain must write filtered_adc_value");
+    if (batch[1].filtered_adc_value != 1550.0) return fail("channels without stages must use filter_alpha");
+
+    // Reload: an unchanged chain keeps its state, a changed one starts over
+    batch[1].filter_count = 1;
+    batch[1].filters[0] = (ChannelFilterStage){ .type = CHANNEL_FILTER_MEDIAN, .window = 3 };
+    if (!filter_chain_configure(batch_chain, batch, 2)) return fail("configure failed");
+    if (filter_chain_stage_count(batch_chain, 1) != 1) return fail("new chain must be compiled");
+    if (filter_chain_process(batch_chain, 0, 500.0, 4.0) != 1100.0) return fail("unchanged chain must keep its window");
+    if (filter_chain_process(batch_chain, 1, 500.0, 4.0) != 500.0) return fail("new chain must start empty");
+    filter_chain_destroy(batch_chain);
+
+    filter_chain_destroy(chain);
+    printf("Filter chain tests passed\n");
+    return 0;
+}
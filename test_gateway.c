@@ -0,0 +1,240 @@
+#include "Gateway.h"
+#include "MqttPublisher.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define CONFIG_PATH "test_gateway.yaml"
+#define LOG_DIRECTORY "test_gateway_logs"
+#define RECEIVE_TIMEOUT_MS 2000
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+// Upstream lines arrive here: the gateway's sender writes to a UDP listener
+typedef struct {
+    int fd;
+    char text[65536];
+    size_t length;
+} Upstream;
+
+static int free_port(int type) {
+    struct sockaddr_in address = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t size = sizeof(address);
+    int fd = socket(AF_INET, type, 0);
+    bind(fd, (struct sockaddr*)&address, sizeof(address));
+    getsockname(fd, (struct sockaddr*)&address, &size);
+    close(fd);
+    return ntohs(address.sin_port);
+}
+
+static bool open_upstream(Upstream* upstream, int* port) {
+    struct sockaddr_in address = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t size = sizeof(address);
+    upstream->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    upstream->length = 0;
+    struct timeval timeout = { .tv_usec = 100000 };
+    setsockopt(upstream->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (upstream->fd < 0 || bind(upstream->fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        getsockname(upstream->fd, (struct sockaddr*)&address, &size) != 0) {
+        return false;
+    }
+    *port = ntohs(address.sin_port);
+    return true;
+}
+
+static int count_lines(const char* text) {
+    int lines = 0;
+    for (const char* c = text; *c; c++) lines += *c == '\n';
+    return lines;
+}
+
+// Collects datagrams until the upstream holds `lines` lines; false on timeout
+static bool wait_for_lines(Upstream* upstream, int lines) {
+    for (int waited = 0; waited < RECEIVE_TIMEOUT_MS; waited += 100) {
+        if (count_lines(upstream->text) >= lines) return true;
+        ssize_t received = recv(upstream->fd, upstream->text + upstream->length,
+                                sizeof(upstream->text) - upstream->length - 1, 0);
+        if (received > 0) {
+            upstream->length += (size_t)received;
+            upstream->text[upstream->length] = '\0';
+            // A datagram's last line has no newline of its own
+            if (upstream->text[upstream->length - 1] != '\n') {
+                upstream->text[upstream->length++] = '\n';
+                upstream->text[upstream->length] = '\0';
+            }
+        }
+    }
+    return count_lines(upstream->text) >= lines;
+}
+
+static void clear_upstream(Upstream* upstream) {
+    upstream->length = 0;
+    upstream->text[0] = '\0';
+}
+
+static bool write_config(int gateway_port, int upstream_port) {
+    FILE* file = fopen(CONFIG_PATH, "w");
+    if (!file) return false;
+    fprintf(file,
+            "hardware:\n"
+            "  i2c_bus: \"/dev/null\"\n"
+            "  boards:\n"
+            "    - address: 0x48\n"
+            "system:\n"
+            "  main_loop_interval_ms: 100\n"
+            "  data_send_interval_ms: 500\n"
+            "channels:\n"
+            "  - board_address: 0x48\n"
+            "    pin: \"A0\"\n"
+            "    id: \"pack_current\"\n"
+            "    unit: \"A\"\n"
+            "  - board_address: 0x48\n"
+            "    pin: \"A1\"\n"
+            "    id: \"pack_voltage\"\n"
+            "    unit: \"V\"\n"
+            "influxdb:\n"
+            "  url: \"localhost\"\n"
+            "  bucket: \"b\"\n"
+            "  org: \"o\"\n"
+            "  token: \"t\"\n"
+            "  transport: udp\n"
+            "  udp_host: \"127.0.0.1\"\n"
+            "  udp_port: %d\n"
+            "  batch_size: 1\n"
+            "  flush_interval_ms: 0\n"
+            "logging:\n"
+            "  csv_directory: \"" LOG_DIRECTORY "\"\n"
+            "gateway:\n"
+            "  port: %d\n"
+            "  max_nodes: 4\n"
+            "  node_lines_per_s: 100000\n",
+            upstream_port, gateway_port);
+    return fclose(file) == 0;
+}
+
+static int connect_node(int port) {
+    struct sockaddr_in address = { .sin_family = AF_INET, .sin_port = htons((uint16_t)port),
+                                   .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr*)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool send_text(int fd, const char* text) {
+    return send(fd, text, strlen(text), 0) == (ssize_t)strlen(text);
+}
+
+static size_t encode_frame(uint64_t sequence, double current, uint8_t* buffer, size_t size) {
+    AcquisitionFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.sequence = sequence;
+    frame.wall_time_s = 1700000000.0 + (double)sequence;
+    frame.gps.latitude = frame.gps.longitude = frame.gps.altitude = frame.gps.speed = NAN;
+    frame.channel_count = 2;
+    for (int i = 0; i < 2; i++) {
+        frame.channels[i].is_active = true;
+        frame.channels[i].publish_value = true;
+    }
+    frame.channels[0].value = current;
+    frame.channels[1].value = 48.0;
+    return mqtt_publisher_encode_binary(&frame, buffer, size);
+}
+
+// Sends frames with these sequences and returns how many reached the upstream
+static int forward_frames(int node, Upstream* upstream, const uint64_t* sequences, int count) {
+    uint8_t record[256];
+    for (int f = 0; f < count; f++) {
+        size_t size = encode_frame(sequences[f], 1.0, record, sizeof(record));
+        if (size == 0 || send(node, record, size, 0) != (ssize_t)size) return -1;
+    }
+    // A marker line after the frames: once it arrives, every frame has been handled
+    if (!send_text(node, "marker v=1 1\n")) return -1;
+    while (!strstr(upstream->text, "marker,")) {
+        if (!wait_for_lines(upstream, count_lines(upstream->text) + 1)) return -1;
+    }
+
+    int forwarded = 0;
+    for (const char* line = upstream->text; (line = strstr(line, "measurements,")); line++) forwarded++;
+    clear_upstream(upstream);
+    return forwarded;
+}
+
+int main(void) {
+    Upstream upstream;
+    int upstream_port = 0;
+    int gateway_port = free_port(SOCK_STREAM);
+    if (!open_upstream(&upstream, &upstream_port) || !write_config(gateway_port, upstream_port)) {
+        return fail("Cannot set up the test upstream and configuration");
+    }
+
+    Gateway* gateway = gateway_create(CONFIG_PATH);
+    if (!gateway) return fail("gateway_create failed");
+    int node = connect_node(gateway_port);
+    if (node < 0) return fail("Cannot connect to the gateway");
+
+    // handle_comment: the announced id tags the following lines; other comments are ignored
+    if (!send_text(node, "# hello\n#  node=bike-7\n# node=\nm,a=b v=1 1\n") || !wait_for_lines(&upstream, 1)) {
+        return fail("line after the comments not forwarded");
+    }
+    if (strcmp(upstream.text, "m,a=b,node=bike-7 v=1 1\n") != 0) return fail("announced node id not applied");
+    clear_upstream(&upstream);
+
+    // submit_tagged: the tag goes after the escaped spaces of the tag set; a node tag is kept
+    if (!send_text(node, "m,a=b\\ c v=2 2\nm\\ x v=3 3\nm,node=other v=4 4\n") ||
+        !wait_for_lines(&upstream, 3)) {
+        return fail("tagged lines not forwarded");
+    }
+    if (strcmp(upstream.text, "m,a=b\\ c,node=bike-7 v=2 2\nm\\ x,node=bike-7 v=3 3\nm,node=other v=4 4\n") != 0) {
+        return fail("node tag misplaced");
+    }
+    clear_upstream(&upstream);
+
+    // consume_messages: a binary record split over two reads is forwarded once, whole
+    uint8_t record[256];
+    size_t size = encode_frame(10, 2.5, record, sizeof(record));
+    if (size == 0 || send(node, record, 20, 0) != 20) return fail("Cannot send the first part of a frame");
+    usleep(200000);
+    if (send(node, record + 20, size - 20, 0) != (ssize_t)(size - 20) || !wait_for_lines(&upstream, 1)) {
+        return fail("split binary record not forwarded");
+    }
+    if (strncmp(upstream.text, "measurements,", 13) != 0 || !strstr(upstream.text, ",node=bike-7") ||
+        !strstr(upstream.text, "pack_current=2.5") || !strstr(upstream.text, "pack_voltage=48")) {
+        return fail("split binary record decoded wrong");
+    }
+    clear_upstream(&upstream);
+
+    // is_duplicate_frame: resent frames are dropped; sequence 1 is a restarted node
+    uint64_t resent[] = { 11, 11, 10, 12 };
+    if (forward_frames(node, &upstream, resent, 4) != 2) return fail("resent frames not deduplicated");
+    uint64_t restarted[] = { 1, 2, 1 };
+    if (forward_frames(node, &upstream, restarted, 3) != 3) return fail("sequence 1 not taken as a restart");
+
+    // ... and so is a sequence far behind the newest; within the window it is a duplicate
+    uint64_t far_behind[] = { 1000, 1000 - GATEWAY_DEDUP_WINDOW + 1, 1000 - GATEWAY_DEDUP_WINDOW, 500, 500 };
+    if (forward_frames(node, &upstream, far_behind, 5) != 4) return fail("far-behind sequence not taken as a restart");
+
+    // consume_messages: an unterminated line is complete once the node closes the stream
+    if (!send_text(node, "m v=5 5")) return fail("Cannot send the unterminated line");
+    usleep(200000);
+    if (wait_for_lines(&upstream, 1)) return fail("unterminated line forwarded too early");
+    close(node);
+    if (!wait_for_lines(&upstream, 1) || strcmp(upstream.text, "m,node=bike-7 v=5 5\n") != 0) {
+        return fail("unterminated line not forwarded at the end of the stream");
+    }
+
+    gateway_destroy(gateway);
+    close(upstream.fd);
+    unlink(CONFIG_PATH);
+    printf("gateway test passed\n");
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include "MqttClient.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <zlib.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define OFFLINE_PATH "test_mqtt_offline.txt"
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+typedef struct {
+    uint8_t type;
+    uint8_t body[4096];
+    size_t length;
+} Packet;
+
+// A scripted broker: one thread, one connection at a time
+typedef struct {
+    int listener;
+    const char* error;  // First failed expectation (NULL = all met)
+} Broker;
+
+static bool receive_exact(int fd, void* data, size_t length) {
+    size_t received = 0;
+    while (received < length) {
+        ssize_t n = recv(fd, (uint8_t*)data + received, length - received, 0);
+        if (n <= 0) return false;
+        received += (size_t)n;
+    }
+    return true;
+}
+
+static bool read_packet(int fd, Packet* packet) {
+    uint8_t byte;
+    if (!receive_exact(fd, &packet->type, 1)) return false;
+    packet->length = 0;
+    for (int shift = 0; shift < 28; shift += 7) {
+        if (!receive_exact(fd, &byte, 1)) return false;
+        packet->length |= (size_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return packet->length <= sizeof(packet->body) && receive_exact(fd, packet->body, packet->length);
+}
+
+static int accept_session(Broker* broker, bool session_present) {
+    int fd = accept(broker->listener, NULL, NULL);
+    if (fd < 0) return -1;
+    struct timeval timeout = { .tv_sec = 3 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    // CONNECT 3.1.1 with CleanSession = 0 and the configured client id
+    Packet connect;
+    static const uint8_t expected[] = { 0, 4, 'M', 'Q', 'T', 'T', 4, 0x00, 0, 60, 0, 11,
+                                        't', 'e', 's', 't', '-', 'c', 'l', 'i', 'e', 'n', 't' };
+    if (!read_packet(fd, &connect) || connect.type != 0x10 || connect.length != sizeof(expected) ||
+        memcmp(connect.body, expected, sizeof(expected)) != 0) {
+        broker->error = "CONNECT mismatch";
+        close(fd);
+        return -1;
+    }
+    const uint8_t connack[] = { 0x20, 2, session_present ? 1 : 0, 0 };
+    send(fd, connack, sizeof(connack), 0);
+    return fd;
+}
+
+// Checks a QoS 1 PUBLISH (and its DUP flag); returns its packet id, 0 on mismatch
+static uint16_t expect_publish(int fd, const char* topic, const char* payload, bool dup) {
+    Packet packet;
+    size_t topic_length = strlen(topic);
+    if (!read_packet(fd, &packet) || packet.type != (dup ? 0x3A : 0x32) ||
+        packet.length != 2 + topic_length + 2 + strlen(payload) ||
+        memcmp(packet.body + 2, topic, topic_length) != 0 ||
+        memcmp(packet.body + 4 + topic_length, payload, strlen(payload)) != 0) {
+        return 0;
+    }
+    return (uint16_t)((packet.body[2 + topic_length] << 8) | packet.body[3 + topic_length]);
+}
+
+static void send_puback(int fd, uint16_t packet_id) {
+    const uint8_t puback[] = { 0x40, 2, (uint8_t)(packet_id >> 8), (uint8_t)(packet_id & 0xFF) };
+    send(fd, puback, sizeof(puback), 0);
+}
+
+// Acknowledges "a", drops the connection with "b" unacknowledged, then expects "b" again
+// (DUP, same packet id) ahead of "c" on the resumed session
+static void* live_broker(void* arg) {
+    Broker* broker = (Broker*)arg;
+
+    int fd = accept_session(broker, false);
+    uint16_t id_a = fd >= 0 ? expect_publish(fd, "daq/test", "a", false) : 0;
+    if (id_a) send_puback(fd, id_a);
+    uint16_t id_b = id_a ? expect_publish(fd, "daq/test", "b", false) : 0;
+    if (fd >= 0) close(fd);
+    if (!id_b) {
+        broker->error = broker->error ? broker->error : "first session mismatch";
+        return NULL;
+    }
+
+    fd = accept_session(broker, true);
+    uint16_t resent_b = fd >= 0 ? expect_publish(fd, "daq/test", "b", true) : 0;
+    uint16_t id_c = resent_b ? expect_publish(fd, "daq/test", "c", false) : 0;
+    if (resent_b != id_b || !id_c) {
+        broker->error = broker->error ? broker->error : "unacknowledged message not resent first, with DUP";
+    } else {
+        send_puback(fd, resent_b);
+        send_puback(fd, id_c);
+    }
+    if (fd >= 0) close(fd);
+    return NULL;
+}
+
+// Expects the offline queue as one gzip batch on the backlog topic
+static void* backlog_broker(void* arg) {
+    Broker* broker = (Broker*)arg;
+
+    int fd = accept_session(broker, true);
+    Packet packet;
+    const char* topic = "daq/test/backlog";
+    size_t topic_length = strlen(topic);
+    if (fd < 0 || !read_packet(fd, &packet) || packet.type != 0x32 ||
+        memcmp(packet.body + 2, topic, topic_length) != 0) {
+        broker->error = broker->error ? broker->error : "no backlog PUBLISH";
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+
+    char lines[64] = "";
+    uLongf size = sizeof(lines) - 1;
+    z_stream stream = { .next_in = packet.body + 4 + topic_length,
+                        .avail_in = (uInt)(packet.length - 4 - topic_length),
+                        .next_out = (Bytef*)lines, .avail_out = (uInt)size };
+    if (inflateInit2(&stream, 15 + 16) != Z_OK || inflate(&stream, Z_FINISH) != Z_STREAM_END ||
+        strcmp(lines, "d\n") != 0) {
+        broker->error = "backlog is not the gzipped offline line";
+    }
+    inflateEnd(&stream);
+
+    send_puback(fd, (uint16_t)((packet.body[topic_length + 2] << 8) | packet.body[topic_length + 3]));
+    read_packet(fd, &packet);
+    close(fd);
+    return NULL;
+}
+
+static int open_listener(int* port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t size = sizeof(address);
+    struct timeval timeout = { .tv_sec = 3 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)); // Bounds accept
+    if (bind(fd, (struct sockaddr*)&address, size) != 0 || listen(fd, 1) != 0 ||
+        getsockname(fd, (struct sockaddr*)&address, &size) != 0) {
+        close(fd);
+        return -1;
+    }
+    *port = ntohs(address.sin_port);
+    return fd;
+}
+
+static bool wait_for(MqttClient* client, MqttClientStats* stats, bool (*done)(const MqttClientStats*)) {
+    for (int i = 0; i < 300; i++) {
+        mqtt_client_poll(client);
+        mqtt_client_get_stats(client, stats);
+        if (done(stats)) return true;
+        usleep(10000);
+    }
+    return false;
+}
+
+static bool first_acknowledged(const MqttClientStats* s) { return s->acknowledged == 1; }
+static bool disconnected(const MqttClientStats* s) { return !s->connected; }
+static bool all_acknowledged(const MqttClientStats* s) { return s->acknowledged == 3; }
+static bool backlog_acknowledged(const MqttClientStats* s) { return s->replayed == 1; }
+
+int main(void) {
+    remove(OFFLINE_PATH);
+
+    MqttConfig config = {
+        .enabled = true, .host = "127.0.0.1", .client_id = "test-client",
+        .topic = "daq/test", .backlog_topic = "daq/test/backlog", .format = MQTT_FORMAT_LINE,
+        .keepalive_s = 60, .max_inflight = 4, .ack_timeout_ms = 500, .reconnect_max_s = 1,
+    };
+    Broker broker = {0};
+    broker.listener = open_listener(&config.port);
+    if (broker.listener < 0) return fail("listen failed");
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, live_broker, &broker);
+    MqttClient* client = mqtt_client_create(&config, OFFLINE_PATH);
+    if (!client) return fail("create failed");
+
+    // QoS 1 round trip
+    MqttClientStats stats;
+    if (!mqtt_client_publish(client, "a", 1, NULL)) return fail("publish a failed");
+    if (!wait_for(client, &stats, first_acknowledged)) return fail("a not acknowledged");
+
+    // Dropped with "b" in flight: the next publish reconnects and resends it first
+    if (!mqtt_client_publish(client, "b", 1, NULL)) return fail("publish b failed");
+    if (!wait_for(client, &stats, disconnected)) return fail("broker close not noticed");
+    if (stats.inflight != 1) return fail("b must stay in flight");
+    if (!mqtt_client_publish(client, "c", 1, NULL)) return fail("publish c failed");
+    if (!wait_for(client, &stats, all_acknowledged)) return fail("b and c not acknowledged");
+    if (stats.retransmitted != 1 || stats.connects != 2 || stats.inflight != 0) return fail("session resume mismatch");
+
+    // Broker gone: messages go to the offline queue
+    close(broker.listener);
+    if (!wait_for(client, &stats, disconnected)) return fail("disconnect not noticed");
+    if (mqtt_client_publish(client, "d", 1, NULL)) return fail("publish without a broker must fail");
+    mqtt_client_destroy(client);
+    pthread_join(thread, NULL);
+    if (broker.error) return fail(broker.error);
+
+    // The next run replays it to the backlog topic, and the queue empties
+    broker.listener = open_listener(&config.port);
+    pthread_create(&thread, NULL, backlog_broker, &broker);
+    client = mqtt_client_create(&config, OFFLINE_PATH);
+    if (!client) return fail("second create failed");
+    mqtt_client_request_replay(client);
+    if (!wait_for(client, &stats, backlog_acknowledged)) return fail("backlog not acknowledged");
+    mqtt_client_destroy(client);
+    pthread_join(thread, NULL);
+    close(broker.listener);
+    if (broker.error) return fail(broker.error);
+    if (access(OFFLINE_PATH, F_OK) == 0) return fail("replayed lines left in the offline queue");
+
+    printf("MQTT client tests passed\n");
+    return 0;
+}
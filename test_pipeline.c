@@ -0,0 +1,77 @@
+#include "Pipeline.h"
+#include <stdio.h>
+#include <unistd.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+typedef struct {
+    volatile bool blocked;      // consume waits while set
+    volatile bool inside;       // Set once consume has been entered
+    volatile int consumed;
+    volatile int flushes;
+    volatile uint64_t last_sequence;
+} TestSink;
+
+static void consume(void* state, const AcquisitionFrame* frame) {
+    TestSink* sink = (TestSink*)state;
+    sink->inside = true;
+    while (sink->blocked) usleep(1000);
+    sink->last_sequence = frame->sequence;
+    sink->consumed++;
+}
+
+static void flush(void* state) {
+    ((TestSink*)state)->flushes++;
+}
+
+int main(void) {
+    Channel channel;
+    channel_init(&channel);
+
+    const int queue_sizes[] = { 2, 16 }; // The fast sink never falls 16 frames behind
+    AcquisitionFrameStore* store = acquisition_frame_store_create(pipeline_frames_needed(queue_sizes, 2));
+    Pipeline* pipeline = pipeline_create(store);
+    if (!store || !pipeline) return fail("create failed");
+
+    // A stalled sink with a short queue, and one that wants a frame every 0.25 s
+    TestSink slow = { .blocked = true }, fast = {0};
+    PipelineSink slow_sink = { .name = "slow", .state = &slow, .consume = consume, .flush = flush };
+    PipelineSink fast_sink = { .name = "fast", .state = &fast, .consume = consume, .flush = flush };
+    PipelineSinkId slow_id = pipeline_add_sink(pipeline, &slow_sink, queue_sizes[0], 0.0);
+    PipelineSinkId fast_id = pipeline_add_sink(pipeline, &fast_sink, queue_sizes[1], 0.25);
+    if (slow_id < 0 || fast_id < 0 || !pipeline_start(pipeline)) return fail("start failed");
+
+    // 20 sweeps 0.125 s apart; submitting never waits for the stalled sink
+    for (int k = 1; k <= 20; k++) {
+        AcquisitionFrame* frame = acquisition_frame_begin(store);
+        if (!frame) return fail("queued frames exhausted the pool");
+        acquisition_frame_capture(frame, &channel, 1, 0, NULL, 0.125 * k, 0.0);
+        acquisition_frame_publish(store, frame);
+        pipeline_submit(pipeline);
+        while (k == 1 && !slow.inside) usleep(1000); // Stall it on the first frame
+    }
+
+    PipelineSinkStats stats;
+    if (!pipeline_get_stats(pipeline, slow_id, &stats) || stats.dropped != 17 || stats.queued != 2) {
+        fprintf(stderr, "dropped %lu, queued %d\n", stats.dropped, stats.queued);
+        return fail("a full queue must drop its oldest frames");
+    }
+
+    // Shutdown consumes what is still queued, newest frames included, and flushes
+    slow.blocked = false;
+    pipeline_destroy(pipeline);
+    if (slow.consumed != 3 || slow.last_sequence != 20 || slow.flushes < 1) return fail("slow sink not drained");
+    if (fast.consumed != 10 || fast.last_sequence != 19 || fast.flushes < 1) return fail("interval not applied");
+
+    // Every hold was returned: the whole pool is free again
+    for (int i = 0; i < pipeline_frames_needed(queue_sizes, 2) - 1; i++) {
+        if (!acquisition_frame_begin(store)) return fail("frames leaked");
+    }
+
+    acquisition_frame_store_destroy(store);
+    printf("Pipeline tests passed\n");
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "QuantileSketch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define SAMPLES 20000
+#define ACCURACY 0.01
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Exact quantile with the sketch's rank convention: element floor(q * (n - 1)) of the sorted data
+static double exact_quantile(const double* sorted, int n, double q) {
+    return sorted[(int)floor(q * (n - 1))];
+}
+
+static bool within_accuracy(double estimate, double exact) {
+    return fabs(estimate - exact) <= ACCURACY * fabs(exact) + 1e-12;
+}
+
+int main(void) {
+    static double values[SAMPLES];
+    static double sorted[SAMPLES];
+    const double quantiles[] = { 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.95, 0.99, 0.999 };
+    const int quantile_count = sizeof(quantiles) / sizeof(quantiles[0]);
+
+    // Battery-like current: mostly discharge, some regeneration, exponential tail
+    srand(7);
+    for (int i = 0; i < SAMPLES; i++) {
+        double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+        values[i] = (i % 10 == 0) ? -2.0 * u : -8.0 * log(u);
+        if (i % 97 == 0) values[i] = 0.0;
+        sorted[i] = values[i];
+    }
+    qsort(sorted, SAMPLES, sizeof(double), compare_doubles);
+
+    QuantileSketch* whole = quantile_sketch_create(ACCURACY);
+    QuantileSketch* first = quantile_sketch_create(ACCURACY);
+    QuantileSketch* second = quantile_sketch_create(ACCURACY);
+    if (!whole || !first || !second) return fail("create failed");
+    if (!isnan(quantile_sketch_quantile(whole, 0.5))) return fail("empty sketch must return NAN");
+
+    for (int i = 0; i < SAMPLES; i++) {
+        quantile_sketch_add(whole, values[i]);
+        quantile_sketch_add(i < SAMPLES / 3 ? first : second, values[i]);
+    }
+    quantile_sketch_add(whole, NAN);
+
+    if (quantile_sketch_count(whole) != SAMPLES) return fail("count mismatch (NaN must be ignored)");
+    if (quantile_sketch_min(whole) != sorted[0] || quantile_sketch_max(whole) != sorted[SAMPLES - 1]) {
+        return fail("min/max must be exact");
+    }
+    for (int q = 0; q < quantile_count; q++) {
+        double exact = exact_quantile(sorted, SAMPLES, quantiles[q]);
+        double estimate = quantile_sketch_quantile(whole, quantiles[q]);
+        if (!within_accuracy(estimate, exact)) {
+            fprintf(stderr, "q=%.3f: estimate %.6f, exact %.6f\n", quantiles[q], estimate, exact);
+            return 1;
+        }
+    }
+
+    // Two trips merged answer exactly like one sketch over all the data
+    if (!quantile_sketch_merge(first, second)) return fail("merge failed");
+    for (int q = 0; q < quantile_count; q++) {
+        if (quantile_sketch_quantile(first, quantiles[q]) != quantile_sketch_quantile(whole, quantiles[q])) {
+            return fail("merged sketch differs from the single sketch");
+        }
+    }
+    QuantileSketch* other_accuracy = quantile_sketch_create(0.02);
+    if (quantile_sketch_merge(first, other_accuracy)) return fail("merging different accuracies must fail");
+    quantile_sketch_destroy(other_accuracy);
+
+    // Serialization round trip
+    FILE* file = tmpfile();
+    if (!file) return fail("cannot create temp file");
+    if (!quantile_sketch_write(whole, file)) return fail("write failed");
+    rewind(file);
+    QuantileSketch* loaded = quantile_sketch_read(file);
+    fclose(file);
+    if (!loaded) return fail("read failed");
+    for (int q = 0; q < quantile_count; q++) {
+        if (quantile_sketch_quantile(loaded, quantiles[q]) != quantile_sketch_quantile(whole, quantiles[q])) {
+            return fail("loaded sketch differs");
+        }
+    }
+
+    // More decades than the bins cover: memory stays bounded, the upper quantiles stay accurate
+    QuantileSketch* wide = quantile_sketch_create(ACCURACY);
+    for (int e = -9; e <= 12; e++) {
+        for (int k = 0; k < 100; k++) quantile_sketch_add(wide, pow(10.0, e) * (1.0 + k / 100.0));
+    }
+    // Values were added in ascending order: rank floor(0.99 * 2199) = 2177 is 1e12 * 1.77
+    if (!within_accuracy(quantile_sketch_quantile(wide, 0.99), 1.77e12)) {
+        return fail("upper quantile lost accuracy after collapsing");
+    }
+
+    quantile_sketch_destroy(wide);
+    quantile_sketch_destroy(loaded);
+    quantile_sketch_destroy(whole);
+    quantile_sketch_destroy(first);
+    quantile_sketch_destroy(second);
+    printf("Quantile sketch tests passed\n");
+    return 0;
+}
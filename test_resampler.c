@@ -0,0 +1,75 @@
+#include "Resampler.h"
+#include <math.h>
+#include <stdio.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+// Sweep k starts at 0.1·k s; channel 0 is read 10 ms in, channel 1 50 ms in.
+// Both see the same signal, so aligned samples must agree. Returns the worst error in counts.
+static double run_sweeps(Resampler* resampler, double (*signal)(double), int sweeps) {
+    Channel channels[2];
+    for (int i = 0; i < 2; i++) channel_init(&channels[i]);
+    const double read_delay_s[2] = { 0.01, 0.05 };
+
+    double worst = 0.0;
+    for (int k = 1; k <= sweeps; k++) {
+        double grid_s = 0.1 * k;
+        for (int i = 0; i < 2; i++) {
+            channels[i].sample_time_s = grid_s + read_delay_s[i];
+            channel_update_raw_value(&channels[i], (int)lround(signal(channels[i].sample_time_s)));
+        }
+        resampler_run(resampler, channels, CHANNEL_MASK_BIT(0) | CHANNEL_MASK_BIT(1), grid_s);
+        if (k < 3) continue; // Let the history fill
+
+        for (int i = 0; i < 2; i++) {
+            if (channels[i].sample_time_s != grid_s) return INFINITY;
+            double error = fabs(channels[i].raw_adc_value - signal(grid_s));
+            if (error > worst) worst = error;
+        }
+    }
+    return worst;
+}
+
+static double ramp(double t) { return 1000.0 * t; }
+static double parabola(double t) { return 8000.0 * (t - 2.0) * (t - 2.0); }
+
+int main(void) {
+    Resampler* resampler = resampler_create(2);
+    if (!resampler) return fail("create failed");
+
+    // Without resampling the 50 ms skew of channel 1 stays in the data
+    Channel channel;
+    channel_init(&channel);
+    channel.sample_time_s = 0.15;
+    channel_update_raw_value(&channel, 150);
+    resampler_run(resampler, &channel, CHANNEL_MASK_BIT(0), 0.1);
+    if (channel.raw_adc_value != 150 || channel.sample_time_s != 0.15) return fail("mode none must not change samples");
+    resampler_destroy(resampler);
+
+    // Linear is exact on a ramp (to the count rounding of the input and output)
+    resampler = resampler_create(2);
+    resampler_set_mode(resampler, RESAMPLE_LINEAR);
+    if (run_sweeps(resampler, ramp, 40) > 1.0) return fail("linear resampling must align a ramp");
+    resampler_destroy(resampler);
+
+    // On a curve, the quadratic kernel does much better than linear
+    resampler = resampler_create(2);
+    resampler_set_mode(resampler, RESAMPLE_LINEAR);
+    double linear_error = run_sweeps(resampler, parabola, 38);
+    resampler_destroy(resampler);
+
+    resampler = resampler_create(2);
+    resampler_set_mode(resampler, RESAMPLE_QUADRATIC);
+    double quadratic_error = run_sweeps(resampler, parabola, 38);
+    resampler_destroy(resampler);
+    if (quadratic_error > 1.0 || linear_error < 10.0) {
+        fprintf(stderr, "linear %.2f, quadratic %.2f counts\n", linear_error, quadratic_error);
+        return fail("quadratic resampling must follow a parabola");
+    }
+
+    printf("Resampler tests passed\n");
+    return 0;
+}
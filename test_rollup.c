@@ -0,0 +1,56 @@
+#include "Rollup.h"
+#include <stdio.h>
+#include <math.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+int main(void) {
+    if (rollup_tier_create(0.0)) return fail("zero interval must be rejected");
+
+    RollupTier* tier = rollup_tier_create(10.0);
+    if (!tier) return fail("create failed");
+
+    // First sweep at 1000003.5 s: the period starts at the 10 s boundary 1000000
+    if (rollup_tier_advance(tier, 1000003.5)) return fail("first advance must not complete a period");
+    rollup_tier_add(tier, 0, 2.0);
+    rollup_tier_add(tier, 0, 4.0);
+    rollup_tier_add(tier, 0, NAN);
+    rollup_tier_add(tier, 5, -1.0);
+    if (rollup_tier_advance(tier, 1000009.9)) return fail("same period must not complete");
+    rollup_tier_add(tier, 0, 9.0);
+
+    if (!rollup_tier_advance(tier, 1000010.0)) return fail("crossing the boundary must complete the period");
+    if (rollup_tier_completed_start(tier) != 1000000.0) return fail("period must be aligned to the interval");
+
+    RollupCell cell;
+    if (!rollup_tier_get_completed(tier, 0, &cell)) return fail("channel 0 must have data");
+    if (cell.count != 3 || cell.sum != 15.0 || cell.min != 2.0 || cell.max != 9.0) {
+        return fail("aggregate mismatch (NaN must be ignored)");
+    }
+    if (!rollup_tier_get_completed(tier, 5, &cell) || cell.count != 1 || cell.min != -1.0) {
+        return fail("channel 5 aggregate mismatch");
+    }
+    if (rollup_tier_get_completed(tier, 1, &cell)) return fail("channel without samples must be absent");
+
+    // A gap with no samples completes nothing; the next period is aligned to the new time
+    if (rollup_tier_advance(tier, 1000047.0)) return fail("empty period must not be reported");
+    rollup_tier_add(tier, 0, 1.0);
+
+    // Clock stepping back stays in the current period
+    if (rollup_tier_advance(tier, 1000001.0)) return fail("clock step back must not complete a period");
+    rollup_tier_add(tier, 0, 3.0);
+
+    if (!rollup_tier_close(tier)) return fail("close must complete the partial period");
+    if (rollup_tier_completed_start(tier) != 1000040.0) return fail("closed period start mismatch");
+    if (!rollup_tier_get_completed(tier, 0, &cell) || cell.count != 2 || cell.sum / cell.count != 2.0) {
+        return fail("closed period aggregate mismatch");
+    }
+    if (rollup_tier_close(tier)) return fail("closing an empty period must report nothing");
+
+    rollup_tier_destroy(tier);
+    printf("Rollup tests passed\n");
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "Sender.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+#define LOG_DIRECTORY "test_sender_udp_logs"
+#define MAX_DATAGRAMS 16
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+// The datagrams of one batch, as the listener received them
+typedef struct {
+    int count;
+    size_t sizes[MAX_DATAGRAMS];
+    int lines[MAX_DATAGRAMS];
+    char text[256 * 1024];  // All payloads, in order
+    size_t length;
+} Received;
+
+static int open_listener(int* port) {
+    struct sockaddr_in address = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t size = sizeof(address);
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct timeval timeout = { .tv_usec = 500000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (fd < 0 || bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        getsockname(fd, (struct sockaddr*)&address, &size) != 0) {
+        return -1;
+    }
+    *port = ntohs(address.sin_port);
+    return fd;
+}
+
+// Sends the lines as one batch (batch_size = line_count) to a sender with the given MTU
+static bool send_batch(int listener, int port, int mtu, char* const lines[], int line_count, Received* received) {
+    YAMLAppConfig* config = calloc(1, sizeof(YAMLAppConfig));
+    if (!config) return false;
+    snprintf(config->influxdb.url, sizeof(config->influxdb.url), "localhost");
+    snprintf(config->influxdb.bucket, sizeof(config->influxdb.bucket), "b");
+    snprintf(config->influxdb.org, sizeof(config->influxdb.org), "o");
+    snprintf(config->influxdb.token, sizeof(config->influxdb.token), "t");
+    snprintf(config->influxdb.udp_host, sizeof(config->influxdb.udp_host), "127.0.0.1");
+    snprintf(config->logging.csv_directory, sizeof(config->logging.csv_directory), LOG_DIRECTORY);
+    config->influxdb.transport = INFLUX_TRANSPORT_UDP;
+    config->influxdb.udp_port = port;
+    config->influxdb.udp_mtu = mtu;
+    config->influxdb.batch_size = line_count;
+    config->influxdb.flush_interval_ms = 5000; // The batch is sent once full
+
+    SenderContext* sender = sender_create_from_yaml(config);
+    free(config);
+    if (!sender) return false;
+    for (int i = 0; i < line_count; i++) sender_submit(sender, lines[i]);
+
+    memset(received, 0, sizeof(*received));
+    while (received->count < MAX_DATAGRAMS) {
+        ssize_t size = recv(listener, received->text + received->length,
+                            sizeof(received->text) - received->length - 1, 0);
+        if (size <= 0) break;
+        int lines_in_datagram = 0;
+        for (ssize_t b = 0; b < size; b++) lines_in_datagram += received->text[received->length + (size_t)b] == '\n';
+        received->sizes[received->count] = (size_t)size;
+        received->lines[received->count++] = lines_in_datagram;
+        received->length += (size_t)size;
+    }
+    received->text[received->length] = '\0';
+    sender_destroy(sender);
+    return true;
+}
+
+static char* make_line(int index, size_t length) {
+    char* line = malloc(length + 1);
+    int prefix = snprintf(line, length + 1, "m,i=%04d v=", index);
+    memset(line + prefix, '1', length - (size_t)prefix);
+    line[length] = '\0';
+    return line;
+}
+
+// The lines, in order and intact, each followed by a newline
+static bool same_lines(const Received* received, char* const lines[], int line_count) {
+    const char* position = received->text;
+    for (int i = 0; i < line_count; i++) {
+        size_t length = strlen(lines[i]);
+        if (strncmp(position, lines[i], length) != 0 || position[length] != '\n') return false;
+        position += length + 1;
+    }
+    return *position == '\0';
+}
+
+static void free_lines(char* lines[], int line_count) {
+    for (int i = 0; i < line_count; i++) free(lines[i]);
+}
+
+int main(void) {
+    int port = 0;
+    int listener = open_listener(&port);
+    if (listener < 0) return fail("Cannot open the UDP listener");
+    Received* received = malloc(sizeof(Received));
+    if (!received) return fail("Out of memory");
+
+    // Packing to the MTU: 576 - 28 header bytes leave 548, room for five 100-byte lines (newline included)
+    char* lines[600];
+    for (int i = 0; i < 12; i++) lines[i] = make_line(i, 99);
+    if (!send_batch(listener, port, 576, lines, 12, received)) return fail("Cannot create the UDP sender");
+    if (received->count != 3 || received->lines[0] != 5 || received->lines[1] != 5 || received->lines[2] != 2 ||
+        received->sizes[0] != 500) {
+        return fail("lines not packed to the payload size");
+    }
+    if (!same_lines(received, lines, 12)) return fail("packed lines reordered or cut");
+    free_lines(lines, 12);
+
+    // A line longer than the payload travels alone, between full datagrams of the others
+    lines[0] = make_line(0, 99);
+    lines[1] = make_line(1, 999);
+    lines[2] = make_line(2, 99);
+    if (!send_batch(listener, port, 576, lines, 3, received)) return fail("Cannot create the UDP sender");
+    if (received->count != 3 || received->sizes[1] != 1000) return fail("long line not sent in a datagram of its own");
+    if (!same_lines(received, lines, 3)) return fail("long line reordered or cut");
+    free_lines(lines, 3);
+
+    // IOV_MAX: a datagram takes two iovecs per line, so 600 short lines need two datagrams even
+    // though their bytes fit in one
+    for (int i = 0; i < 600; i++) lines[i] = make_line(i, 19);
+    if (!send_batch(listener, port, 65535, lines, 600, received)) return fail("Cannot create the UDP sender");
+    if (received->count != 2 || received->lines[0] != IOV_MAX / 2 || received->lines[1] != 600 - IOV_MAX / 2) {
+        return fail("datagram not split at IOV_MAX");
+    }
+    if (!same_lines(received, lines, 600)) return fail("split lines reordered or cut");
+    free_lines(lines, 600);
+
+    free(received);
+    close(listener);
+    printf("sender udp test passed\n");
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "StateStore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+typedef struct {
+    double soc;
+    double throughput;
+} Record;
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+// Overwrites a few bytes in the middle of a slot, like a write torn by a power cut
+static void damage_slot(const char* path, int slot) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    int fd = open(path, O_WRONLY);
+    const char garbage[8] = "torn!!!";
+    pwrite(fd, garbage, sizeof(garbage), (off_t)slot * page_size + 20);
+    close(fd);
+}
+
+int main(void) {
+    char path[] = "/tmp/state_store_testXXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return fail("cannot create temp file");
+    close(fd);
+
+    StateStore* store = state_store_open(path, sizeof(Record));
+    if (!store) return fail("open failed");
+
+    Record record;
+    if (state_store_load(store, &record)) {
+        return fail("an empty file must not yield a record");
+    }
+
+    // Three saves: slots 0, 1, 0 with sequences 1, 2, 3
+    for (int i = 1; i <= 3; i++) {
+        Record r = { .soc = 100.0 - i, .throughput = i * 0.5 };
+        if (!state_store_save(store, &r)) return fail("save failed");
+    }
+    state_store_close(store);
+
+    store = state_store_open(path, sizeof(Record));
+    if (!store || !state_store_load(store, &record)) return fail("reopen/load failed");
+    if (record.soc != 97.0 || record.throughput != 1.5 || state_store_sequence(store) != 3) {
+        return fail("reopen should return the newest record");
+    }
+    state_store_close(store);
+
+    // A damaged newest slot falls back to the previous record
+    damage_slot(path, 0);
+    store = state_store_open(path, sizeof(Record));
+    if (!store || !state_store_load(store, &record)) return fail("load after damage failed");
+    if (record.soc != 98.0 || state_store_sequence(store) != 2) {
+        return fail("damaged newest slot should fall back to the older one");
+    }
+
+    // The next save replaces the damaged slot, not the surviving one
+    Record r = { .soc = 90.0, .throughput = 5.0 };
+    if (!state_store_save(store, &r) || state_store_sequence(store) != 3) {
+        return fail("save after recovery failed");
+    }
+    state_store_close(store);
+
+    store = state_store_open(path, sizeof(Record));
+    if (!store || !state_store_load(store, &record) || record.soc != 90.0) {
+        return fail("record saved after recovery was lost");
+    }
+    state_store_close(store);
+
+    // A store opened with a different record size ignores existing slots
+    store = state_store_open(path, sizeof(double));
+    double single;
+    if (!store || state_store_load(store, &single)) {
+        return fail("records of another size must be rejected");
+    }
+    state_store_close(store);
+    unlink(path);
+
+    // The file's directory is created on open
+    char directory[] = "/tmp/state_store_dirXXXXXX";
+    if (!mkdtemp(directory)) return fail("mkdtemp failed");
+    char nested[64];
+    snprintf(nested, sizeof(nested), "%s/state/store.bin", directory);
+    store = state_store_open(nested, sizeof(Record));
+    if (!store) return fail("store in a missing directory not created");
+    state_store_close(store);
+    unlink(nested);
+    snprintf(nested, sizeof(nested), "%s/state", directory);
+    rmdir(nested);
+    rmdir(directory);
+    return 0;
+}
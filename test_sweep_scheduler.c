@@ -0,0 +1,117 @@
+#include "Channel.h"
+#include "SweepScheduler.h"
+#include <stdio.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+static int popcount64(ChannelMask mask) {
+    int count = 0;
+    while (mask) {
+        mask &= mask - 1;
+        count++;
+    }
+    return count;
+}
+
+int main(void) {
+    Channel channels[4];
+    for (int i = 0; i < 4; i++) {
+        channel_init(&channels[i]);
+        channels[i].is_active = true;
+    }
+
+    // 100 ms slots: ch0 every slot, ch1/ch2 every 2nd, ch3 every 3rd
+    channels[1].sample_interval_ms = 200;
+    channels[2].sample_interval_ms = 200;
+    channels[3].sample_interval_ms = 300;
+    channels[0].publish_interval_ms = 0;
+    channels[3].publish_interval_ms = 1500; // every 3rd transmission at 500 ms
+
+    SweepScheduler* scheduler = sweep_scheduler_create(channels, 4, 100, 500);
+    if (!scheduler) {
+        return fail("scheduler creation failed");
+    }
+
+    if (sweep_scheduler_get_slot_count(scheduler) != 6) {
+        return fail("hyperperiod should be lcm(1, 2, 3) = 6 slots");
+    }
+
+    int hits[4] = {0};
+    for (int slot = 0; slot < 6; slot++) {
+        ChannelMask mask = sweep_scheduler_get_slot_mask(scheduler, slot);
+        for (int i = 0; i < 4; i++) {
+            if (mask & CHANNEL_MASK_BIT(i)) hits[i]++;
+        }
+    }
+    if (hits[0] != 6 || hits[1] != 3 || hits[2] != 3 || hits[3] != 2) {
+        return fail("each channel should be read exactly hyperperiod / period times");
+    }
+
+    // The two 200 ms channels must not share slots when they can be interleaved
+    for (int slot = 0; slot < 6; slot++) {
+        ChannelMask mask = sweep_scheduler_get_slot_mask(scheduler, slot);
+        if ((mask & CHANNEL_MASK_BIT(1)) && (mask & CHANNEL_MASK_BIT(2))) {
+            return fail("equal-rate channels should be phase-shifted");
+        }
+    }
+    if (sweep_scheduler_get_peak_slot_load(scheduler) != 3) {
+        return fail("peak load should be 3 conversions (1 + 1 + slow channel)");
+    }
+
+    // Iteration wraps around the table
+    ChannelMask first = sweep_scheduler_next_sample_mask(scheduler);
+    for (int slot = 1; slot < 6; slot++) {
+        sweep_scheduler_next_sample_mask(scheduler);
+    }
+    if (sweep_scheduler_next_sample_mask(scheduler) != first) {
+        return fail("sample table should repeat every hyperperiod");
+    }
+
+    // Publish: ch3 in transmissions 0, 3, 6 ...; others every time
+    for (int tx = 0; tx < 6; tx++) {
+        ChannelMask mask = sweep_scheduler_next_publish_mask(scheduler);
+        bool expect_ch3 = (tx % 3) == 0;
+        if (popcount64(mask & CHANNEL_MASK_BIT(0)) != 1) {
+            return fail("default publish interval should publish every transmission");
+        }
+        if (((mask & CHANNEL_MASK_BIT(3)) != 0) != expect_ch3) {
+            return fail("publish_interval_ms should select every Nth transmission");
+        }
+    }
+
+    sweep_scheduler_destroy(scheduler);
+
+    // Period sets whose LCM overflows the table fall back to powers of two
+    for (int i = 0; i < 4; i++) {
+        channels[i].sample_interval_ms = 100 * (i == 0 ? 997 : (i == 1 ? 991 : 1));
+    }
+    scheduler = sweep_scheduler_create(channels, 4, 100, 500);
+    if (!scheduler || sweep_scheduler_get_slot_count(scheduler) != 512) {
+        return fail("oversized hyperperiod should fall back to the largest power-of-two period");
+    }
+
+    // Every channel, including those after the overflowing ones, runs at its rounded period
+    const int rounded[4] = { 512, 512, 1, 1 };
+    for (int i = 0; i < 4; i++) {
+        int last = -1;
+        int count = 0;
+        for (int slot = 0; slot < 512; slot++) {
+            if (!(sweep_scheduler_get_slot_mask(scheduler, slot) & CHANNEL_MASK_BIT(i))) continue;
+            if (last >= 0 && slot - last != rounded[i]) {
+                return fail("fallback channel not spaced at its rounded period");
+            }
+            last = slot;
+            count++;
+        }
+        if (count != 512 / rounded[i]) {
+            return fail("fallback channel should be read once per rounded period");
+        }
+    }
+    sweep_scheduler_destroy(scheduler);
+
+    printf("Sweep scheduler test passed\n");
+    return 0;
+}
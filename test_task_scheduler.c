@@ -0,0 +1,111 @@
+#include "TaskScheduler.h"
+#include <stdio.h>
+#include <time.h>
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void sleep_ms(int ms) {
+    struct timespec ts = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static int order_log[8];
+static int order_count;
+
+static void count_task(void* user_data) {
+    (*(int*)user_data)++;
+}
+
+static void first_task(void* user_data) {
+    (void)user_data;
+    if (order_count < 8) order_log[order_count++] = 1;
+}
+
+static void second_task(void* user_data) {
+    (void)user_data;
+    if (order_count < 8) order_log[order_count++] = 2;
+}
+
+static void run_for(TaskScheduler* scheduler, double seconds) {
+    double end = now_s() + seconds;
+    while (now_s() < end) {
+        task_scheduler_run_due(scheduler);
+        task_scheduler_wait(scheduler);
+    }
+}
+
+int main(void) {
+    // Same deadline: registration order decides
+    TaskScheduler* scheduler = task_scheduler_create();
+    if (!scheduler) return fail("create failed");
+    task_scheduler_add(scheduler, "first", 1.0, TASK_POLICY_SKIP, first_task, NULL);
+    task_scheduler_add(scheduler, "second", 1.0, TASK_POLICY_SKIP, second_task, NULL);
+    task_scheduler_run_due(scheduler);
+    if (order_count != 2 || order_log[0] != 1 || order_log[1] != 2) {
+        return fail("tasks with equal deadlines should run in registration order");
+    }
+    task_scheduler_destroy(scheduler);
+
+    // Absolute deadlines: slow work inside a period must not reduce the rate
+    scheduler = task_scheduler_create();
+    int fast_runs = 0;
+    TaskId fast = task_scheduler_add(scheduler, "fast", 0.010, TASK_POLICY_SKIP, count_task, &fast_runs);
+    run_for(scheduler, 0.205);
+    if (fast_runs < 19 || fast_runs > 22) {
+        fprintf(stderr, "runs: %d\n", fast_runs);
+        return fail("10 ms task should run ~21 times in 205 ms");
+    }
+
+    // Skip policy: a 55 ms stall drops the missed releases and counts an overrun
+    TaskStats before, after;
+    task_scheduler_get_stats(scheduler, fast, &before);
+    sleep_ms(55);
+    task_scheduler_run_due(scheduler);
+    task_scheduler_get_stats(scheduler, fast, &after);
+    if (after.runs != before.runs + 1 || after.overruns != before.overruns + 1 ||
+        after.skipped < before.skipped + 4) {
+        return fail("skip policy should run once, count an overrun and skip missed releases");
+    }
+    task_scheduler_destroy(scheduler);
+
+    // Catch-up policy: replays at most TASK_SCHEDULER_MAX_CATCH_UP missed releases
+    scheduler = task_scheduler_create();
+    int catch_runs = 0;
+    TaskId catch_up = task_scheduler_add(scheduler, "catch-up", 0.010, TASK_POLICY_CATCH_UP, count_task, &catch_runs);
+    task_scheduler_run_due(scheduler);
+    sleep_ms(25); // two releases missed
+    int executed = task_scheduler_run_due(scheduler);
+    if (executed < 2 || executed > 3) {
+        return fail("catch-up policy should replay the missed releases");
+    }
+    sleep_ms(105); // ten missed releases
+    executed = task_scheduler_run_due(scheduler);
+    TaskStats stats;
+    task_scheduler_get_stats(scheduler, catch_up, &stats);
+    if (executed != TASK_SCHEDULER_MAX_CATCH_UP + 1 || stats.skipped < 6) {
+        return fail("catch-up should be bounded and the rest counted as skipped");
+    }
+
+    // Period change keeps the task schedulable
+    if (!task_scheduler_set_period(scheduler, catch_up, 0.020)) {
+        return fail("set_period failed");
+    }
+    catch_runs = 0;
+    run_for(scheduler, 0.105);
+    if (catch_runs < 4 || catch_runs > 7) {
+        return fail("new period should take effect");
+    }
+    task_scheduler_destroy(scheduler);
+
+    printf("Task scheduler test passed\n");
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "TriggerEngine.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define PRE 3
+#define POST 2
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+// Feeds one sweep with the given sample on each channel; returns the engine's result
+static bool sweep(TriggerEngine* engine, Channel channels[], double v0, double v1, double now_s) {
+    channel_set_calibrated_override(&channels[0], v0);
+    channel_set_calibrated_override(&channels[1], v1);
+    ChannelMask fresh = (isnan(v0) ? 0 : CHANNEL_MASK_BIT(0)) | (isnan(v1) ? 0 : CHANNEL_MASK_BIT(1));
+    return trigger_engine_process(engine, channels, fresh, now_s);
+}
+
+int main(void) {
+    Channel channels[2];
+    for (int i = 0; i < 2; i++) {
+        channel_init(&channels[i]);
+        channels[i].is_active = true;
+        snprintf(channels[i].id, sizeof(channels[i].id), "ch%d", i);
+    }
+    channels[0].trigger_above = 10.0;
+    channels[1].trigger_rate = 100.0; // units per second
+
+    if (trigger_engine_create(2, PRE, 0, 0.0)) return fail("post_samples 0 must be rejected");
+    TriggerEngine* engine = trigger_engine_create(2, PRE, POST, 1.0);
+    if (!engine) return fail("create failed");
+
+    // Sweeps every 0.1 s; channel 0 spikes at sweep 5, channel 1 misses sweep 6
+    const double v0[] = { 1, 2, 3, 4, 5, 20, 6, 7 };
+    const double v1[] = { 0, 0, 0, 0, 0, 0, NAN, 0 };
+    for (int k = 0; k < 8; k++) {
+        bool done = sweep(engine, channels, v0[k], v1[k], 100.0 + 0.1 * k);
+        if (done != (k == 7)) {
+            fprintf(stderr, "capture completion at sweep %d: %d\n", k, done);
+            return 1;
+        }
+    }
+
+    const TriggerEvent* event = trigger_engine_get_event(engine);
+    if (!event || event->channel_index != 0 || event->condition != TRIGGER_CONDITION_ABOVE || event->value != 20.0) {
+        return fail("wrong trigger");
+    }
+    if (event->frame_count != PRE + 1 + POST || event->trigger_frame != PRE) return fail("wrong capture window");
+    for (int f = 0; f < event->frame_count; f++) {
+        double time_s;
+        ChannelMask mask;
+        const float* values;
+        if (!trigger_engine_get_frame(engine, f, &time_s, &mask, &values)) return fail("frame missing");
+        if (values[0] != (float)v0[f + 2] || fabs(time_s - (100.0 + 0.1 * (f + 2))) > 1e-9) {
+            return fail("frames must be the pre, trigger and post sweeps in order");
+        }
+        if ((f + 2 == 6) != isnan(values[1]) || (f + 2 == 6) == !!(mask & CHANNEL_MASK_BIT(1))) {
+            return fail("a channel without a fresh sample must be NAN in the frame");
+        }
+    }
+
+    // Capture file: header, ids and frames
+    char path[] = "/tmp/trigger_capture_test.bin";
+    TriggerCapture* capture = trigger_engine_copy_capture(engine, channels);
+    if (!capture || capture->event.frame_count != PRE + 1 + POST || capture->values[0] != (float)v0[2] ||
+        strcmp(capture->channel_ids[1], "ch1") != 0) {
+        return fail("capture copy mismatch");
+    }
+    if (!trigger_capture_write(capture, path)) return fail("write failed");
+    trigger_capture_free(capture);
+    FILE* file = fopen(path, "rb");
+    if (!file) return fail("capture file missing");
+    char magic[4];
+    uint32_t header[6];
+    if (fread(magic, 1, 4, file) != 4 || memcmp(magic, TRIGGER_CAPTURE_MAGIC, 4) != 0 ||
+        fread(header, sizeof(uint32_t), 6, file) != 6 || header[1] != 2 || header[2] != PRE + 1 + POST ||
+        header[3] != PRE) {
+        fclose(file);
+        return fail("capture header mismatch");
+    }
+    fseek(file, 0, SEEK_END);
+    long expected_size = 4 + 6 * 4 + 2 * 8 + 2 * MEASUREMENT_ID_SIZE + (PRE + 1 + POST) * (8 + 8 + 2 * 4);
+    if (ftell(file) != expected_size) {
+        fclose(file);
+        return fail("capture file size mismatch");
+    }
+    fclose(file);
+    remove(path);
+
+    // The capture is gone after the next sweep (whose edge falls inside the holdoff)
+    if (sweep(engine, channels, 30.0, 0.0, 100.8) || trigger_engine_get_event(engine)) {
+        return fail("capture must be released by the next sweep");
+    }
+
+    // Holdoff: an edge within 1 s of the end of the capture is ignored
+    sweep(engine, channels, 1.0, 0.0, 100.9);
+    sweep(engine, channels, 15.0, 0.0, 101.0);
+    for (int k = 0; k < POST + 1; k++) {
+        if (sweep(engine, channels, 1.0, 0.0, 101.1 + 0.1 * k)) return fail("trigger during holdoff");
+    }
+
+    // Rate trigger after the holdoff: channel 1 jumps 20 units in 0.1 s (200/s)
+    sweep(engine, channels, 1.0, 0.0, 101.9);
+    sweep(engine, channels, 1.0, 20.0, 102.0);
+    bool done = false;
+    for (int k = 0; k < POST && !done; k++) {
+        done = sweep(engine, channels, 1.0, 20.0, 102.1 + 0.1 * k);
+    }
+    event = trigger_engine_get_event(engine);
+    if (!done || !event || event->channel_index != 1 || event->condition != TRIGGER_CONDITION_RATE ||
+        fabs(event->value - 200.0) > 1e-6) {
+        return fail("rate trigger mismatch");
+    }
+
+    trigger_engine_destroy(engine);
+
+    // Right after start-up fewer pre frames exist
+    engine = trigger_engine_create(2, PRE, POST, 0.0);
+    sweep(engine, channels, 50.0, 0.0, 0.0);
+    sweep(engine, channels, 50.0, 0.0, 0.1);
+    if (!sweep(engine, channels, 50.0, 0.0, 0.2)) return fail("start-up capture must complete");
+    event = trigger_engine_get_event(engine);
+    if (event->trigger_frame != 0 || event->frame_count != 1 + POST) return fail("start-up capture window mismatch");
+    trigger_engine_destroy(engine);
+
+    // An invalid sample neither fires nor enters the frames
+    engine = trigger_engine_create(2, PRE, POST, 0.0);
+    channels[0].sample_quality_flags = CHANNEL_QUALITY_INVALID;
+    if (sweep(engine, channels, 50.0, 0.0, 0.0) || sweep(engine, channels, 50.0, 0.0, 0.1) ||
+        sweep(engine, channels, 50.0, 0.0, 0.2) || trigger_engine_get_event(engine)) {
+        return fail("invalid samples must not trigger");
+    }
+    channels[0].sample_quality_flags = CHANNEL_QUALITY_OK;
+    trigger_engine_destroy(engine);
+
+    printf("Trigger engine tests passed\n");
+    return 0;
+}
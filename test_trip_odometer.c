@@ -0,0 +1,97 @@
+#include "TripOdometer.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define STATE_FILE "/tmp/trip_odometer_test.bin"
+#define METERS_PER_DEGREE (6371008.8 * M_PI / 180.0)
+
+static int fail(const char* message) {
+    fprintf(stderr, "%s\n", message);
+    return 1;
+}
+
+static TripOdometer* create_odometer(void) {
+    TripConfig config = { .enabled = true, .window_s = 60.0 };
+    snprintf(config.state_file, sizeof(config.state_file), STATE_FILE);
+    return trip_odometer_create(&config);
+}
+
+// One fix per second heading north at speed_mps, spending wh_per_km
+static void drive(TripOdometer* odometer, GPSData* gps, double* energy_wh, int seconds,
+                  double speed_mps, double wh_per_km) {
+    for (int s = 0; s < seconds; s++) {
+        gps->latitude += speed_mps / METERS_PER_DEGREE;
+        gps->speed = speed_mps;
+        gps->fix_time_s += 1.0;
+        *energy_wh += wh_per_km * speed_mps / 1000.0;
+        trip_odometer_update(odometer, gps, *energy_wh);
+        trip_odometer_update(odometer, gps, *energy_wh); // A repeated fix adds nothing
+    }
+}
+
+int main(void) {
+    unlink(STATE_FILE);
+    TripConfig disabled = {0};
+    if (trip_odometer_create(&disabled)) return fail("a disabled section must not create an odometer");
+
+    TripOdometer* odometer = create_odometer();
+    if (!odometer) return fail("create failed");
+
+    GPSData gps = { .latitude = -23.5, .longitude = -46.6, .speed = 0.0, .fix_time_s = 100.0 };
+    double energy_wh = 1000.0; // The meter's lifetime total; only differences count
+    trip_odometer_update(odometer, &gps, energy_wh);
+
+    // 2 km at 36 km/h and 20 Wh/km
+    drive(odometer, &gps, &energy_wh, 200, 10.0, 20.0);
+    TripReading reading;
+    trip_odometer_get_reading(odometer, &reading);
+    if (fabs(reading.trip_km - 2.0) > 1e-6 || reading.odometer_km != reading.trip_km) return fail("distance mismatch");
+    if (fabs(reading.wh_per_km - 20.0) > 1e-6 || fabs(reading.trip_wh_per_km - 20.0) > 1e-6) {
+        return fail("efficiency mismatch");
+    }
+
+    // Two minutes parked: ±5 m of wander at low reported speed adds nothing, and the
+    // rolling window, now without distance, has no efficiency
+    double parked_latitude = gps.latitude;
+    for (int s = 0; s < 120; s++) {
+        gps.latitude = parked_latitude + ((s % 2) ? 5.0 : -5.0) / METERS_PER_DEGREE;
+        gps.speed = 0.2;
+        gps.fix_time_s += 1.0;
+        trip_odometer_update(odometer, &gps, energy_wh);
+    }
+    gps.latitude = parked_latitude;
+    trip_odometer_get_reading(odometer, &reading);
+    if (fabs(reading.trip_km - 2.0) > 1e-6) return fail("stationary drift must not add distance");
+    if (!isnan(reading.wh_per_km) || fabs(reading.trip_wh_per_km - 20.0) > 1e-6) return fail("parked efficiency mismatch");
+
+    // A fix 50 km away is a position jump; distance resumes from the new position
+    gps.latitude += 50000.0 / METERS_PER_DEGREE;
+    gps.speed = 10.0;
+    gps.fix_time_s += 1.0;
+    trip_odometer_update(odometer, &gps, energy_wh);
+    trip_odometer_get_reading(odometer, &reading);
+    if (fabs(reading.trip_km - 2.0) > 1e-6) return fail("position jump must not add distance");
+
+    // Two minutes at 30 Wh/km: the rolling window only sees the last minute
+    drive(odometer, &gps, &energy_wh, 120, 10.0, 30.0);
+    trip_odometer_get_reading(odometer, &reading);
+    if (fabs(reading.trip_km - 3.2) > 1e-6) return fail("distance after jump mismatch");
+    if (fabs(reading.wh_per_km - 30.0) > 1e-6) return fail("rolling efficiency mismatch");
+    if (fabs(reading.trip_wh_per_km - (2.0 * 20.0 + 1.2 * 30.0) / 3.2) > 1e-6) return fail("trip efficiency mismatch");
+
+    // The odometer survives a restart; the trip starts over
+    trip_odometer_save(odometer);
+    trip_odometer_destroy(odometer);
+    odometer = create_odometer();
+    trip_odometer_get_reading(odometer, &reading);
+    if (fabs(reading.odometer_km - 3.2) > 1e-6 || reading.trip_km != 0.0 || !isnan(reading.trip_wh_per_km)) {
+        return fail("odometer must be restored and the trip reset");
+    }
+
+    trip_odometer_destroy(odometer);
+    unlink(STATE_FILE);
+    printf("Trip odometer tests passed\n");
+    return 0;
+}